@@ -0,0 +1,98 @@
+#include "CpuInfo.hpp"
+
+#if defined(WFE_ARCH_X86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace wfe {
+	// Constants
+	static const uint32_t CPUID_1_ECX_OSXSAVE = 1 << 27;
+	static const uint32_t CPUID_1_ECX_AVX = 1 << 28;
+	static const uint32_t CPUID_1_EDX_SSE2 = 1 << 26;
+	static const uint32_t CPUID_7_EBX_AVX2 = 1 << 5;
+	static const uint32_t CPUID_7_EBX_AVX512F = 1 << 16;
+	static const uint64_t XCR0_AVX_STATE = 0x6;
+	static const uint64_t XCR0_AVX512_STATE = 0xe6;
+
+	// Internal helper functions
+#if defined(WFE_ARCH_X86)
+	static void GetCpuId(uint32_t leaf, uint32_t subleaf, uint32_t* registers) {
+#if defined(_MSC_VER)
+		__cpuidex((int32_t*)registers, (int32_t)leaf, (int32_t)subleaf);
+#else
+		__cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+	}
+	static uint64_t GetXcr0() {
+#if defined(_MSC_VER)
+		return _xgetbv(0);
+#else
+		uint32_t eax, edx;
+		__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+		return ((uint64_t)edx << 32) | eax;
+#endif
+	}
+#endif
+	static SimdLevel DetectSimdLevel() {
+#if defined(WFE_ARCH_X86)
+		// Get the highest supported leaf and the basic feature flags
+		uint32_t registers[4];
+		GetCpuId(0, 0, registers);
+		uint32_t maxLeaf = registers[0];
+
+		GetCpuId(1, 0, registers);
+		uint32_t features1Ecx = registers[2];
+		uint32_t features1Edx = registers[3];
+
+		if(!(features1Edx & CPUID_1_EDX_SSE2))
+			return SIMD_LEVEL_SCALAR;
+
+		// The AVX levels also require the OS to save the extended register state on context switches
+		if(maxLeaf < 7 || !(features1Ecx & CPUID_1_ECX_OSXSAVE) || !(features1Ecx & CPUID_1_ECX_AVX))
+			return SIMD_LEVEL_SSE2;
+
+		uint64_t xcr0 = GetXcr0();
+		if((xcr0 & XCR0_AVX_STATE) != XCR0_AVX_STATE)
+			return SIMD_LEVEL_SSE2;
+
+		GetCpuId(7, 0, registers);
+		uint32_t features7Ebx = registers[1];
+
+		if((features7Ebx & CPUID_7_EBX_AVX512F) && (xcr0 & XCR0_AVX512_STATE) == XCR0_AVX512_STATE)
+			return SIMD_LEVEL_AVX512;
+		if(features7Ebx & CPUID_7_EBX_AVX2)
+			return SIMD_LEVEL_AVX2;
+
+		return SIMD_LEVEL_SSE2;
+#elif defined(WFE_ARCH_ARM64)
+		// NEON is mandatory on ARM64
+		return SIMD_LEVEL_NEON;
+#else
+		return SIMD_LEVEL_SCALAR;
+#endif
+	}
+
+	// Public functions
+	SimdLevel GetSimdLevel() {
+		static SimdLevel simdLevel = DetectSimdLevel();
+		return simdLevel;
+	}
+	const char_t* GetSimdLevelName(SimdLevel simdLevel) {
+		switch(simdLevel) {
+		case SIMD_LEVEL_NEON:
+			return "NEON";
+		case SIMD_LEVEL_SSE2:
+			return "SSE2";
+		case SIMD_LEVEL_AVX2:
+			return "AVX2";
+		case SIMD_LEVEL_AVX512:
+			return "AVX-512";
+		default:
+			return "Scalar";
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Core.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+/// @brief Defined if the target architecture is x86 or x86-64.
+#define WFE_ARCH_X86
+#elif defined(__aarch64__) || defined(_M_ARM64)
+/// @brief Defined if the target architecture is ARM64.
+#define WFE_ARCH_ARM64
+#endif
+
+#if defined(WFE_ARCH_X86)
+#include <immintrin.h>
+#elif defined(WFE_ARCH_ARM64)
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+/// @brief Compiles the following function for the given instruction set features. MSVC accepts any intrinsic without it.
+#define WFE_TARGET(features)
+/// @brief Keeps the following function from being inlined into its callers.
+#define WFE_NOINLINE __declspec(noinline)
+#else
+/// @brief Compiles the following function for the given instruction set features, so that it can be dispatched to at runtime.
+#define WFE_TARGET(features) __attribute__((target(features)))
+/// @brief Keeps the following function from being inlined into its callers, which is required for functions reading thread locals that may be called across a fiber switch.
+#define WFE_NOINLINE __attribute__((noinline))
+#endif
+
+namespace wfe {
+	/// @brief All SIMD instruction set levels that kernels can be dispatched to.
+	typedef enum {
+		/// @brief No SIMD instruction set is available.
+		SIMD_LEVEL_SCALAR,
+		/// @brief ARM's NEON instruction set, with 4-wide float vectors.
+		SIMD_LEVEL_NEON,
+		/// @brief x86's SSE2 instruction set, with 4-wide float vectors.
+		SIMD_LEVEL_SSE2,
+		/// @brief x86's AVX2 instruction set, with 8-wide float vectors.
+		SIMD_LEVEL_AVX2,
+		/// @brief x86's AVX-512 foundation instruction set, with 16-wide float vectors.
+		SIMD_LEVEL_AVX512
+	} SimdLevel;
+
+	/// @brief Gets the most capable SIMD instruction set level supported by both the CPU and the OS. The level is detected once, on the first call.
+	/// @return The SIMD level enum value.
+	SimdLevel GetSimdLevel();
+	/// @brief Gets the given SIMD level's name.
+	/// @param simdLevel The SIMD level whose name to get.
+	/// @return A null-terminated string containing the level's name.
+	const char_t* GetSimdLevelName(SimdLevel simdLevel);
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#include "FixedTimestep.hpp"
+
+namespace wfe {
+	// Public functions
+	FixedTimestep::FixedTimestep(uint64_t stepTime, uint32_t maxStepCount) : stepTime(stepTime ? stepTime : 1), maxStepCount(maxStepCount ? maxStepCount : 1), accumulatedTime(0), droppedTime(0), stepCount(0) { }
+
+	uint32_t FixedTimestep::Advance(uint64_t elapsedTime) {
+		// Take every whole step out of the accumulated time
+		accumulatedTime += elapsedTime;
+
+		uint64_t steps = accumulatedTime / stepTime;
+		accumulatedTime -= steps * stepTime;
+
+		// Drop the steps over the limit, so that a hitch is absorbed instead of making every following advance run more steps
+		if(steps > maxStepCount) {
+			droppedTime += (steps - maxStepCount) * stepTime;
+			steps = maxStepCount;
+		}
+
+		stepCount += steps;
+
+		return (uint32_t)steps;
+	}
+	void FixedTimestep::Reset() {
+		accumulatedTime = 0;
+		droppedTime = 0;
+		stepCount = 0;
+	}
+}
\ No newline at end of file
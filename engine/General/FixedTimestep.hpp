@@ -0,0 +1,66 @@
+#pragma once
+
+#include <Core.hpp>
+
+namespace wfe {
+	/// @brief A fixed timestep accumulator, which turns variable elapsed times into a whole number of fixed length steps. The number of steps per advance is clamped, so that a slow step can't make the following advances fall further and further behind.
+	class FixedTimestep {
+	public:
+		/// @brief Creates a fixed timestep accumulator.
+		/// @param stepTime The length of a single step, in nanoseconds.
+		/// @param maxStepCount The maximum number of steps a single advance can return. Time that would require more steps is dropped.
+		FixedTimestep(uint64_t stepTime, uint32_t maxStepCount);
+		FixedTimestep(const FixedTimestep&) = default;
+		FixedTimestep(FixedTimestep&&) noexcept = default;
+
+		FixedTimestep& operator=(const FixedTimestep&) = default;
+		FixedTimestep& operator=(FixedTimestep&&) = default;
+
+		/// @brief Gets the length of a single step.
+		/// @return The step time, in nanoseconds.
+		uint64_t GetStepTime() const {
+			return stepTime;
+		}
+		/// @brief Gets the maximum number of steps a single advance can return.
+		/// @return The maximum step count.
+		uint32_t GetMaxStepCount() const {
+			return maxStepCount;
+		}
+		/// @brief Gets the time accumulated since the last step, which is always less than the step time.
+		/// @return The accumulated time, in nanoseconds.
+		uint64_t GetAccumulatedTime() const {
+			return accumulatedTime;
+		}
+		/// @brief Gets the total time dropped because an advance would have required too many steps.
+		/// @return The dropped time, in nanoseconds.
+		uint64_t GetDroppedTime() const {
+			return droppedTime;
+		}
+		/// @brief Gets the total number of steps returned by every advance.
+		/// @return The step count.
+		uint64_t GetStepCount() const {
+			return stepCount;
+		}
+		/// @brief Gets how far the accumulator is between the last step and the next one.
+		/// @return The accumulated time divided by the step time, in the [0, 1) range.
+		float32_t GetInterpolationFactor() const {
+			return (float32_t)accumulatedTime / (float32_t)stepTime;
+		}
+
+		/// @brief Adds the given elapsed time to the accumulator and takes as many whole steps out of it as possible.
+		/// @param elapsedTime The time elapsed since the last advance, in nanoseconds.
+		/// @return The number of steps to run, which is at most the maximum step count.
+		uint32_t Advance(uint64_t elapsedTime);
+		/// @brief Resets the accumulator, keeping its step time and maximum step count.
+		void Reset();
+
+		/// @brief Destroys the fixed timestep accumulator.
+		~FixedTimestep() = default;
+	private:
+		uint64_t stepTime;
+		uint32_t maxStepCount;
+		uint64_t accumulatedTime;
+		uint64_t droppedTime;
+		uint64_t stepCount;
+	};
+}
\ No newline at end of file
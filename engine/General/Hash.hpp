@@ -0,0 +1,28 @@
+#pragma once
+
+#include <Core.hpp>
+
+namespace wfe {
+	/// @brief The initial value of a 64-bit FNV-1a hash.
+	static const uint64_t FNV1A_HASH_OFFSET = 0xcbf29ce484222325;
+	/// @brief The prime used by the 64-bit FNV-1a hash.
+	static const uint64_t FNV1A_HASH_PRIME = 0x100000001b3;
+
+	/// @brief Computes the 64-bit FNV-1a hash of the given memory.
+	/// @param data A pointer to the memory to hash.
+	/// @param size The size of the memory to hash, in bytes.
+	/// @param hash The hash to continue from. Defaulted to the FNV-1a offset basis.
+	/// @return The resulting 64-bit hash.
+	inline uint64_t ComputeFNV1aHash(const void* data, size_t size, uint64_t hash = FNV1A_HASH_OFFSET) {
+		// Hash every byte of the given memory
+		const uint8_t* bytes = (const uint8_t*)data;
+		const uint8_t* bytesEnd = bytes + size;
+
+		for(; bytes != bytesEnd; ++bytes) {
+			hash ^= *bytes;
+			hash *= FNV1A_HASH_PRIME;
+		}
+
+		return hash;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include "HeapMemory.hpp"
+#include "CpuInfo.hpp"
+
+#include <stdlib.h>
+
+namespace wfe {
+	// Thread local variables
+	static thread_local uint64_t heapAllocationCount = 0;
+
+	// Public functions
+	WFE_NOINLINE void* AllocHeapMemory(size_t size) {
+		// Never inline this function, so that a job that moved to another thread after a fiber switch counts its allocations for its new thread
+#ifndef WFE_WRAP_HEAP_FUNCTIONS
+		++heapAllocationCount;
+#endif
+		return AllocMemory(size);
+	}
+	WFE_NOINLINE uint64_t GetThreadHeapAllocationCount() {
+		return heapAllocationCount;
+	}
+}
+
+#ifdef WFE_WRAP_HEAP_FUNCTIONS
+// The linker redirects every malloc, calloc and realloc call made by the engine, Core and the project to the functions below, which count the call before forwarding it to the real allocator.
+// This catches the allocations Core's containers and NewObject make through AllocMemory, which AllocHeapMemory alone can't see.
+extern "C" {
+	void* __real_malloc(size_t size);
+	void* __real_calloc(size_t count, size_t size);
+	void* __real_realloc(void* memory, size_t size);
+
+	WFE_NOINLINE void* __wrap_malloc(size_t size) {
+		++wfe::heapAllocationCount;
+		return __real_malloc(size);
+	}
+	WFE_NOINLINE void* __wrap_calloc(size_t count, size_t size) {
+		++wfe::heapAllocationCount;
+		return __real_calloc(count, size);
+	}
+	WFE_NOINLINE void* __wrap_realloc(void* memory, size_t size) {
+		++wfe::heapAllocationCount;
+		return __real_realloc(memory, size);
+	}
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <Core.hpp>
+
+namespace wfe {
+	/// @brief Allocates memory from the general heap, counting the allocation for the calling thread. The engine allocates its raw heap memory through this function instead of AllocMemory, so that paths that shouldn't reach the heap, like a steady-state frame, can be checked. The memory must be freed using FreeMemory.
+	/// @param size The size of the allocation.
+	/// @return A pointer to the allocated memory, or nullptr if the allocation failed.
+	void* AllocHeapMemory(size_t size);
+	/// @brief Gets the number of heap allocations the calling thread made, including the ones made by jobs it ran. On Linux, every malloc, calloc and realloc call is counted, including the ones Core's containers make; on other platforms, only the allocations made through AllocHeapMemory are counted.
+	/// @return The thread's heap allocation count.
+	uint64_t GetThreadHeapAllocationCount();
+}
\ No newline at end of file
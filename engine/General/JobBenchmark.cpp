@@ -0,0 +1,164 @@
+#include "JobBenchmark.hpp"
+#include "JobSystem.hpp"
+#include "RadixSort.hpp"
+#include "Platform/Clock.hpp"
+#include "Platform/Thread.hpp"
+#include "Renderer/Culling/FrustumCuller.hpp"
+
+#include <math.h>
+
+namespace wfe {
+	// Constants
+	static const size_t SORT_KEY_COUNT = 1 << 22;
+	static const size_t CULL_OBJECT_COUNT = 1 << 21;
+	static const size_t COMPUTE_ELEMENT_COUNT = 1 << 20;
+	static const size_t COMPUTE_ITERATION_COUNT = 64;
+	static const size_t COMPUTE_MIN_BATCH_SIZE = 1 << 10;
+	static const uint32_t RUN_COUNT = 5;
+
+	// Internal structs
+	enum BenchmarkType {
+		BENCHMARK_TYPE_RADIX_SORT,
+		BENCHMARK_TYPE_FRUSTUM_CULL,
+		BENCHMARK_TYPE_PARALLEL_FOR,
+		BENCHMARK_TYPE_COUNT
+	};
+
+	struct BenchmarkData {
+		vector<uint64_t> sourceKeys;
+		vector<uint64_t> keys;
+		vector<uint32_t> values;
+		vector<uint64_t> tempKeys;
+		vector<uint32_t> tempValues;
+
+		FrustumCuller::Plane planes[FrustumCuller::PLANE_COUNT];
+		vector<uint32_t> visibleIndices;
+
+		vector<float32_t> computeValues;
+	};
+
+	static const char_t* const BENCHMARK_NAMES[BENCHMARK_TYPE_COUNT] {
+		"radix sort",
+		"frustum cull",
+		"parallel for"
+	};
+
+	// Internal helper functions
+	static uint32_t NextRandom(uint32_t& state) {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+	static float32_t NextRandomFloat(uint32_t& state, float32_t min, float32_t max) {
+		return min + (max - min) * (float32_t)(NextRandom(state) >> 8) * (1.f / (float32_t)(1 << 24));
+	}
+	static void ComputeBatch(void* userData, size_t begin, size_t end) {
+		// Run a fixed number of dependent iterations on every element, so that the batch is bound by arithmetic instead of memory
+		float32_t* values = (float32_t*)userData;
+
+		for(size_t i = begin; i != end; ++i) {
+			float32_t value = (float32_t)i;
+			for(size_t j = 0; j != COMPUTE_ITERATION_COUNT; ++j)
+				value = sqrtf(value * 1.0001f + 1.f);
+
+			values[i] = value;
+		}
+	}
+	static uint64_t RunBenchmark(BenchmarkType type, JobSystem* jobSystem, const FrustumCuller* culler, BenchmarkData& data) {
+		// Time the fastest of multiple runs, to filter out the noise of other processes
+		uint64_t bestTime = UINT64_T_MAX;
+
+		for(uint32_t run = 0; run != RUN_COUNT; ++run) {
+			// Reset the sort's keys outside of the timed section
+			if(type == BENCHMARK_TYPE_RADIX_SORT) {
+				memcpy(data.keys.data(), data.sourceKeys.data(), SORT_KEY_COUNT * sizeof(uint64_t));
+				for(size_t i = 0; i != SORT_KEY_COUNT; ++i)
+					data.values[i] = (uint32_t)i;
+			}
+
+			uint64_t startTime = GetClockTime();
+
+			switch(type) {
+			case BENCHMARK_TYPE_RADIX_SORT:
+				RadixSort(SORT_KEY_COUNT, data.keys.data(), data.values.data(), data.tempKeys.data(), data.tempValues.data(), jobSystem);
+				break;
+			case BENCHMARK_TYPE_FRUSTUM_CULL:
+				culler->Cull(data.planes, data.visibleIndices.data());
+				break;
+			case BENCHMARK_TYPE_PARALLEL_FOR:
+				jobSystem->ParallelFor(COMPUTE_ELEMENT_COUNT, COMPUTE_MIN_BATCH_SIZE, ComputeBatch, data.computeValues.data());
+				break;
+			default:
+				break;
+			}
+
+			uint64_t time = GetClockTime() - startTime;
+			if(time < bestTime)
+				bestTime = time;
+		}
+
+		return bestTime;
+	}
+
+	// Public functions
+	void RunJobScalingBenchmarks(Logger* logger, uint32_t maxThreadCount) {
+		// Use every hardware thread if no maximum is given
+		if(!maxThreadCount)
+			maxThreadCount = Thread::GetHardwareThreadCount();
+
+		PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
+
+		// Generate the benchmarks' data
+		BenchmarkData data;
+		uint32_t randomState = 0x2545f491;
+
+		data.sourceKeys.resize(SORT_KEY_COUNT);
+		data.keys.resize(SORT_KEY_COUNT);
+		data.values.resize(SORT_KEY_COUNT);
+		data.tempKeys.resize(SORT_KEY_COUNT);
+		data.tempValues.resize(SORT_KEY_COUNT);
+		for(size_t i = 0; i != SORT_KEY_COUNT; ++i)
+			data.sourceKeys[i] = ((uint64_t)NextRandom(randomState) << 32) | NextRandom(randomState);
+
+		const Matrix4 viewProjection {{
+			{ 1.f, 0.f, 0.f, 0.f },
+			{ 0.f, 1.f, 0.f, 0.f },
+			{ 0.f, 0.f, -.5f, -1.f },
+			{ 0.f, 0.f, .5f, 0.f }
+		}};
+		FrustumCuller::ExtractPlanes(viewProjection, data.planes);
+		data.visibleIndices.resize(CULL_OBJECT_COUNT);
+
+		data.computeValues.resize(COMPUTE_ELEMENT_COUNT);
+
+		uint64_t baseTimes[BENCHMARK_TYPE_COUNT];
+
+		for(uint32_t threadCount = 1; threadCount <= maxThreadCount; ++threadCount) {
+			// Create a job system with the current thread count, along with a culler holding randomly placed spheres
+			JobSystem* jobSystem = NewObject<JobSystem>(threadCount);
+			FrustumCuller* culler = NewObject<FrustumCuller>(jobSystem);
+
+			uint32_t cullRandomState = 0x9e3779b9;
+			for(size_t i = 0; i != CULL_OBJECT_COUNT; ++i) {
+				float32_t center[3] { NextRandomFloat(cullRandomState, -100.f, 100.f), NextRandomFloat(cullRandomState, -100.f, 100.f), NextRandomFloat(cullRandomState, -100.f, 100.f) };
+				culler->AddSphere(center, NextRandomFloat(cullRandomState, .1f, 2.f));
+			}
+
+			// Run every benchmark, using the single threaded times as the speedup baselines
+			for(uint32_t type = 0; type != BENCHMARK_TYPE_COUNT; ++type) {
+				uint64_t time = RunBenchmark((BenchmarkType)type, jobSystem, culler, data);
+				if(threadCount == 1)
+					baseTimes[type] = time;
+
+				uint64_t speedup = time ? baseTimes[type] * 100 / time : 0;
+				logger->LogInfoMessage("Job scaling benchmark: %s on %u threads took %llu us, %llu.%02llux speedup.", BENCHMARK_NAMES[type], threadCount, (unsigned long long)(time / 1000), (unsigned long long)(speedup / 100), (unsigned long long)(speedup % 100));
+			}
+
+			DestroyObject(culler);
+			DestroyObject(jobSystem);
+		}
+
+		PopMemoryUsageType();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <Core.hpp>
+
+namespace wfe {
+	/// @brief Runs the job system's scaling benchmarks, which time a radix sort, a frustum cull and a compute bound parallel for on job systems with every thread count from 1 to the given maximum, logging every run's time and its speedup over a single thread.
+	/// @param logger The logger to write the results to.
+	/// @param maxThreadCount The largest thread count to benchmark, or 0 to use every hardware thread.
+	void RunJobScalingBenchmarks(Logger* logger, uint32_t maxThreadCount = 0);
+}
\ No newline at end of file
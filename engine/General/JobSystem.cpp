@@ -0,0 +1,610 @@
+#include "JobSystem.hpp"
+#include "CpuInfo.hpp"
+
+namespace wfe {
+	// Constants
+	static const uint32_t IDLE_SPIN_COUNT = 64;
+
+	// Internal structs
+	struct ParallelForBatch {
+		JobSystem::ParallelForFunction function;
+		void* userData;
+		size_t begin;
+		size_t end;
+	};
+
+	// Thread local variables
+	static thread_local JobSystem* currentJobSystem = nullptr;
+	static thread_local uint32_t currentWorkerIndex = UINT32_T_MAX;
+
+	// Internal helper functions
+	static void ParallelForJob(void* userData) {
+		// Run the batch's function on its range
+		ParallelForBatch* batch = (ParallelForBatch*)userData;
+		batch->function(batch->userData, batch->begin, batch->end);
+	}
+
+	void JobSystem::WorkerThread(void* userData) {
+		// Register the thread as the worker of its job system
+		Worker* worker = (Worker*)userData;
+		JobSystem* jobSystem = worker->jobSystem;
+
+		currentJobSystem = jobSystem;
+		currentWorkerIndex = worker->workerIndex;
+
+		// Convert the thread to a fiber, so it can switch to the job fibers
+		worker->threadFiber = NewObject<Fiber>();
+
+		while(jobSystem->running) {
+			// Run the next available job
+			if(jobSystem->RunNextJob(worker))
+				continue;
+
+			// Spin for a while before sleeping, as new jobs usually arrive in bursts
+			bool8_t foundJob = false;
+			for(uint32_t i = 0; i != IDLE_SPIN_COUNT && !foundJob; ++i) {
+				Thread::YieldCurrentThread();
+				foundJob = jobSystem->RunNextJob(worker);
+			}
+			if(foundJob)
+				continue;
+
+			// Sleep until jobs are submitted, checking the queues again after announcing the sleep so that no wake up is missed
+			++jobSystem->sleepingCount;
+			if(jobSystem->running && !jobSystem->HasQueuedJobs())
+				jobSystem->sleepSemaphore->Wait();
+			--jobSystem->sleepingCount;
+		}
+
+		DestroyObject(worker->threadFiber);
+	}
+	void JobSystem::FiberMain(void* userData) {
+		JobFiber* fiber = (JobFiber*)userData;
+		JobSystem* jobSystem = fiber->jobSystem;
+
+		while(true) {
+			// Run the fiber's current job, then free the scratch memory it left in the fiber's arena
+			jobSystem->RunJob(fiber->job);
+			fiber->scratchArena.Reset();
+
+			// Switch back to the thread fiber of the worker now running this fiber, which may have changed if the job waited, and let it free this fiber
+			Worker* worker = jobSystem->GetCurrentWorker();
+			worker->switchAction = SWITCH_ACTION_FREE;
+			worker->switchFiber = fiber;
+
+			fiber->fiber->SwitchTo(worker->threadFiber);
+		}
+	}
+	void JobSystem::LockSpinLock(atomic_uint32_t& lock) {
+		while(lock.exchange(1))
+			Thread::YieldCurrentThread();
+	}
+	void JobSystem::UnlockSpinLock(atomic_uint32_t& lock) {
+		lock = 0;
+	}
+
+	WFE_NOINLINE JobSystem::Worker* JobSystem::GetCurrentWorker() const {
+		// Never inline this function, so that the thread local variables are read again after a fiber switch, as the fiber may have moved to another thread
+		return currentJobSystem == this ? workers[currentWorkerIndex] : nullptr;
+	}
+	bool8_t JobSystem::PushJob(Worker* worker, const QueuedJob& job) {
+		// Exit the function if the deque is full
+		size_t bottom = worker->bottom;
+		size_t top = worker->top;
+		if(bottom - top >= DEQUE_CAPACITY)
+			return false;
+
+		// Write the job, then publish it to thieves by moving the bottom
+		worker->jobs[bottom & (DEQUE_CAPACITY - 1)] = job;
+		worker->bottom = bottom + 1;
+
+		return true;
+	}
+	bool8_t JobSystem::PopJob(Worker* worker, QueuedJob& job) {
+		// Reserve the bottom job before reading the top, so that thieves can't take it unnoticed
+		size_t bottom = worker->bottom - 1;
+		worker->bottom = bottom;
+		size_t top = worker->top;
+
+		ptrdiff_t size = (ptrdiff_t)(bottom - top);
+		if(size < 0) {
+			// The deque is empty; restore the bottom
+			worker->bottom = bottom + 1;
+			return false;
+		}
+
+		job = worker->jobs[bottom & (DEQUE_CAPACITY - 1)];
+		if(size)
+			return true;
+
+		// This is the last job, so race the thieves for it by moving the top
+		bool8_t popped = worker->top.compare_exchange_strong(top, top + 1);
+		worker->bottom = bottom + 1;
+
+		return popped;
+	}
+	bool8_t JobSystem::StealJob(Worker* worker, QueuedJob& job) {
+		// Pick a random first victim, so that thieves don't all contend over the same deque
+		uint32_t workerCount = (uint32_t)workers.size();
+		uint32_t firstVictim = 0;
+
+		if(worker) {
+			worker->randomState ^= worker->randomState << 13;
+			worker->randomState ^= worker->randomState >> 17;
+			worker->randomState ^= worker->randomState << 5;
+			firstVictim = worker->randomState % workerCount;
+		}
+
+		for(uint32_t i = 0; i != workerCount; ++i) {
+			Worker* victim = workers[(firstVictim + i) % workerCount];
+			if(victim == worker)
+				continue;
+
+			// Skip the victim if its deque is empty
+			size_t top = victim->top;
+			size_t bottom = victim->bottom;
+			if((ptrdiff_t)(bottom - top) <= 0)
+				continue;
+
+			// Try to take the top job, which fails if the owner or another thief took it first
+			job = victim->jobs[top & (DEQUE_CAPACITY - 1)];
+			if(victim->top.compare_exchange_strong(top, top + 1))
+				return true;
+		}
+
+		return false;
+	}
+	bool8_t JobSystem::PopSharedJob(QueuedJob& job) {
+		// Exit the function if the shared queue is empty, without taking the lock
+		if(!sharedJobCount)
+			return false;
+
+		LockSpinLock(sharedLock);
+
+		if(sharedJobHead == sharedJobs.size()) {
+			UnlockSpinLock(sharedLock);
+			return false;
+		}
+
+		// Take the oldest job, resetting the queue once it's drained
+		job = sharedJobs[sharedJobHead++];
+		--sharedJobCount;
+
+		if(sharedJobHead == sharedJobs.size()) {
+			sharedJobs.clear();
+			sharedJobHead = 0;
+		}
+
+		UnlockSpinLock(sharedLock);
+
+		return true;
+	}
+	bool8_t JobSystem::HasQueuedJobs() const {
+		// Check the resumable fibers, the shared queue and every worker's deque
+		if(readyFiberCount || sharedJobCount)
+			return true;
+
+		for(const Worker* worker : workers)
+			if((ptrdiff_t)(worker->bottom - worker->top) > 0)
+				return true;
+
+		return false;
+	}
+	void JobSystem::QueueJob(const QueuedJob& job) {
+		// Push the job to the calling worker's deque
+		Worker* worker = GetCurrentWorker();
+		if(worker && PushJob(worker, job))
+			return;
+
+		// Push the job to the shared queue, as the calling thread isn't a worker or its deque is full
+		LockSpinLock(sharedLock);
+		sharedJobs.push_back(job);
+		++sharedJobCount;
+		UnlockSpinLock(sharedLock);
+	}
+	void JobSystem::WakeWorkers(uint32_t count) {
+		// Wake at most one sleeping worker for every job
+		uint32_t sleeping = sleepingCount;
+		if(sleeping)
+			sleepSemaphore->Signal(count < sleeping ? count : sleeping);
+	}
+	bool8_t JobSystem::RunNextJob(Worker* worker) {
+		QueuedJob job;
+
+		// Run queued jobs directly if the calling thread isn't a worker, as it has no thread fiber to switch from
+		if(!worker) {
+			if(PopSharedJob(job) || StealJob(nullptr, job)) {
+				RunJob(job);
+				return true;
+			}
+
+			return false;
+		}
+
+		// Resume a fiber whose wait finished first, as its job is already underway
+		JobFiber* fiber = PopReadyFiber();
+		if(fiber) {
+			RunFiber(worker, fiber);
+			return true;
+		}
+
+		// Take a job from the worker's own deque first, then from the shared queue and finally from another worker
+		if(!PopJob(worker, job) && !PopSharedJob(job) && !StealJob(worker, job))
+			return false;
+
+		// Run the job on a free fiber, or directly on the thread if every fiber is in use
+		fiber = AcquireFiber();
+		if(!fiber) {
+			RunJob(job);
+			return true;
+		}
+
+		fiber->job = job;
+		RunFiber(worker, fiber);
+
+		return true;
+	}
+	void JobSystem::RunJob(const QueuedJob& job) {
+		// Run the job
+		job.function(job.userData);
+
+		// Decrement the job's counter, releasing the jobs and fibers waiting on it if it reached zero
+		if(job.counter && --job.counter->value == 0) {
+			if(pendingJobCount)
+				ReleasePendingJobs();
+			if(waitingFiberCount)
+				ReleaseWaitingFibers();
+		}
+	}
+	void JobSystem::RunFiber(Worker* worker, JobFiber* fiber) {
+		// Switch to the fiber with its scratch arena made current, which returns once it finished its job or started waiting
+		worker->currentFiber = fiber;
+		LinearArena* previousArena = SetThreadScratchArena(&fiber->scratchArena);
+
+		worker->threadFiber->SwitchTo(fiber->fiber);
+
+		SetThreadScratchArena(previousArena);
+		worker->currentFiber = nullptr;
+
+		// Complete the fiber's switch now that it isn't running anymore, so that no other worker can resume it too early
+		switch(worker->switchAction) {
+		case SWITCH_ACTION_FREE:
+			LockSpinLock(freeFiberLock);
+			freeFibers.push_back(worker->switchFiber);
+			UnlockSpinLock(freeFiberLock);
+			break;
+		case SWITCH_ACTION_WAIT:
+			SuspendFiber(worker->switchFiber, worker->switchCounter);
+			break;
+		default:
+			break;
+		}
+
+		worker->switchAction = SWITCH_ACTION_NONE;
+	}
+	JobSystem::JobFiber* JobSystem::AcquireFiber() {
+		LockSpinLock(freeFiberLock);
+
+		JobFiber* fiber = nullptr;
+		if(!freeFibers.empty()) {
+			fiber = freeFibers.back();
+			freeFibers.pop_back();
+		}
+
+		UnlockSpinLock(freeFiberLock);
+
+		return fiber;
+	}
+	void JobSystem::SuspendFiber(JobFiber* fiber, const Counter* counter) {
+		// Add the fiber to the waiting fibers if its counter didn't finish. The waiting count is increased before checking the counter, so that a job finishing in the meantime always sees the new waiting fiber
+		LockSpinLock(waitingLock);
+
+		++waitingFiberCount;
+		if(counter->value) {
+			waitingFibers.push_back({ fiber, counter });
+
+			UnlockSpinLock(waitingLock);
+			return;
+		}
+		--waitingFiberCount;
+
+		UnlockSpinLock(waitingLock);
+
+		// The counter finished before the fiber could be suspended; make it resumable right away
+		PushReadyFiber(fiber);
+	}
+	void JobSystem::PushReadyFiber(JobFiber* fiber) {
+		LockSpinLock(readyLock);
+		readyFibers.push_back(fiber);
+		++readyFiberCount;
+		UnlockSpinLock(readyLock);
+
+		WakeWorkers(1);
+	}
+	JobSystem::JobFiber* JobSystem::PopReadyFiber() {
+		// Exit the function if no fiber is resumable, without taking the lock
+		if(!readyFiberCount)
+			return nullptr;
+
+		LockSpinLock(readyLock);
+
+		JobFiber* fiber = nullptr;
+		if(!readyFibers.empty()) {
+			fiber = readyFibers.back();
+			readyFibers.pop_back();
+			--readyFiberCount;
+		}
+
+		UnlockSpinLock(readyLock);
+
+		return fiber;
+	}
+	void JobSystem::ReleasePendingJobs() {
+		LockSpinLock(pendingLock);
+
+		// Queue every pending job whose dependency finished
+		uint32_t releasedCount = 0;
+		for(size_t i = 0; i != pendingJobs.size();) {
+			if(pendingJobs[i].dependency->value) {
+				++i;
+				continue;
+			}
+
+			QueueJob(pendingJobs[i].job);
+			++releasedCount;
+
+			pendingJobs[i] = pendingJobs.back();
+			pendingJobs.pop_back();
+		}
+		pendingJobCount -= releasedCount;
+
+		UnlockSpinLock(pendingLock);
+
+		WakeWorkers(releasedCount);
+	}
+
+	void JobSystem::ReleaseWaitingFibers() {
+		LockSpinLock(waitingLock);
+
+		// Make every waiting fiber whose counter finished resumable
+		size_t releasedCount = 0;
+		for(size_t i = 0; i != waitingFibers.size();) {
+			if(waitingFibers[i].counter->value) {
+				++i;
+				continue;
+			}
+
+			PushReadyFiber(waitingFibers[i].fiber);
+			++releasedCount;
+
+			waitingFibers[i] = waitingFibers.back();
+			waitingFibers.pop_back();
+		}
+		waitingFiberCount -= releasedCount;
+
+		UnlockSpinLock(waitingLock);
+	}
+
+	// Public functions
+	JobSystem::JobSystem(uint32_t threadCount, uint32_t externalThreadCount) : sleepingCount(0), running(1), sharedJobHead(0), sharedLock(0), sharedJobCount(0), pendingLock(0), pendingJobCount(0), freeFiberLock(0), readyLock(0), readyFiberCount(0), waitingLock(0), waitingFiberCount(0), previousJobSystem(currentJobSystem), previousWorkerIndex(currentWorkerIndex) {
+		// Use every hardware thread if no thread count is given
+		if(!threadCount)
+			threadCount = Thread::GetHardwareThreadCount();
+		this->threadCount = threadCount;
+
+		// Create the semaphore idle workers sleep on
+		sleepSemaphore = NewObject<Semaphore>();
+
+		// Create every worker's deque, followed by the external workers' deques
+		uint32_t workerCount = threadCount + externalThreadCount;
+
+		workers.resize(workerCount);
+		for(uint32_t i = 0; i != workerCount; ++i) {
+			Worker* worker = NewObject<Worker>();
+			if(!worker)
+				throw BadAllocException("Failed to allocate job system worker!");
+
+			worker->top = 0;
+			worker->bottom = 0;
+			worker->jobSystem = this;
+			worker->workerIndex = i;
+			worker->randomState = i * 0x9e3779b9 + 1;
+			worker->thread = nullptr;
+			worker->registered = 0;
+			worker->threadFiber = nullptr;
+			worker->currentFiber = nullptr;
+			worker->switchAction = SWITCH_ACTION_NONE;
+			worker->switchFiber = nullptr;
+			worker->switchCounter = nullptr;
+
+			workers[i] = worker;
+		}
+
+		// Create the pool of job fibers, allocating all of their stacks up front
+		jobFibers.resize(FIBER_COUNT);
+		freeFibers.resize(FIBER_COUNT);
+		for(size_t i = 0; i != FIBER_COUNT; ++i) {
+			JobFiber* fiber = NewObject<JobFiber>();
+			if(!fiber)
+				throw BadAllocException("Failed to allocate job fiber!");
+
+			fiber->jobSystem = this;
+			fiber->fiber = NewObject<Fiber>(FiberMain, fiber, FIBER_STACK_SIZE);
+
+			jobFibers[i] = fiber;
+			freeFibers[i] = fiber;
+		}
+
+		// Register the calling thread as the first worker and convert it to a fiber, then start the other workers' threads
+		currentJobSystem = this;
+		currentWorkerIndex = 0;
+
+		workers[0]->threadFiber = NewObject<Fiber>();
+
+		for(uint32_t i = 1; i != threadCount; ++i)
+			workers[i]->thread = NewObject<Thread>(WorkerThread, workers[i]);
+	}
+
+	void JobSystem::RegisterThread() {
+		// Claim the first free external worker
+		Worker* worker = nullptr;
+		for(uint32_t i = threadCount; i != workers.size(); ++i) {
+			uint32_t registered = 0;
+			if(workers[i]->registered.compare_exchange_strong(registered, 1)) {
+				worker = workers[i];
+				break;
+			}
+		}
+
+		if(!worker)
+			throw Exception("Failed to register thread with the job system, as every external worker is in use!");
+
+		// Make the thread the worker's owner and convert it to a fiber, so it can switch to the job fibers while it waits
+		currentJobSystem = this;
+		currentWorkerIndex = worker->workerIndex;
+
+		worker->threadFiber = NewObject<Fiber>();
+	}
+	void JobSystem::UnregisterThread() {
+		Worker* worker = GetCurrentWorker();
+		if(!worker || worker->workerIndex < threadCount)
+			throw Exception("Failed to unregister thread from the job system, as it isn't a registered external worker!");
+
+		// Move the jobs left in the worker's deque to the shared queue, so that the other workers still run them
+		QueuedJob job;
+		uint32_t movedCount = 0;
+
+		LockSpinLock(sharedLock);
+		while(PopJob(worker, job)) {
+			sharedJobs.push_back(job);
+			++sharedJobCount;
+			++movedCount;
+		}
+		UnlockSpinLock(sharedLock);
+
+		WakeWorkers(movedCount);
+
+		// Release the worker
+		DestroyObject(worker->threadFiber);
+		worker->threadFiber = nullptr;
+
+		currentJobSystem = nullptr;
+		currentWorkerIndex = UINT32_T_MAX;
+
+		worker->registered = 0;
+	}
+
+	void JobSystem::Submit(uint32_t count, const Job* jobs, Counter* counter, const Counter* dependency) {
+		// Exit the function if there's nothing to submit
+		if(!count)
+			return;
+
+		if(counter)
+			counter->value += count;
+
+		// Hold the jobs back if their dependency didn't finish. The pending count is increased before checking the dependency, so that a job finishing in the meantime always sees the new pending jobs
+		if(dependency && dependency->value) {
+			LockSpinLock(pendingLock);
+
+			pendingJobCount += count;
+			if(dependency->value) {
+				for(uint32_t i = 0; i != count; ++i)
+					pendingJobs.push_back({ { jobs[i].function, jobs[i].userData, counter }, dependency });
+
+				UnlockSpinLock(pendingLock);
+				return;
+			}
+			pendingJobCount -= count;
+
+			UnlockSpinLock(pendingLock);
+		}
+
+		// Queue the jobs and wake the workers to run them
+		for(uint32_t i = 0; i != count; ++i)
+			QueueJob({ jobs[i].function, jobs[i].userData, counter });
+
+		WakeWorkers(count);
+	}
+	void JobSystem::Wait(const Counter* counter) {
+		// Exit the function if the counter's jobs already finished
+		if(!counter->value)
+			return;
+
+		// Suspend the current job's fiber until the counter's jobs finish, switching back to the worker's thread fiber to run other jobs
+		Worker* worker = GetCurrentWorker();
+		if(worker && worker->currentFiber) {
+			JobFiber* fiber = worker->currentFiber;
+			worker->switchAction = SWITCH_ACTION_WAIT;
+			worker->switchFiber = fiber;
+			worker->switchCounter = counter;
+
+			fiber->fiber->SwitchTo(worker->threadFiber);
+			return;
+		}
+
+		// Run other jobs until the counter's jobs finish, as the calling thread isn't running a job fiber
+		while(counter->value)
+			if(!RunNextJob(worker))
+				Thread::YieldCurrentThread();
+	}
+	void JobSystem::ParallelFor(size_t count, size_t minBatchSize, ParallelForFunction function, void* userData) {
+		// Split the range into enough batches for stealing to balance them, as long as the batches stay large enough
+		if(!count)
+			return;
+		if(!minBatchSize)
+			minBatchSize = 1;
+
+		size_t batchCount = count / minBatchSize;
+		size_t maxBatchCount = workers.size() * BATCHES_PER_THREAD;
+		if(batchCount > maxBatchCount)
+			batchCount = maxBatchCount;
+
+		// Run the whole range on the calling thread if it can't be split
+		if(batchCount < 2) {
+			function(userData, 0, count);
+			return;
+		}
+
+		// Set every batch's range and job in scratch memory, which stays with the calling job's fiber if it's resumed on another thread
+		ScratchScope scratch;
+		ParallelForBatch* batches = (ParallelForBatch*)scratch.Allocate(batchCount * sizeof(ParallelForBatch), alignof(ParallelForBatch));
+		Job* jobs = (Job*)scratch.Allocate(batchCount * sizeof(Job), alignof(Job));
+
+		for(size_t i = 0; i != batchCount; ++i) {
+			batches[i] = { function, userData, count * i / batchCount, count * (i + 1) / batchCount };
+			jobs[i] = { ParallelForJob, batches + i };
+		}
+
+		// Submit every batch but the first, then run the first batch on the calling thread and help with the rest
+		Counter counter;
+		Submit((uint32_t)batchCount - 1, jobs + 1, &counter);
+
+		ParallelForJob(batches);
+		Wait(&counter);
+	}
+
+	JobSystem::~JobSystem() {
+		// Stop the workers, waking every sleeping worker so it can exit
+		running = 0;
+		sleepSemaphore->Signal(threadCount - 1);
+
+		// Wait for the worker threads to exit, then destroy the workers
+		for(uint32_t i = 1; i != threadCount; ++i)
+			DestroyObject(workers[i]->thread);
+		DestroyObject(workers[0]->threadFiber);
+		for(Worker* worker : workers)
+			DestroyObject(worker);
+
+		// Destroy the job fibers
+		for(JobFiber* fiber : jobFibers) {
+			DestroyObject(fiber->fiber);
+			DestroyObject(fiber);
+		}
+
+		DestroyObject(sleepSemaphore);
+
+		// Restore the calling thread's previous job system
+		currentJobSystem = previousJobSystem;
+		currentWorkerIndex = previousWorkerIndex;
+	}
+}
\ No newline at end of file
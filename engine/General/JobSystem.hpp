@@ -0,0 +1,199 @@
+#pragma once
+
+#include "LinearArena.hpp"
+#include "Platform/Fiber.hpp"
+#include "Platform/Semaphore.hpp"
+#include "Platform/Thread.hpp"
+
+#include <Core.hpp>
+
+namespace wfe {
+	/// @brief A work-stealing job system, which runs jobs on a worker thread per hardware thread. Every worker owns a Chase-Lev deque it pushes and pops jobs from, while idle workers steal jobs from the other workers' deques. Jobs run on pooled fibers, so that a job waiting on a counter is suspended and its worker moves on to other jobs. Every fiber has its own scratch arena, which is current while the fiber runs and is reset after every job.
+	class JobSystem {
+	public:
+		/// @brief The maximum number of jobs a worker's deque can hold. Jobs submitted to a full deque are moved to the shared queue.
+		static constexpr size_t DEQUE_CAPACITY = 4096;
+		/// @brief The number of batches a parallel for splits its range into per thread, so that uneven batches are balanced by stealing.
+		static constexpr size_t BATCHES_PER_THREAD = 4;
+		/// @brief The number of fibers jobs run on. If every fiber is in use, jobs run directly on their worker's thread and block it while waiting.
+		static constexpr size_t FIBER_COUNT = 128;
+		/// @brief The stack size of every job fiber, in bytes.
+		static constexpr size_t FIBER_STACK_SIZE = 128 << 10;
+
+		/// @brief The signature of the function run by a job.
+		typedef void(*JobFunction)(void* userData);
+		/// @brief The signature of the function run by a parallel for's batch.
+		typedef void(*ParallelForFunction)(void* userData, size_t begin, size_t end);
+
+		/// @brief A job to submit to the job system.
+		struct Job {
+			/// @brief The function to run.
+			JobFunction function;
+			/// @brief The user data to pass to the function.
+			void* userData;
+		};
+		/// @brief A counter of unfinished jobs, used as a lightweight handle to wait on or to make other jobs depend on.
+		class Counter {
+		public:
+			/// @brief Creates a counter with no unfinished jobs.
+			Counter() : value(0) { }
+			Counter(const Counter&) = delete;
+			Counter(Counter&&) noexcept = delete;
+
+			Counter& operator=(const Counter&) = delete;
+			Counter& operator=(Counter&&) = delete;
+
+			/// @brief Checks if every job tracked by the counter finished.
+			/// @return True if no tracked jobs are unfinished, otherwise false.
+			bool8_t IsDone() const {
+				return !value;
+			}
+
+			/// @brief Destroys the counter.
+			~Counter() = default;
+		private:
+			atomic_uint32_t value;
+
+			friend JobSystem;
+		};
+
+		/// @brief Creates a job system and starts its worker threads. The calling thread becomes the system's first worker, running jobs while it waits.
+		/// @param threadCount The number of threads that run jobs, including the calling thread, or 0 to use every hardware thread. Defaulted to 0.
+		/// @param externalThreadCount The number of workers reserved for threads the system doesn't own, like a simulation thread, which join the system with RegisterThread. Defaulted to 0.
+		JobSystem(uint32_t threadCount = 0, uint32_t externalThreadCount = 0);
+		JobSystem(const JobSystem&) = delete;
+		JobSystem(JobSystem&&) noexcept = delete;
+
+		JobSystem& operator=(const JobSystem&) = delete;
+		JobSystem& operator=(JobSystem&&) = delete;
+
+		/// @brief Gets the number of threads that run jobs, including the thread that created the system.
+		/// @return The system's thread count.
+		uint32_t GetThreadCount() const {
+			return threadCount;
+		}
+
+		/// @brief Registers the calling thread as one of the system's reserved external workers. The thread gets its own deque, which its submitted jobs are pushed to and other workers steal from, and runs jobs while it waits. Must be balanced by a call to UnregisterThread on the same thread.
+		void RegisterThread();
+		/// @brief Unregisters the calling thread, which must have been registered with RegisterThread, moving the jobs left in its deque to the shared queue.
+		void UnregisterThread();
+
+		/// @brief Submits the given jobs to the job system.
+		/// @param count The number of jobs to submit.
+		/// @param jobs A pointer to the array of jobs to submit, which is copied and may be freed afterwards.
+		/// @param counter The counter incremented by the job count and decremented when every job finishes, or nullptr. Must stay alive until every job finished.
+		/// @param dependency The counter whose jobs must finish before the submitted jobs start, or nullptr. Must stay alive until the submitted jobs started.
+		void Submit(uint32_t count, const Job* jobs, Counter* counter = nullptr, const Counter* dependency = nullptr);
+		/// @brief Waits for every job tracked by the given counter to finish. If called from a job, the job's fiber is suspended and resumed by any worker once the counter's jobs finish; otherwise, the calling thread runs other jobs in the meantime.
+		/// @param counter The counter to wait for.
+		void Wait(const Counter* counter);
+		/// @brief Splits the given range into batches and runs the given function on every batch in parallel, waiting for every batch to finish.
+		/// @param count The number of elements in the range.
+		/// @param minBatchSize The minimum number of elements in a batch, below which splitting the range isn't worth the overhead.
+		/// @param function The function to run on every batch.
+		/// @param userData The user data to pass to the function.
+		void ParallelFor(size_t count, size_t minBatchSize, ParallelForFunction function, void* userData);
+
+		/// @brief Waits for the worker threads to finish their current jobs and destroys the job system. Jobs still queued or suspended are discarded. Must be called on the thread that created the system.
+		~JobSystem();
+	private:
+		static constexpr size_t CACHE_LINE_SIZE = 64;
+
+		struct QueuedJob {
+			JobFunction function;
+			void* userData;
+			Counter* counter;
+		};
+		struct PendingJob {
+			QueuedJob job;
+			const Counter* dependency;
+		};
+		struct JobFiber {
+			Fiber* fiber;
+			JobSystem* jobSystem;
+			QueuedJob job;
+			LinearArena scratchArena;
+		};
+		struct WaitingFiber {
+			JobFiber* fiber;
+			const Counter* counter;
+		};
+		enum SwitchAction {
+			SWITCH_ACTION_NONE,
+			SWITCH_ACTION_FREE,
+			SWITCH_ACTION_WAIT
+		};
+		struct Worker {
+			atomic_size_t top;
+			uint8_t topPadding[CACHE_LINE_SIZE - sizeof(atomic_size_t)];
+			atomic_size_t bottom;
+			uint8_t bottomPadding[CACHE_LINE_SIZE - sizeof(atomic_size_t)];
+			QueuedJob jobs[DEQUE_CAPACITY];
+
+			JobSystem* jobSystem;
+			uint32_t workerIndex;
+			uint32_t randomState;
+			Thread* thread;
+			atomic_uint32_t registered;
+
+			Fiber* threadFiber;
+			JobFiber* currentFiber;
+			SwitchAction switchAction;
+			JobFiber* switchFiber;
+			const Counter* switchCounter;
+		};
+
+		static void WorkerThread(void* userData);
+		static void FiberMain(void* userData);
+		static void LockSpinLock(atomic_uint32_t& lock);
+		static void UnlockSpinLock(atomic_uint32_t& lock);
+
+		Worker* GetCurrentWorker() const;
+		bool8_t PushJob(Worker* worker, const QueuedJob& job);
+		bool8_t PopJob(Worker* worker, QueuedJob& job);
+		bool8_t StealJob(Worker* worker, QueuedJob& job);
+		bool8_t PopSharedJob(QueuedJob& job);
+		bool8_t HasQueuedJobs() const;
+		void QueueJob(const QueuedJob& job);
+		void WakeWorkers(uint32_t count);
+		bool8_t RunNextJob(Worker* worker);
+		void RunJob(const QueuedJob& job);
+		void RunFiber(Worker* worker, JobFiber* fiber);
+		JobFiber* AcquireFiber();
+		void SuspendFiber(JobFiber* fiber, const Counter* counter);
+		void PushReadyFiber(JobFiber* fiber);
+		JobFiber* PopReadyFiber();
+		void ReleasePendingJobs();
+		void ReleaseWaitingFibers();
+
+		vector<Worker*> workers;
+		uint32_t threadCount;
+		Semaphore* sleepSemaphore;
+		atomic_uint32_t sleepingCount;
+		atomic_uint32_t running;
+
+		vector<QueuedJob> sharedJobs;
+		size_t sharedJobHead;
+		atomic_uint32_t sharedLock;
+		atomic_size_t sharedJobCount;
+
+		vector<PendingJob> pendingJobs;
+		atomic_uint32_t pendingLock;
+		atomic_size_t pendingJobCount;
+
+		vector<JobFiber*> jobFibers;
+		vector<JobFiber*> freeFibers;
+		atomic_uint32_t freeFiberLock;
+
+		vector<JobFiber*> readyFibers;
+		atomic_uint32_t readyLock;
+		atomic_size_t readyFiberCount;
+
+		vector<WaitingFiber> waitingFibers;
+		atomic_uint32_t waitingLock;
+		atomic_size_t waitingFiberCount;
+
+		JobSystem* previousJobSystem;
+		uint32_t previousWorkerIndex;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "LinearArena.hpp"
+#include "CpuInfo.hpp"
+#include "HeapMemory.hpp"
+
+namespace wfe {
+	// Thread local variables
+	static thread_local LinearArena threadScratchArena;
+	static thread_local LinearArena* activeScratchArena = nullptr;
+
+	// Internal helper functions
+	LinearArena::Block* LinearArena::CreateBlock(size_t size) {
+		// Allocate the block's header and memory together
+		Block* block = (Block*)AllocHeapMemory(sizeof(Block) + size);
+		if(!block)
+			throw BadAllocException("Failed to allocate linear arena block!");
+
+		block->next = nullptr;
+		block->size = size;
+		block->offset = 0;
+
+		return block;
+	}
+	void LinearArena::FreeBlocks() {
+		while(first) {
+			Block* next = first->next;
+			FreeMemory(first);
+			first = next;
+		}
+
+		current = nullptr;
+	}
+
+	// Public functions
+	LinearArena::LinearArena(size_t blockSize) : blockSize(blockSize), first(nullptr), current(nullptr), allocatedSize(0) { }
+
+	void* LinearArena::Allocate(size_t size, size_t alignment) {
+		// Create the first block on the first allocation
+		if(!current) {
+			first = CreateBlock(blockSize > size + alignment ? blockSize : size + alignment);
+			current = first;
+		}
+
+		// Align the allocation inside the current block
+		uintptr_t blockStart = (uintptr_t)(current + 1);
+		uintptr_t address = (blockStart + current->offset + alignment - 1) & ~(uintptr_t)(alignment - 1);
+
+		if(address + size > blockStart + current->size) {
+			// Move on to the next block, which is left over from before a rewind, or a new block at least twice as large if there is none large enough
+			Block* next = current->next;
+			if(!next || next->size < size + alignment) {
+				size_t newBlockSize = current->size << 1;
+				if(newBlockSize < size + alignment)
+					newBlockSize = size + alignment;
+
+				Block* block = CreateBlock(newBlockSize);
+				block->next = next;
+				current->next = block;
+				next = block;
+			}
+
+			current = next;
+			current->offset = 0;
+
+			blockStart = (uintptr_t)(current + 1);
+			address = (blockStart + alignment - 1) & ~(uintptr_t)(alignment - 1);
+		}
+
+		current->offset = address + size - blockStart;
+		allocatedSize += size;
+
+		return (void*)address;
+	}
+	void LinearArena::Rewind(const Marker& marker) {
+		// Go back to the marker's block and offset, keeping the later blocks for the following allocations
+		if(marker.block) {
+			current = (Block*)marker.block;
+			current->offset = marker.offset;
+		} else if(first) {
+			current = first;
+			current->offset = 0;
+		}
+
+		allocatedSize = marker.allocatedSize;
+	}
+	void LinearArena::Reset() {
+		// Exit the function if nothing was ever allocated
+		if(!first)
+			return;
+
+		// Merge the blocks into a single block large enough for all of them, if more than one was needed
+		if(first->next) {
+			size_t mergedSize = 0;
+			for(Block* block = first; block; block = block->next)
+				mergedSize += block->size;
+
+			FreeBlocks();
+			first = CreateBlock(mergedSize);
+		}
+
+		current = first;
+		current->offset = 0;
+		allocatedSize = 0;
+	}
+
+	LinearArena::~LinearArena() {
+		FreeBlocks();
+	}
+
+	ScratchScope::ScratchScope() : arena(GetThreadScratchArena()), marker(arena->GetMarker()) { }
+
+	ScratchScope::~ScratchScope() {
+		arena->Rewind(marker);
+	}
+
+	WFE_NOINLINE LinearArena* GetThreadScratchArena() {
+		// Never inline this function, so that the thread local variables are read again after a fiber switch
+		return activeScratchArena ? activeScratchArena : &threadScratchArena;
+	}
+	WFE_NOINLINE LinearArena* SetThreadScratchArena(LinearArena* arena) {
+		LinearArena* previousArena = activeScratchArena;
+		activeScratchArena = arena;
+
+		return previousArena;
+	}
+}
\ No newline at end of file
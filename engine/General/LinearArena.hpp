@@ -0,0 +1,104 @@
+#pragma once
+
+#include <Core.hpp>
+
+namespace wfe {
+	/// @brief A linear allocator, which bumps an offset through chained memory blocks and frees everything at once on reset. Allocations can also be freed in stack order by rewinding to a marker. Blocks chained after overflowing the first one are merged into one on reset, so an arena that sees the same peak usage every frame stops allocating after the first frames.
+	class LinearArena {
+	public:
+		/// @brief The default size of the arena's first memory block.
+		static const size_t DEFAULT_BLOCK_SIZE = 64 << 10;
+
+		/// @brief A marker of the arena's state, which can be rewound to in order to free every allocation made after it.
+		struct Marker {
+			/// @brief The block that was in use.
+			void* block;
+			/// @brief The offset in the block that was in use.
+			size_t offset;
+			/// @brief The arena's allocated size.
+			size_t allocatedSize;
+		};
+
+		/// @brief Creates an empty linear arena. No memory is allocated until the first allocation.
+		/// @param blockSize The size of the arena's first memory block. Defaulted to DEFAULT_BLOCK_SIZE.
+		LinearArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+		LinearArena(const LinearArena&) = delete;
+		LinearArena(LinearArena&&) noexcept = delete;
+
+		LinearArena& operator=(const LinearArena&) = delete;
+		LinearArena& operator=(LinearArena&&) = delete;
+
+		/// @brief Gets the number of bytes allocated since the arena was last reset.
+		/// @return The arena's allocated size.
+		size_t GetAllocatedSize() const {
+			return allocatedSize;
+		}
+		/// @brief Gets the arena's current state, to later rewind to it.
+		/// @return The arena's marker.
+		Marker GetMarker() const {
+			return { current, current ? current->offset : 0, allocatedSize };
+		}
+
+		/// @brief Allocates memory from the arena, which stays valid until the arena is reset or rewound to an earlier marker.
+		/// @param size The size of the allocation.
+		/// @param alignment The alignment of the allocation, which must be a power of 2. Defaulted to 16.
+		/// @return A pointer to the allocated memory.
+		void* Allocate(size_t size, size_t alignment = 16);
+		/// @brief Frees every allocation made after the given marker was taken, keeping the arena's blocks.
+		/// @param marker A marker taken from this arena since its last reset.
+		void Rewind(const Marker& marker);
+		/// @brief Frees every allocation, merging the arena's blocks into one if more than one was needed.
+		void Reset();
+
+		/// @brief Destroys the linear arena, freeing its blocks.
+		~LinearArena();
+	private:
+		struct Block {
+			Block* next;
+			size_t size;
+			size_t offset;
+		};
+
+		Block* CreateBlock(size_t size);
+		void FreeBlocks();
+
+		size_t blockSize;
+		Block* first;
+		Block* current;
+		size_t allocatedSize;
+	};
+
+	/// @brief A scope of the calling thread's scratch arena, which frees every allocation made through it when destroyed. Scopes must be destroyed in the reverse order of their creation. A scope opened by a job may span a wait on the job system, as every job fiber has its own scratch arena that moves with it between threads.
+	class ScratchScope {
+	public:
+		/// @brief Opens a scope of the calling thread's current scratch arena.
+		ScratchScope();
+		ScratchScope(const ScratchScope&) = delete;
+		ScratchScope(ScratchScope&&) noexcept = delete;
+
+		ScratchScope& operator=(const ScratchScope&) = delete;
+		ScratchScope& operator=(ScratchScope&&) = delete;
+
+		/// @brief Allocates scratch memory, which stays valid until the scope is destroyed.
+		/// @param size The size of the allocation.
+		/// @param alignment The alignment of the allocation, which must be a power of 2. Defaulted to 16.
+		/// @return A pointer to the allocated memory.
+		void* Allocate(size_t size, size_t alignment = 16) {
+			return arena->Allocate(size, alignment);
+		}
+
+		/// @brief Closes the scope, freeing its allocations.
+		~ScratchScope();
+	private:
+		LinearArena* arena;
+		LinearArena::Marker marker;
+	};
+
+	/// @brief Gets the calling thread's current scratch arena, which is the arena of the job fiber the thread is running, if any, or the thread's own arena otherwise. Allocations made outside of a scratch scope live until the arena is reset, which the program does for its main and simulation threads at every frame and tick boundary and the job system does for its fibers after every job.
+	/// @return A pointer to the current scratch arena.
+	LinearArena* GetThreadScratchArena();
+	/// @brief Sets the calling thread's current scratch arena. Used by the job system to switch to a job fiber's arena while the thread runs the fiber.
+	/// @param arena The arena to use, or nullptr to use the thread's own arena.
+	/// @return The previously set arena, or nullptr if the thread's own arena was used.
+	LinearArena* SetThreadScratchArena(LinearArena* arena);
+}
\ No newline at end of file
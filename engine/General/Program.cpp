@@ -1,8 +1,34 @@
 #include "Program.hpp"
+#include "FixedTimestep.hpp"
+#include "HeapMemory.hpp"
+#include "JobBenchmark.hpp"
+#include "LinearArena.hpp"
 #include "ProjectInfo.hpp"
-#include <unistd.h>
+#include "SortBenchmark.hpp"
+#include "Math/MathBenchmark.hpp"
+#include "Platform/Clock.hpp"
+#include "Renderer/Culling/CullBenchmark.hpp"
+
+#include <string.h>
 
 namespace wfe {
+	// Constants
+	static const char_t BENCHMARK_CULL_ARGUMENT[] = "--benchmark-cull";
+	static const char_t BENCHMARK_JOBS_ARGUMENT[] = "--benchmark-jobs";
+	static const char_t BENCHMARK_MATH_ARGUMENT[] = "--benchmark-math";
+	static const char_t BENCHMARK_SORT_ARGUMENT[] = "--benchmark-sort";
+	static const uint64_t TICK_TIME = 1000000000 / Program::TICK_RATE;
+	static const float32_t TICK_DELTA_TIME = 1.f / (float32_t)Program::TICK_RATE;
+	static constexpr uint32_t SmearLowerBits(uint32_t value, uint32_t shift = 1) {
+		// Copy every set bit into all lower bits, turning the value into one less than the next power of two
+		return shift == 32 ? value : SmearLowerBits(value | (value >> shift), shift << 1);
+	}
+	static const uint32_t SNAPSHOT_INDEX_MASK = SmearLowerBits(Program::TICK_SNAPSHOT_COUNT - 1);
+	static const uint32_t SNAPSHOT_NEW_BIT = SNAPSHOT_INDEX_MASK + 1;
+	static_assert(Program::TICK_SNAPSHOT_COUNT && Program::TICK_SNAPSHOT_COUNT - 1 <= SNAPSHOT_INDEX_MASK && !(SNAPSHOT_INDEX_MASK & SNAPSHOT_NEW_BIT), "Every tick snapshot index must fit in the snapshot index mask, below the new snapshot bit!");
+	static const uint64_t HEAP_WARM_UP_FRAME_COUNT = 16;
+	static const uint64_t HEAP_WARM_UP_TICK_COUNT = 16;
+
 	// Window close callback
 	static void* WindowCloseEventCallback(void* args, void* userData) {
 		// Close the current program
@@ -12,11 +38,112 @@ namespace wfe {
 		return nullptr;
 	}
 
+	// Render event callback
+	static void* RenderEventCallback(void* args, void* userData) {
+		// Submit the rendered tick's frame packet to the renderer, blended with the tick before it, which copies its instances before the event returns, or their transforms while recording the frame if they're culled on the GPU
+		Program::RenderEventInfo* renderInfo = (Program::RenderEventInfo*)args;
+		Renderer* renderer = (Renderer*)userData;
+		renderer->SubmitFramePacket(renderInfo->framePacket, renderInfo->interpolationFactor);
+
+		return nullptr;
+	}
+
+	// Internal helper functions
+	void Program::SimulationThread(void* userData) {
+		Program* program = (Program*)userData;
+
+		// Join the job system as its reserved external worker, so that the ticks' parallel work is pushed to the thread's own deque and run by it while it waits
+		program->jobSystem->RegisterThread();
+
+		FixedTimestep timestep(TICK_TIME, MAX_CATCH_UP_TICK_COUNT);
+		uint64_t lastTime = program->startTime;
+		uint64_t tickIndex = 0;
+		uint64_t pausedTime = 0;
+		uint32_t backSnapshotIndex = 1;
+		uint64_t heapAllocationCount = GetThreadHeapAllocationCount();
+
+		while(program->running) {
+			// Pause while the program is idle. The paused time is left out of the timestep, so that resuming doesn't run every tick missed in the meantime
+			if(program->idle) {
+				uint64_t pauseTime = GetClockTime();
+				program->simulationSemaphore->Wait();
+				uint64_t pauseLength = GetClockTime() - pauseTime;
+
+				lastTime += pauseLength;
+				pausedTime += pauseLength;
+
+				continue;
+			}
+
+			// Run every tick that's due
+			uint64_t time = GetClockTime();
+			uint32_t tickCount = timestep.Advance(time - lastTime);
+			lastTime = time;
+
+			for(uint32_t i = 0; i != tickCount; ++i) {
+				++tickIndex;
+
+				// Run the tick, letting its listeners extract its render state to the back snapshot's packet
+				TickSnapshot& snapshot = program->tickSnapshots[backSnapshotIndex];
+				snapshot.framePacket->Reset();
+
+				TickEventInfo tickInfo { tickIndex, TICK_DELTA_TIME, snapshot.framePacket };
+				program->tickEvent.CallEvent(&tickInfo);
+
+				// Extract the world's renderable entities and the camera, as the tick's listeners left them, to the packet
+				if(program->sceneSystems)
+					program->sceneSystems->UpdateFramePacket(program->camera, snapshot.framePacket);
+
+				// Publish the tick by swapping the back snapshot with the shared one, which the main thread picks up without waiting. The tick's time is shifted by the paused and dropped time, so that it lines up with the clock
+				snapshot.tickIndex = tickIndex;
+				snapshot.tickTime = program->startTime + pausedTime + timestep.GetDroppedTime() + tickIndex * TICK_TIME;
+
+				backSnapshotIndex = program->sharedSnapshotIndex.exchange(backSnapshotIndex | SNAPSHOT_NEW_BIT) & SNAPSHOT_INDEX_MASK;
+
+				// Free the tick's scratch allocations
+				GetThreadScratchArena()->Reset();
+
+				// Hand the tick's heap allocations to the main thread, which reports them, as warmed up ticks should only allocate from the scratch arenas
+				uint64_t newHeapAllocationCount = GetThreadHeapAllocationCount();
+				if(tickIndex > HEAP_WARM_UP_TICK_COUNT)
+					program->tickHeapAllocationCount += newHeapAllocationCount - heapAllocationCount;
+				heapAllocationCount = newHeapAllocationCount;
+			}
+
+			// Sleep until the next tick is due if no tick was run
+			if(!tickCount)
+				Thread::SleepCurrentThread(TICK_TIME - timestep.GetAccumulatedTime());
+		}
+
+		program->jobSystem->UnregisterThread();
+	}
+
 	// Public functions
-	Program::Program(int32_t argc, char_t** args) : running(1), returnCode(0) {
+	Program::Program(int32_t argc, char_t** args) : running(1), returnCode(0), idle(0), redrawTime(UINT64_T_MAX), startTime(0), simulationThread(nullptr), simulationSemaphore(nullptr), tickSnapshots{}, sharedSnapshotIndex(TICK_SNAPSHOT_COUNT - 1), tickHeapAllocationCount(0) {
 		// Create the logger
 		logger = NewObject<Logger>("log.txt", false);
 
+		// Create the semaphore that resumes the simulation thread after idling
+		simulationSemaphore = NewObject<Semaphore>();
+
+		// Create a frame packet for every tick snapshot. The main thread is done reading its packet once the render event returns, as the render event's packet listener copies the packet's instances to the renderer's draw queue
+		for(TickSnapshot& snapshot : tickSnapshots)
+			snapshot.framePacket = NewObject<FramePacket>();
+
+		// Create the job system, which makes the main thread its first worker and reserves a worker for the simulation thread
+		jobSystem = NewObject<JobSystem>(0, 1);
+
+		// Run the job system's scaling benchmarks, the math library's benchmarks, the sort benchmark and the cull benchmark if they were requested
+		for(int32_t i = 1; i < argc; ++i)
+			if(!strcmp(args[i], BENCHMARK_JOBS_ARGUMENT))
+				RunJobScalingBenchmarks(logger, jobSystem->GetThreadCount());
+			else if(!strcmp(args[i], BENCHMARK_MATH_ARGUMENT))
+				RunMathBenchmarks(logger);
+			else if(!strcmp(args[i], BENCHMARK_SORT_ARGUMENT))
+				RunSortBenchmark(logger, jobSystem);
+			else if(!strcmp(args[i], BENCHMARK_CULL_ARGUMENT))
+				RunCullBenchmark(logger, jobSystem);
+
 		// Create the window
 		Window::WindowInfo windowInfo {
 			.name = WFE_PROJECT_NAME,
@@ -30,36 +157,161 @@ namespace wfe {
 		window = NewObject<Window>(windowInfo);
 
 		// Create the renderer
-		renderer = NewObject<Renderer>(window, true, logger);
+		renderer = NewObject<Renderer>(window, true, logger, jobSystem);
+
+		// Create the entity world and, if the renderer uses Vulkan, the scene systems that extract its renderable entities to every tick's frame packet
+		world = NewObject<EntityWorld>(jobSystem);
+		if(renderer->GetRendererBackendAPI() == Renderer::RENDERER_BACKEND_API_VULKAN) {
+			sceneSystems = NewObject<SceneSystems>(world);
+		} else {
+			sceneSystems = nullptr;
+		}
 
-		// Add the window close event callback
+		// Use an identity view projection until a tick listener sets the camera
+		camera.viewProjection = IDENTITY_MATRIX;
+		camera.position = { 0.f, 0.f, 0.f };
+
+		// Add the window close event callback and the render event callback, which submits every rendered frame's packet
 		window->GetCloseEvent().AddListener(Event::Listener(WindowCloseEventCallback, this));
+		renderEvent.AddListener(Event::Listener(RenderEventCallback, renderer));
+	}
+
+	void Program::SetIdle(bool8_t newIdle) {
+		// Exit the function if the idle mode doesn't change
+		if(idle.exchange(newIdle) == (int32_t)newIdle)
+			return;
+
+		// Resume the simulation thread when leaving idle mode, and wake the main thread from the window's event wait either way
+		if(!newIdle)
+			simulationSemaphore->Signal();
+		window->Wake();
+	}
+	void Program::RequestRedraw(uint64_t delay) {
+		// Lower the redraw time to the requested time, keeping any earlier pending request
+		uint64_t time = GetClockTime() + delay;
+		uint64_t nextRedrawTime = redrawTime;
+
+		while(time < nextRedrawTime) {
+			if(redrawTime.compare_exchange_strong(nextRedrawTime, time)) {
+				// Wake the main thread, so that it waits for the new redraw time instead
+				window->Wake();
+				break;
+			}
+		}
 	}
 
 	int32_t Program::Run() {
-		// Keep the update loop running until the running bool is reset
+		// Start the simulation thread, which runs the ticks independently of the frame rate
+		startTime = GetClockTime();
+		for(TickSnapshot& snapshot : tickSnapshots) {
+			snapshot.tickIndex = 0;
+			snapshot.tickTime = startTime;
+			snapshot.framePacket->Reset();
+		}
+
+		simulationThread = NewObject<Thread>(SimulationThread, this);
+
+		uint64_t lastFrameTime = startTime;
+		uint64_t frameIndex = 0;
+		uint64_t heapAllocationCount = GetThreadHeapAllocationCount();
+		uint32_t frontSnapshotIndex = 0;
+
+		// Keep the render loop running until the running bool is reset
 		while(running) {
-			// Poll the window's events
-			window->PollEvents();
+			if(idle) {
+				// Sleep in the window's event wait until the window receives an event or the next requested redraw is due
+				uint64_t time = GetClockTime();
+				uint64_t nextRedrawTime = redrawTime;
+				bool8_t eventsReceived = false;
 
-			sleep(0);
+				if(nextRedrawTime > time)
+					eventsReceived = window->WaitEvents(nextRedrawTime == UINT64_T_MAX ? UINT64_T_MAX : nextRedrawTime - time);
+				else
+					window->PollEvents();
+
+				// Go back to waiting if the wait was only woken to pick up a new redraw time
+				if(!eventsReceived && idle && redrawTime > GetClockTime())
+					continue;
+			} else {
+				// Poll the window's events
+				window->PollEvents();
+			}
+
+			// Pick up the last tick published by the simulation thread, if a new one was published
+			if(sharedSnapshotIndex & SNAPSHOT_NEW_BIT)
+				frontSnapshotIndex = sharedSnapshotIndex.exchange(frontSnapshotIndex) & SNAPSHOT_INDEX_MASK;
+			const TickSnapshot& snapshot = tickSnapshots[frontSnapshotIndex];
+
+			// Render one tick behind the clock, so that the rendered time is always between two finished ticks
+			uint64_t time = GetClockTime();
+
+			// Consume the pending redraw request if it's due, as this frame fulfills it
+			uint64_t nextRedrawTime = redrawTime;
+			if(nextRedrawTime <= time)
+				redrawTime.compare_exchange_strong(nextRedrawTime, UINT64_T_MAX);
+
+			float32_t interpolationFactor = 1.f;
+			if(time < snapshot.tickTime + TICK_TIME)
+				interpolationFactor = time > snapshot.tickTime ? (float32_t)(time - snapshot.tickTime) / (float32_t)TICK_TIME : 0.f;
+
+			// Call the render event, whose packet listener submits the tick's frame packet to the renderer
+			RenderEventInfo renderInfo { frameIndex, (float32_t)(time - lastFrameTime) * 1e-9f, snapshot.tickIndex, interpolationFactor, snapshot.framePacket };
+			renderEvent.CallEvent(&renderInfo);
+
+			// Render the frame with the tick's camera, blended with the camera of the tick before it
+			renderer->RenderFrame(snapshot.framePacket->GetInterpolatedCamera(interpolationFactor).viewProjection);
+
+			// Free the frame's scratch allocations. Once the arenas reached their peak usage, frames shouldn't touch the heap anymore
+			GetThreadScratchArena()->Reset();
+
+			uint64_t newHeapAllocationCount = GetThreadHeapAllocationCount();
+			if(newHeapAllocationCount != heapAllocationCount && frameIndex >= HEAP_WARM_UP_FRAME_COUNT)
+				logger->LogWarningMessage("Frame %llu made %llu heap allocations after warming up.", (unsigned long long)frameIndex, (unsigned long long)(newHeapAllocationCount - heapAllocationCount));
+			heapAllocationCount = newHeapAllocationCount;
+
+			uint64_t tickAllocationCount = tickHeapAllocationCount.exchange(0);
+			if(tickAllocationCount)
+				logger->LogWarningMessage("Simulation ticks made %llu heap allocations after warming up.", (unsigned long long)tickAllocationCount);
+
+			lastFrameTime = time;
+			++frameIndex;
+
+			// Yield the rest of the thread's time slice while rendering continuously
+			if(!idle)
+				Thread::YieldCurrentThread();
 		}
 
+		// Resume the simulation thread if it's paused and wait for it to finish its current tick
+		simulationSemaphore->Signal();
+		DestroyObject(simulationThread);
+		simulationThread = nullptr;
+
 		return returnCode;
 	}
 	void Program::Close(int32_t returnCode) {
 		// Set the running bool and the return code
 		running = 0;
 		returnCode = 0;
+
+		// Wake the main thread if it's waiting for window events
+		window->Wake();
 	}
 
 	Program::~Program() {
-		// Remove the window close event callback
+		// Remove the window close and render event callbacks
 		window->GetCloseEvent().RemoveListener(Event::Listener(WindowCloseEventCallback, this));
+		renderEvent.RemoveListener(Event::Listener(RenderEventCallback, renderer));
 
 		// Destroy all child objects
+		if(sceneSystems)
+			DestroyObject(sceneSystems);
+		DestroyObject(world);
 		DestroyObject(renderer);
 		DestroyObject(window);
+		DestroyObject(jobSystem);
+		for(TickSnapshot& snapshot : tickSnapshots)
+			DestroyObject(snapshot.framePacket);
+		DestroyObject(simulationSemaphore);
 		DestroyObject(logger);
 	}
 }
\ No newline at end of file
@@ -1,14 +1,50 @@
 #pragma once
 
+#include "JobSystem.hpp"
+#include "Platform/Semaphore.hpp"
+#include "Platform/Thread.hpp"
 #include "Platform/Window.hpp"
+#include "Renderer/FramePacket.hpp"
 #include "Renderer/Renderer.hpp"
+#include "Scene/EntityWorld.hpp"
+#include "Scene/SceneSystems.hpp"
 
 #include <Core.hpp>
 
 namespace wfe {
-	/// @brief A class containing an abstraction for the program and its components.
+	/// @brief A class containing an abstraction for the program and its components. The simulation runs at a fixed tick rate on its own thread, while the main thread renders as fast as it can, interpolating between the last two finished ticks. Every tick builds a frame packet with its render state, which is handed to the main thread along with the tick, so that rendering never reads live game state. In idle mode, the simulation is paused and the main thread sleeps in the window's event wait, only rendering after window events or requested redraws.
 	class Program {
 	public:
+		/// @brief The number of simulation ticks per second.
+		static const uint32_t TICK_RATE = 60;
+		/// @brief The maximum number of ticks the simulation runs to catch up at once. Time that would require more ticks is dropped, slowing the simulation down instead of letting it fall further and further behind.
+		static const uint32_t MAX_CATCH_UP_TICK_COUNT = 8;
+		/// @brief The number of tick snapshots, each with its own frame packet: the simulation thread builds one, one waits in the shared slot and the main thread renders one. The main thread never holds on to a packet past the frame it renders, as the renderer copies the packet's instances during the render event and, for GPU culled frames, its transforms while recording the frame, so no more snapshots are needed regardless of the renderer's frames in flight.
+		static const uint32_t TICK_SNAPSHOT_COUNT = 3;
+
+		/// @brief A struct containing the info packed with tick events.
+		struct TickEventInfo {
+			/// @brief The index of the tick, starting from 1.
+			uint64_t tickIndex;
+			/// @brief The fixed time simulated by the tick, in seconds.
+			float32_t deltaTime;
+			/// @brief The empty frame packet the tick's render state is extracted to. Once the tick's listeners return, the scene systems extract the world's renderable entities and the camera to it, after which it's published to the main thread.
+			FramePacket* framePacket;
+		};
+		/// @brief A struct containing the info packed with render events.
+		struct RenderEventInfo {
+			/// @brief The index of the rendered frame, starting from 0.
+			uint64_t frameIndex;
+			/// @brief The time elapsed since the previous frame, in seconds.
+			float32_t deltaTime;
+			/// @brief The index of the last finished tick, or 0 if no tick finished yet.
+			uint64_t tickIndex;
+			/// @brief The factor to interpolate between the states of the tick before the last finished tick and the last finished tick with, in the [0, 1] range. The factor stays at 1 while the simulation is behind, holding the last finished tick's state.
+			float32_t interpolationFactor;
+			/// @brief The frame packet built by the last finished tick, which stays unchanged until the render event returns.
+			const FramePacket* framePacket;
+		};
+
 		/// @brief Creates the program and its components.
 		/// @param argc The number for console arguments given. Defaulted to 0.
 		/// @param args The console arguments given, or nullpre if none are present.
@@ -19,7 +55,57 @@ namespace wfe {
 		Program& operator=(const Program&) = delete;
 		Program& operator=(Program&&) = delete;
 
-		/// @brief Runs the program.
+		/// @brief Gets the program's job system.
+		/// @return A pointer to the job system.
+		JobSystem* GetJobSystem() {
+			return jobSystem;
+		}
+
+		/// @brief Gets the program's entity world, whose renderable entities are extracted to every tick's frame packet. Must only be accessed from tick listeners, as it belongs to the simulation thread.
+		/// @return A pointer to the entity world.
+		EntityWorld* GetWorld() {
+			return world;
+		}
+		/// @brief Gets the program's scene systems, which run on the world's entities at the end of every tick. Must only be accessed from tick listeners.
+		/// @return A pointer to the scene systems, or nullptr if the renderer's backend doesn't support them.
+		SceneSystems* GetSceneSystems() {
+			return sceneSystems;
+		}
+		/// @brief Gets the camera the world's entities are culled and sorted for. Must only be accessed from tick listeners.
+		/// @return A const reference to the camera struct.
+		const FramePacket::Camera& GetCamera() const {
+			return camera;
+		}
+		/// @brief Sets the camera the world's entities are culled and sorted for, starting with the current tick. Must only be called from tick listeners.
+		/// @param newCamera The new camera.
+		void SetCamera(const FramePacket::Camera& newCamera) {
+			camera = newCamera;
+		}
+
+		/// @brief Gets the tick event, which is called on the simulation thread for every fixed timestep tick.
+		/// @return A reference to the tick event.
+		Event& GetTickEvent() {
+			return tickEvent;
+		}
+		/// @brief Gets the render event, which is called on the main thread for every rendered frame.
+		/// @return A reference to the render event.
+		Event& GetRenderEvent() {
+			return renderEvent;
+		}
+
+		/// @brief Checks if the program is in idle mode.
+		/// @return True if the program is idle, otherwise false.
+		bool8_t IsIdle() const {
+			return idle;
+		}
+		/// @brief Sets whether the program is in idle mode. An idle program pauses its simulation and renders only when the window receives events or a redraw is requested, instead of continuously.
+		/// @param newIdle True to enter idle mode, or false to resume continuous rendering.
+		void SetIdle(bool8_t newIdle);
+		/// @brief Requests a frame to be rendered while the program is idle. Safe to call from any thread.
+		/// @param delay The time to wait before rendering the frame, in nanoseconds. Requests with a later time than an already pending request are merged into it. Defaulted to 0.
+		void RequestRedraw(uint64_t delay = 0);
+
+		/// @brief Runs the program, starting the simulation thread and rendering on the calling thread until the program is closed.
 		/// @return The program's return code.
 		int32_t Run();
 		/// @brief Closes the program, causing it to stop running after the current update loop.
@@ -29,11 +115,35 @@ namespace wfe {
 		/// @brief Destroys the program and its components.
 		~Program();
 	private:
+		struct TickSnapshot {
+			uint64_t tickIndex;
+			uint64_t tickTime;
+			FramePacket* framePacket;
+		};
+
+		static void SimulationThread(void* userData);
+
 		atomic_int32_t running;
 		atomic_int32_t returnCode;
+		atomic_int32_t idle;
+		atomic_uint64_t redrawTime;
+
+		Event tickEvent;
+		Event renderEvent;
+
+		uint64_t startTime;
+		Thread* simulationThread;
+		Semaphore* simulationSemaphore;
+		TickSnapshot tickSnapshots[TICK_SNAPSHOT_COUNT];
+		atomic_uint32_t sharedSnapshotIndex;
+		atomic_uint64_t tickHeapAllocationCount;
 
 		Logger* logger;
+		JobSystem* jobSystem;
 		Window* window;
 		Renderer* renderer;
+		EntityWorld* world;
+		SceneSystems* sceneSystems;
+		FramePacket::Camera camera;
 	};
 }
\ No newline at end of file
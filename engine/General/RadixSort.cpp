@@ -0,0 +1,186 @@
+#include "RadixSort.hpp"
+#include "LinearArena.hpp"
+
+namespace wfe {
+	// Constants
+	static const uint32_t DIGIT_BITS = 8;
+	static const size_t DIGIT_COUNT = 1 << DIGIT_BITS;
+	static const uint32_t PASS_COUNT = 64 / DIGIT_BITS;
+	static const size_t MIN_KEYS_PER_CHUNK = 1 << 15;
+
+	// Internal structs
+	typedef size_t RadixHistogram[PASS_COUNT][DIGIT_COUNT];
+
+	struct RadixSortContext {
+		size_t count;
+		uint64_t* keys[2];
+		uint32_t* values[2];
+		JobSystem* jobSystem;
+		size_t chunkCount;
+		RadixHistogram* histograms;
+
+		uint32_t pass;
+		uint32_t source;
+	};
+
+	// Internal helper functions
+	static void RunSortChunks(RadixSortContext* context, JobSystem::ParallelForFunction function) {
+		// Run the function on every chunk, in parallel if a job system is given
+		if(context->jobSystem) {
+			context->jobSystem->ParallelFor(context->chunkCount, 1, function, context);
+		} else {
+			function(context, 0, context->chunkCount);
+		}
+	}
+	static void CountChunkDigits(void* userData, size_t beginChunk, size_t endChunk) {
+		RadixSortContext* context = (RadixSortContext*)userData;
+
+		for(size_t chunk = beginChunk; chunk != endChunk; ++chunk) {
+			// Count every digit of the chunk's keys in a single read
+			size_t begin = context->count * chunk / context->chunkCount;
+			size_t end = context->count * (chunk + 1) / context->chunkCount;
+
+			RadixHistogram& histogram = context->histograms[chunk];
+			memset(histogram, 0, sizeof(RadixHistogram));
+
+			for(size_t i = begin; i != end; ++i) {
+				uint64_t key = context->keys[0][i];
+				for(uint32_t pass = 0; pass != PASS_COUNT; ++pass)
+					++histogram[pass][(key >> (pass * DIGIT_BITS)) & (DIGIT_COUNT - 1)];
+			}
+		}
+	}
+	static void RecountChunkPassDigits(void* userData, size_t beginChunk, size_t endChunk) {
+		RadixSortContext* context = (RadixSortContext*)userData;
+		uint32_t shift = context->pass * DIGIT_BITS;
+		const uint64_t* srcKeys = context->keys[context->source];
+
+		for(size_t chunk = beginChunk; chunk != endChunk; ++chunk) {
+			// Recount the pass's digits, as the previous pass moved keys between the chunks
+			size_t begin = context->count * chunk / context->chunkCount;
+			size_t end = context->count * (chunk + 1) / context->chunkCount;
+
+			size_t* passHistogram = context->histograms[chunk][context->pass];
+			memset(passHistogram, 0, DIGIT_COUNT * sizeof(size_t));
+
+			for(size_t i = begin; i != end; ++i)
+				++passHistogram[(srcKeys[i] >> shift) & (DIGIT_COUNT - 1)];
+		}
+	}
+	static void ScatterChunkKeys(void* userData, size_t beginChunk, size_t endChunk) {
+		RadixSortContext* context = (RadixSortContext*)userData;
+		uint32_t pass = context->pass;
+		uint32_t shift = pass * DIGIT_BITS;
+		const uint64_t* srcKeys = context->keys[context->source];
+		const uint32_t* srcValues = context->values[context->source];
+		uint64_t* dstKeys = context->keys[context->source ^ 1];
+		uint32_t* dstValues = context->values[context->source ^ 1];
+
+		for(size_t chunk = beginChunk; chunk != endChunk; ++chunk) {
+			size_t begin = context->count * chunk / context->chunkCount;
+			size_t end = context->count * (chunk + 1) / context->chunkCount;
+
+			// Get the chunk's output offset for every digit, placing its keys after the same digit's keys from previous chunks
+			size_t offsets[DIGIT_COUNT];
+			size_t digitOffset = 0;
+
+			for(size_t digit = 0; digit != DIGIT_COUNT; ++digit) {
+				offsets[digit] = digitOffset;
+				for(size_t i = 0; i != context->chunkCount; ++i) {
+					if(i < chunk)
+						offsets[digit] += context->histograms[i][pass][digit];
+					digitOffset += context->histograms[i][pass][digit];
+				}
+			}
+
+			// Scatter the chunk's keys and values to their sorted positions
+			for(size_t i = begin; i != end; ++i) {
+				uint64_t key = srcKeys[i];
+				size_t dstIndex = offsets[(key >> shift) & (DIGIT_COUNT - 1)]++;
+
+				dstKeys[dstIndex] = key;
+				dstValues[dstIndex] = srcValues[i];
+			}
+		}
+	}
+	static void CopyBackChunkKeys(void* userData, size_t beginChunk, size_t endChunk) {
+		RadixSortContext* context = (RadixSortContext*)userData;
+
+		// Copy the chunks' ranges from the temporary arrays back to the given arrays
+		size_t begin = context->count * beginChunk / context->chunkCount;
+		size_t end = context->count * endChunk / context->chunkCount;
+
+		memcpy(context->keys[0] + begin, context->keys[1] + begin, (end - begin) * sizeof(uint64_t));
+		memcpy(context->values[0] + begin, context->values[1] + begin, (end - begin) * sizeof(uint32_t));
+	}
+
+	// Public functions
+	void RadixSort(size_t count, uint64_t* keys, uint32_t* values, uint64_t* tempKeys, uint32_t* tempValues, JobSystem* jobSystem) {
+		// Exit the function if there's nothing to sort
+		if(count < 2)
+			return;
+
+		// Only split the arrays into as many chunks as it takes for the per-chunk work to outweigh the synchronization
+		size_t chunkCount = jobSystem ? jobSystem->GetThreadCount() : 1;
+		size_t maxChunkCount = count / MIN_KEYS_PER_CHUNK;
+		if(chunkCount > maxChunkCount)
+			chunkCount = maxChunkCount ? maxChunkCount : 1;
+
+		// Set the sort's context
+		RadixSortContext context;
+		context.count = count;
+		context.keys[0] = keys;
+		context.keys[1] = tempKeys;
+		context.values[0] = values;
+		context.values[1] = tempValues;
+		context.jobSystem = chunkCount > 1 ? jobSystem : nullptr;
+		context.chunkCount = chunkCount;
+		context.pass = 0;
+		context.source = 0;
+
+		// Allocate the histograms in scratch memory, so that sorting every frame doesn't reach the heap once the scratch arena is warm
+		ScratchScope scratch;
+		context.histograms = (RadixHistogram*)scratch.Allocate(chunkCount * sizeof(RadixHistogram), alignof(RadixHistogram));
+
+		// Count every digit of every chunk
+		RunSortChunks(&context, CountChunkDigits);
+
+		// Skip the passes whose digit is the same for every key, as they wouldn't change the order
+		bool8_t passEnabled[PASS_COUNT];
+		for(uint32_t pass = 0; pass != PASS_COUNT; ++pass) {
+			passEnabled[pass] = true;
+			for(size_t digit = 0; digit != DIGIT_COUNT; ++digit) {
+				size_t digitCount = 0;
+				for(size_t i = 0; i != chunkCount; ++i)
+					digitCount += context.histograms[i][pass][digit];
+
+				if(digitCount) {
+					passEnabled[pass] = digitCount != count;
+					break;
+				}
+			}
+		}
+
+		// Run every enabled pass, ping-ponging between the given and temporary arrays
+		bool8_t firstPass = true;
+
+		for(uint32_t pass = 0; pass != PASS_COUNT; ++pass) {
+			if(!passEnabled[pass])
+				continue;
+
+			context.pass = pass;
+
+			// Recount the pass's digits if multiple chunks are used, as the previous pass moved keys between them; the first pass can use the initial counts
+			if(!firstPass && chunkCount > 1)
+				RunSortChunks(&context, RecountChunkPassDigits);
+			firstPass = false;
+
+			RunSortChunks(&context, ScatterChunkKeys);
+			context.source ^= 1;
+		}
+
+		// Copy the result back to the given arrays if it ended up in the temporary arrays
+		if(context.source)
+			RunSortChunks(&context, CopyBackChunkKeys);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "JobSystem.hpp"
+
+#include <Core.hpp>
+
+namespace wfe {
+	/// @brief Sorts the given 64-bit keys and their values in ascending key order using a stable LSD radix sort with 8-bit digits. Passes over digits shared by every key are skipped, so keys with unused high bits sort faster.
+	/// @param count The number of keys to sort.
+	/// @param keys A pointer to the array of keys to sort, which will contain the sorted keys.
+	/// @param values A pointer to the array of values moved along with their keys, which will contain the sorted values.
+	/// @param tempKeys A pointer to a temporary key array at least as large as the key array.
+	/// @param tempValues A pointer to a temporary value array at least as large as the value array.
+	/// @param jobSystem The job system to split the sort's passes between, or nullptr to sort on the calling thread. Small arrays are always sorted on the calling thread.
+	void RadixSort(size_t count, uint64_t* keys, uint32_t* values, uint64_t* tempKeys, uint32_t* tempValues, JobSystem* jobSystem = nullptr);
+}
\ No newline at end of file
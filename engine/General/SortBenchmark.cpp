@@ -0,0 +1,94 @@
+#include "SortBenchmark.hpp"
+#include "RadixSort.hpp"
+#include "Platform/Clock.hpp"
+
+namespace wfe {
+	// Constants
+	static const size_t SORT_KEY_COUNT = 1 << 20;
+	static const uint32_t RUN_COUNT = 5;
+
+	// Internal structs
+	struct SortData {
+		vector<uint64_t> sourceKeys;
+		vector<uint64_t> keys;
+		vector<uint32_t> values;
+		vector<uint64_t> tempKeys;
+		vector<uint32_t> tempValues;
+	};
+
+	// Internal helper functions
+	static uint32_t NextRandom(uint32_t& state) {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+	static uint64_t TimeSort(SortData& data, JobSystem* jobSystem) {
+		// Time the fastest of multiple runs, to filter out the noise of other processes
+		uint64_t bestTime = UINT64_T_MAX;
+
+		for(uint32_t run = 0; run != RUN_COUNT; ++run) {
+			// Reset the keys and values outside of the timed section
+			memcpy(data.keys.data(), data.sourceKeys.data(), SORT_KEY_COUNT * sizeof(uint64_t));
+			for(size_t i = 0; i != SORT_KEY_COUNT; ++i)
+				data.values[i] = (uint32_t)i;
+
+			uint64_t startTime = GetClockTime();
+			RadixSort(SORT_KEY_COUNT, data.keys.data(), data.values.data(), data.tempKeys.data(), data.tempValues.data(), jobSystem);
+			uint64_t time = GetClockTime() - startTime;
+
+			if(time < bestTime)
+				bestTime = time;
+		}
+
+		return bestTime;
+	}
+	static bool8_t CheckSort(const SortData& data) {
+		// Every key must be ordered, carry its own value and keep the order of equal keys, as the sort is stable
+		for(size_t i = 0; i != SORT_KEY_COUNT; ++i) {
+			uint32_t value = data.values[i];
+			if(data.sourceKeys[value] != data.keys[i])
+				return false;
+
+			if(i && (data.keys[i - 1] > data.keys[i] || (data.keys[i - 1] == data.keys[i] && data.values[i - 1] > value)))
+				return false;
+		}
+
+		return true;
+	}
+
+	// Public functions
+	bool8_t RunSortBenchmark(Logger* logger, JobSystem* jobSystem) {
+		PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
+
+		// Generate the random keys, whose high bits are all used so that no pass is skipped
+		SortData data;
+		uint32_t randomState = 0x2545f491;
+
+		data.sourceKeys.resize(SORT_KEY_COUNT);
+		data.keys.resize(SORT_KEY_COUNT);
+		data.values.resize(SORT_KEY_COUNT);
+		data.tempKeys.resize(SORT_KEY_COUNT);
+		data.tempValues.resize(SORT_KEY_COUNT);
+		for(size_t i = 0; i != SORT_KEY_COUNT; ++i)
+			data.sourceKeys[i] = ((uint64_t)NextRandom(randomState) << 32) | NextRandom(randomState);
+
+		// Sort on the calling thread, then on every thread of the job system, checking the last run of each
+		uint64_t singleTime = TimeSort(data, nullptr);
+		bool8_t singleSorted = CheckSort(data);
+
+		uint64_t multiTime = TimeSort(data, jobSystem);
+		bool8_t multiSorted = CheckSort(data);
+
+		uint64_t speedup = multiTime ? singleTime * 100 / multiTime : 0;
+		logger->LogInfoMessage("Sort benchmark: 1 thread sorted %llu keys in %llu us.", (unsigned long long)SORT_KEY_COUNT, (unsigned long long)(singleTime / 1000));
+		logger->LogInfoMessage("Sort benchmark: %u threads sorted %llu keys in %llu us, %llu.%02llux speedup.", jobSystem->GetThreadCount(), (unsigned long long)SORT_KEY_COUNT, (unsigned long long)(multiTime / 1000), (unsigned long long)(speedup / 100), (unsigned long long)(speedup % 100));
+
+		if(!singleSorted || !multiSorted)
+			logger->LogErrorMessage("Sort benchmark: the %s sort's output is out of order!", singleSorted ? "multithreaded" : "single threaded");
+
+		PopMemoryUsageType();
+
+		return singleSorted && multiSorted;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "JobSystem.hpp"
+
+#include <Core.hpp>
+
+namespace wfe {
+	/// @brief Runs the radix sort benchmark, which sorts 1M random 64-bit keys on the calling thread and on every thread of the given job system, logging both times, the multithreaded speedup and whether both sorts match.
+	/// @param logger The logger to write the results to.
+	/// @param jobSystem The job system the multithreaded sort splits its passes between.
+	/// @return True if both sorts ordered the keys correctly, otherwise false.
+	bool8_t RunSortBenchmark(Logger* logger, JobSystem* jobSystem);
+}
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include "MathBatch.hpp"
+
+namespace wfe {
+	// Internal structs
+	typedef void(*TransformPointsKernel)(const Matrix4& matrix, size_t count, const Vector3* points, Vector3* results);
+	typedef void(*MultiplyMatricesKernel)(size_t count, const Matrix4* lhs, const Matrix4* rhs, Matrix4* results);
+
+	// Internal helper functions
+	static void TransformPointsScalar(const Matrix4& matrix, size_t count, const Vector3* points, Vector3* results) {
+		for(size_t i = 0; i != count; ++i)
+			results[i] = TransformPoint(matrix, points[i]);
+	}
+	static void MultiplyMatricesScalar(size_t count, const Matrix4* lhs, const Matrix4* rhs, Matrix4* results) {
+		for(size_t i = 0; i != count; ++i)
+			results[i] = lhs[i] * rhs[i];
+	}
+#if defined(WFE_ARCH_X86)
+	static void TransformPointsSse2(const Matrix4& matrix, size_t count, const Vector3* points, Vector3* results) {
+		__m128 column0 = _mm_loadu_ps(&matrix.columns[0].x);
+		__m128 column1 = _mm_loadu_ps(&matrix.columns[1].x);
+		__m128 column2 = _mm_loadu_ps(&matrix.columns[2].x);
+		__m128 column3 = _mm_loadu_ps(&matrix.columns[3].x);
+
+		// Every point fills a register thanks to its padding; broadcast its components and sum the scaled columns
+		for(size_t i = 0; i != count; ++i) {
+			__m128 point = _mm_loadu_ps(&points[i].x);
+			__m128 x = _mm_shuffle_ps(point, point, _MM_SHUFFLE(0, 0, 0, 0));
+			__m128 y = _mm_shuffle_ps(point, point, _MM_SHUFFLE(1, 1, 1, 1));
+			__m128 z = _mm_shuffle_ps(point, point, _MM_SHUFFLE(2, 2, 2, 2));
+
+			__m128 result = _mm_add_ps(_mm_add_ps(_mm_mul_ps(column0, x), _mm_mul_ps(column1, y)), _mm_add_ps(_mm_mul_ps(column2, z), column3));
+			_mm_storeu_ps(&results[i].x, result);
+		}
+	}
+	static void MultiplyMatricesSse2(size_t count, const Matrix4* lhs, const Matrix4* rhs, Matrix4* results) {
+		for(size_t i = 0; i != count; ++i) {
+			// Load both matrices before storing any column, so that the results may overwrite either input
+			__m128 lhsColumns[4];
+			__m128 rhsColumns[4];
+			for(size_t j = 0; j != 4; ++j) {
+				lhsColumns[j] = _mm_loadu_ps(&lhs[i].columns[j].x);
+				rhsColumns[j] = _mm_loadu_ps(&rhs[i].columns[j].x);
+			}
+
+			for(size_t j = 0; j != 4; ++j) {
+				__m128 column = rhsColumns[j];
+				__m128 x = _mm_shuffle_ps(column, column, _MM_SHUFFLE(0, 0, 0, 0));
+				__m128 y = _mm_shuffle_ps(column, column, _MM_SHUFFLE(1, 1, 1, 1));
+				__m128 z = _mm_shuffle_ps(column, column, _MM_SHUFFLE(2, 2, 2, 2));
+				__m128 w = _mm_shuffle_ps(column, column, _MM_SHUFFLE(3, 3, 3, 3));
+
+				__m128 result = _mm_add_ps(_mm_add_ps(_mm_mul_ps(lhsColumns[0], x), _mm_mul_ps(lhsColumns[1], y)), _mm_add_ps(_mm_mul_ps(lhsColumns[2], z), _mm_mul_ps(lhsColumns[3], w)));
+				_mm_storeu_ps(&results[i].columns[j].x, result);
+			}
+		}
+	}
+	WFE_TARGET("avx2") static void TransformPointsAvx2(const Matrix4& matrix, size_t count, const Vector3* points, Vector3* results) {
+		// Repeat every column in both 128-bit lanes, so that each lane transforms its own point
+		__m256 column0 = _mm256_broadcast_ps((const __m128*)&matrix.columns[0]);
+		__m256 column1 = _mm256_broadcast_ps((const __m128*)&matrix.columns[1]);
+		__m256 column2 = _mm256_broadcast_ps((const __m128*)&matrix.columns[2]);
+		__m256 column3 = _mm256_broadcast_ps((const __m128*)&matrix.columns[3]);
+
+		// Transform 4 points per iteration, as two independent pairs
+		size_t i = 0;
+		for(; i + 4 <= count; i += 4) {
+			__m256 points0 = _mm256_loadu_ps(&points[i].x);
+			__m256 points1 = _mm256_loadu_ps(&points[i + 2].x);
+
+			__m256 result0 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(column0, _mm256_permute_ps(points0, _MM_SHUFFLE(0, 0, 0, 0))), _mm256_mul_ps(column1, _mm256_permute_ps(points0, _MM_SHUFFLE(1, 1, 1, 1)))), _mm256_add_ps(_mm256_mul_ps(column2, _mm256_permute_ps(points0, _MM_SHUFFLE(2, 2, 2, 2))), column3));
+			__m256 result1 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(column0, _mm256_permute_ps(points1, _MM_SHUFFLE(0, 0, 0, 0))), _mm256_mul_ps(column1, _mm256_permute_ps(points1, _MM_SHUFFLE(1, 1, 1, 1)))), _mm256_add_ps(_mm256_mul_ps(column2, _mm256_permute_ps(points1, _MM_SHUFFLE(2, 2, 2, 2))), column3));
+
+			_mm256_storeu_ps(&results[i].x, result0);
+			_mm256_storeu_ps(&results[i + 2].x, result1);
+		}
+
+		// Transform the remaining points one at a time
+		TransformPointsScalar(matrix, count - i, points + i, results + i);
+	}
+	WFE_TARGET("avx2") static void MultiplyMatricesAvx2(size_t count, const Matrix4* lhs, const Matrix4* rhs, Matrix4* results) {
+		for(size_t i = 0; i != count; ++i) {
+			// Repeat every left hand side column in both lanes and compute two result columns per register
+			__m256 lhsColumn0 = _mm256_broadcast_ps((const __m128*)&lhs[i].columns[0]);
+			__m256 lhsColumn1 = _mm256_broadcast_ps((const __m128*)&lhs[i].columns[1]);
+			__m256 lhsColumn2 = _mm256_broadcast_ps((const __m128*)&lhs[i].columns[2]);
+			__m256 lhsColumn3 = _mm256_broadcast_ps((const __m128*)&lhs[i].columns[3]);
+
+			__m256 rhsColumns01 = _mm256_loadu_ps(&rhs[i].columns[0].x);
+			__m256 rhsColumns23 = _mm256_loadu_ps(&rhs[i].columns[2].x);
+
+			__m256 result01 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(lhsColumn0, _mm256_permute_ps(rhsColumns01, _MM_SHUFFLE(0, 0, 0, 0))), _mm256_mul_ps(lhsColumn1, _mm256_permute_ps(rhsColumns01, _MM_SHUFFLE(1, 1, 1, 1)))), _mm256_add_ps(_mm256_mul_ps(lhsColumn2, _mm256_permute_ps(rhsColumns01, _MM_SHUFFLE(2, 2, 2, 2))), _mm256_mul_ps(lhsColumn3, _mm256_permute_ps(rhsColumns01, _MM_SHUFFLE(3, 3, 3, 3)))));
+			__m256 result23 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(lhsColumn0, _mm256_permute_ps(rhsColumns23, _MM_SHUFFLE(0, 0, 0, 0))), _mm256_mul_ps(lhsColumn1, _mm256_permute_ps(rhsColumns23, _MM_SHUFFLE(1, 1, 1, 1)))), _mm256_add_ps(_mm256_mul_ps(lhsColumn2, _mm256_permute_ps(rhsColumns23, _MM_SHUFFLE(2, 2, 2, 2))), _mm256_mul_ps(lhsColumn3, _mm256_permute_ps(rhsColumns23, _MM_SHUFFLE(3, 3, 3, 3)))));
+
+			_mm256_storeu_ps(&results[i].columns[0].x, result01);
+			_mm256_storeu_ps(&results[i].columns[2].x, result23);
+		}
+	}
+#elif defined(WFE_ARCH_ARM64)
+	static void TransformPointsNeon(const Matrix4& matrix, size_t count, const Vector3* points, Vector3* results) {
+		float32x4_t column0 = vld1q_f32(&matrix.columns[0].x);
+		float32x4_t column1 = vld1q_f32(&matrix.columns[1].x);
+		float32x4_t column2 = vld1q_f32(&matrix.columns[2].x);
+		float32x4_t column3 = vld1q_f32(&matrix.columns[3].x);
+
+		// Every point fills a register thanks to its padding; accumulate the columns scaled by its lanes
+		for(size_t i = 0; i != count; ++i) {
+			float32x4_t point = vld1q_f32(&points[i].x);
+
+			float32x4_t result = vmlaq_laneq_f32(column3, column0, point, 0);
+			result = vmlaq_laneq_f32(result, column1, point, 1);
+			result = vmlaq_laneq_f32(result, column2, point, 2);
+			vst1q_f32(&results[i].x, result);
+		}
+	}
+	static void MultiplyMatricesNeon(size_t count, const Matrix4* lhs, const Matrix4* rhs, Matrix4* results) {
+		for(size_t i = 0; i != count; ++i) {
+			// Load both matrices before storing any column, so that the results may overwrite either input
+			float32x4_t lhsColumns[4];
+			float32x4_t rhsColumns[4];
+			for(size_t j = 0; j != 4; ++j) {
+				lhsColumns[j] = vld1q_f32(&lhs[i].columns[j].x);
+				rhsColumns[j] = vld1q_f32(&rhs[i].columns[j].x);
+			}
+
+			for(size_t j = 0; j != 4; ++j) {
+				float32x4_t result = vmulq_laneq_f32(lhsColumns[0], rhsColumns[j], 0);
+				result = vmlaq_laneq_f32(result, lhsColumns[1], rhsColumns[j], 1);
+				result = vmlaq_laneq_f32(result, lhsColumns[2], rhsColumns[j], 2);
+				result = vmlaq_laneq_f32(result, lhsColumns[3], rhsColumns[j], 3);
+				vst1q_f32(&results[i].columns[j].x, result);
+			}
+		}
+	}
+#endif
+
+	// Public functions
+	void TransformPoints(const Matrix4& matrix, size_t count, const Vector3* points, Vector3* results, SimdLevel simdLevel) {
+		TransformPointsKernel kernel;
+
+		switch(simdLevel) {
+#if defined(WFE_ARCH_X86)
+		case SIMD_LEVEL_SSE2:
+			kernel = TransformPointsSse2;
+			break;
+		case SIMD_LEVEL_AVX2:
+		case SIMD_LEVEL_AVX512:
+			kernel = TransformPointsAvx2;
+			break;
+#elif defined(WFE_ARCH_ARM64)
+		case SIMD_LEVEL_NEON:
+			kernel = TransformPointsNeon;
+			break;
+#endif
+		default:
+			kernel = TransformPointsScalar;
+			break;
+		}
+
+		kernel(matrix, count, points, results);
+	}
+	void MultiplyMatrices(size_t count, const Matrix4* lhs, const Matrix4* rhs, Matrix4* results, SimdLevel simdLevel) {
+		MultiplyMatricesKernel kernel;
+
+		switch(simdLevel) {
+#if defined(WFE_ARCH_X86)
+		case SIMD_LEVEL_SSE2:
+			kernel = MultiplyMatricesSse2;
+			break;
+		case SIMD_LEVEL_AVX2:
+		case SIMD_LEVEL_AVX512:
+			kernel = MultiplyMatricesAvx2;
+			break;
+#elif defined(WFE_ARCH_ARM64)
+		case SIMD_LEVEL_NEON:
+			kernel = MultiplyMatricesNeon;
+			break;
+#endif
+		default:
+			kernel = MultiplyMatricesScalar;
+			break;
+		}
+
+		kernel(count, lhs, rhs, results);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Matrix.hpp"
+#include "General/CpuInfo.hpp"
+
+#include <Core.hpp>
+
+namespace wfe {
+	/// @brief Transforms every given point by the same affine transform, multiple points at once with the given SIMD instruction set.
+	/// @param matrix The affine transform matrix.
+	/// @param count The number of points to transform.
+	/// @param points The array of points to transform.
+	/// @param results The array in which the transformed points will be written. May be the same as the points array.
+	/// @param simdLevel The SIMD level of the kernel to use, which mustn't exceed the CPU's level. Defaulted to the CPU's level.
+	void TransformPoints(const Matrix4& matrix, size_t count, const Vector3* points, Vector3* results, SimdLevel simdLevel = GetSimdLevel());
+	/// @brief Multiplies every pair of matrices in the given arrays, one or two matrix columns at once with the given SIMD instruction set.
+	/// @param count The number of matrix pairs to multiply.
+	/// @param lhs The array of left hand side matrices.
+	/// @param rhs The array of right hand side matrices.
+	/// @param results The array in which every product lhs[i] * rhs[i] will be written. May be the same as either input array.
+	/// @param simdLevel The SIMD level of the kernel to use, which mustn't exceed the CPU's level. Defaulted to the CPU's level.
+	void MultiplyMatrices(size_t count, const Matrix4* lhs, const Matrix4* rhs, Matrix4* results, SimdLevel simdLevel = GetSimdLevel());
+}
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include "MathBenchmark.hpp"
+#include "MathBatch.hpp"
+#include "Platform/Clock.hpp"
+
+#include <math.h>
+
+namespace wfe {
+	// Constants
+	static const size_t POINT_COUNT = 1 << 18;
+	static const size_t MATRIX_COUNT = 1 << 15;
+	static const uint32_t RUN_COUNT = 5;
+	static const float64_t MAX_RELATIVE_ERROR = 1e-5;
+
+#if defined(WFE_ARCH_X86)
+	static const SimdLevel BENCHMARK_SIMD_LEVELS[] { SIMD_LEVEL_SCALAR, SIMD_LEVEL_SSE2, SIMD_LEVEL_AVX2 };
+#elif defined(WFE_ARCH_ARM64)
+	static const SimdLevel BENCHMARK_SIMD_LEVELS[] { SIMD_LEVEL_SCALAR, SIMD_LEVEL_NEON };
+#else
+	static const SimdLevel BENCHMARK_SIMD_LEVELS[] { SIMD_LEVEL_SCALAR };
+#endif
+
+	// Internal helper functions
+	static uint32_t NextRandom(uint32_t& state) {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+	static float32_t NextRandomFloat(uint32_t& state, float32_t min, float32_t max) {
+		return min + (max - min) * (float32_t)(NextRandom(state) >> 8) * (1.f / (float32_t)(1 << 24));
+	}
+	static float64_t ComputeRelativeError(float64_t expected, float64_t magnitude, float32_t value) {
+		// Measure the error relative to the magnitude of the summed terms, as cancelling terms make the result's own magnitude meaningless
+		return fabs(expected - (float64_t)value) / (magnitude > 1. ? magnitude : 1.);
+	}
+	static float64_t CheckTransformedPoints(const Matrix4& matrix, const Vector3* points, const Vector3* results) {
+		const float32_t* column0 = &matrix.columns[0].x;
+		const float32_t* column1 = &matrix.columns[1].x;
+		const float32_t* column2 = &matrix.columns[2].x;
+		const float32_t* column3 = &matrix.columns[3].x;
+		float64_t maxError = 0.;
+
+		for(size_t i = 0; i != POINT_COUNT; ++i) {
+			const float32_t* result = &results[i].x;
+			for(size_t row = 0; row != 3; ++row) {
+				float64_t terms[4] { (float64_t)column0[row] * points[i].x, (float64_t)column1[row] * points[i].y, (float64_t)column2[row] * points[i].z, column3[row] };
+				float64_t expected = terms[0] + terms[1] + terms[2] + terms[3];
+				float64_t magnitude = fabs(terms[0]) + fabs(terms[1]) + fabs(terms[2]) + fabs(terms[3]);
+
+				float64_t error = ComputeRelativeError(expected, magnitude, result[row]);
+				if(error > maxError)
+					maxError = error;
+			}
+		}
+
+		return maxError;
+	}
+	static float64_t CheckMultipliedMatrices(const Matrix4* lhs, const Matrix4* rhs, const Matrix4* results) {
+		float64_t maxError = 0.;
+
+		for(size_t i = 0; i != MATRIX_COUNT; ++i) {
+			const float32_t* lhsValues = &lhs[i].columns[0].x;
+			const float32_t* rhsValues = &rhs[i].columns[0].x;
+			const float32_t* resultValues = &results[i].columns[0].x;
+
+			for(size_t column = 0; column != 4; ++column)
+				for(size_t row = 0; row != 4; ++row) {
+					float64_t expected = 0.;
+					float64_t magnitude = 0.;
+					for(size_t k = 0; k != 4; ++k) {
+						float64_t term = (float64_t)lhsValues[k * 4 + row] * rhsValues[column * 4 + k];
+						expected += term;
+						magnitude += fabs(term);
+					}
+
+					float64_t error = ComputeRelativeError(expected, magnitude, resultValues[column * 4 + row]);
+					if(error > maxError)
+						maxError = error;
+				}
+		}
+
+		return maxError;
+	}
+	static uint64_t ComputeSpeedup(uint64_t baseTime, uint64_t time) {
+		return time ? baseTime * 100 / time : 0;
+	}
+
+	// Public functions
+	bool8_t RunMathBenchmarks(Logger* logger) {
+		PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
+
+		// Generate the benchmarks' data
+		uint32_t randomState = 0x2545f491;
+
+		Matrix4 matrix = MatrixFromTransform({ 1.f, -2.f, 3.f }, Normalize(Quaternion { .1f, .7f, -.3f, .6f }), { 1.5f, .5f, 2.f });
+
+		vector<Vector3> points;
+		vector<Vector3> transformedPoints;
+		points.resize(POINT_COUNT);
+		transformedPoints.resize(POINT_COUNT);
+		for(size_t i = 0; i != POINT_COUNT; ++i)
+			points[i] = { NextRandomFloat(randomState, -100.f, 100.f), NextRandomFloat(randomState, -100.f, 100.f), NextRandomFloat(randomState, -100.f, 100.f) };
+
+		vector<Matrix4> lhs;
+		vector<Matrix4> rhs;
+		vector<Matrix4> products;
+		lhs.resize(MATRIX_COUNT);
+		rhs.resize(MATRIX_COUNT);
+		products.resize(MATRIX_COUNT);
+		for(size_t i = 0; i != MATRIX_COUNT; ++i) {
+			float32_t* lhsValues = &lhs[i].columns[0].x;
+			float32_t* rhsValues = &rhs[i].columns[0].x;
+			for(size_t j = 0; j != 16; ++j) {
+				lhsValues[j] = NextRandomFloat(randomState, -1.f, 1.f);
+				rhsValues[j] = NextRandomFloat(randomState, -1.f, 1.f);
+			}
+		}
+
+		bool8_t accurate = true;
+		uint64_t baseTransformTime = 0;
+		uint64_t baseMultiplyTime = 0;
+
+		for(SimdLevel simdLevel : BENCHMARK_SIMD_LEVELS) {
+			// Skip the levels the CPU doesn't support
+			if(simdLevel > GetSimdLevel())
+				continue;
+
+			// Time the fastest of multiple runs of every kernel, to filter out the noise of other processes
+			uint64_t transformTime = UINT64_T_MAX;
+			uint64_t multiplyTime = UINT64_T_MAX;
+
+			for(uint32_t run = 0; run != RUN_COUNT; ++run) {
+				uint64_t startTime = GetClockTime();
+				TransformPoints(matrix, POINT_COUNT, points.data(), transformedPoints.data(), simdLevel);
+				uint64_t time = GetClockTime() - startTime;
+				if(time < transformTime)
+					transformTime = time;
+
+				startTime = GetClockTime();
+				MultiplyMatrices(MATRIX_COUNT, lhs.data(), rhs.data(), products.data(), simdLevel);
+				time = GetClockTime() - startTime;
+				if(time < multiplyTime)
+					multiplyTime = time;
+			}
+
+			if(simdLevel == SIMD_LEVEL_SCALAR) {
+				baseTransformTime = transformTime;
+				baseMultiplyTime = multiplyTime;
+			}
+
+			// Check the last run's results against a double precision reference
+			float64_t transformError = CheckTransformedPoints(matrix, points.data(), transformedPoints.data());
+			float64_t multiplyError = CheckMultipliedMatrices(lhs.data(), rhs.data(), products.data());
+
+			uint64_t transformSpeedup = ComputeSpeedup(baseTransformTime, transformTime);
+			uint64_t multiplySpeedup = ComputeSpeedup(baseMultiplyTime, multiplyTime);
+			logger->LogInfoMessage("Math benchmark: %s point transform took %llu us, %llu.%02llux speedup, max error %.3e.", GetSimdLevelName(simdLevel), (unsigned long long)(transformTime / 1000), (unsigned long long)(transformSpeedup / 100), (unsigned long long)(transformSpeedup % 100), transformError);
+			logger->LogInfoMessage("Math benchmark: %s matrix multiply took %llu us, %llu.%02llux speedup, max error %.3e.", GetSimdLevelName(simdLevel), (unsigned long long)(multiplyTime / 1000), (unsigned long long)(multiplySpeedup / 100), (unsigned long long)(multiplySpeedup % 100), multiplyError);
+
+			if(transformError > MAX_RELATIVE_ERROR || multiplyError > MAX_RELATIVE_ERROR) {
+				logger->LogErrorMessage("Math benchmark: %s kernels exceeded the maximum error!", GetSimdLevelName(simdLevel));
+				accurate = false;
+			}
+		}
+
+		PopMemoryUsageType();
+
+		return accurate;
+	}
+}
\ No newline at end of file
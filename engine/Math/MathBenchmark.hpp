@@ -0,0 +1,10 @@
+#pragma once
+
+#include <Core.hpp>
+
+namespace wfe {
+	/// @brief Runs the math library's batch benchmarks with every SIMD level the CPU supports, logging every kernel's time, its speedup over the scalar kernel and its largest error relative to a double precision reference.
+	/// @param logger The logger to write the results to.
+	/// @return True if every kernel's error is within tolerance, otherwise false.
+	bool8_t RunMathBenchmarks(Logger* logger);
+}
\ No newline at end of file
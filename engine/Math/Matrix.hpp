@@ -0,0 +1,146 @@
+#pragma once
+
+#include "Quaternion.hpp"
+#include "Vector.hpp"
+
+#include <Core.hpp>
+
+namespace wfe {
+	/// @brief A column-major 4x4 matrix, matching the layout expected by shaders.
+	struct alignas(16) Matrix4 {
+		/// @brief The matrix's columns.
+		Vector4 columns[4];
+
+		/// @brief Multiplies this matrix by the given matrix.
+		/// @param other The matrix to multiply by.
+		/// @return A matrix applying the other matrix's transform, then this matrix's transform.
+		Matrix4 operator*(const Matrix4& other) const {
+			Matrix4 result;
+			for(size_t i = 0; i != 4; ++i) {
+				const Vector4& column = other.columns[i];
+				result.columns[i] = columns[0] * column.x + columns[1] * column.y + columns[2] * column.z + columns[3] * column.w;
+			}
+
+			return result;
+		}
+		/// @brief Transforms the given vector.
+		/// @param vector The vector to transform.
+		/// @return The transformed vector.
+		Vector4 operator*(const Vector4& vector) const {
+			return columns[0] * vector.x + columns[1] * vector.y + columns[2] * vector.z + columns[3] * vector.w;
+		}
+	};
+
+	/// @brief The identity matrix.
+	static const Matrix4 IDENTITY_MATRIX {{
+		{ 1.f, 0.f, 0.f, 0.f },
+		{ 0.f, 1.f, 0.f, 0.f },
+		{ 0.f, 0.f, 1.f, 0.f },
+		{ 0.f, 0.f, 0.f, 1.f }
+	}};
+
+	/// @brief Transforms the given point, treating the matrix as an affine transform.
+	/// @param matrix The affine transform matrix.
+	/// @param point The point to transform.
+	/// @return The transformed point.
+	inline Vector3 TransformPoint(const Matrix4& matrix, const Vector3& point) {
+		Vector4 result = matrix.columns[0] * point.x + matrix.columns[1] * point.y + matrix.columns[2] * point.z + matrix.columns[3];
+		return { result.x, result.y, result.z };
+	}
+	/// @brief Transforms the given direction, ignoring the matrix's translation.
+	/// @param matrix The affine transform matrix.
+	/// @param vector The direction to transform.
+	/// @return The transformed direction.
+	inline Vector3 TransformVector(const Matrix4& matrix, const Vector3& vector) {
+		Vector4 result = matrix.columns[0] * vector.x + matrix.columns[1] * vector.y + matrix.columns[2] * vector.z;
+		return { result.x, result.y, result.z };
+	}
+	/// @brief Transposes the given matrix.
+	/// @param matrix The matrix to transpose.
+	/// @return The transposed matrix.
+	inline Matrix4 Transpose(const Matrix4& matrix) {
+		const Vector4* columns = matrix.columns;
+		return {{
+			{ columns[0].x, columns[1].x, columns[2].x, columns[3].x },
+			{ columns[0].y, columns[1].y, columns[2].y, columns[3].y },
+			{ columns[0].z, columns[1].z, columns[2].z, columns[3].z },
+			{ columns[0].w, columns[1].w, columns[2].w, columns[3].w }
+		}};
+	}
+	/// @brief Creates an affine transform matrix from a translation, a rotation and a per-axis scale, applied in scale, rotation, translation order.
+	/// @param translation The transform's translation.
+	/// @param rotation The transform's normalized rotation.
+	/// @param scale The transform's scale along every axis.
+	/// @return The transform matrix.
+	inline Matrix4 MatrixFromTransform(const Vector3& translation, const Quaternion& rotation, const Vector3& scale) {
+		float32_t x = rotation.x, y = rotation.y, z = rotation.z, w = rotation.w;
+
+		return {{
+			{ (1.f - 2.f * (y * y + z * z)) * scale.x, 2.f * (x * y + w * z) * scale.x, 2.f * (x * z - w * y) * scale.x, 0.f },
+			{ 2.f * (x * y - w * z) * scale.y, (1.f - 2.f * (x * x + z * z)) * scale.y, 2.f * (y * z + w * x) * scale.y, 0.f },
+			{ 2.f * (x * z + w * y) * scale.z, 2.f * (y * z - w * x) * scale.z, (1.f - 2.f * (x * x + y * y)) * scale.z, 0.f },
+			{ translation.x, translation.y, translation.z, 1.f }
+		}};
+	}
+	/// @brief Inverts the given affine transform matrix.
+	/// @param matrix The affine transform matrix, whose 3x3 part must be invertible.
+	/// @return The inverse transform matrix.
+	inline Matrix4 AffineInverse(const Matrix4& matrix) {
+		const Vector4* columns = matrix.columns;
+		Vector3 a { columns[0].x, columns[0].y, columns[0].z };
+		Vector3 b { columns[1].x, columns[1].y, columns[1].z };
+		Vector3 c { columns[2].x, columns[2].y, columns[2].z };
+
+		// The inverse 3x3 part's rows are the cross products of the columns, divided by the determinant
+		Vector3 row0 = Cross(b, c);
+		Vector3 row1 = Cross(c, a);
+		Vector3 row2 = Cross(a, b);
+		float32_t inverseDeterminant = 1.f / Dot(a, row0);
+		row0 = row0 * inverseDeterminant;
+		row1 = row1 * inverseDeterminant;
+		row2 = row2 * inverseDeterminant;
+
+		Vector3 translation { columns[3].x, columns[3].y, columns[3].z };
+
+		return {{
+			{ row0.x, row1.x, row2.x, 0.f },
+			{ row0.y, row1.y, row2.y, 0.f },
+			{ row0.z, row1.z, row2.z, 0.f },
+			{ -Dot(row0, translation), -Dot(row1, translation), -Dot(row2, translation), 1.f }
+		}};
+	}
+	/// @brief Creates a right-handed view matrix, looking down its negative Z axis.
+	/// @param eye The camera's position.
+	/// @param target The point the camera looks at, which mustn't be the camera's position.
+	/// @param up The world's up direction, which mustn't be parallel to the view direction.
+	/// @return The view matrix.
+	inline Matrix4 LookAt(const Vector3& eye, const Vector3& target, const Vector3& up) {
+		Vector3 forward = Normalize(target - eye);
+		Vector3 right = Normalize(Cross(forward, up));
+		Vector3 cameraUp = Cross(right, forward);
+
+		return {{
+			{ right.x, cameraUp.x, -forward.x, 0.f },
+			{ right.y, cameraUp.y, -forward.y, 0.f },
+			{ right.z, cameraUp.z, -forward.z, 0.f },
+			{ -Dot(right, eye), -Dot(cameraUp, eye), Dot(forward, eye), 1.f }
+		}};
+	}
+	/// @brief Creates a right-handed perspective projection matrix, mapping depth to Vulkan's [0, 1] range. The Y axis isn't flipped.
+	/// @param verticalFov The vertical field of view, in radians.
+	/// @param aspectRatio The viewport's width divided by its height.
+	/// @param nearPlane The distance to the near plane.
+	/// @param farPlane The distance to the far plane.
+	/// @return The projection matrix.
+	inline Matrix4 PerspectiveMatrix(float32_t verticalFov, float32_t aspectRatio, float32_t nearPlane, float32_t farPlane) {
+		float32_t focalLength = 1.f / tanf(verticalFov * .5f);
+		float32_t depthScale = farPlane / (nearPlane - farPlane);
+
+		return {{
+			{ focalLength / aspectRatio, 0.f, 0.f, 0.f },
+			{ 0.f, focalLength, 0.f, 0.f },
+			{ 0.f, 0.f, depthScale, -1.f },
+			{ 0.f, 0.f, nearPlane * depthScale, 0.f }
+		}};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Vector.hpp"
+
+#include <Core.hpp>
+
+namespace wfe {
+	/// @brief A rotation quaternion, stored in XYZW order.
+	struct alignas(16) Quaternion {
+		/// @brief The X component of the quaternion's vector part.
+		float32_t x;
+		/// @brief The Y component of the quaternion's vector part.
+		float32_t y;
+		/// @brief The Z component of the quaternion's vector part.
+		float32_t z;
+		/// @brief The quaternion's scalar part.
+		float32_t w;
+
+		/// @brief Composes two rotations.
+		/// @param other The rotation applied before this one.
+		/// @return A quaternion rotating by the other quaternion, then by this one.
+		Quaternion operator*(const Quaternion& other) const {
+			return {
+				w * other.x + x * other.w + y * other.z - z * other.y,
+				w * other.y - x * other.z + y * other.w + z * other.x,
+				w * other.z + x * other.y - y * other.x + z * other.w,
+				w * other.w - x * other.x - y * other.y - z * other.z
+			};
+		}
+	};
+
+	/// @brief The identity quaternion, which doesn't rotate.
+	static const Quaternion IDENTITY_QUATERNION { 0.f, 0.f, 0.f, 1.f };
+
+	/// @brief Creates a quaternion rotating around the given axis.
+	/// @param axis The rotation's axis, which must be normalized.
+	/// @param angle The rotation's angle, in radians, counter-clockwise when looking down the axis.
+	/// @return The rotation quaternion.
+	inline Quaternion QuaternionFromAxisAngle(const Vector3& axis, float32_t angle) {
+		float32_t halfSin = sinf(angle * .5f);
+		return { axis.x * halfSin, axis.y * halfSin, axis.z * halfSin, cosf(angle * .5f) };
+	}
+	/// @brief Gets the given quaternion's conjugate, which is its inverse if the quaternion is normalized.
+	/// @param quaternion The quaternion.
+	/// @return The quaternion's conjugate.
+	inline Quaternion Conjugate(const Quaternion& quaternion) {
+		return { -quaternion.x, -quaternion.y, -quaternion.z, quaternion.w };
+	}
+	/// @brief Scales the given quaternion to a length of 1, removing the drift accumulated by repeated compositions.
+	/// @param quaternion The quaternion to normalize, which mustn't have a length of 0.
+	/// @return The normalized quaternion.
+	inline Quaternion Normalize(const Quaternion& quaternion) {
+		float32_t scale = 1.f / sqrtf(quaternion.x * quaternion.x + quaternion.y * quaternion.y + quaternion.z * quaternion.z + quaternion.w * quaternion.w);
+		return { quaternion.x * scale, quaternion.y * scale, quaternion.z * scale, quaternion.w * scale };
+	}
+	/// @brief Rotates the given vector.
+	/// @param quaternion The normalized rotation quaternion.
+	/// @param vector The vector to rotate.
+	/// @return The rotated vector.
+	inline Vector3 Rotate(const Quaternion& quaternion, const Vector3& vector) {
+		// Use the expansion v' = v + w * t + q x t, where t = 2 * (q x v), which skips the full quaternion products
+		Vector3 axis { quaternion.x, quaternion.y, quaternion.z };
+		Vector3 t = Cross(axis, vector) * 2.f;
+
+		return vector + t * quaternion.w + Cross(axis, t);
+	}
+	/// @brief Spherically interpolates between two rotations, taking the shortest path.
+	/// @param a The normalized rotation returned when the factor is 0.
+	/// @param b The normalized rotation returned when the factor is 1.
+	/// @param factor The interpolation factor.
+	/// @return The normalized interpolated rotation.
+	inline Quaternion Slerp(const Quaternion& a, Quaternion b, float32_t factor) {
+		// Flip the second rotation if needed, as q and -q represent the same rotation
+		float32_t cosAngle = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+		if(cosAngle < 0.f) {
+			b = { -b.x, -b.y, -b.z, -b.w };
+			cosAngle = -cosAngle;
+		}
+
+		// Fall back to a normalized linear interpolation for nearly equal rotations, where the angle's sine vanishes
+		float32_t aWeight = 1.f - factor;
+		float32_t bWeight = factor;
+		if(cosAngle < .9995f) {
+			float32_t angle = acosf(cosAngle);
+			float32_t inverseSin = 1.f / sinf(angle);
+			aWeight = sinf(aWeight * angle) * inverseSin;
+			bWeight = sinf(bWeight * angle) * inverseSin;
+		}
+
+		return Normalize(Quaternion { a.x * aWeight + b.x * bWeight, a.y * aWeight + b.y * bWeight, a.z * aWeight + b.z * bWeight, a.w * aWeight + b.w * bWeight });
+	}
+}
\ No newline at end of file
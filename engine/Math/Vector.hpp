@@ -0,0 +1,151 @@
+#pragma once
+
+#include <Core.hpp>
+
+#include <math.h>
+
+namespace wfe {
+	/// @brief A 3D vector, padded to 16 bytes so that it can be loaded into a single SIMD register.
+	struct alignas(16) Vector3 {
+		/// @brief The vector's X component.
+		float32_t x;
+		/// @brief The vector's Y component.
+		float32_t y;
+		/// @brief The vector's Z component.
+		float32_t z;
+
+		/// @brief Adds the given vector to this vector.
+		/// @param other The vector to add.
+		/// @return The sum of the two vectors.
+		Vector3 operator+(const Vector3& other) const {
+			return { x + other.x, y + other.y, z + other.z };
+		}
+		/// @brief Subtracts the given vector from this vector.
+		/// @param other The vector to subtract.
+		/// @return The difference of the two vectors.
+		Vector3 operator-(const Vector3& other) const {
+			return { x - other.x, y - other.y, z - other.z };
+		}
+		/// @brief Negates this vector.
+		/// @return The negated vector.
+		Vector3 operator-() const {
+			return { -x, -y, -z };
+		}
+		/// @brief Scales this vector.
+		/// @param scale The scale to multiply every component by.
+		/// @return The scaled vector.
+		Vector3 operator*(float32_t scale) const {
+			return { x * scale, y * scale, z * scale };
+		}
+		/// @brief Multiplies this vector by the given vector, component by component.
+		/// @param other The vector to multiply by.
+		/// @return The component-wise product of the two vectors.
+		Vector3 operator*(const Vector3& other) const {
+			return { x * other.x, y * other.y, z * other.z };
+		}
+	};
+
+	/// @brief A 4D vector, which also represents the columns of a Matrix4.
+	struct alignas(16) Vector4 {
+		/// @brief The vector's X component.
+		float32_t x;
+		/// @brief The vector's Y component.
+		float32_t y;
+		/// @brief The vector's Z component.
+		float32_t z;
+		/// @brief The vector's W component.
+		float32_t w;
+
+		/// @brief Adds the given vector to this vector.
+		/// @param other The vector to add.
+		/// @return The sum of the two vectors.
+		Vector4 operator+(const Vector4& other) const {
+			return { x + other.x, y + other.y, z + other.z, w + other.w };
+		}
+		/// @brief Subtracts the given vector from this vector.
+		/// @param other The vector to subtract.
+		/// @return The difference of the two vectors.
+		Vector4 operator-(const Vector4& other) const {
+			return { x - other.x, y - other.y, z - other.z, w - other.w };
+		}
+		/// @brief Negates this vector.
+		/// @return The negated vector.
+		Vector4 operator-() const {
+			return { -x, -y, -z, -w };
+		}
+		/// @brief Scales this vector.
+		/// @param scale The scale to multiply every component by.
+		/// @return The scaled vector.
+		Vector4 operator*(float32_t scale) const {
+			return { x * scale, y * scale, z * scale, w * scale };
+		}
+		/// @brief Multiplies this vector by the given vector, component by component.
+		/// @param other The vector to multiply by.
+		/// @return The component-wise product of the two vectors.
+		Vector4 operator*(const Vector4& other) const {
+			return { x * other.x, y * other.y, z * other.z, w * other.w };
+		}
+	};
+
+	/// @brief Computes the dot product of two vectors.
+	/// @param a The first vector.
+	/// @param b The second vector.
+	/// @return The dot product of the two vectors.
+	inline float32_t Dot(const Vector3& a, const Vector3& b) {
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+	/// @brief Computes the dot product of two vectors.
+	/// @param a The first vector.
+	/// @param b The second vector.
+	/// @return The dot product of the two vectors.
+	inline float32_t Dot(const Vector4& a, const Vector4& b) {
+		return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+	}
+	/// @brief Computes the cross product of two vectors.
+	/// @param a The first vector.
+	/// @param b The second vector.
+	/// @return A vector perpendicular to both vectors, following the right hand rule.
+	inline Vector3 Cross(const Vector3& a, const Vector3& b) {
+		return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+	}
+	/// @brief Computes the given vector's length.
+	/// @param vector The vector.
+	/// @return The vector's length.
+	inline float32_t Length(const Vector3& vector) {
+		return sqrtf(Dot(vector, vector));
+	}
+	/// @brief Computes the given vector's length.
+	/// @param vector The vector.
+	/// @return The vector's length.
+	inline float32_t Length(const Vector4& vector) {
+		return sqrtf(Dot(vector, vector));
+	}
+	/// @brief Scales the given vector to a length of 1.
+	/// @param vector The vector to normalize, which mustn't have a length of 0.
+	/// @return The normalized vector.
+	inline Vector3 Normalize(const Vector3& vector) {
+		return vector * (1.f / Length(vector));
+	}
+	/// @brief Scales the given vector to a length of 1.
+	/// @param vector The vector to normalize, which mustn't have a length of 0.
+	/// @return The normalized vector.
+	inline Vector4 Normalize(const Vector4& vector) {
+		return vector * (1.f / Length(vector));
+	}
+	/// @brief Linearly interpolates between two vectors.
+	/// @param a The vector returned when the factor is 0.
+	/// @param b The vector returned when the factor is 1.
+	/// @param factor The interpolation factor.
+	/// @return The interpolated vector.
+	inline Vector3 Lerp(const Vector3& a, const Vector3& b, float32_t factor) {
+		return a + (b - a) * factor;
+	}
+	/// @brief Linearly interpolates between two vectors.
+	/// @param a The vector returned when the factor is 0.
+	/// @param b The vector returned when the factor is 1.
+	/// @param factor The interpolation factor.
+	/// @return The interpolated vector.
+	inline Vector4 Lerp(const Vector4& a, const Vector4& b, float32_t factor) {
+		return a + (b - a) * factor;
+	}
+}
\ No newline at end of file
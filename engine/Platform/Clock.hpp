@@ -0,0 +1,9 @@
+#pragma once
+
+#include <Core.hpp>
+
+namespace wfe {
+	/// @brief Gets the current time of the platform's monotonic high-resolution clock.
+	/// @return The time since an unspecified point, in nanoseconds.
+	uint64_t GetClockTime();
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <Core.hpp>
+
+namespace wfe {
+	/// @brief A native fiber, which is a user-mode execution context with its own stack that threads cooperatively switch between.
+	class Fiber {
+	public:
+		/// @brief The signature of the function run by a fiber. The function must never return; instead, it must switch to another fiber.
+		typedef void(*FiberFunction)(void* userData);
+
+#if defined(WFE_PLATFORM_WINDOWS)
+		/// @brief The fiber's Windows specific info.
+		struct PlatformInfo {
+			/// @brief The address of the Win32 fiber.
+			void* fiber;
+			/// @brief True if the fiber was converted from a thread that wasn't a fiber already, otherwise false.
+			bool8_t convertedThread;
+		};
+#elif defined(WFE_PLATFORM_LINUX)
+		/// @brief The fiber's Linux specific info.
+		struct PlatformInfo {
+			/// @brief The fiber's saved stack pointer, which points to its saved callee-saved registers while the fiber isn't running.
+			void* stackPointer;
+			/// @brief The fiber's stack, or nullptr if the fiber runs on a thread's stack.
+			void* stack;
+		};
+#endif
+
+		/// @brief Creates a fiber from the calling thread, allowing it to switch to other fibers. Must be destroyed on the same thread.
+		Fiber();
+		/// @brief Creates a new fiber with its own stack, which starts running the given function when it's first switched to.
+		/// @param function The function to run on the fiber.
+		/// @param userData The user data to pass to the function.
+		/// @param stackSize The size of the fiber's stack, in bytes.
+		Fiber(FiberFunction function, void* userData, size_t stackSize);
+		Fiber(const Fiber&) = delete;
+		Fiber(Fiber&&) noexcept = delete;
+
+		Fiber& operator=(const Fiber&) = delete;
+		Fiber& operator=(Fiber&&) = delete;
+
+		/// @brief Gets the fiber's platform specific info.
+		/// @return The fiber platform info struct.
+		const PlatformInfo& GetPlatformInfo() const {
+			return platformInfo;
+		}
+
+		/// @brief Saves the state of this fiber, which must be the one running on the calling thread, and switches to the given fiber. Returns once another fiber switches back to this one, possibly on another thread.
+		/// @param fiber The fiber to switch to.
+		void SwitchTo(Fiber* fiber);
+
+		/// @brief Destroys the fiber, which must not be running.
+		~Fiber();
+	private:
+		PlatformInfo platformInfo;
+		FiberFunction function;
+		void* userData;
+
+#if defined(WFE_PLATFORM_WINDOWS)
+		static void __stdcall FiberEntry(void* args);
+#elif defined(WFE_PLATFORM_LINUX)
+		static void FiberEntry(Fiber* fiber);
+#endif
+	};
+}
\ No newline at end of file
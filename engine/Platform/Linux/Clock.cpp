@@ -0,0 +1,20 @@
+#include <BuildInfo.hpp>
+
+#ifdef WFE_PLATFORM_LINUX
+
+#include "Platform/Clock.hpp"
+
+#include <time.h>
+
+namespace wfe {
+	// Public functions
+	uint64_t GetClockTime() {
+		// Get the monotonic clock's time, which isn't affected by system time changes
+		timespec time;
+		clock_gettime(CLOCK_MONOTONIC, &time);
+
+		return (uint64_t)time.tv_sec * 1000000000 + (uint64_t)time.tv_nsec;
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include <BuildInfo.hpp>
+
+#ifdef WFE_PLATFORM_LINUX
+
+#include "Platform/Fiber.hpp"
+#include "General/HeapMemory.hpp"
+
+#include <string.h>
+
+// Switch contexts by hand instead of with swapcontext, which saves and restores the signal mask with a syscall on every switch. Only the registers the calling convention makes callee-saved are kept, as the switch is an ordinary function call to the compiler
+#if defined(__x86_64__)
+__asm__(
+	".pushsection .text\n"
+	".globl wfeSwitchFiberContext\n"
+	".hidden wfeSwitchFiberContext\n"
+	".type wfeSwitchFiberContext, @function\n"
+	"wfeSwitchFiberContext:\n"
+	"	pushq %rbp\n"
+	"	pushq %rbx\n"
+	"	pushq %r12\n"
+	"	pushq %r13\n"
+	"	pushq %r14\n"
+	"	pushq %r15\n"
+	"	subq $8, %rsp\n"
+	"	stmxcsr (%rsp)\n"
+	"	fnstcw 4(%rsp)\n"
+	"	movq %rsp, (%rdi)\n"
+	"	movq %rsi, %rsp\n"
+	"	ldmxcsr (%rsp)\n"
+	"	fldcw 4(%rsp)\n"
+	"	addq $8, %rsp\n"
+	"	popq %r15\n"
+	"	popq %r14\n"
+	"	popq %r13\n"
+	"	popq %r12\n"
+	"	popq %rbx\n"
+	"	popq %rbp\n"
+	"	ret\n"
+	".size wfeSwitchFiberContext, .-wfeSwitchFiberContext\n"
+	".globl wfeStartFiber\n"
+	".hidden wfeStartFiber\n"
+	".type wfeStartFiber, @function\n"
+	"wfeStartFiber:\n"
+	"	movq %rbx, %rdi\n"
+	"	callq *%r12\n"
+	"	ud2\n"
+	".size wfeStartFiber, .-wfeStartFiber\n"
+	".popsection\n"
+);
+#elif defined(__aarch64__)
+__asm__(
+	".pushsection .text\n"
+	".globl wfeSwitchFiberContext\n"
+	".hidden wfeSwitchFiberContext\n"
+	".type wfeSwitchFiberContext, %function\n"
+	"wfeSwitchFiberContext:\n"
+	"	sub sp, sp, #160\n"
+	"	stp x19, x20, [sp, #0]\n"
+	"	stp x21, x22, [sp, #16]\n"
+	"	stp x23, x24, [sp, #32]\n"
+	"	stp x25, x26, [sp, #48]\n"
+	"	stp x27, x28, [sp, #64]\n"
+	"	stp x29, x30, [sp, #80]\n"
+	"	stp d8, d9, [sp, #96]\n"
+	"	stp d10, d11, [sp, #112]\n"
+	"	stp d12, d13, [sp, #128]\n"
+	"	stp d14, d15, [sp, #144]\n"
+	"	mov x9, sp\n"
+	"	str x9, [x0]\n"
+	"	mov sp, x1\n"
+	"	ldp x19, x20, [sp, #0]\n"
+	"	ldp x21, x22, [sp, #16]\n"
+	"	ldp x23, x24, [sp, #32]\n"
+	"	ldp x25, x26, [sp, #48]\n"
+	"	ldp x27, x28, [sp, #64]\n"
+	"	ldp x29, x30, [sp, #80]\n"
+	"	ldp d8, d9, [sp, #96]\n"
+	"	ldp d10, d11, [sp, #112]\n"
+	"	ldp d12, d13, [sp, #128]\n"
+	"	ldp d14, d15, [sp, #144]\n"
+	"	add sp, sp, #160\n"
+	"	ret\n"
+	".size wfeSwitchFiberContext, .-wfeSwitchFiberContext\n"
+	".globl wfeStartFiber\n"
+	".hidden wfeStartFiber\n"
+	".type wfeStartFiber, %function\n"
+	"wfeStartFiber:\n"
+	"	mov x0, x19\n"
+	"	blr x20\n"
+	"	brk #0\n"
+	".size wfeStartFiber, .-wfeStartFiber\n"
+	".popsection\n"
+);
+#else
+#error "Linux fibers are only implemented for x86-64 and AArch64!"
+#endif
+
+extern "C" {
+	/// @brief Saves the callee-saved registers on the current stack, writes the stack pointer to the given location and resumes the context saved at the given stack pointer.
+	/// @param stackPointer A pointer to the location in which the current context's stack pointer will be written.
+	/// @param newStackPointer The saved stack pointer of the context to resume.
+	void wfeSwitchFiberContext(void** stackPointer, void* newStackPointer);
+	/// @brief The first code run by a new fiber, which calls the entry function with the fiber, both restored from its initial context.
+	void wfeStartFiber();
+}
+
+namespace wfe {
+	// Constants
+#if defined(__x86_64__)
+	static const size_t CONTEXT_SIZE = 10 * sizeof(uint64_t);
+	static const uint32_t DEFAULT_MXCSR = 0x1f80;
+	static const uint32_t DEFAULT_FPU_CONTROL_WORD = 0x037f;
+#elif defined(__aarch64__)
+	static const size_t CONTEXT_SIZE = 20 * sizeof(uint64_t);
+#endif
+
+	// Internal helper functions
+	void Fiber::FiberEntry(Fiber* fiber) {
+		// Run the fiber's function, which is stored in the fiber object restored from the initial context
+		fiber->function(fiber->userData);
+	}
+
+	// Public functions
+	Fiber::Fiber() : function(nullptr), userData(nullptr) {
+		// The thread's context is saved when it first switches to another fiber
+		platformInfo.stackPointer = nullptr;
+		platformInfo.stack = nullptr;
+	}
+	Fiber::Fiber(FiberFunction function, void* userData, size_t stackSize) : function(function), userData(userData) {
+		// Allocate the fiber's stack
+		platformInfo.stack = AllocHeapMemory(stackSize);
+		if(!platformInfo.stack)
+			throw BadAllocException("Failed to allocate fiber stack!");
+
+		// Write the initial context at the 16-byte aligned top of the stack, so that the first switch to the fiber restores it and returns into the start trampoline
+		uintptr_t stackTop = ((uintptr_t)platformInfo.stack + stackSize) & ~(uintptr_t)15;
+		uint64_t* context = (uint64_t*)(stackTop - CONTEXT_SIZE);
+		memset(context, 0, CONTEXT_SIZE);
+
+#if defined(__x86_64__)
+		// The context holds the control registers, r15, r14, r13, r12, rbx, rbp and the return address, followed by padding that leaves the stack aligned for the trampoline's call
+		context[0] = (uint64_t)DEFAULT_MXCSR | ((uint64_t)DEFAULT_FPU_CONTROL_WORD << 32);
+		context[4] = (uint64_t)(uintptr_t)FiberEntry;
+		context[5] = (uint64_t)(uintptr_t)this;
+		context[7] = (uint64_t)(uintptr_t)wfeStartFiber;
+#elif defined(__aarch64__)
+		// The context holds x19 to x28, the frame pointer, the link register and d8 to d15
+		context[0] = (uint64_t)(uintptr_t)this;
+		context[1] = (uint64_t)(uintptr_t)FiberEntry;
+		context[11] = (uint64_t)(uintptr_t)wfeStartFiber;
+#endif
+
+		platformInfo.stackPointer = context;
+	}
+
+	void Fiber::SwitchTo(Fiber* fiber) {
+		// Save the current context on the current stack and resume the given fiber's
+		wfeSwitchFiberContext(&platformInfo.stackPointer, fiber->platformInfo.stackPointer);
+	}
+
+	Fiber::~Fiber() {
+		// Free the fiber's stack, if it has its own
+		if(platformInfo.stack)
+			FreeMemory(platformInfo.stack);
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,39 @@
+#include <BuildInfo.hpp>
+
+#ifdef WFE_PLATFORM_LINUX
+
+#include "Platform/Semaphore.hpp"
+
+#include <errno.h>
+#include <semaphore.h>
+#include <string.h>
+
+namespace wfe {
+	// Public functions
+	Semaphore::Semaphore(uint32_t initialCount) {
+		// Create the semaphore, shared only between the process's threads
+		if(sem_init(&platformInfo.semaphore, 0, initialCount))
+			throw Exception("Failed to create POSIX semaphore! Error: %s", strerror(errno));
+	}
+
+	void Semaphore::Signal(uint32_t count) {
+		// Post the semaphore once for every signal
+		for(uint32_t i = 0; i != count; ++i)
+			if(sem_post(&platformInfo.semaphore))
+				throw Exception("Failed to signal POSIX semaphore! Error: %s", strerror(errno));
+	}
+	void Semaphore::Wait() {
+		// Wait for the semaphore, retrying if the wait was interrupted by a signal handler
+		while(sem_wait(&platformInfo.semaphore)) {
+			if(errno != EINTR)
+				throw Exception("Failed to wait for POSIX semaphore! Error: %s", strerror(errno));
+		}
+	}
+
+	Semaphore::~Semaphore() {
+		// Destroy the semaphore
+		sem_destroy(&platformInfo.semaphore);
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include <BuildInfo.hpp>
+
+#ifdef WFE_PLATFORM_LINUX
+
+#include "Platform/Thread.hpp"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace wfe {
+	// Internal structs
+	struct ThreadStartInfo {
+		Thread::ThreadFunction function;
+		void* userData;
+	};
+
+	// Internal helper functions
+	static void* ThreadEntry(void* args) {
+		// Copy the start info and free it, as it was allocated by the creating thread
+		ThreadStartInfo startInfo = *(ThreadStartInfo*)args;
+		DestroyObject((ThreadStartInfo*)args);
+
+		// Run the thread's function
+		startInfo.function(startInfo.userData);
+
+		return nullptr;
+	}
+
+	// Public functions
+	uint32_t Thread::GetHardwareThreadCount() {
+		// Get the number of online processors
+		long processorCount = sysconf(_SC_NPROCESSORS_ONLN);
+		if(processorCount < 1)
+			return 1;
+
+		return (uint32_t)processorCount;
+	}
+	void Thread::YieldCurrentThread() {
+		sched_yield();
+	}
+	void Thread::SleepCurrentThread(uint64_t nanoseconds) {
+		// Sleep for the given time, continuing with the remaining time if the sleep was interrupted by a signal handler
+		timespec time { (time_t)(nanoseconds / 1000000000), (long)(nanoseconds % 1000000000) };
+		while(nanosleep(&time, &time) && errno == EINTR)
+			continue;
+	}
+
+	Thread::Thread(ThreadFunction function, void* userData) : joinable(true) {
+		// Allocate the start info passed to the new thread
+		ThreadStartInfo* startInfo = NewObject<ThreadStartInfo>();
+		if(!startInfo)
+			throw BadAllocException("Failed to allocate thread start info!");
+		startInfo->function = function;
+		startInfo->userData = userData;
+
+		// Create the thread
+		int32_t result = pthread_create(&platformInfo.thread, nullptr, ThreadEntry, startInfo);
+		if(result) {
+			DestroyObject(startInfo);
+			throw Exception("Failed to create pthread! Error: %s", strerror(result));
+		}
+	}
+
+	void Thread::Join() {
+		// Exit the function if the thread was already joined
+		if(!joinable)
+			return;
+
+		// Join the thread
+		int32_t result = pthread_join(platformInfo.thread, nullptr);
+		if(result)
+			throw Exception("Failed to join pthread! Error: %s", strerror(result));
+
+		joinable = false;
+	}
+
+	Thread::~Thread() {
+		// Join the thread if it's still running
+		if(joinable)
+			pthread_join(platformInfo.thread, nullptr);
+	}
+}
+
+#endif
\ No newline at end of file
@@ -7,6 +7,10 @@
 #include "ProjectInfo.hpp"
 
 #include <X11/Xlib.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 namespace wfe {
 	// Constants
@@ -27,6 +31,8 @@ namespace wfe {
 	static Atom destroyMsgAtom;
 	static Atom fullscreenMsgAtom;
 
+	static int32_t wakeFd = -1;
+
 	// Internal helper functions
 	static void ConnectToX() {
 		// Open the X display
@@ -41,6 +47,12 @@ namespace wfe {
 		// Get the screen with the default index
 		screen = XScreenOfDisplay(display, screenIndex);
 
+		// Create the event fd that wakes the window event wait
+		wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+		if(wakeFd == -1)
+			WFE_LOG_FATAL("Failed to create window wake event fd!");
+
 		WFE_LOG_INFO("Connected to X display.");
 	}
 	static void CreateXWindow() {
@@ -96,7 +108,8 @@ namespace wfe {
 		CreateXWindow();
 	}
 	void DestroyWindow() {
-		// No action required to destroy the window
+		// Close the wake event fd
+		close(wakeFd);
 	}
 	void PollWindowEvents() {
 		// Process every pending event from X
@@ -111,6 +124,50 @@ namespace wfe {
 			ProcessEvent(event);
 		}
 	}
+	bool8_t WaitWindowEvents(uint64_t timeout) {
+		// Flush any requests still buffered by Xlib, as the server won't answer them while the wait blocks
+		XFlush(display);
+
+		// Skip the wait if Xlib already read events from the connection, as they won't make the connection's fd readable again
+		bool8_t eventsReceived = XPending(display);
+
+		if(!eventsReceived) {
+			// Convert the timeout to milliseconds, rounding up so that the wait never returns before the timeout
+			int32_t timeoutMs = -1;
+			if(timeout != UINT64_T_MAX) {
+				uint64_t timeoutMs64 = (timeout + 999999) / 1000000;
+				timeoutMs = timeoutMs64 < INT32_T_MAX ? (int32_t)timeoutMs64 : INT32_T_MAX;
+			}
+
+			// Wait for the X connection or the wake event fd to become readable
+			pollfd fds[2];
+			fds[0] = { ConnectionNumber(display), POLLIN, 0 };
+			fds[1] = { wakeFd, POLLIN, 0 };
+
+			while(poll(fds, 2, timeoutMs) == -1) {
+				if(errno != EINTR)
+					WFE_LOG_FATAL("Failed to wait for X events!");
+			}
+
+			// Reset the wake event fd if it was written to
+			if(fds[1].revents & POLLIN) {
+				uint64_t wakeCount;
+				read(wakeFd, &wakeCount, sizeof(uint64_t));
+			}
+
+			eventsReceived = fds[0].revents & POLLIN;
+		}
+
+		// Process the received events
+		PollWindowEvents();
+
+		return eventsReceived;
+	}
+	void WakeWindow() {
+		// Write to the wake event fd, which stays readable until the next wait resets it
+		uint64_t wakeCount = 1;
+		write(wakeFd, &wakeCount, sizeof(uint64_t));
+	}
 
 	WindowPlatformInfo GetWindowPlatformInfo() {
 		return { display, screenIndex, screen, window };
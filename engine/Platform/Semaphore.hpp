@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Core.hpp>
+
+// Platform includes
+#if defined(WFE_PLATFORM_WINDOWS)
+#include <windef.h>
+#elif defined(WFE_PLATFORM_LINUX)
+#include <semaphore.h>
+#endif
+
+namespace wfe {
+	/// @brief A native counting semaphore, used to put threads to sleep until they're signaled.
+	class Semaphore {
+	public:
+#if defined(WFE_PLATFORM_WINDOWS)
+		/// @brief The semaphore's Windows specific info.
+		struct PlatformInfo {
+			/// @brief The handle to the semaphore.
+			HANDLE hSemaphore;
+		};
+#elif defined(WFE_PLATFORM_LINUX)
+		/// @brief The semaphore's Linux specific info.
+		struct PlatformInfo {
+			/// @brief The POSIX semaphore.
+			sem_t semaphore;
+		};
+#endif
+
+		/// @brief Creates a new semaphore.
+		/// @param initialCount The semaphore's initial count. Defaulted to 0.
+		Semaphore(uint32_t initialCount = 0);
+		Semaphore(const Semaphore&) = delete;
+		Semaphore(Semaphore&&) noexcept = delete;
+
+		Semaphore& operator=(const Semaphore&) = delete;
+		Semaphore& operator=(Semaphore&&) = delete;
+
+		/// @brief Gets the semaphore's platform specific info.
+		/// @return The semaphore platform info struct.
+		const PlatformInfo& GetPlatformInfo() const {
+			return platformInfo;
+		}
+
+		/// @brief Increases the semaphore's count, waking up to the given number of waiting threads.
+		/// @param count The number to increase the count by. Defaulted to 1.
+		void Signal(uint32_t count = 1);
+		/// @brief Waits until the semaphore's count is positive, then decreases it.
+		void Wait();
+
+		/// @brief Destroys the semaphore.
+		~Semaphore();
+	private:
+		PlatformInfo platformInfo;
+	};
+}
\ No newline at end of file
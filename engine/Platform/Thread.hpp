@@ -0,0 +1,72 @@
+#pragma once
+
+#include <Core.hpp>
+
+// Platform includes
+#if defined(WFE_PLATFORM_WINDOWS)
+#include <windef.h>
+#elif defined(WFE_PLATFORM_LINUX)
+#include <pthread.h>
+#endif
+
+namespace wfe {
+	/// @brief A native thread, which runs the given function from the moment it's created.
+	class Thread {
+	public:
+		/// @brief The signature of the function run by a thread.
+		typedef void(*ThreadFunction)(void* userData);
+
+#if defined(WFE_PLATFORM_WINDOWS)
+		/// @brief The thread's Windows specific info.
+		struct PlatformInfo {
+			/// @brief The handle to the thread.
+			HANDLE hThread;
+		};
+#elif defined(WFE_PLATFORM_LINUX)
+		/// @brief The thread's Linux specific info.
+		struct PlatformInfo {
+			/// @brief The handle to the thread.
+			pthread_t thread;
+		};
+#endif
+
+		/// @brief Gets the number of hardware threads the program can run on.
+		/// @return The number of logical processors, which is always at least 1.
+		static uint32_t GetHardwareThreadCount();
+		/// @brief Yields the rest of the calling thread's time slice to other ready threads.
+		static void YieldCurrentThread();
+		/// @brief Suspends the calling thread for at least the given time.
+		/// @param nanoseconds The time to sleep for, in nanoseconds. The actual time is rounded to the platform's timer resolution.
+		static void SleepCurrentThread(uint64_t nanoseconds);
+
+		/// @brief Creates a new thread and starts running the given function on it.
+		/// @param function The function to run on the thread.
+		/// @param userData The user data to pass to the function.
+		Thread(ThreadFunction function, void* userData);
+		Thread(const Thread&) = delete;
+		Thread(Thread&&) noexcept = delete;
+
+		Thread& operator=(const Thread&) = delete;
+		Thread& operator=(Thread&&) = delete;
+
+		/// @brief Gets the thread's platform specific info.
+		/// @return The thread platform info struct.
+		const PlatformInfo& GetPlatformInfo() const {
+			return platformInfo;
+		}
+		/// @brief Checks if the thread can be joined.
+		/// @return True if the thread wasn't joined yet, otherwise false.
+		bool8_t IsJoinable() const {
+			return joinable;
+		}
+
+		/// @brief Waits for the thread's function to return.
+		void Join();
+
+		/// @brief Destroys the thread, joining it first if it wasn't joined already.
+		~Thread();
+	private:
+		PlatformInfo platformInfo;
+		bool8_t joinable;
+	};
+}
\ No newline at end of file
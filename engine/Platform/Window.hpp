@@ -41,6 +41,8 @@ namespace wfe {
 			ATOM winClassID;
 			/// @brief The handle to the window.
 			HWND hWnd;
+			/// @brief The handle to the auto-reset event that wakes the window's event wait.
+			HANDLE hWakeEvent;
 		};
 #elif defined(WFE_PLATFORM_LINUX)
 		/// @brief The game window's Linux specific info.
@@ -95,6 +97,12 @@ namespace wfe {
 
 		/// @brief Polls the window's events.
 		void PollEvents();
+		/// @brief Blocks until the window receives an event, the given timeout elapses or the window is woken, then polls the window's events.
+		/// @param timeout The maximum time to wait for, in nanoseconds, or UINT64_T_MAX to wait indefinitely. Defaulted to UINT64_T_MAX.
+		/// @return True if the window received any events, otherwise false.
+		bool8_t WaitEvents(uint64_t timeout = UINT64_T_MAX);
+		/// @brief Wakes the thread waiting for the window's events, or makes the next wait return immediately if no thread is waiting. Safe to call from any thread.
+		void Wake();
 
 		/// @brief Gets the window resize event.
 		/// @return A reference to the window resize event.
@@ -0,0 +1,30 @@
+#include <BuildInfo.hpp>
+
+#ifdef WFE_PLATFORM_WINDOWS
+
+#include "Platform/Clock.hpp"
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+namespace wfe {
+	// Public functions
+	uint64_t GetClockTime() {
+		// Get the performance counter's frequency once, as it's fixed at boot
+		static uint64_t frequency = 0;
+		if(!frequency) {
+			LARGE_INTEGER frequencyValue;
+			QueryPerformanceFrequency(&frequencyValue);
+			frequency = (uint64_t)frequencyValue.QuadPart;
+		}
+
+		// Get the performance counter's value, converting the whole seconds and the remainder separately to avoid overflowing
+		LARGE_INTEGER counter;
+		QueryPerformanceCounter(&counter);
+
+		uint64_t ticks = (uint64_t)counter.QuadPart;
+		return ticks / frequency * 1000000000 + ticks % frequency * 1000000000 / frequency;
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include <BuildInfo.hpp>
+
+#ifdef WFE_PLATFORM_WINDOWS
+
+#include "Platform/Fiber.hpp"
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+namespace wfe {
+	// Constants
+	static const size_t ERR_BUFFER_SIZE = 256;
+
+	// Internal helper functions
+	VOID WINAPI Fiber::FiberEntry(LPVOID args) {
+		// Run the fiber's function, which is stored in the fiber object passed as the fiber's parameter
+		Fiber* fiber = (Fiber*)args;
+		fiber->function(fiber->userData);
+	}
+
+	// Public functions
+	Fiber::Fiber() : function(nullptr), userData(nullptr) {
+		// Use the thread's current fiber if it was already converted, as a thread can only be converted once
+		if(IsThreadAFiber()) {
+			platformInfo.fiber = GetCurrentFiber();
+			platformInfo.convertedThread = false;
+			return;
+		}
+
+		// Convert the thread to a fiber
+		platformInfo.fiber = ConvertThreadToFiber(nullptr);
+		platformInfo.convertedThread = true;
+
+		if(!platformInfo.fiber) {
+			// Format the message
+			char_t err[ERR_BUFFER_SIZE] = "Unknown.";
+			FormatMessageA(FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS, nullptr, GetLastError(), LANG_SYSTEM_DEFAULT, err, ERR_BUFFER_SIZE, nullptr);
+
+			// Throw an exception
+			throw Exception("Failed to convert thread to Win32 fiber! Error: %s", err);
+		}
+	}
+	Fiber::Fiber(FiberFunction function, void* userData, size_t stackSize) : function(function), userData(userData) {
+		// Create the fiber, which starts at the entry function on its own stack
+		platformInfo.fiber = CreateFiber(stackSize, FiberEntry, this);
+		platformInfo.convertedThread = false;
+
+		if(!platformInfo.fiber) {
+			// Format the message
+			char_t err[ERR_BUFFER_SIZE] = "Unknown.";
+			FormatMessageA(FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS, nullptr, GetLastError(), LANG_SYSTEM_DEFAULT, err, ERR_BUFFER_SIZE, nullptr);
+
+			// Throw an exception
+			throw Exception("Failed to create Win32 fiber! Error: %s", err);
+		}
+	}
+
+	void Fiber::SwitchTo(Fiber* fiber) {
+		// Switch to the given fiber; the current fiber's state is saved by Windows
+		SwitchToFiber(fiber->platformInfo.fiber);
+	}
+
+	Fiber::~Fiber() {
+		// Convert the thread back if this fiber was created from it, otherwise delete the fiber if it has its own stack
+		if(platformInfo.convertedThread) {
+			ConvertFiberToThread();
+		} else if(function) {
+			DeleteFiber(platformInfo.fiber);
+		}
+	}
+}
+
+#endif
\ No newline at end of file
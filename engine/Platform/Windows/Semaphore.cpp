@@ -0,0 +1,63 @@
+#include <BuildInfo.hpp>
+
+#ifdef WFE_PLATFORM_WINDOWS
+
+#include "Platform/Semaphore.hpp"
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+namespace wfe {
+	// Constants
+	static const size_t ERR_BUFFER_SIZE = 256;
+	static const LONG MAX_SEMAPHORE_COUNT = 0x7fffffff;
+
+	// Public functions
+	Semaphore::Semaphore(uint32_t initialCount) {
+		// Create the semaphore
+		platformInfo.hSemaphore = CreateSemaphoreA(nullptr, (LONG)initialCount, MAX_SEMAPHORE_COUNT, nullptr);
+
+		if(!platformInfo.hSemaphore) {
+			// Format the message
+			char_t err[ERR_BUFFER_SIZE] = "Unknown.";
+			FormatMessageA(FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS, nullptr, GetLastError(), LANG_SYSTEM_DEFAULT, err, ERR_BUFFER_SIZE, nullptr);
+
+			// Throw an exception
+			throw Exception("Failed to create Win32 semaphore! Error: %s", err);
+		}
+	}
+
+	void Semaphore::Signal(uint32_t count) {
+		// Exit the function if there's nothing to signal
+		if(!count)
+			return;
+
+		// Release the semaphore by the given count
+		if(!ReleaseSemaphore(platformInfo.hSemaphore, (LONG)count, nullptr)) {
+			// Format the message
+			char_t err[ERR_BUFFER_SIZE] = "Unknown.";
+			FormatMessageA(FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS, nullptr, GetLastError(), LANG_SYSTEM_DEFAULT, err, ERR_BUFFER_SIZE, nullptr);
+
+			// Throw an exception
+			throw Exception("Failed to signal Win32 semaphore! Error: %s", err);
+		}
+	}
+	void Semaphore::Wait() {
+		// Wait for the semaphore
+		if(WaitForSingleObject(platformInfo.hSemaphore, INFINITE) == WAIT_FAILED) {
+			// Format the message
+			char_t err[ERR_BUFFER_SIZE] = "Unknown.";
+			FormatMessageA(FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS, nullptr, GetLastError(), LANG_SYSTEM_DEFAULT, err, ERR_BUFFER_SIZE, nullptr);
+
+			// Throw an exception
+			throw Exception("Failed to wait for Win32 semaphore! Error: %s", err);
+		}
+	}
+
+	Semaphore::~Semaphore() {
+		// Close the semaphore's handle
+		CloseHandle(platformInfo.hSemaphore);
+	}
+}
+
+#endif
\ No newline at end of file
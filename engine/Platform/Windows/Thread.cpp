@@ -0,0 +1,100 @@
+#include <BuildInfo.hpp>
+
+#ifdef WFE_PLATFORM_WINDOWS
+
+#include "Platform/Thread.hpp"
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+namespace wfe {
+	// Internal structs
+	struct ThreadStartInfo {
+		Thread::ThreadFunction function;
+		void* userData;
+	};
+
+	// Constants
+	static const size_t ERR_BUFFER_SIZE = 256;
+
+	// Internal helper functions
+	static DWORD WINAPI ThreadEntry(LPVOID args) {
+		// Copy the start info and free it, as it was allocated by the creating thread
+		ThreadStartInfo startInfo = *(ThreadStartInfo*)args;
+		DestroyObject((ThreadStartInfo*)args);
+
+		// Run the thread's function
+		startInfo.function(startInfo.userData);
+
+		return 0;
+	}
+
+	// Public functions
+	uint32_t Thread::GetHardwareThreadCount() {
+		// Get the number of logical processors across all processor groups
+		DWORD processorCount = GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+		if(!processorCount)
+			return 1;
+
+		return (uint32_t)processorCount;
+	}
+	void Thread::YieldCurrentThread() {
+		SwitchToThread();
+	}
+	void Thread::SleepCurrentThread(uint64_t nanoseconds) {
+		// Sleep for the given time rounded up to whole milliseconds, as that's Sleep's resolution
+		Sleep((DWORD)((nanoseconds + 999999) / 1000000));
+	}
+
+	Thread::Thread(ThreadFunction function, void* userData) : joinable(true) {
+		// Allocate the start info passed to the new thread
+		ThreadStartInfo* startInfo = NewObject<ThreadStartInfo>();
+		if(!startInfo)
+			throw BadAllocException("Failed to allocate thread start info!");
+		startInfo->function = function;
+		startInfo->userData = userData;
+
+		// Create the thread
+		platformInfo.hThread = CreateThread(nullptr, 0, ThreadEntry, startInfo, 0, nullptr);
+
+		if(!platformInfo.hThread) {
+			DestroyObject(startInfo);
+
+			// Format the message
+			char_t err[ERR_BUFFER_SIZE] = "Unknown.";
+			FormatMessageA(FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS, nullptr, GetLastError(), LANG_SYSTEM_DEFAULT, err, ERR_BUFFER_SIZE, nullptr);
+
+			// Throw an exception
+			throw Exception("Failed to create Win32 thread! Error: %s", err);
+		}
+	}
+
+	void Thread::Join() {
+		// Exit the function if the thread was already joined
+		if(!joinable)
+			return;
+
+		// Wait for the thread to exit and close its handle
+		if(WaitForSingleObject(platformInfo.hThread, INFINITE) == WAIT_FAILED) {
+			// Format the message
+			char_t err[ERR_BUFFER_SIZE] = "Unknown.";
+			FormatMessageA(FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS, nullptr, GetLastError(), LANG_SYSTEM_DEFAULT, err, ERR_BUFFER_SIZE, nullptr);
+
+			// Throw an exception
+			throw Exception("Failed to join Win32 thread! Error: %s", err);
+		}
+
+		CloseHandle(platformInfo.hThread);
+		joinable = false;
+	}
+
+	Thread::~Thread() {
+		// Join the thread if it's still running
+		if(joinable) {
+			WaitForSingleObject(platformInfo.hThread, INFINITE);
+			CloseHandle(platformInfo.hThread);
+		}
+	}
+}
+
+#endif
\ No newline at end of file
@@ -312,6 +312,18 @@ namespace wfe {
 			throw Exception("Failed to create Win32 window! Error: %s", err);
 		}
 
+		// Create the event that wakes the window's event wait
+		platformInfo.hWakeEvent = CreateEventA(nullptr, FALSE, FALSE, nullptr);
+
+		if(!platformInfo.hWakeEvent) {
+			// Format the message
+			char_t err[ERR_BUFFER_SIZE] = "Unknown.";
+			FormatMessageA(FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS, nullptr, GetLastError(), LANG_SYSTEM_DEFAULT, err, ERR_BUFFER_SIZE, nullptr);
+
+			// Throw an exception
+			throw Exception("Failed to create Win32 window wake event! Error: %s", err);
+		}
+
 		// Add the window to the map
 		windowsMutex.Lock();
 		windows.insert({ platformInfo.hWnd, { this, ProcessInternalEvent } });
@@ -347,6 +359,45 @@ namespace wfe {
 		// Begin the input manager's event management
 		inputManager.EndInputEvents();
 	}
+	bool8_t Window::WaitEvents(uint64_t timeout) {
+		// Convert the timeout to milliseconds, rounding up so that the wait never returns before the timeout
+		DWORD timeoutMs = INFINITE;
+		if(timeout != UINT64_T_MAX) {
+			uint64_t timeoutMs64 = (timeout + 999999) / 1000000;
+			timeoutMs = timeoutMs64 < INFINITE ? (DWORD)timeoutMs64 : INFINITE - 1;
+		}
+
+		// Wait for any message or for the wake event. Input that's already queued but was seen by a previous peek also ends the wait
+		DWORD result = MsgWaitForMultipleObjectsEx(1, &platformInfo.hWakeEvent, timeoutMs, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+
+		if(result == WAIT_FAILED) {
+			// Format the message
+			char_t err[ERR_BUFFER_SIZE] = "Unknown.";
+			FormatMessageA(FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS, nullptr, GetLastError(), LANG_SYSTEM_DEFAULT, err, ERR_BUFFER_SIZE, nullptr);
+
+			// Throw an exception
+			throw Exception("Failed to wait for Win32 window events! Error: %s", err);
+		}
+
+		// Check for messages queued alongside the wake event, as the wait reports only the wake event if both are signaled
+		bool8_t eventsReceived = result == WAIT_OBJECT_0 + 1 || (result == WAIT_OBJECT_0 && HIWORD(GetQueueStatus(QS_ALLINPUT)));
+
+		// Poll the received events
+		PollEvents();
+
+		return eventsReceived;
+	}
+	void Window::Wake() {
+		// Set the wake event, which stays set until the next wait consumes it
+		if(!SetEvent(platformInfo.hWakeEvent)) {
+			// Format the message
+			char_t err[ERR_BUFFER_SIZE] = "Unknown.";
+			FormatMessageA(FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS, nullptr, GetLastError(), LANG_SYSTEM_DEFAULT, err, ERR_BUFFER_SIZE, nullptr);
+
+			// Throw an exception
+			throw Exception("Failed to wake Win32 window! Error: %s", err);
+		}
+	}
 
 	void Window::SetWindowName(const string& newName) {
 		// Set the window's new name
@@ -396,8 +447,9 @@ namespace wfe {
 		windows.erase(platformInfo.hWnd);
 		windowsMutex.Unlock();
 
-		// Destroy the window
+		// Destroy the window and its wake event
 		DestroyWindow(platformInfo.hWnd);
+		CloseHandle(platformInfo.hWakeEvent);
 
 		// Unregister the window class
 		UnregisterClassA((LPCSTR)(size_t)platformInfo.winClassID, platformInfo.hInstance);
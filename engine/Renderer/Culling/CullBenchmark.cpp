@@ -0,0 +1,126 @@
+#include "CullBenchmark.hpp"
+#include "FrustumCuller.hpp"
+#include "Platform/Clock.hpp"
+
+namespace wfe {
+	// Constants
+	static const size_t CULL_OBJECT_COUNT = 1 << 20;
+	static const uint32_t RUN_COUNT = 5;
+
+#if defined(WFE_ARCH_X86)
+	static const SimdLevel BENCHMARK_SIMD_LEVELS[] { SIMD_LEVEL_SCALAR, SIMD_LEVEL_SSE2, SIMD_LEVEL_AVX2, SIMD_LEVEL_AVX512 };
+#elif defined(WFE_ARCH_ARM64)
+	static const SimdLevel BENCHMARK_SIMD_LEVELS[] { SIMD_LEVEL_SCALAR, SIMD_LEVEL_NEON };
+#else
+	static const SimdLevel BENCHMARK_SIMD_LEVELS[] { SIMD_LEVEL_SCALAR };
+#endif
+
+	// Internal helper functions
+	static uint32_t NextRandom(uint32_t& state) {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+	static float32_t NextRandomFloat(uint32_t& state, float32_t min, float32_t max) {
+		return min + (max - min) * (float32_t)(NextRandom(state) >> 8) * (1.f / (float32_t)(1 << 24));
+	}
+	static uint64_t TimeCull(const FrustumCuller* culler, const FrustumCuller::Plane* planes, uint32_t* visibleIndices, size_t& visibleCount) {
+		// Time the fastest of multiple runs, to filter out the noise of other processes
+		uint64_t bestTime = UINT64_T_MAX;
+
+		for(uint32_t run = 0; run != RUN_COUNT; ++run) {
+			uint64_t startTime = GetClockTime();
+			visibleCount = culler->Cull(planes, visibleIndices);
+			uint64_t time = GetClockTime() - startTime;
+
+			if(time < bestTime)
+				bestTime = time;
+		}
+
+		return bestTime;
+	}
+	static float64_t ComputeObjectsPerCoreSecond(uint64_t time, uint32_t threadCount) {
+		return time ? (float64_t)CULL_OBJECT_COUNT * 1e9 / ((float64_t)time * threadCount) : 0.;
+	}
+
+	// Public functions
+	bool8_t RunCullBenchmark(Logger* logger, JobSystem* jobSystem) {
+		PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
+
+		// Fill a culler on the calling thread and one on the job system with the same randomly placed spheres and boxes, so that both kernel shapes are timed
+		FrustumCuller* singleCuller = NewObject<FrustumCuller>(nullptr);
+		FrustumCuller* multiCuller = NewObject<FrustumCuller>(jobSystem);
+		uint32_t randomState = 0x9e3779b9;
+
+		for(size_t i = 0; i != CULL_OBJECT_COUNT; ++i) {
+			float32_t center[3] { NextRandomFloat(randomState, -100.f, 100.f), NextRandomFloat(randomState, -100.f, 100.f), NextRandomFloat(randomState, -100.f, 100.f) };
+			if(i & 1) {
+				float32_t extents[3] { NextRandomFloat(randomState, .1f, 2.f), NextRandomFloat(randomState, .1f, 2.f), NextRandomFloat(randomState, .1f, 2.f) };
+				singleCuller->AddBox(center, extents);
+				multiCuller->AddBox(center, extents);
+			} else {
+				float32_t radius = NextRandomFloat(randomState, .1f, 2.f);
+				singleCuller->AddSphere(center, radius);
+				multiCuller->AddSphere(center, radius);
+			}
+		}
+
+		// Look down the negative z axis with a perspective frustum, so that only part of the objects is visible
+		const Matrix4 viewProjection {{
+			{ 1.f, 0.f, 0.f, 0.f },
+			{ 0.f, 1.f, 0.f, 0.f },
+			{ 0.f, 0.f, -.5f, -1.f },
+			{ 0.f, 0.f, .5f, 0.f }
+		}};
+		FrustumCuller::Plane planes[FrustumCuller::PLANE_COUNT];
+		FrustumCuller::ExtractPlanes(viewProjection, planes);
+
+		vector<uint32_t> visibleIndices;
+		vector<uint32_t> baseVisibleIndices;
+		visibleIndices.resize(CULL_OBJECT_COUNT);
+		baseVisibleIndices.resize(CULL_OBJECT_COUNT);
+
+		uint32_t threadCount = jobSystem->GetThreadCount();
+		size_t baseVisibleCount = 0;
+		bool8_t matching = true;
+
+		for(SimdLevel simdLevel : BENCHMARK_SIMD_LEVELS) {
+			// Skip the levels the CPU doesn't support
+			if(simdLevel > GetSimdLevel())
+				continue;
+
+			singleCuller->SetSimdLevel(simdLevel);
+			multiCuller->SetSimdLevel(simdLevel);
+
+			// Cull on the calling thread, keeping the scalar kernel's visible objects as the reference
+			size_t singleVisibleCount;
+			uint64_t singleTime = TimeCull(singleCuller, planes, simdLevel == SIMD_LEVEL_SCALAR ? baseVisibleIndices.data() : visibleIndices.data(), singleVisibleCount);
+			if(simdLevel == SIMD_LEVEL_SCALAR)
+				baseVisibleCount = singleVisibleCount;
+
+			bool8_t singleMatching = singleVisibleCount == baseVisibleCount && (simdLevel == SIMD_LEVEL_SCALAR || !memcmp(visibleIndices.data(), baseVisibleIndices.data(), baseVisibleCount * sizeof(uint32_t)));
+
+			// Cull on every thread of the job system
+			size_t multiVisibleCount;
+			uint64_t multiTime = TimeCull(multiCuller, planes, visibleIndices.data(), multiVisibleCount);
+
+			bool8_t multiMatching = multiVisibleCount == baseVisibleCount && !memcmp(visibleIndices.data(), baseVisibleIndices.data(), baseVisibleCount * sizeof(uint32_t));
+
+			logger->LogInfoMessage("Cull benchmark: %s kernel on 1 thread culled %llu objects in %llu us, %.1f M objects per second per core, %llu visible.", GetSimdLevelName(simdLevel), (unsigned long long)CULL_OBJECT_COUNT, (unsigned long long)(singleTime / 1000), ComputeObjectsPerCoreSecond(singleTime, 1) * 1e-6, (unsigned long long)singleVisibleCount);
+			logger->LogInfoMessage("Cull benchmark: %s kernel on %u threads culled %llu objects in %llu us, %.1f M objects per second per core, %llu visible.", GetSimdLevelName(simdLevel), threadCount, (unsigned long long)CULL_OBJECT_COUNT, (unsigned long long)(multiTime / 1000), ComputeObjectsPerCoreSecond(multiTime, threadCount) * 1e-6, (unsigned long long)multiVisibleCount);
+
+			if(!singleMatching || !multiMatching) {
+				logger->LogErrorMessage("Cull benchmark: %s kernel's visible objects don't match the scalar kernel's!", GetSimdLevelName(simdLevel));
+				matching = false;
+			}
+		}
+
+		DestroyObject(singleCuller);
+		DestroyObject(multiCuller);
+
+		PopMemoryUsageType();
+
+		return matching;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "General/JobSystem.hpp"
+
+#include <Core.hpp>
+
+namespace wfe {
+	/// @brief Runs the frustum culler's benchmark with every SIMD level the CPU supports, culling randomly placed spheres and boxes on the calling thread and on every thread of the given job system, logging every run's time, the objects culled per second per core and whether its visible objects match the scalar kernel's.
+	/// @param logger The logger to write the results to.
+	/// @param jobSystem The job system the multithreaded culls are split between.
+	/// @return True if every kernel found the same visible objects as the scalar kernel, otherwise false.
+	bool8_t RunCullBenchmark(Logger* logger, JobSystem* jobSystem);
+}
\ No newline at end of file
@@ -0,0 +1,372 @@
+#include "FrustumCuller.hpp"
+#include "General/LinearArena.hpp"
+
+namespace wfe {
+	// Constants
+	static const size_t MIN_OBJECTS_PER_CHUNK = 1 << 14;
+
+	// Internal structs
+	struct CullInput {
+		const float32_t* centersX;
+		const float32_t* centersY;
+		const float32_t* centersZ;
+		const float32_t* radii;
+		const float32_t* extentsX;
+		const float32_t* extentsY;
+		const float32_t* extentsZ;
+
+		float32_t planesX[FrustumCuller::PLANE_COUNT];
+		float32_t planesY[FrustumCuller::PLANE_COUNT];
+		float32_t planesZ[FrustumCuller::PLANE_COUNT];
+		float32_t planeDistances[FrustumCuller::PLANE_COUNT];
+		float32_t absPlanesX[FrustumCuller::PLANE_COUNT];
+		float32_t absPlanesY[FrustumCuller::PLANE_COUNT];
+		float32_t absPlanesZ[FrustumCuller::PLANE_COUNT];
+	};
+
+	typedef size_t(*CullKernel)(const CullInput& input, size_t begin, size_t end, uint32_t* visibleIndices);
+
+	struct CullContext {
+		const CullInput* input;
+		CullKernel kernel;
+		size_t objectCount;
+		size_t chunkCount;
+		uint32_t* visibleIndices;
+		size_t* visibleCounts;
+	};
+
+	// Internal helper functions
+	static uint32_t CountTrailingZeros(uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return (uint32_t)index;
+#else
+		return (uint32_t)__builtin_ctz(mask);
+#endif
+	}
+	static size_t WriteVisibleIndices(uint32_t mask, uint32_t baseIndex, uint32_t* visibleIndices) {
+		// Write the index of every set bit in the visibility mask
+		size_t visibleCount = 0;
+		while(mask) {
+			visibleIndices[visibleCount++] = baseIndex + CountTrailingZeros(mask);
+			mask &= mask - 1;
+		}
+
+		return visibleCount;
+	}
+
+	static size_t CullRangeScalar(const CullInput& input, size_t begin, size_t end, uint32_t* visibleIndices) {
+		size_t visibleCount = 0;
+
+		for(size_t index = begin; index != end; ++index) {
+			// An object is outside the frustum if it's fully behind any plane; boxes are tested using their projected radius on the plane's normal
+			bool8_t visible = true;
+			for(size_t i = 0; i != FrustumCuller::PLANE_COUNT; ++i) {
+				float32_t distance = (input.centersX[index] * input.planesX[i] + input.centersY[index] * input.planesY[i]) + (input.centersZ[index] * input.planesZ[i] + input.planeDistances[i]);
+				float32_t radius = ((input.radii[index] + input.extentsX[index] * input.absPlanesX[i]) + input.extentsY[index] * input.absPlanesY[i]) + input.extentsZ[index] * input.absPlanesZ[i];
+				visible &= distance + radius >= 0.f;
+			}
+
+			if(visible)
+				visibleIndices[visibleCount++] = (uint32_t)index;
+		}
+
+		return visibleCount;
+	}
+#if defined(WFE_ARCH_X86)
+	static size_t CullRangeSse2(const CullInput& input, size_t begin, size_t end, uint32_t* visibleIndices) {
+		size_t visibleCount = 0;
+		size_t index = begin;
+		__m128 zero = _mm_setzero_ps();
+
+		// Test 4 objects per iteration
+		for(; index + 4 <= end; index += 4) {
+			__m128 centerX = _mm_loadu_ps(input.centersX + index);
+			__m128 centerY = _mm_loadu_ps(input.centersY + index);
+			__m128 centerZ = _mm_loadu_ps(input.centersZ + index);
+			__m128 radius = _mm_loadu_ps(input.radii + index);
+			__m128 extentX = _mm_loadu_ps(input.extentsX + index);
+			__m128 extentY = _mm_loadu_ps(input.extentsY + index);
+			__m128 extentZ = _mm_loadu_ps(input.extentsZ + index);
+
+			__m128 visible = _mm_cmpeq_ps(zero, zero);
+			for(size_t i = 0; i != FrustumCuller::PLANE_COUNT; ++i) {
+				__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(centerX, _mm_set1_ps(input.planesX[i])), _mm_mul_ps(centerY, _mm_set1_ps(input.planesY[i]))), _mm_add_ps(_mm_mul_ps(centerZ, _mm_set1_ps(input.planesZ[i])), _mm_set1_ps(input.planeDistances[i])));
+				__m128 projectedRadius = _mm_add_ps(_mm_add_ps(_mm_add_ps(radius, _mm_mul_ps(extentX, _mm_set1_ps(input.absPlanesX[i]))), _mm_mul_ps(extentY, _mm_set1_ps(input.absPlanesY[i]))), _mm_mul_ps(extentZ, _mm_set1_ps(input.absPlanesZ[i])));
+				visible = _mm_and_ps(visible, _mm_cmpge_ps(_mm_add_ps(distance, projectedRadius), zero));
+			}
+
+			visibleCount += WriteVisibleIndices((uint32_t)_mm_movemask_ps(visible), (uint32_t)index, visibleIndices + visibleCount);
+		}
+
+		// Test the remaining objects one at a time
+		return visibleCount + CullRangeScalar(input, index, end, visibleIndices + visibleCount);
+	}
+	WFE_TARGET("avx2") static size_t CullRangeAvx2(const CullInput& input, size_t begin, size_t end, uint32_t* visibleIndices) {
+		size_t visibleCount = 0;
+		size_t index = begin;
+		__m256 zero = _mm256_setzero_ps();
+
+		// Test 8 objects per iteration
+		for(; index + 8 <= end; index += 8) {
+			__m256 centerX = _mm256_loadu_ps(input.centersX + index);
+			__m256 centerY = _mm256_loadu_ps(input.centersY + index);
+			__m256 centerZ = _mm256_loadu_ps(input.centersZ + index);
+			__m256 radius = _mm256_loadu_ps(input.radii + index);
+			__m256 extentX = _mm256_loadu_ps(input.extentsX + index);
+			__m256 extentY = _mm256_loadu_ps(input.extentsY + index);
+			__m256 extentZ = _mm256_loadu_ps(input.extentsZ + index);
+
+			__m256 visible = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ);
+			for(size_t i = 0; i != FrustumCuller::PLANE_COUNT; ++i) {
+				__m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(centerX, _mm256_broadcast_ss(input.planesX + i)), _mm256_mul_ps(centerY, _mm256_broadcast_ss(input.planesY + i))), _mm256_add_ps(_mm256_mul_ps(centerZ, _mm256_broadcast_ss(input.planesZ + i)), _mm256_broadcast_ss(input.planeDistances + i)));
+				__m256 projectedRadius = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(radius, _mm256_mul_ps(extentX, _mm256_broadcast_ss(input.absPlanesX + i))), _mm256_mul_ps(extentY, _mm256_broadcast_ss(input.absPlanesY + i))), _mm256_mul_ps(extentZ, _mm256_broadcast_ss(input.absPlanesZ + i)));
+				visible = _mm256_and_ps(visible, _mm256_cmp_ps(_mm256_add_ps(distance, projectedRadius), zero, _CMP_GE_OQ));
+			}
+
+			visibleCount += WriteVisibleIndices((uint32_t)_mm256_movemask_ps(visible), (uint32_t)index, visibleIndices + visibleCount);
+		}
+
+		// Test the remaining objects one at a time
+		return visibleCount + CullRangeScalar(input, index, end, visibleIndices + visibleCount);
+	}
+	WFE_TARGET("avx512f") static size_t CullRangeAvx512(const CullInput& input, size_t begin, size_t end, uint32_t* visibleIndices) {
+		size_t visibleCount = 0;
+		size_t index = begin;
+		__m512 zero = _mm512_setzero_ps();
+
+		// Test 16 objects per iteration
+		for(; index + 16 <= end; index += 16) {
+			__m512 centerX = _mm512_loadu_ps(input.centersX + index);
+			__m512 centerY = _mm512_loadu_ps(input.centersY + index);
+			__m512 centerZ = _mm512_loadu_ps(input.centersZ + index);
+			__m512 radius = _mm512_loadu_ps(input.radii + index);
+			__m512 extentX = _mm512_loadu_ps(input.extentsX + index);
+			__m512 extentY = _mm512_loadu_ps(input.extentsY + index);
+			__m512 extentZ = _mm512_loadu_ps(input.extentsZ + index);
+
+			__mmask16 visible = 0xffff;
+			for(size_t i = 0; i != FrustumCuller::PLANE_COUNT; ++i) {
+				__m512 distance = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(centerX, _mm512_set1_ps(input.planesX[i])), _mm512_mul_ps(centerY, _mm512_set1_ps(input.planesY[i]))), _mm512_add_ps(_mm512_mul_ps(centerZ, _mm512_set1_ps(input.planesZ[i])), _mm512_set1_ps(input.planeDistances[i])));
+				__m512 projectedRadius = _mm512_add_ps(_mm512_add_ps(_mm512_add_ps(radius, _mm512_mul_ps(extentX, _mm512_set1_ps(input.absPlanesX[i]))), _mm512_mul_ps(extentY, _mm512_set1_ps(input.absPlanesY[i]))), _mm512_mul_ps(extentZ, _mm512_set1_ps(input.absPlanesZ[i])));
+				visible = _mm512_mask_cmp_ps_mask(visible, _mm512_add_ps(distance, projectedRadius), zero, _CMP_GE_OQ);
+			}
+
+			visibleCount += WriteVisibleIndices((uint32_t)visible, (uint32_t)index, visibleIndices + visibleCount);
+		}
+
+		// Test the remaining objects one at a time
+		return visibleCount + CullRangeScalar(input, index, end, visibleIndices + visibleCount);
+	}
+#elif defined(WFE_ARCH_ARM64)
+	static size_t CullRangeNeon(const CullInput& input, size_t begin, size_t end, uint32_t* visibleIndices) {
+		static const uint32_t LANE_BITS[4] = { 1, 2, 4, 8 };
+
+		size_t visibleCount = 0;
+		size_t index = begin;
+		float32x4_t zero = vdupq_n_f32(0.f);
+		uint32x4_t laneBits = vld1q_u32(LANE_BITS);
+
+		// Test 4 objects per iteration
+		for(; index + 4 <= end; index += 4) {
+			float32x4_t centerX = vld1q_f32(input.centersX + index);
+			float32x4_t centerY = vld1q_f32(input.centersY + index);
+			float32x4_t centerZ = vld1q_f32(input.centersZ + index);
+			float32x4_t radius = vld1q_f32(input.radii + index);
+			float32x4_t extentX = vld1q_f32(input.extentsX + index);
+			float32x4_t extentY = vld1q_f32(input.extentsY + index);
+			float32x4_t extentZ = vld1q_f32(input.extentsZ + index);
+
+			uint32x4_t visible = vdupq_n_u32(UINT32_T_MAX);
+			for(size_t i = 0; i != FrustumCuller::PLANE_COUNT; ++i) {
+				float32x4_t distance = vaddq_f32(vaddq_f32(vmulq_n_f32(centerX, input.planesX[i]), vmulq_n_f32(centerY, input.planesY[i])), vaddq_f32(vmulq_n_f32(centerZ, input.planesZ[i]), vdupq_n_f32(input.planeDistances[i])));
+				float32x4_t projectedRadius = vaddq_f32(vaddq_f32(vaddq_f32(radius, vmulq_n_f32(extentX, input.absPlanesX[i])), vmulq_n_f32(extentY, input.absPlanesY[i])), vmulq_n_f32(extentZ, input.absPlanesZ[i]));
+				visible = vandq_u32(visible, vcgeq_f32(vaddq_f32(distance, projectedRadius), zero));
+			}
+
+			visibleCount += WriteVisibleIndices(vaddvq_u32(vandq_u32(visible, laneBits)), (uint32_t)index, visibleIndices + visibleCount);
+		}
+
+		// Test the remaining objects one at a time
+		return visibleCount + CullRangeScalar(input, index, end, visibleIndices + visibleCount);
+	}
+#endif
+	static CullKernel GetCullKernel(SimdLevel simdLevel) {
+		switch(simdLevel) {
+#if defined(WFE_ARCH_X86)
+		case SIMD_LEVEL_SSE2:
+			return CullRangeSse2;
+		case SIMD_LEVEL_AVX2:
+			return CullRangeAvx2;
+		case SIMD_LEVEL_AVX512:
+			return CullRangeAvx512;
+#elif defined(WFE_ARCH_ARM64)
+		case SIMD_LEVEL_NEON:
+			return CullRangeNeon;
+#endif
+		default:
+			return CullRangeScalar;
+		}
+	}
+	static void CullChunks(void* userData, size_t beginChunk, size_t endChunk) {
+		CullContext* context = (CullContext*)userData;
+
+		for(size_t chunk = beginChunk; chunk != endChunk; ++chunk) {
+			// Cull the chunk's range, writing its visible indices at the start of the range
+			size_t begin = context->objectCount * chunk / context->chunkCount;
+			size_t end = context->objectCount * (chunk + 1) / context->chunkCount;
+
+			context->visibleCounts[chunk] = context->kernel(*context->input, begin, end, context->visibleIndices + begin);
+		}
+	}
+
+	// Public functions
+	void FrustumCuller::ExtractPlanes(const Matrix4& viewProjection, Plane* planes) {
+		// Extract the planes from the matrix's rows, using Vulkan's [0, 1] depth range
+		Matrix4 rows = Transpose(viewProjection);
+		const Vector4 planeValues[PLANE_COUNT] = {
+			rows.columns[3] + rows.columns[0],
+			rows.columns[3] - rows.columns[0],
+			rows.columns[3] + rows.columns[1],
+			rows.columns[3] - rows.columns[1],
+			rows.columns[2],
+			rows.columns[3] - rows.columns[2]
+		};
+
+		// Normalize the planes, so that distances to them are in world units
+		for(size_t i = 0; i != PLANE_COUNT; ++i) {
+			Vector3 normal { planeValues[i].x, planeValues[i].y, planeValues[i].z };
+			float32_t length = Length(normal);
+			float32_t invLength = length > 0.f ? 1.f / length : 0.f;
+
+			normal = normal * invLength;
+			planes[i].normal[0] = normal.x;
+			planes[i].normal[1] = normal.y;
+			planes[i].normal[2] = normal.z;
+			planes[i].distance = planeValues[i].w * invLength;
+		}
+	}
+
+	FrustumCuller::FrustumCuller(JobSystem* jobSystem) : simdLevel(wfe::GetSimdLevel()), jobSystem(jobSystem) { }
+
+	uint32_t FrustumCuller::AddSphere(const float32_t* center, float32_t radius) {
+		// Add the sphere as a box with no extents
+		uint32_t index = (uint32_t)radii.size();
+
+		centersX.push_back(center[0]);
+		centersY.push_back(center[1]);
+		centersZ.push_back(center[2]);
+		radii.push_back(radius);
+		extentsX.push_back(0.f);
+		extentsY.push_back(0.f);
+		extentsZ.push_back(0.f);
+
+		return index;
+	}
+	uint32_t FrustumCuller::AddBox(const float32_t* center, const float32_t* extents) {
+		// Add the box with no radius
+		uint32_t index = (uint32_t)radii.size();
+
+		centersX.push_back(center[0]);
+		centersY.push_back(center[1]);
+		centersZ.push_back(center[2]);
+		radii.push_back(0.f);
+		extentsX.push_back(extents[0]);
+		extentsY.push_back(extents[1]);
+		extentsZ.push_back(extents[2]);
+
+		return index;
+	}
+	void FrustumCuller::SetSphere(uint32_t index, const float32_t* center, float32_t radius) {
+		centersX[index] = center[0];
+		centersY[index] = center[1];
+		centersZ[index] = center[2];
+		radii[index] = radius;
+		extentsX[index] = 0.f;
+		extentsY[index] = 0.f;
+		extentsZ[index] = 0.f;
+	}
+	void FrustumCuller::SetBox(uint32_t index, const float32_t* center, const float32_t* extents) {
+		centersX[index] = center[0];
+		centersY[index] = center[1];
+		centersZ[index] = center[2];
+		radii[index] = 0.f;
+		extentsX[index] = extents[0];
+		extentsY[index] = extents[1];
+		extentsZ[index] = extents[2];
+	}
+	void FrustumCuller::Resize(size_t objectCount) {
+		// Resize every bounding volume array
+		centersX.resize(objectCount);
+		centersY.resize(objectCount);
+		centersZ.resize(objectCount);
+		radii.resize(objectCount);
+		extentsX.resize(objectCount);
+		extentsY.resize(objectCount);
+		extentsZ.resize(objectCount);
+	}
+	size_t FrustumCuller::Cull(const Plane* planes, uint32_t* visibleIndices) const {
+		// Exit the function if there's nothing to cull
+		size_t objectCount = radii.size();
+		if(!objectCount)
+			return 0;
+
+		// Set the kernel's input, splatting the planes into arrays of their components
+		CullInput input;
+		input.centersX = centersX.data();
+		input.centersY = centersY.data();
+		input.centersZ = centersZ.data();
+		input.radii = radii.data();
+		input.extentsX = extentsX.data();
+		input.extentsY = extentsY.data();
+		input.extentsZ = extentsZ.data();
+
+		for(size_t i = 0; i != PLANE_COUNT; ++i) {
+			input.planesX[i] = planes[i].normal[0];
+			input.planesY[i] = planes[i].normal[1];
+			input.planesZ[i] = planes[i].normal[2];
+			input.planeDistances[i] = planes[i].distance;
+			input.absPlanesX[i] = fabsf(planes[i].normal[0]);
+			input.absPlanesY[i] = fabsf(planes[i].normal[1]);
+			input.absPlanesZ[i] = fabsf(planes[i].normal[2]);
+		}
+
+		CullKernel kernel = GetCullKernel(simdLevel);
+
+		// Only split the objects into as many chunks as it takes for the per-chunk work to outweigh the synchronization
+		size_t chunkCount = jobSystem ? jobSystem->GetThreadCount() : 1;
+		size_t maxChunkCount = objectCount / MIN_OBJECTS_PER_CHUNK;
+		if(chunkCount > maxChunkCount)
+			chunkCount = maxChunkCount ? maxChunkCount : 1;
+
+		if(chunkCount == 1)
+			return kernel(input, 0, objectCount, visibleIndices);
+
+		// Cull every chunk on the job system, counting every chunk's visible objects in scratch memory
+		ScratchScope scratch;
+		size_t* visibleCounts = (size_t*)scratch.Allocate(chunkCount * sizeof(size_t), alignof(size_t));
+
+		CullContext context { &input, kernel, objectCount, chunkCount, visibleIndices, visibleCounts };
+		jobSystem->ParallelFor(chunkCount, 1, CullChunks, &context);
+
+		// Move every chunk's visible indices right after the previous chunk's
+		size_t visibleCount = visibleCounts[0];
+		for(size_t i = 1; i != chunkCount; ++i) {
+			memmove(visibleIndices + visibleCount, visibleIndices + objectCount * i / chunkCount, visibleCounts[i] * sizeof(uint32_t));
+			visibleCount += visibleCounts[i];
+		}
+
+		return visibleCount;
+	}
+	void FrustumCuller::Clear() {
+		// Clear every bounding volume array
+		centersX.clear();
+		centersY.clear();
+		centersZ.clear();
+		radii.clear();
+		extentsX.clear();
+		extentsY.clear();
+		extentsZ.clear();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "General/CpuInfo.hpp"
+#include "General/JobSystem.hpp"
+#include "Math/Matrix.hpp"
+
+#include <Core.hpp>
+
+namespace wfe {
+	/// @brief A CPU frustum culler, which stores its objects' bounding volumes as a structure of arrays and tests multiple objects at once with the most capable available SIMD instruction set.
+	class FrustumCuller {
+	public:
+		/// @brief The number of planes in a frustum.
+		static const size_t PLANE_COUNT = 6;
+
+		/// @brief A struct containing a normalized plane, where points with a non-negative signed distance are inside.
+		struct Plane {
+			/// @brief The plane's unit-length normal, pointing inside the frustum.
+			float32_t normal[3];
+			/// @brief The plane's signed distance from the origin.
+			float32_t distance;
+		};
+
+		/// @brief Extracts the normalized frustum planes from the given view projection matrix.
+		/// @param viewProjection The column-major view projection matrix, which maps depth to Vulkan's [0, 1] range.
+		/// @param planes The array of PLANE_COUNT planes in which the frustum planes will be written.
+		static void ExtractPlanes(const Matrix4& viewProjection, Plane* planes);
+
+		/// @brief Creates a frustum culler.
+		/// @param jobSystem The job system used to split large culls between threads, or nullptr to cull on the calling thread.
+		FrustumCuller(JobSystem* jobSystem);
+		FrustumCuller(const FrustumCuller&) = delete;
+		FrustumCuller(FrustumCuller&&) noexcept = delete;
+
+		FrustumCuller& operator=(const FrustumCuller&) = delete;
+		FrustumCuller& operator=(FrustumCuller&&) = delete;
+
+		/// @brief Gets the SIMD level of the culling kernel chosen for the current CPU.
+		/// @return The culling kernel's SIMD level.
+		SimdLevel GetSimdLevel() const {
+			return simdLevel;
+		}
+		/// @brief Sets the SIMD level of the culling kernel, overriding the level chosen for the current CPU, for instance to compare kernels.
+		/// @param simdLevel The culling kernel's new SIMD level, which the CPU must support.
+		void SetSimdLevel(SimdLevel simdLevel) {
+			this->simdLevel = simdLevel;
+		}
+		/// @brief Gets the job system used to split large culls between threads.
+		/// @return A pointer to the job system, or nullptr if culls run on the calling thread.
+		JobSystem* GetJobSystem() const {
+			return jobSystem;
+		}
+		/// @brief Gets the number of objects added since the culler was last cleared.
+		/// @return The culler's object count.
+		size_t GetObjectCount() const {
+			return radii.size();
+		}
+
+		/// @brief Adds an object bounded by a sphere to the culler.
+		/// @param center The sphere's center.
+		/// @param radius The sphere's radius.
+		/// @return The object's index, which is written to the visible indices when the object passes the cull.
+		uint32_t AddSphere(const float32_t* center, float32_t radius);
+		/// @brief Adds an object bounded by an axis-aligned box to the culler.
+		/// @param center The box's center.
+		/// @param extents The box's half size on every axis.
+		/// @return The object's index, which is written to the visible indices when the object passes the cull.
+		uint32_t AddBox(const float32_t* center, const float32_t* extents);
+		/// @brief Replaces the given object's bounding volume with a sphere.
+		/// @param index The object's index.
+		/// @param center The sphere's center.
+		/// @param radius The sphere's radius.
+		void SetSphere(uint32_t index, const float32_t* center, float32_t radius);
+		/// @brief Replaces the given object's bounding volume with an axis-aligned box.
+		/// @param index The object's index.
+		/// @param center The box's center.
+		/// @param extents The box's half size on every axis.
+		void SetBox(uint32_t index, const float32_t* center, const float32_t* extents);
+		/// @brief Resizes the culler to the given object count, so that the objects' bounding volumes can be set in place, from multiple threads if needed. Added objects are empty spheres at the origin.
+		/// @param objectCount The culler's new object count.
+		void Resize(size_t objectCount);
+		/// @brief Culls every object against the given frustum, splitting large object counts between the job system's threads.
+		/// @param planes The array of PLANE_COUNT frustum planes, usually extracted using ExtractPlanes.
+		/// @param visibleIndices The array in which the indices of the visible objects will be written, in ascending order. Must have room for every object.
+		/// @return The number of visible objects.
+		size_t Cull(const Plane* planes, uint32_t* visibleIndices) const;
+		/// @brief Removes every object from the culler, keeping its memory.
+		void Clear();
+
+		/// @brief Destroys the frustum culler.
+		~FrustumCuller() = default;
+	private:
+		SimdLevel simdLevel;
+		JobSystem* jobSystem;
+
+		vector<float32_t> centersX;
+		vector<float32_t> centersY;
+		vector<float32_t> centersZ;
+		vector<float32_t> radii;
+		vector<float32_t> extentsX;
+		vector<float32_t> extentsY;
+		vector<float32_t> extentsZ;
+	};
+}
\ No newline at end of file
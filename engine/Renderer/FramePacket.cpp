@@ -0,0 +1,56 @@
+#include "FramePacket.hpp"
+
+namespace wfe {
+	// Public functions
+	FramePacket::FramePacket(size_t blockSize) : arena(blockSize), camera{}, previousCamera{}, draws(nullptr), drawCount(0), meshInstances(nullptr), meshInstanceCount(0), lights(nullptr), lightCount(0) { }
+
+	FramePacket::Camera FramePacket::GetInterpolatedCamera(float32_t factor) const {
+		Camera interpolated;
+		for(size_t i = 0; i != 4; ++i)
+			interpolated.viewProjection.columns[i] = Lerp(previousCamera.viewProjection.columns[i], camera.viewProjection.columns[i], factor);
+		interpolated.position = Lerp(previousCamera.position, camera.position, factor);
+
+		return interpolated;
+	}
+	VulkanDrawQueue::InstanceTransform FramePacket::GetInterpolatedTransform(size_t index, float32_t factor) const {
+		const MeshInstance& instance = meshInstances[index];
+
+		VulkanDrawQueue::InstanceTransform interpolated;
+		for(size_t i = 0; i != 3; ++i)
+			for(size_t j = 0; j != 4; ++j)
+				interpolated.rows[i][j] = instance.previousTransform.rows[i][j] + (instance.transform.rows[i][j] - instance.previousTransform.rows[i][j]) * factor;
+
+		return interpolated;
+	}
+
+	VulkanDrawQueue::Draw* FramePacket::AllocateDraws(size_t count) {
+		draws = (VulkanDrawQueue::Draw*)Allocate(count * sizeof(VulkanDrawQueue::Draw), alignof(VulkanDrawQueue::Draw));
+		drawCount = count;
+
+		return draws;
+	}
+	FramePacket::MeshInstance* FramePacket::AllocateMeshInstances(size_t count) {
+		meshInstances = (MeshInstance*)Allocate(count * sizeof(MeshInstance), alignof(MeshInstance));
+		meshInstanceCount = count;
+
+		return meshInstances;
+	}
+	FramePacket::Light* FramePacket::AllocateLights(size_t count) {
+		lights = (Light*)Allocate(count * sizeof(Light), alignof(Light));
+		lightCount = count;
+
+		return lights;
+	}
+	void FramePacket::Reset() {
+		arena.Reset();
+
+		camera = {};
+		previousCamera = {};
+		draws = nullptr;
+		drawCount = 0;
+		meshInstances = nullptr;
+		meshInstanceCount = 0;
+		lights = nullptr;
+		lightCount = 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "General/LinearArena.hpp"
+#include "Math/Matrix.hpp"
+#include "Renderer/Vulkan/Draw/VulkanDrawQueue.hpp"
+
+#include <Core.hpp>
+
+namespace wfe {
+	/// @brief A compact copy of the render-relevant state of a single simulation tick, built by the simulation thread and consumed by the render thread without touching live game state. The packet also holds the camera and the instance transforms of the tick before, so that frames rendered between two ticks can blend them. All of the packet's arrays are carved out of a linear allocator, which is rewound when the packet is reset and keeps its memory between ticks.
+	class FramePacket {
+	public:
+		/// @brief A struct containing the camera the packet's instances are culled and sorted for.
+		struct Camera {
+			/// @brief The camera's view projection matrix, which maps depth to Vulkan's [0, 1] range.
+			Matrix4 viewProjection;
+			/// @brief The camera's world position.
+			Vector3 position;
+		};
+		/// @brief A struct containing a visible mesh instance.
+		struct MeshInstance {
+			/// @brief The instance's draw queue sort key.
+			uint64_t sortKey;
+			/// @brief The index of the instance's draw state in the packet's draws.
+			uint32_t drawIndex;
+			/// @brief The instance's object to world transform.
+			VulkanDrawQueue::InstanceTransform transform;
+			/// @brief The instance's object to world transform as of the previous tick, or its current transform if it didn't exist back then.
+			VulkanDrawQueue::InstanceTransform previousTransform;
+			/// @brief The instance's world space bounding sphere, with the center in xyz and the radius in w, used to cull the instance on the GPU.
+			float32_t boundingSphere[4];
+		};
+		/// @brief A struct containing a point light.
+		struct Light {
+			/// @brief The light's world position.
+			float32_t position[3];
+			/// @brief The distance at which the light's contribution reaches 0.
+			float32_t radius;
+			/// @brief The light's linear color.
+			float32_t color[3];
+			/// @brief The light's intensity, which scales its color.
+			float32_t intensity;
+		};
+
+		/// @brief Creates an empty frame packet.
+		/// @param blockSize The size of the packet's first memory block. Defaulted to LinearArena::DEFAULT_BLOCK_SIZE.
+		FramePacket(size_t blockSize = LinearArena::DEFAULT_BLOCK_SIZE);
+		FramePacket(const FramePacket&) = delete;
+		FramePacket(FramePacket&&) noexcept = delete;
+
+		FramePacket& operator=(const FramePacket&) = delete;
+		FramePacket& operator=(FramePacket&&) = delete;
+
+		/// @brief Gets the packet's camera.
+		/// @return A const reference to the camera struct.
+		const Camera& GetCamera() const {
+			return camera;
+		}
+		/// @brief Sets the packet's camera.
+		/// @param newCamera The new camera.
+		void SetCamera(const Camera& newCamera) {
+			camera = newCamera;
+		}
+		/// @brief Gets the packet's camera as of the previous tick.
+		/// @return A const reference to the previous camera struct.
+		const Camera& GetPreviousCamera() const {
+			return previousCamera;
+		}
+		/// @brief Sets the packet's camera as of the previous tick.
+		/// @param newPreviousCamera The new previous camera.
+		void SetPreviousCamera(const Camera& newPreviousCamera) {
+			previousCamera = newPreviousCamera;
+		}
+		/// @brief Gets the draw states referenced by the packet's mesh instances.
+		/// @return A const pointer to the packet's draws.
+		const VulkanDrawQueue::Draw* GetDraws() const {
+			return draws;
+		}
+		/// @brief Gets the number of draw states in the packet.
+		/// @return The packet's draw count.
+		size_t GetDrawCount() const {
+			return drawCount;
+		}
+		/// @brief Gets the packet's visible mesh instances.
+		/// @return A const pointer to the packet's mesh instances.
+		const MeshInstance* GetMeshInstances() const {
+			return meshInstances;
+		}
+		/// @brief Gets the number of visible mesh instances in the packet.
+		/// @return The packet's mesh instance count.
+		size_t GetMeshInstanceCount() const {
+			return meshInstanceCount;
+		}
+		/// @brief Gets the packet's lights.
+		/// @return A const pointer to the packet's lights.
+		const Light* GetLights() const {
+			return lights;
+		}
+		/// @brief Gets the number of lights in the packet.
+		/// @return The packet's light count.
+		size_t GetLightCount() const {
+			return lightCount;
+		}
+		/// @brief Gets the number of bytes allocated since the packet was last reset.
+		/// @return The packet's allocated size.
+		size_t GetAllocatedSize() const {
+			return arena.GetAllocatedSize();
+		}
+
+		/// @brief Blends the packet's previous and current cameras. The view projection matrices are blended element-wise, which is close enough to blending the view itself over a single tick.
+		/// @param factor The interpolation factor, where 0 gives the previous camera and 1 gives the current one.
+		/// @return The interpolated camera.
+		Camera GetInterpolatedCamera(float32_t factor) const;
+		/// @brief Blends the previous and current transforms of one of the packet's mesh instances element-wise.
+		/// @param index The index of the mesh instance.
+		/// @param factor The interpolation factor, where 0 gives the previous transform and 1 gives the current one.
+		/// @return The interpolated transform.
+		VulkanDrawQueue::InstanceTransform GetInterpolatedTransform(size_t index, float32_t factor) const;
+
+		/// @brief Allocates memory from the packet's linear allocator, which stays valid until the packet is reset.
+		/// @param size The size of the allocation.
+		/// @param alignment The alignment of the allocation, which must be a power of 2.
+		/// @return A pointer to the allocated memory.
+		void* Allocate(size_t size, size_t alignment) {
+			return arena.Allocate(size, alignment);
+		}
+		/// @brief Allocates the packet's draw state array, replacing any previously allocated one.
+		/// @param count The number of draw states.
+		/// @return A pointer to the uninitialized draw states.
+		VulkanDrawQueue::Draw* AllocateDraws(size_t count);
+		/// @brief Allocates the packet's mesh instance array, replacing any previously allocated one.
+		/// @param count The number of mesh instances.
+		/// @return A pointer to the uninitialized mesh instances.
+		MeshInstance* AllocateMeshInstances(size_t count);
+		/// @brief Allocates the packet's light array, replacing any previously allocated one.
+		/// @param count The number of lights.
+		/// @return A pointer to the uninitialized lights.
+		Light* AllocateLights(size_t count);
+		/// @brief Empties the packet, resetting its linear allocator.
+		void Reset();
+
+		/// @brief Destroys the frame packet.
+		~FramePacket() = default;
+	private:
+		LinearArena arena;
+
+		Camera camera;
+		Camera previousCamera;
+		VulkanDrawQueue::Draw* draws;
+		size_t drawCount;
+		MeshInstance* meshInstances;
+		size_t meshInstanceCount;
+		Light* lights;
+		size_t lightCount;
+	};
+}
\ No newline at end of file
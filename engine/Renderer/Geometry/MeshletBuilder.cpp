@@ -0,0 +1,182 @@
+#include "MeshletBuilder.hpp"
+
+#include <float.h>
+#include <math.h>
+
+namespace wfe {
+	// Constants
+	static const float32_t MIN_CONE_DOT = .1f;
+
+	// Internal helper functions
+	static const float32_t* GetPosition(const float32_t* positions, size_t positionStride, uint32_t index) {
+		return (const float32_t*)((const uint8_t*)positions + index * positionStride);
+	}
+
+	void MeshletBuilder::FinishMeshlet(const float32_t* positions, size_t positionStride) {
+		Meshlet& meshlet = meshlets.back();
+		const uint32_t* vertices = meshletVertices.data() + meshlet.vertexOffset;
+		const uint32_t* triangles = meshletTriangles.data() + meshlet.triangleOffset;
+
+		// Reset the local indices of the meshlet's vertices for the next meshlet
+		for(uint32_t i = 0; i != meshlet.vertexCount; ++i)
+			localIndices[vertices[i]] = UINT32_T_MAX;
+
+		// Bound the meshlet's vertices with a sphere centered on their bounding box
+		float32_t minPosition[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+		float32_t maxPosition[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+		for(uint32_t i = 0; i != meshlet.vertexCount; ++i) {
+			const float32_t* position = GetPosition(positions, positionStride, vertices[i]);
+			for(uint32_t j = 0; j != 3; ++j) {
+				minPosition[j] = fminf(minPosition[j], position[j]);
+				maxPosition[j] = fmaxf(maxPosition[j], position[j]);
+			}
+		}
+
+		float32_t radiusSquared = 0.f;
+		for(uint32_t j = 0; j != 3; ++j)
+			meshlet.center[j] = (minPosition[j] + maxPosition[j]) * .5f;
+
+		for(uint32_t i = 0; i != meshlet.vertexCount; ++i) {
+			const float32_t* position = GetPosition(positions, positionStride, vertices[i]);
+			float32_t offset[3] = { position[0] - meshlet.center[0], position[1] - meshlet.center[1], position[2] - meshlet.center[2] };
+			radiusSquared = fmaxf(radiusSquared, offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2]);
+		}
+
+		meshlet.radius = sqrtf(radiusSquared);
+
+		// Disable cone culling until a valid cone is found
+		memcpy(meshlet.coneApex, meshlet.center, sizeof(meshlet.coneApex));
+		memset(meshlet.coneAxis, 0, sizeof(meshlet.coneAxis));
+		meshlet.coneCutoff = 1.f;
+
+		// Calculate every triangle's unit normal and sum them to get the cone's axis, skipping triangles with no area
+		float32_t normals[MAX_TRIANGLE_COUNT][3];
+		float32_t axis[3] = { 0.f, 0.f, 0.f };
+
+		for(uint32_t i = 0; i != meshlet.triangleCount; ++i) {
+			const float32_t* position0 = GetPosition(positions, positionStride, vertices[triangles[i] & 0xff]);
+			const float32_t* position1 = GetPosition(positions, positionStride, vertices[(triangles[i] >> 8) & 0xff]);
+			const float32_t* position2 = GetPosition(positions, positionStride, vertices[(triangles[i] >> 16) & 0xff]);
+
+			float32_t edge0[3] = { position1[0] - position0[0], position1[1] - position0[1], position1[2] - position0[2] };
+			float32_t edge1[3] = { position2[0] - position0[0], position2[1] - position0[1], position2[2] - position0[2] };
+			float32_t* normal = normals[i];
+			normal[0] = edge0[1] * edge1[2] - edge0[2] * edge1[1];
+			normal[1] = edge0[2] * edge1[0] - edge0[0] * edge1[2];
+			normal[2] = edge0[0] * edge1[1] - edge0[1] * edge1[0];
+
+			float32_t length = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+			if(length == 0.f)
+				continue;
+
+			for(uint32_t j = 0; j != 3; ++j) {
+				normal[j] /= length;
+				axis[j] += normal[j];
+			}
+		}
+
+		float32_t axisLength = sqrtf(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+		if(axisLength == 0.f)
+			return;
+
+		for(uint32_t j = 0; j != 3; ++j)
+			axis[j] /= axisLength;
+
+		// Find the largest angle between the axis and a normal, skipping the cone if the normals are spread too wide for it to ever cull the meshlet
+		float32_t minDot = 1.f;
+		for(uint32_t i = 0; i != meshlet.triangleCount; ++i) {
+			const float32_t* normal = normals[i];
+			if(normal[0] == 0.f && normal[1] == 0.f && normal[2] == 0.f)
+				continue;
+
+			minDot = fminf(minDot, normal[0] * axis[0] + normal[1] * axis[1] + normal[2] * axis[2]);
+		}
+
+		if(minDot <= MIN_CONE_DOT)
+			return;
+
+		// Move the apex back along the axis until it's behind every triangle's plane
+		float32_t maxDistance = 0.f;
+		for(uint32_t i = 0; i != meshlet.triangleCount; ++i) {
+			const float32_t* normal = normals[i];
+			if(normal[0] == 0.f && normal[1] == 0.f && normal[2] == 0.f)
+				continue;
+
+			const float32_t* position0 = GetPosition(positions, positionStride, vertices[triangles[i] & 0xff]);
+			float32_t centerDot = (meshlet.center[0] - position0[0]) * normal[0] + (meshlet.center[1] - position0[1]) * normal[1] + (meshlet.center[2] - position0[2]) * normal[2];
+			float32_t axisDot = axis[0] * normal[0] + axis[1] * normal[1] + axis[2] * normal[2];
+			maxDistance = fmaxf(maxDistance, centerDot / axisDot);
+		}
+
+		for(uint32_t j = 0; j != 3; ++j) {
+			meshlet.coneApex[j] = meshlet.center[j] - axis[j] * maxDistance;
+			meshlet.coneAxis[j] = axis[j];
+		}
+
+		// Widen the normal cone by 90 degrees on every side to get the cone of backfacing view directions, whose cutoff is the sine of the normal cone's angle
+		meshlet.coneCutoff = sqrtf(1.f - minDot * minDot);
+	}
+
+	void MeshletBuilder::Build(const float32_t* positions, size_t positionStride, uint32_t vertexCount, const uint32_t* indices, size_t indexCount) {
+		// Check if the indices form a triangle list
+		if(indexCount % 3)
+			throw Exception("Meshlet index count %llu isn't a multiple of 3!", (unsigned long long)indexCount);
+
+		Clear();
+
+		// Mark every vertex as not being in the current meshlet
+		localIndices.resize(vertexCount);
+		for(uint32_t i = 0; i != vertexCount; ++i)
+			localIndices[i] = UINT32_T_MAX;
+
+		for(size_t i = 0; i != indexCount; i += 3) {
+			const uint32_t* triangle = indices + i;
+			if(triangle[0] >= vertexCount || triangle[1] >= vertexCount || triangle[2] >= vertexCount)
+				throw Exception("Meshlet index exceeds the mesh's vertex count of %u!", vertexCount);
+
+			// Skip degenerate triangles, which are never rasterized
+			if(triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[0] == triangle[2])
+				continue;
+
+			// Start a new meshlet if the triangle's new vertices or the triangle itself don't fit in the current one
+			uint32_t newVertexCount = (localIndices[triangle[0]] == UINT32_T_MAX) + (localIndices[triangle[1]] == UINT32_T_MAX) + (localIndices[triangle[2]] == UINT32_T_MAX);
+
+			if(meshlets.empty() || meshlets.back().vertexCount + newVertexCount > MAX_VERTEX_COUNT || meshlets.back().triangleCount == MAX_TRIANGLE_COUNT) {
+				if(!meshlets.empty())
+					FinishMeshlet(positions, positionStride);
+
+				Meshlet meshlet {};
+				meshlet.vertexOffset = (uint32_t)meshletVertices.size();
+				meshlet.triangleOffset = (uint32_t)meshletTriangles.size();
+				meshlets.push_back(meshlet);
+			}
+
+			// Add the triangle and its new vertices to the current meshlet
+			Meshlet& meshlet = meshlets.back();
+			uint32_t packedTriangle = 0;
+
+			for(uint32_t j = 0; j != 3; ++j) {
+				if(localIndices[triangle[j]] == UINT32_T_MAX) {
+					localIndices[triangle[j]] = meshlet.vertexCount++;
+					meshletVertices.push_back(triangle[j]);
+				}
+
+				packedTriangle |= localIndices[triangle[j]] << (j << 3);
+				meshletIndices.push_back(triangle[j]);
+			}
+
+			meshletTriangles.push_back(packedTriangle);
+			++meshlet.triangleCount;
+		}
+
+		if(!meshlets.empty())
+			FinishMeshlet(positions, positionStride);
+	}
+	void MeshletBuilder::Clear() {
+		meshlets.clear();
+		meshletVertices.clear();
+		meshletTriangles.clear();
+		meshletIndices.clear();
+	}
+}
\ No newline at end of file
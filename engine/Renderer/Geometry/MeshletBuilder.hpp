@@ -0,0 +1,89 @@
+#pragma once
+
+#include <Core.hpp>
+
+namespace wfe {
+	/// @brief A builder that splits indexed triangle meshes into meshlets, small clusters of triangles with their own bounding sphere and normal cone, which can be culled and drawn independently.
+	class MeshletBuilder {
+	public:
+		/// @brief The maximum number of unique vertices in a meshlet.
+		static const uint32_t MAX_VERTEX_COUNT = 64;
+		/// @brief The maximum number of triangles in a meshlet.
+		static const uint32_t MAX_TRIANGLE_COUNT = 124;
+
+		/// @brief A struct containing a meshlet's ranges and bounds. Must match the meshlet struct in MeshletCommon.glsl.
+		struct Meshlet {
+			/// @brief The center of the meshlet's bounding sphere.
+			float32_t center[3];
+			/// @brief The radius of the meshlet's bounding sphere.
+			float32_t radius;
+			/// @brief The apex of the meshlet's normal cone.
+			float32_t coneApex[3];
+			/// @brief The cone cutoff; the meshlet is backfacing if the dot product of the normalized vector from the camera to the apex with the cone's axis is at least the cutoff. A cutoff of 1 disables cone culling.
+			float32_t coneCutoff;
+			/// @brief The normalized axis of the meshlet's normal cone.
+			float32_t coneAxis[3];
+			/// @brief The index of the meshlet's first vertex in the meshlet vertex array.
+			uint32_t vertexOffset;
+			/// @brief The index of the meshlet's first triangle in the meshlet triangle array.
+			uint32_t triangleOffset;
+			/// @brief The number of the meshlet's unique vertices.
+			uint32_t vertexCount;
+			/// @brief The number of the meshlet's triangles.
+			uint32_t triangleCount;
+			/// @brief Padding to keep every meshlet 64 bytes large.
+			uint32_t padding;
+		};
+
+		/// @brief Creates an empty meshlet builder.
+		MeshletBuilder() = default;
+		MeshletBuilder(const MeshletBuilder&) = delete;
+		MeshletBuilder(MeshletBuilder&&) noexcept = delete;
+
+		MeshletBuilder& operator=(const MeshletBuilder&) = delete;
+		MeshletBuilder& operator=(MeshletBuilder&&) = delete;
+
+		/// @brief Gets the built meshlets.
+		/// @return A const reference to the meshlet vector.
+		const vector<Meshlet>& GetMeshlets() const {
+			return meshlets;
+		}
+		/// @brief Gets the built meshlets' vertices, with every meshlet's unique vertices stored as mesh vertex indices starting from its vertex offset.
+		/// @return A const reference to the meshlet vertex vector.
+		const vector<uint32_t>& GetMeshletVertices() const {
+			return meshletVertices;
+		}
+		/// @brief Gets the built meshlets' triangles, with every triangle's three meshlet-local vertex indices packed into the low three bytes of a value.
+		/// @return A const reference to the meshlet triangle vector.
+		const vector<uint32_t>& GetMeshletTriangles() const {
+			return meshletTriangles;
+		}
+		/// @brief Gets the built meshlets' triangles as mesh vertex indices, with three indices per meshlet triangle, used to draw meshlets without mesh shaders.
+		/// @return A const reference to the meshlet index vector.
+		const vector<uint32_t>& GetMeshletIndices() const {
+			return meshletIndices;
+		}
+
+		/// @brief Splits the given mesh into meshlets, replacing the previously built meshlets. Triangles are gathered in index order, so the indices should be optimized for vertex locality beforehand.
+		/// @param positions A pointer to the first vertex's position, made out of three floats.
+		/// @param positionStride The distance between two vertices' positions, in bytes.
+		/// @param vertexCount The number of the mesh's vertices.
+		/// @param indices A pointer to the mesh's triangle list indices, with counter-clockwise front faces.
+		/// @param indexCount The number of the mesh's indices, which must be a multiple of 3.
+		void Build(const float32_t* positions, size_t positionStride, uint32_t vertexCount, const uint32_t* indices, size_t indexCount);
+		/// @brief Removes every built meshlet, keeping the builder's memory.
+		void Clear();
+
+		/// @brief Destroys the meshlet builder.
+		~MeshletBuilder() = default;
+	private:
+		void FinishMeshlet(const float32_t* positions, size_t positionStride);
+
+		vector<Meshlet> meshlets;
+		vector<uint32_t> meshletVertices;
+		vector<uint32_t> meshletTriangles;
+		vector<uint32_t> meshletIndices;
+
+		vector<uint32_t> localIndices;
+	};
+}
\ No newline at end of file
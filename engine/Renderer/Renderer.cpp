@@ -3,11 +3,11 @@
 
 namespace wfe {
 	/// @brief Creates a renderer using the most optimal available API.
-	Renderer::Renderer(Window* window, bool8_t debugEnabled, Logger* logger) {
+	Renderer::Renderer(Window* window, bool8_t debugEnabled, Logger* logger, JobSystem* jobSystem) {
 		// Try to create the Vulkan renderer
 		try {
 			PushMemoryUsageType(MEMORY_USAGE_TYPE_RENDERER);
-			rendererBackend = NewObject<VulkanRenderer>(window, debugEnabled, logger);
+			rendererBackend = NewObject<VulkanRenderer>(window, debugEnabled, logger, jobSystem);
 			PopMemoryUsageType();
 			rendererBackendAPI = RENDERER_BACKEND_API_VULKAN;
 			return;
@@ -27,6 +27,23 @@ namespace wfe {
 		return rendererBackend;
 	}
 
+	void Renderer::SubmitFramePacket(const FramePacket* packet, float32_t interpolationFactor) {
+		// Submit the packet using the renderer backend's API
+		switch(rendererBackendAPI) {
+		case RENDERER_BACKEND_API_VULKAN:
+			((VulkanRenderer*)rendererBackend)->SubmitFramePacket(packet, interpolationFactor);
+			break;
+		}
+	}
+	void Renderer::RenderFrame(const Matrix4& viewProjection) {
+		// Render the frame using the renderer backend's API
+		switch(rendererBackendAPI) {
+		case RENDERER_BACKEND_API_VULKAN:
+			((VulkanRenderer*)rendererBackend)->RenderFrame(viewProjection);
+			break;
+		}
+	}
+
 	/// @brief Destroys the renderer.
 	Renderer::~Renderer() {
 		// Destroy the renderer backend based on its API
@@ -1,10 +1,14 @@
 #pragma once
 
+#include "General/JobSystem.hpp"
+#include "Math/Matrix.hpp"
 #include "Platform/Window.hpp"
 
 #include <Core.hpp>
 
 namespace wfe {
+	class FramePacket;
+
 	/// @brief An abstraction for the renderer's backend API.
 	class Renderer {
 	public:
@@ -60,7 +64,8 @@ namespace wfe {
 		/// @param window The window the renderer will display to.
 		/// @param debugEnabled True if debugging should be enabled, otherwise false.
 		/// @param logger The logger to use for general messages.
-		Renderer(Window* window, bool8_t debugEnabled, Logger* logger);
+		/// @param jobSystem The job system the renderer splits its CPU work between.
+		Renderer(Window* window, bool8_t debugEnabled, Logger* logger, JobSystem* jobSystem);
 		Renderer(const Renderer&) = delete;
 		Renderer(Renderer&&) noexcept = delete;
 
@@ -77,6 +82,14 @@ namespace wfe {
 		/// @return A const void pointer that can be cast to a const pointer to the appropriate renderer backend's class.
 		const void* GetRendererBackend() const;
 
+		/// @brief Submits every mesh instance in the given frame packet to the renderer's backend, to be drawn by the next rendered frame. The packet isn't read after the call returns.
+		/// @param packet The frame packet to submit.
+		/// @param interpolationFactor The factor to blend the instances' previous and current transforms with, where 1 draws the packet's tick as is.
+		void SubmitFramePacket(const FramePacket* packet, float32_t interpolationFactor);
+		/// @brief Renders and presents a frame with everything submitted to the renderer's backend since the last frame.
+		/// @param viewProjection The view projection matrix to render the frame with.
+		void RenderFrame(const Matrix4& viewProjection);
+
 		/// @brief Destroys the renderer.
 		~Renderer();
 	private:
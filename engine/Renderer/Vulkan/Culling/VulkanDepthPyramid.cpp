@@ -0,0 +1,346 @@
+#include "VulkanDepthPyramid.hpp"
+#include "Renderer/Vulkan/VulkanRenderer.hpp"
+
+#include <vulkan/vk_enum_string_helper.h>
+
+namespace wfe {
+	// Constants
+	static const char_t REDUCE_SHADER_NAME[] = "DepthPyramidReduce.comp";
+	static const uint32_t WORKGROUP_SIZE = 8;
+
+	// Internal helper functions
+	static uint32_t PreviousPowerOfTwo(uint32_t value) {
+		uint32_t result = 1;
+		while((result << 1) && (result << 1) <= value)
+			result <<= 1;
+
+		return result;
+	}
+	static VkImageAspectFlags GetDepthAspectFlags(VkFormat depthFormat) {
+		// Add the stencil aspect for combined depth stencil formats
+		if(depthFormat == VK_FORMAT_D16_UNORM_S8_UINT || depthFormat == VK_FORMAT_D24_UNORM_S8_UINT || depthFormat == VK_FORMAT_D32_SFLOAT_S8_UINT)
+			return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+
+		return VK_IMAGE_ASPECT_DEPTH_BIT;
+	}
+
+	void VulkanDepthPyramid::CreateImage(VkExtent2D newDepthExtent) {
+		// Round the depth extent down to powers of two, so that every mip level exactly halves the previous one
+		depthExtent = newDepthExtent;
+		extent.width = PreviousPowerOfTwo(depthExtent.width);
+		extent.height = PreviousPowerOfTwo(depthExtent.height);
+
+		mipCount = 1;
+		while(mipCount != MAX_MIP_COUNT && ((extent.width >> mipCount) || (extent.height >> mipCount)))
+			++mipCount;
+
+		// Share the image between the graphics and compute queue families, if they're different
+		VulkanDevice::QueueFamilyIndices queueFamilyIndices = device->GetQueueFamilyIndices();
+
+		uint32_t imageIndices[] = { queueFamilyIndices.graphicsIndex, queueFamilyIndices.computeIndex };
+		uint32_t imageIndexCount;
+		VkSharingMode imageSharingMode;
+
+		if(queueFamilyIndices.graphicsIndex == queueFamilyIndices.computeIndex) {
+			imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+			imageIndexCount = 1;
+		} else {
+			imageSharingMode = VK_SHARING_MODE_CONCURRENT;
+			imageIndexCount = 2;
+		}
+
+		// Set the image's create info
+		VkImageCreateInfo imageInfo {
+			.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.imageType = VK_IMAGE_TYPE_2D,
+			.format = VK_FORMAT_R32_SFLOAT,
+			.extent = { extent.width, extent.height, 1 },
+			.mipLevels = mipCount,
+			.arrayLayers = 1,
+			.samples = VK_SAMPLE_COUNT_1_BIT,
+			.tiling = VK_IMAGE_TILING_OPTIMAL,
+			.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT,
+			.sharingMode = imageSharingMode,
+			.queueFamilyIndexCount = imageIndexCount,
+			.pQueueFamilyIndices = imageIndices,
+			.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+		};
+
+		// Create the image and allocate its memory
+		VkResult result = device->GetLoader()->vkCreateImage(device->GetDevice(), &imageInfo, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS, &image);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to create Vulkan depth pyramid image! Error code: %s", string_VkResult(result));
+
+		result = allocator->AllocImageMemory(image, VulkanAllocator::MEMORY_TYPE_GPU, imageMemory);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to allocate Vulkan depth pyramid image memory! Error code: %s", string_VkResult(result));
+
+		result = allocator->BindImageMemories(1, &image, &imageMemory);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to bind Vulkan depth pyramid image memory! Error code: %s", string_VkResult(result));
+
+		// Set the image views' create info
+		VkImageViewCreateInfo viewInfo {
+			.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.image = image,
+			.viewType = VK_IMAGE_VIEW_TYPE_2D,
+			.format = VK_FORMAT_R32_SFLOAT,
+			.components = {
+				.r = VK_COMPONENT_SWIZZLE_R,
+				.g = VK_COMPONENT_SWIZZLE_G,
+				.b = VK_COMPONENT_SWIZZLE_B,
+				.a = VK_COMPONENT_SWIZZLE_A
+			},
+			.subresourceRange = {
+				.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+				.baseMipLevel = 0,
+				.levelCount = mipCount,
+				.baseArrayLayer = 0,
+				.layerCount = 1
+			}
+		};
+
+		// Create the view of the entire mip chain, sampled by the culling shader
+		result = device->GetLoader()->vkCreateImageView(device->GetDevice(), &viewInfo, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS, &imageView);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to create Vulkan depth pyramid image view! Error code: %s", string_VkResult(result));
+
+		// Create every mip level's view, written and then read by the reduction
+		viewInfo.subresourceRange.levelCount = 1;
+		for(uint32_t i = 0; i != mipCount; ++i) {
+			viewInfo.subresourceRange.baseMipLevel = i;
+
+			result = device->GetLoader()->vkCreateImageView(device->GetDevice(), &viewInfo, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS, mipViews + i);
+			if(result != VK_SUCCESS)
+				throw Exception("Failed to create Vulkan depth pyramid mip view! Error code: %s", string_VkResult(result));
+		}
+	}
+	void VulkanDepthPyramid::RetireImage() {
+		// Exit the function if the image wasn't created
+		if(!image)
+			return;
+
+		// Queue the image for destruction on the current frame's next reset, as frames still in flight may be reading it
+		RetiredImage retiredImage;
+		retiredImage.image = image;
+		retiredImage.imageMemory = imageMemory;
+		retiredImage.imageView = imageView;
+		retiredImage.mipCount = mipCount;
+		for(uint32_t i = 0; i != mipCount; ++i)
+			retiredImage.mipViews[i] = mipViews[i];
+
+		retiredImages[currentFrame].push_back(retiredImage);
+
+		image = VK_NULL_HANDLE;
+		imageView = VK_NULL_HANDLE;
+		extent = { 0, 0 };
+		mipCount = 0;
+	}
+	void VulkanDepthPyramid::DestroyRetiredImage(const RetiredImage& retiredImage) {
+		// Destroy the image views
+		for(uint32_t i = 0; i != retiredImage.mipCount; ++i)
+			device->GetLoader()->vkDestroyImageView(device->GetDevice(), retiredImage.mipViews[i], &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+		device->GetLoader()->vkDestroyImageView(device->GetDevice(), retiredImage.imageView, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+
+		// Destroy the image and free its memory
+		device->GetLoader()->vkDestroyImage(device->GetDevice(), retiredImage.image, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+		allocator->FreeMemory(retiredImage.imageMemory);
+	}
+
+	// Public functions
+	VulkanDepthPyramid::VulkanDepthPyramid(VulkanDevice* device, VulkanAllocator* allocator, VulkanShaderLibrary* shaderLibrary, VulkanPipelineVariantCache* pipelineVariantCache, VulkanDescriptorAllocator* descriptorAllocator) : device(device), allocator(allocator), descriptorAllocator(descriptorAllocator), depthExtent{ 0, 0 }, extent{ 0, 0 }, mipCount(0), image(VK_NULL_HANDLE), imageView(VK_NULL_HANDLE), currentFrame(0) {
+		// Set the sampler's create info
+		VkSamplerCreateInfo samplerInfo {
+			.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.magFilter = VK_FILTER_NEAREST,
+			.minFilter = VK_FILTER_NEAREST,
+			.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+			.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+			.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+			.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+			.mipLodBias = 0.f,
+			.anisotropyEnable = VK_FALSE,
+			.maxAnisotropy = 1.f,
+			.compareEnable = VK_FALSE,
+			.compareOp = VK_COMPARE_OP_ALWAYS,
+			.minLod = 0.f,
+			.maxLod = VK_LOD_CLAMP_NONE,
+			.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE,
+			.unnormalizedCoordinates = VK_FALSE
+		};
+
+		// Create the sampler
+		VkResult result = device->GetLoader()->vkCreateSampler(device->GetDevice(), &samplerInfo, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS, &sampler);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to create Vulkan depth pyramid sampler! Error code: %s", string_VkResult(result));
+
+		// Load the reduction shader and get its pipeline layout
+		const VulkanShaderLibrary::ShaderModule* shaderModule = shaderLibrary->GetShaderModule(REDUCE_SHADER_NAME);
+		pipelineLayout = shaderLibrary->GetPipelineLayout(1, &shaderModule);
+
+		// Set the reduction pipeline's create info
+		VkComputePipelineCreateInfo createInfo {
+			.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.stage = {
+				.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+				.pNext = nullptr,
+				.flags = 0,
+				.stage = VK_SHADER_STAGE_COMPUTE_BIT,
+				.module = shaderModule->shaderModule,
+				.pName = "main",
+				.pSpecializationInfo = nullptr
+			},
+			.layout = pipelineLayout->pipelineLayout,
+			.basePipelineHandle = VK_NULL_HANDLE,
+			.basePipelineIndex = -1
+		};
+
+		// Create the reduction pipeline
+		result = device->GetLoader()->vkCreateComputePipelines(device->GetDevice(), pipelineVariantCache->GetPipelineCache(), 1, &createInfo, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS, &pipeline);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to create Vulkan depth pyramid pipeline! Error code: %s", string_VkResult(result));
+	}
+
+	void VulkanDepthPyramid::RecordBuild(VkCommandBuffer commandBuffer, VulkanSwapChain* swapChain, uint32_t imageIndex) {
+		// Recreate the pyramid's image if the depth image's extent changed
+		VkExtent2D swapChainExtent = swapChain->GetVulkanSwapChainExtent();
+		if(!image || swapChainExtent.width != depthExtent.width || swapChainExtent.height != depthExtent.height) {
+			RetireImage();
+			CreateImage(swapChainExtent);
+		}
+
+		const VulkanSwapChain::SwapChainImage& swapChainImage = swapChain->GetSwapChainImages()[imageIndex];
+		VkImageAspectFlags depthAspectFlags = GetDepthAspectFlags(swapChain->GetSwapChainSettings().depthFormat);
+
+		// Transition the depth image for sampling and the pyramid for writing, discarding its previous contents
+		VkImageMemoryBarrier startBarriers[] {
+			{
+				.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+				.pNext = nullptr,
+				.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+				.dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
+				.oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+				.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+				.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.image = swapChainImage.depthImage,
+				.subresourceRange = { depthAspectFlags, 0, 1, 0, 1 }
+			},
+			{
+				.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+				.pNext = nullptr,
+				.srcAccessMask = 0,
+				.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+				.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+				.newLayout = VK_IMAGE_LAYOUT_GENERAL,
+				.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.image = image,
+				.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, mipCount, 0, 1 }
+			}
+		};
+
+		device->GetLoader()->vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 2, startBarriers);
+
+		// Reduce every mip level from the previous one, starting from the depth image
+		device->GetLoader()->vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+
+		VkMemoryBarrier mipBarrier {
+			.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+			.pNext = nullptr,
+			.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+			.dstAccessMask = VK_ACCESS_SHADER_READ_BIT
+		};
+
+		PushConstants pushConstants;
+		pushConstants.outputSize[0] = depthExtent.width;
+		pushConstants.outputSize[1] = depthExtent.height;
+
+		for(uint32_t i = 0; i != mipCount; ++i) {
+			// Set the reduction's input and output sizes
+			pushConstants.inputSize[0] = pushConstants.outputSize[0];
+			pushConstants.inputSize[1] = pushConstants.outputSize[1];
+			pushConstants.outputSize[0] = extent.width >> i ? extent.width >> i : 1;
+			pushConstants.outputSize[1] = extent.height >> i ? extent.height >> i : 1;
+
+			// Write a transient descriptor set reading the previous level and writing the current one, as the views change whenever the pyramid is recreated
+			VulkanDescriptorAllocator::DescriptorWrite writes[2];
+			writes[0].binding = 0;
+			writes[0].arrayElement = 0;
+			writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			writes[0].imageInfo = { sampler, i ? mipViews[i - 1] : swapChainImage.depthImageView, i ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL };
+			writes[1].binding = 1;
+			writes[1].arrayElement = 0;
+			writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+			writes[1].imageInfo = { VK_NULL_HANDLE, mipViews[i], VK_IMAGE_LAYOUT_GENERAL };
+
+			VkDescriptorSet descriptorSet = descriptorAllocator->AllocTransientDescriptorSet(pipelineLayout->setLayouts[0]);
+			descriptorAllocator->WriteDescriptorSet(descriptorSet, 2, writes);
+
+			// Dispatch the reduction
+			device->GetLoader()->vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout->pipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+			device->GetLoader()->vkCmdPushConstants(commandBuffer, pipelineLayout->pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants), &pushConstants);
+			device->GetLoader()->vkCmdDispatch(commandBuffer, (pushConstants.outputSize[0] + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, (pushConstants.outputSize[1] + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1);
+
+			// Wait for the current level to be written before reducing the next one
+			if(i != mipCount - 1)
+				device->GetLoader()->vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &mipBarrier, 0, nullptr, 0, nullptr);
+		}
+
+		// Make every mip's writes, including the last one's, visible to the culling shaders and return the depth image to the attachment layout
+		VkImageMemoryBarrier endBarriers[] {
+			{
+				.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+				.pNext = nullptr,
+				.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+				.dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
+				.oldLayout = VK_IMAGE_LAYOUT_GENERAL,
+				.newLayout = VK_IMAGE_LAYOUT_GENERAL,
+				.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.image = image,
+				.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, mipCount, 0, 1 }
+			},
+			{
+				.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+				.pNext = nullptr,
+				.srcAccessMask = 0,
+				.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+				.oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+				.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+				.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.image = swapChainImage.depthImage,
+				.subresourceRange = { depthAspectFlags, 0, 1, 0, 1 }
+			}
+		};
+
+		device->GetLoader()->vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, 0, 0, nullptr, 0, nullptr, 2, endBarriers);
+	}
+	void VulkanDepthPyramid::ResetFrame(size_t frameIndex) {
+		// Destroy the images retired during the frame's previous use, which the GPU is done reading
+		for(const auto& retiredImage : retiredImages[frameIndex])
+			DestroyRetiredImage(retiredImage);
+		retiredImages[frameIndex].clear();
+
+		currentFrame = frameIndex;
+	}
+
+	VulkanDepthPyramid::~VulkanDepthPyramid() {
+		// Destroy the pyramid's current and retired images, pipeline and sampler
+		RetireImage();
+		for(size_t i = 0; i != Renderer::MAX_FRAMES_IN_FLIGHT; ++i)
+			for(const auto& retiredImage : retiredImages[i])
+				DestroyRetiredImage(retiredImage);
+		device->GetLoader()->vkDestroyPipeline(device->GetDevice(), pipeline, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+		device->GetLoader()->vkDestroySampler(device->GetDevice(), sampler, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+	}
+}
\ No newline at end of file
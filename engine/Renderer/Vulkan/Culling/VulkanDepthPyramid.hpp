@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Renderer/Renderer.hpp"
+#include "Renderer/Vulkan/Descriptor/VulkanDescriptorAllocator.hpp"
+#include "Renderer/Vulkan/Instance/VulkanAllocator.hpp"
+#include "Renderer/Vulkan/Instance/VulkanDevice.hpp"
+#include "Renderer/Vulkan/Instance/VulkanSwapChain.hpp"
+#include "Renderer/Vulkan/Shader/VulkanPipelineVariantCache.hpp"
+#include "Renderer/Vulkan/Shader/VulkanShaderLibrary.hpp"
+
+#include <Core.hpp>
+#include <vulkan/vk_platform.h>
+#include <vulkan/vulkan_core.h>
+
+namespace wfe {
+	/// @brief A hierarchical depth pyramid, built from the swap chain's depth image with a compute reduction and used for occlusion culling.
+	class VulkanDepthPyramid {
+	public:
+		/// @brief The maximum number of mip levels a depth pyramid can have.
+		static const uint32_t MAX_MIP_COUNT = 16;
+
+		/// @brief Creates a Vulkan depth pyramid. The pyramid's image is created on the first build.
+		/// @param device The Vulkan device to create the pyramid's resources for.
+		/// @param allocator The allocator used to allocate the pyramid's image.
+		/// @param shaderLibrary The shader library to load the reduction shader from.
+		/// @param pipelineVariantCache The pipeline variant cache whose pipeline cache is used to create the reduction pipeline.
+		/// @param descriptorAllocator The descriptor allocator to get the reduction descriptor sets from.
+		VulkanDepthPyramid(VulkanDevice* device, VulkanAllocator* allocator, VulkanShaderLibrary* shaderLibrary, VulkanPipelineVariantCache* pipelineVariantCache, VulkanDescriptorAllocator* descriptorAllocator);
+		VulkanDepthPyramid(const VulkanDepthPyramid&) = delete;
+		VulkanDepthPyramid(VulkanDepthPyramid&&) noexcept = delete;
+
+		VulkanDepthPyramid& operator=(const VulkanDepthPyramid&) = delete;
+		VulkanDepthPyramid& operator=(VulkanDepthPyramid&&) = delete;
+
+		/// @brief Gets the Vulkan function loader used by the pyramid.
+		/// @return A pointer to the Vulkan loader used by the pyramid.
+		const VulkanLoader* GetLoader() const {
+			return device->GetLoader();
+		}
+		/// @brief Gets the Vulkan device that owns the pyramid.
+		/// @return A pointer to the Vulkan device wrapper object.
+		VulkanDevice* GetDevice() {
+			return device;
+		}
+		/// @brief Gets the Vulkan device that owns the pyramid.
+		/// @return A const pointer to the Vulkan device wrapper object.
+		const VulkanDevice* GetDevice() const {
+			return device;
+		}
+		/// @brief Gets the pyramid's base level extent, which is the depth image's extent rounded down to powers of two.
+		/// @return The pyramid's extent, or a zero extent if the pyramid wasn't built yet.
+		VkExtent2D GetExtent() const {
+			return extent;
+		}
+		/// @brief Gets the pyramid's number of mip levels.
+		/// @return The pyramid's mip count.
+		uint32_t GetMipCount() const {
+			return mipCount;
+		}
+		/// @brief Gets the view of the pyramid's entire mip chain, which is in the general layout after every build.
+		/// @return A handle to the Vulkan image view, or VK_NULL_HANDLE if the pyramid wasn't built yet.
+		VkImageView GetImageView() {
+			return imageView;
+		}
+		/// @brief Gets the nearest filtering sampler used to sample the pyramid.
+		/// @return A handle to the Vulkan sampler.
+		VkSampler GetSampler() {
+			return sampler;
+		}
+
+		/// @brief Records the pyramid's build from the given swap chain image's depth, which must have been rendered with its contents stored. The depth image is returned to the depth attachment layout afterwards. If the swap chain's extent changed, the pyramid is recreated and its old image is kept alive until the current frame's next reset.
+		/// @param commandBuffer The command buffer to record the build in.
+		/// @param swapChain The swap chain whose depth image to reduce.
+		/// @param imageIndex The index of the swap chain image whose depth to reduce.
+		void RecordBuild(VkCommandBuffer commandBuffer, VulkanSwapChain* swapChain, uint32_t imageIndex);
+		/// @brief Destroys the pyramid images retired during the given frame's previous use and makes it the current frame. Must only be called after the frame's fence was signaled.
+		/// @param frameIndex The index of the frame in flight to reset.
+		void ResetFrame(size_t frameIndex);
+
+		/// @brief Destroys the Vulkan depth pyramid.
+		~VulkanDepthPyramid();
+	private:
+		struct PushConstants {
+			uint32_t inputSize[2];
+			uint32_t outputSize[2];
+		};
+		struct RetiredImage {
+			VkImage image;
+			VulkanAllocator::MemoryBlock imageMemory;
+			VkImageView imageView;
+			VkImageView mipViews[MAX_MIP_COUNT];
+			uint32_t mipCount;
+		};
+
+		void CreateImage(VkExtent2D depthExtent);
+		void RetireImage();
+		void DestroyRetiredImage(const RetiredImage& retiredImage);
+
+		VulkanDevice* device;
+		VulkanAllocator* allocator;
+		VulkanDescriptorAllocator* descriptorAllocator;
+
+		VkExtent2D depthExtent;
+		VkExtent2D extent;
+		uint32_t mipCount;
+		VkImage image;
+		VulkanAllocator::MemoryBlock imageMemory;
+		VkImageView imageView;
+		VkImageView mipViews[MAX_MIP_COUNT];
+		VkSampler sampler;
+
+		vector<RetiredImage> retiredImages[Renderer::MAX_FRAMES_IN_FLIGHT];
+		size_t currentFrame;
+
+		const VulkanShaderLibrary::PipelineLayout* pipelineLayout;
+		VkPipeline pipeline;
+	};
+}
\ No newline at end of file
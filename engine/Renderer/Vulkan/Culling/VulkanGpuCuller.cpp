@@ -0,0 +1,407 @@
+#include "VulkanGpuCuller.hpp"
+#include "Renderer/Vulkan/VulkanRenderer.hpp"
+
+#include <math.h>
+#include <vulkan/vk_enum_string_helper.h>
+
+namespace wfe {
+	// Constants
+	static const char_t CULL_SHADER_NAME[] = "InstanceCull.comp";
+	static const char_t OCCLUSION_CULL_SHADER_NAME[] = "InstanceOcclusionCull.comp";
+
+	// Internal helper functions
+	void VulkanGpuCuller::WriteDescriptorSet(VkDescriptorSet descriptorSet, size_t frameIndex, VulkanDepthPyramid* depthPyramid) {
+		// Write every buffer binding, followed by the depth pyramid if it's given
+		VulkanDescriptorAllocator::DescriptorWrite writes[6];
+		writes[0].binding = 0;
+		writes[0].arrayElement = 0;
+		writes[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writes[0].bufferInfo = { instanceBuffer, 0, VK_WHOLE_SIZE };
+		writes[1].binding = 1;
+		writes[1].arrayElement = 0;
+		writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writes[1].bufferInfo = { drawBuffers[frameIndex], 0, VK_WHOLE_SIZE };
+		writes[2].binding = 2;
+		writes[2].arrayElement = 0;
+		writes[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writes[2].bufferInfo = { countBuffers[frameIndex], 0, VK_WHOLE_SIZE };
+		writes[3].binding = 3;
+		writes[3].arrayElement = 0;
+		writes[3].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writes[3].bufferInfo = { visibilityBuffer, 0, VK_WHOLE_SIZE };
+		writes[4].binding = 5;
+		writes[4].arrayElement = 0;
+		writes[4].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writes[4].bufferInfo = { meshBuffer, 0, VK_WHOLE_SIZE };
+
+		if(!depthPyramid) {
+			descriptorAllocator->WriteDescriptorSet(descriptorSet, 5, writes);
+			return;
+		}
+
+		writes[5].binding = 4;
+		writes[5].arrayElement = 0;
+		writes[5].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		writes[5].imageInfo = { depthPyramid->GetSampler(), depthPyramid->GetImageView(), VK_IMAGE_LAYOUT_GENERAL };
+
+		descriptorAllocator->WriteDescriptorSet(descriptorSet, 6, writes);
+	}
+	void VulkanGpuCuller::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VulkanAllocator::MemoryType memoryType, bool8_t shared, VkBuffer& buffer, VulkanAllocator::MemoryBlock& memoryBlock) {
+		// Share the buffer between the compute and graphics queue families, if they're different
+		VulkanDevice::QueueFamilyIndices queueFamilyIndices = device->GetQueueFamilyIndices();
+
+		uint32_t bufferIndices[] = { queueFamilyIndices.computeIndex, queueFamilyIndices.graphicsIndex };
+		uint32_t bufferIndexCount;
+		VkSharingMode bufferSharingMode;
+
+		if(!shared || queueFamilyIndices.computeIndex == queueFamilyIndices.graphicsIndex) {
+			bufferSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+			bufferIndexCount = 1;
+		} else {
+			bufferSharingMode = VK_SHARING_MODE_CONCURRENT;
+			bufferIndexCount = 2;
+		}
+
+		// Set the buffer's create info
+		VkBufferCreateInfo createInfo {
+			.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.size = size,
+			.usage = usage,
+			.sharingMode = bufferSharingMode,
+			.queueFamilyIndexCount = bufferIndexCount,
+			.pQueueFamilyIndices = bufferIndices
+		};
+
+		// Create the buffer
+		VkResult result = device->GetLoader()->vkCreateBuffer(device->GetDevice(), &createInfo, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS, &buffer);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to create Vulkan GPU culler buffer! Error code: %s", string_VkResult(result));
+
+		// Allocate and bind the buffer's memory
+		result = allocator->AllocBufferMemory(buffer, memoryType, memoryBlock);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to allocate Vulkan GPU culler buffer memory! Error code: %s", string_VkResult(result));
+
+		result = allocator->BindBufferMemories(1, &buffer, &memoryBlock);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to bind Vulkan GPU culler buffer memory! Error code: %s", string_VkResult(result));
+	}
+	VkPipeline VulkanGpuCuller::CreatePipeline(const VulkanShaderLibrary::PipelineLayout* pipelineLayout, const VulkanShaderLibrary::ShaderModule* shaderModule, VkPipelineCache pipelineCache) {
+		// Set the culling pipeline's create info
+		VkComputePipelineCreateInfo createInfo {
+			.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.stage = {
+				.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+				.pNext = nullptr,
+				.flags = 0,
+				.stage = VK_SHADER_STAGE_COMPUTE_BIT,
+				.module = shaderModule->shaderModule,
+				.pName = "main",
+				.pSpecializationInfo = nullptr
+			},
+			.layout = pipelineLayout->pipelineLayout,
+			.basePipelineHandle = VK_NULL_HANDLE,
+			.basePipelineIndex = -1
+		};
+
+		// Create the culling pipeline
+		VkPipeline pipeline;
+		VkResult result = device->GetLoader()->vkCreateComputePipelines(device->GetDevice(), pipelineCache, 1, &createInfo, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS, &pipeline);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to create Vulkan GPU culling pipeline! Error code: %s", string_VkResult(result));
+
+		return pipeline;
+	}
+
+	// Public functions
+	bool8_t VulkanGpuCuller::IsSupported(const VulkanDevice* device) {
+		// Every instance has its own draw command, so drawing them one call at a time would cost as much CPU time as not culling on the GPU at all
+		return device->GetDeviceFeatures().multiDrawIndirect;
+	}
+
+	VulkanGpuCuller::VulkanGpuCuller(VulkanDevice* device, VulkanAllocator* allocator, VulkanShaderLibrary* shaderLibrary, VulkanPipelineVariantCache* pipelineVariantCache, VulkanDescriptorAllocator* descriptorAllocator, uint32_t maxInstanceCount, uint32_t maxMeshCount) : device(device), allocator(allocator), descriptorAllocator(descriptorAllocator), maxInstanceCount(maxInstanceCount), instanceCount(0), maxMeshCount(maxMeshCount), lodBias(0.f), dirtyBegin(UINT32_T_MAX), dirtyEnd(0), dirtyMeshBegin(UINT32_T_MAX), dirtyMeshEnd(0), visibilityCleared(false) {
+		// Compact the draw commands only if the draw count can be read from the count buffer
+		drawCountSupported = device->GetCapabilities().drawIndirectCount;
+
+		// Create the instance and mesh buffers, keeping a host copy of their contents that's staged as it changes
+		CreateBuffer(maxInstanceCount * sizeof(Instance), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VulkanAllocator::MEMORY_TYPE_GPU, false, instanceBuffer, instanceMemory);
+		CreateBuffer(maxMeshCount * sizeof(Mesh), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VulkanAllocator::MEMORY_TYPE_GPU, false, meshBuffer, meshMemory);
+
+		hostInstances.resize(maxInstanceCount);
+		hostMeshes.resize(maxMeshCount);
+
+		// Create every frame's persistently mapped staging buffer, which holds the changed instances followed by the changed meshes. Every frame has its own, as an earlier frame's copies may still be reading its staging buffer
+		meshStagingOffset = maxInstanceCount * sizeof(Instance);
+
+		VkResult result;
+		for(size_t i = 0; i != Renderer::MAX_FRAMES_IN_FLIGHT; ++i) {
+			CreateBuffer(meshStagingOffset + maxMeshCount * sizeof(Mesh), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VulkanAllocator::MEMORY_TYPE_CPU_GPU_VISIBLE, false, stagingBuffers[i], stagingMemories[i]);
+
+			void* mappedData;
+			result = allocator->MapMemory(stagingMemories[i], mappedData);
+			if(result != VK_SUCCESS)
+				throw Exception("Failed to map Vulkan GPU culler staging memory! Error code: %s", string_VkResult(result));
+			stagingData[i] = (uint8_t*)mappedData;
+		}
+
+		// Create the visibility buffer, which holds every instance's visibility and selected LOD from the previous frame's late phase
+		CreateBuffer(maxInstanceCount * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VulkanAllocator::MEMORY_TYPE_GPU, false, visibilityBuffer, visibilityMemory);
+
+		// Create every frame's draw, count and readback buffers, as the graphics queue may still read the previous frame's draws; every draw buffer holds the early phase's draws followed by the late phase's
+		for(size_t i = 0; i != Renderer::MAX_FRAMES_IN_FLIGHT; ++i) {
+			CreateBuffer(2 * maxInstanceCount * sizeof(VkDrawIndexedIndirectCommand), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VulkanAllocator::MEMORY_TYPE_GPU, true, drawBuffers[i], drawMemories[i]);
+			CreateBuffer(sizeof(Stats), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VulkanAllocator::MEMORY_TYPE_GPU, true, countBuffers[i], countMemories[i]);
+			CreateBuffer(sizeof(Stats), VK_BUFFER_USAGE_TRANSFER_DST_BIT, VulkanAllocator::MEMORY_TYPE_CPU_GPU_VISIBLE, false, readbackBuffers[i], readbackMemories[i]);
+
+			void* readbackData;
+			result = allocator->MapMemory(readbackMemories[i], readbackData);
+			if(result != VK_SUCCESS)
+				throw Exception("Failed to map Vulkan GPU culler readback memory! Error code: %s", string_VkResult(result));
+			readbackStats[i] = (Stats*)readbackData;
+			memset(readbackStats[i], 0, sizeof(Stats));
+		}
+
+		// Load the culling shaders and create their pipelines
+		const VulkanShaderLibrary::ShaderModule* shaderModule = shaderLibrary->GetShaderModule(CULL_SHADER_NAME);
+		pipelineLayout = shaderLibrary->GetPipelineLayout(1, &shaderModule);
+		pipeline = CreatePipeline(pipelineLayout, shaderModule, pipelineVariantCache->GetPipelineCache());
+
+		const VulkanShaderLibrary::ShaderModule* occlusionShaderModule = shaderLibrary->GetShaderModule(OCCLUSION_CULL_SHADER_NAME);
+		occlusionPipelineLayout = shaderLibrary->GetPipelineLayout(1, &occlusionShaderModule);
+		occlusionPipeline = CreatePipeline(occlusionPipelineLayout, occlusionShaderModule, pipelineVariantCache->GetPipelineCache());
+
+		// Allocate and write every frame's descriptor set used without the depth pyramid
+		for(size_t i = 0; i != Renderer::MAX_FRAMES_IN_FLIGHT; ++i) {
+			descriptorSets[i] = descriptorAllocator->AllocDescriptorSet(pipelineLayout->setLayouts[0]);
+			WriteDescriptorSet(descriptorSets[i], i, nullptr);
+		}
+	}
+
+	void VulkanGpuCuller::SetInstances(uint32_t firstInstance, uint32_t count, const Instance* instances) {
+		// Check if the instances fit in the culler
+		if(firstInstance + count > maxInstanceCount)
+			throw Exception("Exceeded the Vulkan GPU culler's capacity of %u instances!", maxInstanceCount);
+
+		// Write the instances to the host copy and extend the range uploaded by the next cull
+		memcpy(hostInstances.data() + firstInstance, instances, count * sizeof(Instance));
+
+		if(firstInstance < dirtyBegin)
+			dirtyBegin = firstInstance;
+		if(firstInstance + count > dirtyEnd)
+			dirtyEnd = firstInstance + count;
+	}
+	void VulkanGpuCuller::SetMeshes(uint32_t firstMesh, uint32_t count, const Mesh* meshes) {
+		// Check if the meshes fit in the culler
+		if(firstMesh + count > maxMeshCount)
+			throw Exception("Exceeded the Vulkan GPU culler's capacity of %u meshes!", maxMeshCount);
+
+		// Write the meshes to the host copy and extend the range uploaded by the next cull
+		memcpy(hostMeshes.data() + firstMesh, meshes, count * sizeof(Mesh));
+
+		if(firstMesh < dirtyMeshBegin)
+			dirtyMeshBegin = firstMesh;
+		if(firstMesh + count > dirtyMeshEnd)
+			dirtyMeshEnd = firstMesh + count;
+	}
+	void VulkanGpuCuller::SetLodBias(float32_t bias) {
+		lodBias = bias;
+	}
+	void VulkanGpuCuller::SetInstanceCount(uint32_t count) {
+		// Check if the instance count fits in the culler
+		if(count > maxInstanceCount)
+			throw Exception("Exceeded the Vulkan GPU culler's capacity of %u instances!", maxInstanceCount);
+
+		instanceCount = count;
+	}
+
+	void VulkanGpuCuller::RecordCull(VkCommandBuffer commandBuffer, size_t frameIndex, Phase phase, const View& view, VulkanDepthPyramid* depthPyramid) {
+		if(phase == PHASE_EARLY) {
+			// Upload the instances changed since the last cull through the frame's staging buffer, which the frame's previous copies are done reading
+			if(dirtyBegin < dirtyEnd) {
+				VkBufferCopy copyRegion {
+					.srcOffset = dirtyBegin * sizeof(Instance),
+					.dstOffset = dirtyBegin * sizeof(Instance),
+					.size = (dirtyEnd - dirtyBegin) * sizeof(Instance)
+				};
+
+				memcpy(stagingData[frameIndex] + copyRegion.srcOffset, hostInstances.data() + dirtyBegin, copyRegion.size);
+				device->GetLoader()->vkCmdCopyBuffer(commandBuffer, stagingBuffers[frameIndex], instanceBuffer, 1, &copyRegion);
+
+				dirtyBegin = UINT32_T_MAX;
+				dirtyEnd = 0;
+			}
+
+			// Upload the meshes changed since the last cull
+			if(dirtyMeshBegin < dirtyMeshEnd) {
+				VkBufferCopy copyRegion {
+					.srcOffset = meshStagingOffset + dirtyMeshBegin * sizeof(Mesh),
+					.dstOffset = dirtyMeshBegin * sizeof(Mesh),
+					.size = (dirtyMeshEnd - dirtyMeshBegin) * sizeof(Mesh)
+				};
+
+				memcpy(stagingData[frameIndex] + copyRegion.srcOffset, hostMeshes.data() + dirtyMeshBegin, copyRegion.size);
+				device->GetLoader()->vkCmdCopyBuffer(commandBuffer, stagingBuffers[frameIndex], meshBuffer, 1, &copyRegion);
+
+				dirtyMeshBegin = UINT32_T_MAX;
+				dirtyMeshEnd = 0;
+			}
+
+			// Clear the visibility buffer on the first cull, leaving every visible instance to the late phase
+			if(!visibilityCleared) {
+				device->GetLoader()->vkCmdFillBuffer(commandBuffer, visibilityBuffer, 0, VK_WHOLE_SIZE, 0);
+				visibilityCleared = true;
+			}
+
+			// Reset the frame's draw counts and statistics
+			device->GetLoader()->vkCmdFillBuffer(commandBuffer, countBuffers[frameIndex], 0, sizeof(Stats), 0);
+
+			// Make the transfers and the previous late phase's visibility writes visible to the culling shader
+			VkMemoryBarrier transferBarrier {
+				.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+				.pNext = nullptr,
+				.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+				.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT
+			};
+
+			device->GetLoader()->vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &transferBarrier, 0, nullptr, 0, nullptr);
+		} else {
+			// Wait for the early phase to read the visibility buffer and write its draw count
+			VkMemoryBarrier phaseBarrier {
+				.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+				.pNext = nullptr,
+				.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+				.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT
+			};
+
+			device->GetLoader()->vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &phaseBarrier, 0, nullptr, 0, nullptr);
+		}
+
+		// Dispatch the culling shader, if there are any instances
+		if(instanceCount) {
+			PushConstants pushConstants;
+			memcpy(pushConstants.viewProjection, view.viewProjection, sizeof(pushConstants.viewProjection));
+			memcpy(pushConstants.cameraPosition, view.cameraPosition, sizeof(pushConstants.cameraPosition));
+
+			// Scale LOD errors so that, divided by the distance, they're in multiples of the allowed screen-space error
+			pushConstants.lodScale = .5f * (float32_t)view.viewportExtent.height * view.projectionScale / (MAX_PIXEL_ERROR * exp2f(lodBias));
+
+			pushConstants.pyramidSize[0] = 0.f;
+			pushConstants.pyramidSize[1] = 0.f;
+			pushConstants.instanceCount = instanceCount;
+			pushConstants.flags = 0;
+			pushConstants.lateDrawOffset = maxInstanceCount;
+
+			if(drawCountSupported)
+				pushConstants.flags |= CULL_FLAG_COMPACT;
+			if(phase == PHASE_LATE)
+				pushConstants.flags |= CULL_FLAG_LATE_PHASE;
+
+			if(phase == PHASE_LATE && depthPyramid && depthPyramid->GetImageView()) {
+				// Write a transient descriptor set that also samples the depth pyramid, which is recreated whenever the swap chain is resized
+				VkExtent2D pyramidExtent = depthPyramid->GetExtent();
+				pushConstants.pyramidSize[0] = (float32_t)pyramidExtent.width;
+				pushConstants.pyramidSize[1] = (float32_t)pyramidExtent.height;
+
+				VkDescriptorSet descriptorSet = descriptorAllocator->AllocTransientDescriptorSet(occlusionPipelineLayout->setLayouts[0]);
+				WriteDescriptorSet(descriptorSet, frameIndex, depthPyramid);
+
+				device->GetLoader()->vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, occlusionPipeline);
+				device->GetLoader()->vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, occlusionPipelineLayout->pipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+				device->GetLoader()->vkCmdPushConstants(commandBuffer, occlusionPipelineLayout->pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants), &pushConstants);
+			} else {
+				device->GetLoader()->vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+				device->GetLoader()->vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout->pipelineLayout, 0, 1, descriptorSets + frameIndex, 0, nullptr);
+				device->GetLoader()->vkCmdPushConstants(commandBuffer, pipelineLayout->pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants), &pushConstants);
+			}
+
+			device->GetLoader()->vkCmdDispatch(commandBuffer, (instanceCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+		}
+
+		// Make the draw commands and counts visible to the indirect draws
+		VkMemoryBarrier drawBarrier {
+			.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+			.pNext = nullptr,
+			.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+			.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT
+		};
+
+		if(phase == PHASE_EARLY) {
+			device->GetLoader()->vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, 1, &drawBarrier, 0, nullptr, 0, nullptr);
+			return;
+		}
+
+		// Read back the frame's statistics after the late phase
+		drawBarrier.dstAccessMask |= VK_ACCESS_TRANSFER_READ_BIT;
+		device->GetLoader()->vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &drawBarrier, 0, nullptr, 0, nullptr);
+
+		VkBufferCopy copyRegion {
+			.srcOffset = 0,
+			.dstOffset = 0,
+			.size = sizeof(Stats)
+		};
+
+		device->GetLoader()->vkCmdCopyBuffer(commandBuffer, countBuffers[frameIndex], readbackBuffers[frameIndex], 1, &copyRegion);
+
+		VkMemoryBarrier readbackBarrier {
+			.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+			.pNext = nullptr,
+			.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+			.dstAccessMask = VK_ACCESS_HOST_READ_BIT
+		};
+
+		device->GetLoader()->vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &readbackBarrier, 0, nullptr, 0, nullptr);
+	}
+	void VulkanGpuCuller::RecordDraws(VkCommandBuffer commandBuffer, size_t frameIndex, Phase phase) {
+		// Exit the function if there are no instances to draw
+		if(!instanceCount)
+			return;
+
+		// Get the offsets of the phase's draw commands and draw count
+		VkDeviceSize drawOffset = (phase == PHASE_LATE ? maxInstanceCount : 0) * sizeof(VkDrawIndexedIndirectCommand);
+		VkDeviceSize countOffset = (phase == PHASE_LATE ? offsetof(Stats, lateDrawCount) : offsetof(Stats, earlyDrawCount));
+
+		// Draw the compacted commands, reading the draw count from the count buffer
+		if(drawCountSupported) {
+			if(device->GetCapabilities().apiVersion >= VK_API_VERSION_1_2) {
+				device->GetLoader()->vkCmdDrawIndexedIndirectCount(commandBuffer, drawBuffers[frameIndex], drawOffset, countBuffers[frameIndex], countOffset, instanceCount, sizeof(VkDrawIndexedIndirectCommand));
+			} else {
+				device->GetLoader()->vkCmdDrawIndexedIndirectCountKHR(commandBuffer, drawBuffers[frameIndex], drawOffset, countBuffers[frameIndex], countOffset, instanceCount, sizeof(VkDrawIndexedIndirectCommand));
+			}
+
+			return;
+		}
+
+		// Draw every instance's command in one call, with the culled instances having no instances to draw
+		device->GetLoader()->vkCmdDrawIndexedIndirect(commandBuffer, drawBuffers[frameIndex], drawOffset, instanceCount, sizeof(VkDrawIndexedIndirectCommand));
+	}
+
+	VulkanGpuCuller::~VulkanGpuCuller() {
+		// Destroy the culling pipelines
+		device->GetLoader()->vkDestroyPipeline(device->GetDevice(), pipeline, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+		device->GetLoader()->vkDestroyPipeline(device->GetDevice(), occlusionPipeline, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+
+		// Destroy every frame's buffers
+		for(size_t i = 0; i != Renderer::MAX_FRAMES_IN_FLIGHT; ++i) {
+			device->GetLoader()->vkDestroyBuffer(device->GetDevice(), drawBuffers[i], &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+			allocator->FreeMemory(drawMemories[i]);
+			device->GetLoader()->vkDestroyBuffer(device->GetDevice(), countBuffers[i], &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+			allocator->FreeMemory(countMemories[i]);
+			device->GetLoader()->vkDestroyBuffer(device->GetDevice(), readbackBuffers[i], &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+			allocator->FreeMemory(readbackMemories[i]);
+			device->GetLoader()->vkDestroyBuffer(device->GetDevice(), stagingBuffers[i], &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+			allocator->FreeMemory(stagingMemories[i]);
+		}
+
+		// Destroy the visibility, instance and mesh buffers
+		device->GetLoader()->vkDestroyBuffer(device->GetDevice(), visibilityBuffer, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+		allocator->FreeMemory(visibilityMemory);
+		device->GetLoader()->vkDestroyBuffer(device->GetDevice(), instanceBuffer, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+		allocator->FreeMemory(instanceMemory);
+		device->GetLoader()->vkDestroyBuffer(device->GetDevice(), meshBuffer, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+		allocator->FreeMemory(meshMemory);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,265 @@
+#pragma once
+
+#include "VulkanDepthPyramid.hpp"
+#include "Renderer/Renderer.hpp"
+#include "Renderer/Vulkan/Descriptor/VulkanDescriptorAllocator.hpp"
+#include "Renderer/Vulkan/Instance/VulkanAllocator.hpp"
+#include "Renderer/Vulkan/Instance/VulkanDevice.hpp"
+#include "Renderer/Vulkan/Shader/VulkanPipelineVariantCache.hpp"
+#include "Renderer/Vulkan/Shader/VulkanShaderLibrary.hpp"
+
+#include <Core.hpp>
+#include <vulkan/vk_platform.h>
+#include <vulkan/vulkan_core.h>
+
+namespace wfe {
+	/// @brief A GPU-driven culler, which culls instances in a compute shader and writes the visible instances' indirect draw commands. Culling is split into two phases: the early phase draws the instances visible last frame, which are then used to build the depth pyramid, and the late phase occlusion culls every instance against the pyramid and draws the newly visible ones. Every drawn instance uses the LOD of its mesh whose projected error is within the allowed screen-space error.
+	class VulkanGpuCuller {
+	public:
+		/// @brief The number of instances culled by a single compute workgroup.
+		static const uint32_t WORKGROUP_SIZE = 64;
+		/// @brief The maximum number of LODs of a single mesh.
+		static const uint32_t MAX_LOD_COUNT = 8;
+		/// @brief The maximum projected error of a selected LOD at no LOD bias, in pixels.
+		static constexpr float32_t MAX_PIXEL_ERROR = 1.f;
+
+		/// @brief An enum containing the culling phases.
+		enum Phase {
+			/// @brief The early phase, which draws the instances in the frustum that were visible last frame.
+			PHASE_EARLY,
+			/// @brief The late phase, which tests every instance in the frustum against the depth pyramid, draws the newly visible ones and saves the visible set for the next frame.
+			PHASE_LATE
+		};
+
+		/// @brief A struct containing a single instance's culling and draw info. Must match the instance struct in InstanceCullCommon.glsl.
+		struct Instance {
+			/// @brief The instance's world space bounding sphere, with the center in xyz and the radius in w.
+			float32_t boundingSphere[4];
+			/// @brief The index of the instance's mesh.
+			uint32_t meshIndex;
+			/// @brief Padding to keep every instance 32 bytes large.
+			uint32_t padding[3];
+		};
+		/// @brief A struct containing a single mesh LOD's index range. Must match the mesh LOD struct in InstanceCullCommon.glsl.
+		struct MeshLod {
+			/// @brief The number of the LOD's indices.
+			uint32_t indexCount;
+			/// @brief The LOD's first index in the index buffer.
+			uint32_t firstIndex;
+			/// @brief The LOD's geometric error compared to the full detail mesh, in world units.
+			float32_t error;
+			/// @brief Padding to keep every LOD 16 bytes large.
+			uint32_t padding;
+		};
+		/// @brief A struct containing a mesh's LODs. Must match the mesh struct in InstanceCullCommon.glsl.
+		struct Mesh {
+			/// @brief The mesh's LODs, ordered from the most to the least detailed, with increasing errors.
+			MeshLod lods[MAX_LOD_COUNT];
+			/// @brief The offset added to the mesh's vertex indices, shared by every LOD.
+			int32_t vertexOffset;
+			/// @brief The number of the mesh's LODs.
+			uint32_t lodCount;
+			/// @brief Padding to keep every mesh's size a multiple of 16 bytes.
+			uint32_t padding[2];
+		};
+		/// @brief A struct containing the view instances are culled and their LODs are selected for.
+		struct View {
+			/// @brief The column-major view projection matrix, which maps depth to Vulkan's [0, 1] range.
+			float32_t viewProjection[16];
+			/// @brief The camera's world space position.
+			float32_t cameraPosition[3];
+			/// @brief The projection's vertical scale, equal to the cotangent of half the vertical field of view.
+			float32_t projectionScale;
+			/// @brief The extent of the rendered viewport, usually the swap chain's extent.
+			VkExtent2D viewportExtent;
+		};
+		/// @brief A struct containing a frame's culling statistics. Must match the count buffer in InstanceCullCommon.glsl.
+		struct Stats {
+			/// @brief The number of draws recorded by the early phase. Only counted if the draw count is supported.
+			uint32_t earlyDrawCount;
+			/// @brief The number of draws recorded by the late phase. Only counted if the draw count is supported.
+			uint32_t lateDrawCount;
+			/// @brief The number of visible instances.
+			uint32_t visibleCount;
+			/// @brief The number of instances outside of the frustum.
+			uint32_t frustumCulledCount;
+			/// @brief The number of instances in the frustum hidden behind the depth pyramid.
+			uint32_t occlusionCulledCount;
+		};
+
+		/// @brief Checks if the given device supports the features required by the GPU culler.
+		/// @param device The Vulkan device to check.
+		/// @return True if the GPU culler can be created for the device, otherwise false.
+		static bool8_t IsSupported(const VulkanDevice* device);
+
+		/// @brief Creates a Vulkan GPU culler.
+		/// @param device The Vulkan device to create the culler's resources for. It must support all features checked by IsSupported.
+		/// @param allocator The allocator used to allocate the culler's buffers.
+		/// @param shaderLibrary The shader library to load the culling shaders from.
+		/// @param pipelineVariantCache The pipeline variant cache whose pipeline cache is used to create the culling pipelines.
+		/// @param descriptorAllocator The descriptor allocator to get the culling descriptor sets from.
+		/// @param maxInstanceCount The maximum number of instances the culler can hold.
+		/// @param maxMeshCount The maximum number of meshes the culler can hold.
+		VulkanGpuCuller(VulkanDevice* device, VulkanAllocator* allocator, VulkanShaderLibrary* shaderLibrary, VulkanPipelineVariantCache* pipelineVariantCache, VulkanDescriptorAllocator* descriptorAllocator, uint32_t maxInstanceCount, uint32_t maxMeshCount);
+		VulkanGpuCuller(const VulkanGpuCuller&) = delete;
+		VulkanGpuCuller(VulkanGpuCuller&&) noexcept = delete;
+
+		VulkanGpuCuller& operator=(const VulkanGpuCuller&) = delete;
+		VulkanGpuCuller& operator=(VulkanGpuCuller&&) = delete;
+
+		/// @brief Gets the Vulkan function loader used by the culler.
+		/// @return A pointer to the Vulkan loader used by the culler.
+		const VulkanLoader* GetLoader() const {
+			return device->GetLoader();
+		}
+		/// @brief Gets the Vulkan device that owns the culler.
+		/// @return A pointer to the Vulkan device wrapper object.
+		VulkanDevice* GetDevice() {
+			return device;
+		}
+		/// @brief Gets the Vulkan device that owns the culler.
+		/// @return A const pointer to the Vulkan device wrapper object.
+		const VulkanDevice* GetDevice() const {
+			return device;
+		}
+		/// @brief Gets the maximum number of instances the culler can hold.
+		/// @return The maximum instance count.
+		uint32_t GetMaxInstanceCount() const {
+			return maxInstanceCount;
+		}
+		/// @brief Gets the number of instances currently culled every frame.
+		/// @return The instance count.
+		uint32_t GetInstanceCount() const {
+			return instanceCount;
+		}
+		/// @brief Gets the maximum number of meshes the culler can hold.
+		/// @return The maximum mesh count.
+		uint32_t GetMaxMeshCount() const {
+			return maxMeshCount;
+		}
+		/// @brief Gets the global LOD bias.
+		/// @return The LOD bias.
+		float32_t GetLodBias() const {
+			return lodBias;
+		}
+		/// @brief Checks if the draw count is read from the count buffer, allowing the draw commands to be compacted.
+		/// @return True if the draw count is read from the count buffer, otherwise false.
+		bool8_t IsDrawCountSupported() const {
+			return drawCountSupported;
+		}
+		/// @brief Gets the buffer containing the given frame's indirect draw commands.
+		/// @param frameIndex The index of the frame in flight.
+		/// @return A handle to the Vulkan draw command buffer.
+		VkBuffer GetDrawBuffer(size_t frameIndex) {
+			return drawBuffers[frameIndex];
+		}
+		/// @brief Gets the buffer containing the given frame's draw counts, followed by the rest of its statistics.
+		/// @param frameIndex The index of the frame in flight.
+		/// @return A handle to the Vulkan count buffer.
+		VkBuffer GetCountBuffer(size_t frameIndex) {
+			return countBuffers[frameIndex];
+		}
+		/// @brief Gets the given frame's culling statistics, which are read back after its late phase.
+		/// @param frameIndex The index of the frame in flight, whose submission must have finished executing.
+		/// @return A const reference to the frame's statistics.
+		const Stats& GetStats(size_t frameIndex) const {
+			return *readbackStats[frameIndex];
+		}
+
+		/// @brief Sets the info of the given instances. The instances are uploaded by the next recorded cull through that frame's staging buffer, so only changed instances cost any CPU time.
+		/// @param firstInstance The index of the first instance to set.
+		/// @param count The number of instances to set.
+		/// @param instances A pointer to an array of the instances' info.
+		void SetInstances(uint32_t firstInstance, uint32_t count, const Instance* instances);
+		/// @brief Sets the LODs of the given meshes. The meshes are uploaded by the next recorded cull.
+		/// @param firstMesh The index of the first mesh to set.
+		/// @param count The number of meshes to set.
+		/// @param meshes A pointer to an array of the meshes' LODs.
+		void SetMeshes(uint32_t firstMesh, uint32_t count, const Mesh* meshes);
+		/// @brief Sets the global LOD bias, used to scale performance dynamically. Every unit of bias doubles the allowed screen-space error, so positive biases select coarser LODs.
+		/// @param bias The new LOD bias.
+		void SetLodBias(float32_t bias);
+		/// @brief Sets the number of instances culled every frame.
+		/// @param count The new instance count, which must not exceed the maximum instance count.
+		void SetInstanceCount(uint32_t count);
+
+		/// @brief Records the given culling phase's dispatch for the given frame. The early phase also uploads the changed instances and meshes and resets the frame's counts, while the late phase also reads back the frame's statistics. The command buffer may belong to the compute queue; when it does, the graphics submission must wait on it at VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT.
+		/// @param commandBuffer The command buffer to record the commands in.
+		/// @param frameIndex The index of the frame in flight.
+		/// @param phase The culling phase to record.
+		/// @param view The view to cull the instances and select their LODs for.
+		/// @param depthPyramid The depth pyramid built from the early phase's draws, used only by the late phase. If it's nullptr or wasn't built yet, the late phase only frustum culls.
+		void RecordCull(VkCommandBuffer commandBuffer, size_t frameIndex, Phase phase, const View& view, VulkanDepthPyramid* depthPyramid = nullptr);
+		/// @brief Records the indirect draws written by the given culling phase. The caller must bind the graphics pipeline and the index and vertex buffers beforehand.
+		/// @param commandBuffer The command buffer to record the draws in.
+		/// @param frameIndex The index of the frame in flight.
+		/// @param phase The culling phase whose draws to record.
+		void RecordDraws(VkCommandBuffer commandBuffer, size_t frameIndex, Phase phase);
+
+		/// @brief Destroys the Vulkan GPU culler.
+		~VulkanGpuCuller();
+	private:
+		enum CullFlags {
+			CULL_FLAG_COMPACT = 1,
+			CULL_FLAG_LATE_PHASE = 2
+		};
+		struct PushConstants {
+			float32_t viewProjection[16];
+			float32_t cameraPosition[3];
+			float32_t lodScale;
+			float32_t pyramidSize[2];
+			uint32_t instanceCount;
+			uint32_t flags;
+			uint32_t lateDrawOffset;
+		};
+
+		void WriteDescriptorSet(VkDescriptorSet descriptorSet, size_t frameIndex, VulkanDepthPyramid* depthPyramid);
+		void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VulkanAllocator::MemoryType memoryType, bool8_t shared, VkBuffer& buffer, VulkanAllocator::MemoryBlock& memoryBlock);
+		VkPipeline CreatePipeline(const VulkanShaderLibrary::PipelineLayout* pipelineLayout, const VulkanShaderLibrary::ShaderModule* shaderModule, VkPipelineCache pipelineCache);
+
+		VulkanDevice* device;
+		VulkanAllocator* allocator;
+		VulkanDescriptorAllocator* descriptorAllocator;
+
+		uint32_t maxInstanceCount;
+		uint32_t instanceCount;
+		uint32_t maxMeshCount;
+		float32_t lodBias;
+		bool8_t drawCountSupported;
+
+		VkBuffer instanceBuffer;
+		VulkanAllocator::MemoryBlock instanceMemory;
+		vector<Instance> hostInstances;
+		uint32_t dirtyBegin;
+		uint32_t dirtyEnd;
+
+		VkBuffer meshBuffer;
+		VulkanAllocator::MemoryBlock meshMemory;
+		vector<Mesh> hostMeshes;
+		uint32_t dirtyMeshBegin;
+		uint32_t dirtyMeshEnd;
+
+		VkBuffer visibilityBuffer;
+		VulkanAllocator::MemoryBlock visibilityMemory;
+		bool8_t visibilityCleared;
+
+		VkDeviceSize meshStagingOffset;
+		VkBuffer stagingBuffers[Renderer::MAX_FRAMES_IN_FLIGHT];
+		VulkanAllocator::MemoryBlock stagingMemories[Renderer::MAX_FRAMES_IN_FLIGHT];
+		uint8_t* stagingData[Renderer::MAX_FRAMES_IN_FLIGHT];
+
+		VkBuffer drawBuffers[Renderer::MAX_FRAMES_IN_FLIGHT];
+		VulkanAllocator::MemoryBlock drawMemories[Renderer::MAX_FRAMES_IN_FLIGHT];
+		VkBuffer countBuffers[Renderer::MAX_FRAMES_IN_FLIGHT];
+		VulkanAllocator::MemoryBlock countMemories[Renderer::MAX_FRAMES_IN_FLIGHT];
+		VkBuffer readbackBuffers[Renderer::MAX_FRAMES_IN_FLIGHT];
+		VulkanAllocator::MemoryBlock readbackMemories[Renderer::MAX_FRAMES_IN_FLIGHT];
+		Stats* readbackStats[Renderer::MAX_FRAMES_IN_FLIGHT];
+		VkDescriptorSet descriptorSets[Renderer::MAX_FRAMES_IN_FLIGHT];
+
+		const VulkanShaderLibrary::PipelineLayout* pipelineLayout;
+		VkPipeline pipeline;
+		const VulkanShaderLibrary::PipelineLayout* occlusionPipelineLayout;
+		VkPipeline occlusionPipeline;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,481 @@
+#include "VulkanMeshletCuller.hpp"
+#include "Renderer/Vulkan/VulkanRenderer.hpp"
+
+#include <vulkan/vk_enum_string_helper.h>
+
+namespace wfe {
+	// Constants
+	static const char_t CULL_SHADER_NAME[] = "MeshletCull.comp";
+	static const char_t TASK_SHADER_NAME[] = "MeshletCull.task";
+	static const char_t MESH_SHADER_NAME[] = "Meshlet.mesh";
+	static const char_t VERTEX_SHADER_NAME[] = "Meshlet.vert";
+	static const uint32_t MAX_DISPATCH_ROW_SIZE = 65535;
+
+	// Internal helper functions
+	void VulkanMeshletCuller::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VulkanAllocator::MemoryType memoryType, VkBuffer& buffer, VulkanAllocator::MemoryBlock& memoryBlock) {
+		// Set the buffer's create info
+		VkBufferCreateInfo createInfo {
+			.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.size = size,
+			.usage = usage,
+			.sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+			.queueFamilyIndexCount = 0,
+			.pQueueFamilyIndices = nullptr
+		};
+
+		// Create the buffer
+		VkResult result = device->GetLoader()->vkCreateBuffer(device->GetDevice(), &createInfo, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS, &buffer);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to create Vulkan meshlet culler buffer! Error code: %s", string_VkResult(result));
+
+		// Allocate and bind the buffer's memory
+		result = allocator->AllocBufferMemory(buffer, memoryType, memoryBlock);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to allocate Vulkan meshlet culler buffer memory! Error code: %s", string_VkResult(result));
+
+		result = allocator->BindBufferMemories(1, &buffer, &memoryBlock);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to bind Vulkan meshlet culler buffer memory! Error code: %s", string_VkResult(result));
+	}
+	void VulkanMeshletCuller::CreateUploadBuffer(VkDeviceSize size, VkBufferUsageFlags usage, UploadBuffer& uploadBuffer) {
+		// Create the buffer and its persistently mapped staging buffer
+		CreateBuffer(size, usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VulkanAllocator::MEMORY_TYPE_GPU, uploadBuffer.buffer, uploadBuffer.memory);
+		CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VulkanAllocator::MEMORY_TYPE_CPU_GPU_VISIBLE, uploadBuffer.stagingBuffer, uploadBuffer.stagingMemory);
+
+		void* stagingData;
+		VkResult result = allocator->MapMemory(uploadBuffer.stagingMemory, stagingData);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to map Vulkan meshlet culler staging memory! Error code: %s", string_VkResult(result));
+
+		uploadBuffer.stagingData = (uint8_t*)stagingData;
+		uploadBuffer.dirtyBegin = VK_WHOLE_SIZE;
+		uploadBuffer.dirtyEnd = 0;
+	}
+	void VulkanMeshletCuller::MarkUploadRange(UploadBuffer& uploadBuffer, VkDeviceSize offset, VkDeviceSize size) {
+		// Extend the range uploaded by the next cull
+		if(offset < uploadBuffer.dirtyBegin)
+			uploadBuffer.dirtyBegin = offset;
+		if(offset + size > uploadBuffer.dirtyEnd)
+			uploadBuffer.dirtyEnd = offset + size;
+	}
+	void VulkanMeshletCuller::RecordUpload(VkCommandBuffer commandBuffer, UploadBuffer& uploadBuffer) {
+		// Exit the function if nothing changed since the last upload
+		if(uploadBuffer.dirtyBegin >= uploadBuffer.dirtyEnd)
+			return;
+
+		VkBufferCopy copyRegion {
+			.srcOffset = uploadBuffer.dirtyBegin,
+			.dstOffset = uploadBuffer.dirtyBegin,
+			.size = uploadBuffer.dirtyEnd - uploadBuffer.dirtyBegin
+		};
+
+		device->GetLoader()->vkCmdCopyBuffer(commandBuffer, uploadBuffer.stagingBuffer, uploadBuffer.buffer, 1, &copyRegion);
+
+		uploadBuffer.dirtyBegin = VK_WHOLE_SIZE;
+		uploadBuffer.dirtyEnd = 0;
+	}
+	void VulkanMeshletCuller::DestroyUploadBuffer(UploadBuffer& uploadBuffer) {
+		device->GetLoader()->vkDestroyBuffer(device->GetDevice(), uploadBuffer.buffer, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+		allocator->FreeMemory(uploadBuffer.memory);
+		device->GetLoader()->vkDestroyBuffer(device->GetDevice(), uploadBuffer.stagingBuffer, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+		allocator->FreeMemory(uploadBuffer.stagingMemory);
+	}
+	void VulkanMeshletCuller::BuildGroups() {
+		// Split every instance's meshlets into groups culled by a single workgroup
+		Group* groups = (Group*)groupBuffer.stagingData;
+		groupCount = 0;
+
+		for(uint32_t i = 0; i != instanceCount; ++i) {
+			// Skip the instances that were never set
+			if(instanceMeshes[i] == UINT32_T_MAX)
+				continue;
+
+			const Mesh& mesh = meshes[instanceMeshes[i]];
+
+			for(uint32_t offset = 0; offset < mesh.meshletCount; offset += GROUP_SIZE) {
+				if(groupCount == limits.maxGroupCount)
+					throw Exception("Exceeded the Vulkan meshlet culler's capacity of %u meshlet groups!", limits.maxGroupCount);
+
+				Group& group = groups[groupCount++];
+				group.instanceIndex = i;
+				group.firstMeshlet = mesh.firstMeshlet + offset;
+				group.meshletCount = mesh.meshletCount - offset < GROUP_SIZE ? mesh.meshletCount - offset : GROUP_SIZE;
+				group.padding = 0;
+			}
+		}
+
+		MarkUploadRange(groupBuffer, 0, groupCount * sizeof(Group));
+		groupsDirty = false;
+	}
+	void VulkanMeshletCuller::GetDispatchSize(uint32_t& groupCountX, uint32_t& groupCountY) const {
+		// Split the groups into rows, as a single dimension may not fit every group
+		groupCountX = groupCount < MAX_DISPATCH_ROW_SIZE ? groupCount : MAX_DISPATCH_ROW_SIZE;
+		groupCountY = (groupCount + groupCountX - 1) / groupCountX;
+	}
+
+	// Public functions
+	VulkanMeshletCuller::VulkanMeshletCuller(VulkanDevice* device, VulkanAllocator* allocator, VulkanShaderLibrary* shaderLibrary, VulkanPipelineVariantCache* pipelineVariantCache, VulkanDescriptorAllocator* descriptorAllocator, const Limits& limits) : device(device), allocator(allocator), descriptorAllocator(descriptorAllocator), limits(limits), meshletCount(0), meshletVertexCount(0), triangleCount(0), vertexCount(0), instanceCount(0), groupCount(0), groupsDirty(false), pipelineLayout(nullptr), pipeline(VK_NULL_HANDLE) {
+		// Cull and draw the meshlets using mesh shaders if they're supported, and compact the fallback's draws if the draw count can be read from a buffer
+		meshShading = device->GetCapabilities().meshShader;
+		drawCountSupported = device->GetCapabilities().drawIndirectCount;
+		memset(&pushConstants, 0, sizeof(PushConstants));
+
+		// Create the geometry, instance and group buffers; the meshlet index buffer is only drawn without mesh shaders
+		CreateUploadBuffer(limits.maxMeshletCount * sizeof(MeshletBuilder::Meshlet), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, meshletBuffer);
+		CreateUploadBuffer(limits.maxMeshletCount * MeshletBuilder::MAX_VERTEX_COUNT * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, meshletVertexBuffer);
+		CreateUploadBuffer(limits.maxTriangleCount * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, triangleBuffer);
+		CreateUploadBuffer(limits.maxVertexCount * 3 * sizeof(float32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, positionBuffer);
+		CreateUploadBuffer(limits.maxInstanceCount * sizeof(Instance), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, instanceBuffer);
+		CreateUploadBuffer(limits.maxGroupCount * sizeof(Group), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, groupBuffer);
+
+		instanceMeshes.resize(limits.maxInstanceCount);
+		for(uint32_t i = 0; i != limits.maxInstanceCount; ++i)
+			instanceMeshes[i] = UINT32_T_MAX;
+
+		if(meshShading) {
+			// Load the task and mesh shaders, whose graphics pipelines are created by the caller
+			taskShaderModule = shaderLibrary->GetShaderModule(TASK_SHADER_NAME);
+			meshShaderModule = shaderLibrary->GetShaderModule(MESH_SHADER_NAME);
+			vertexShaderModule = nullptr;
+			return;
+		}
+
+		taskShaderModule = nullptr;
+		meshShaderModule = nullptr;
+		vertexShaderModule = shaderLibrary->GetShaderModule(VERTEX_SHADER_NAME);
+
+		CreateUploadBuffer(limits.maxTriangleCount * 3 * sizeof(uint32_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT, indexBuffer);
+
+		// Create every frame's draw and count buffers, as the previous frame may still read its draws
+		for(size_t i = 0; i != Renderer::MAX_FRAMES_IN_FLIGHT; ++i) {
+			CreateBuffer(limits.maxGroupCount * GROUP_SIZE * sizeof(VkDrawIndexedIndirectCommand), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VulkanAllocator::MEMORY_TYPE_GPU, drawBuffers[i], drawMemories[i]);
+			CreateBuffer(sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VulkanAllocator::MEMORY_TYPE_GPU, countBuffers[i], countMemories[i]);
+		}
+
+		// Load the culling shader and create its pipeline
+		const VulkanShaderLibrary::ShaderModule* shaderModule = shaderLibrary->GetShaderModule(CULL_SHADER_NAME);
+		pipelineLayout = shaderLibrary->GetPipelineLayout(1, &shaderModule);
+
+		VkComputePipelineCreateInfo createInfo {
+			.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.stage = {
+				.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+				.pNext = nullptr,
+				.flags = 0,
+				.stage = VK_SHADER_STAGE_COMPUTE_BIT,
+				.module = shaderModule->shaderModule,
+				.pName = "main",
+				.pSpecializationInfo = nullptr
+			},
+			.layout = pipelineLayout->pipelineLayout,
+			.basePipelineHandle = VK_NULL_HANDLE,
+			.basePipelineIndex = -1
+		};
+
+		VkResult result = device->GetLoader()->vkCreateComputePipelines(device->GetDevice(), pipelineVariantCache->GetPipelineCache(), 1, &createInfo, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS, &pipeline);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to create Vulkan meshlet culling pipeline! Error code: %s", string_VkResult(result));
+
+		// Allocate and write every frame's culling descriptor set
+		for(size_t i = 0; i != Renderer::MAX_FRAMES_IN_FLIGHT; ++i) {
+			descriptorSets[i] = descriptorAllocator->AllocDescriptorSet(pipelineLayout->setLayouts[0]);
+
+			VulkanDescriptorAllocator::DescriptorWrite writes[5];
+			writes[0].binding = 0;
+			writes[0].arrayElement = 0;
+			writes[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			writes[0].bufferInfo = { meshletBuffer.buffer, 0, VK_WHOLE_SIZE };
+			writes[1].binding = 4;
+			writes[1].arrayElement = 0;
+			writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			writes[1].bufferInfo = { instanceBuffer.buffer, 0, VK_WHOLE_SIZE };
+			writes[2].binding = 5;
+			writes[2].arrayElement = 0;
+			writes[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			writes[2].bufferInfo = { groupBuffer.buffer, 0, VK_WHOLE_SIZE };
+			writes[3].binding = 6;
+			writes[3].arrayElement = 0;
+			writes[3].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			writes[3].bufferInfo = { drawBuffers[i], 0, VK_WHOLE_SIZE };
+			writes[4].binding = 7;
+			writes[4].arrayElement = 0;
+			writes[4].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			writes[4].bufferInfo = { countBuffers[i], 0, VK_WHOLE_SIZE };
+
+			descriptorAllocator->WriteDescriptorSet(descriptorSets[i], 5, writes);
+		}
+	}
+
+	uint32_t VulkanMeshletCuller::GetShaderModules(const VulkanShaderLibrary::ShaderModule** shaderModules) const {
+		if(meshShading) {
+			shaderModules[0] = taskShaderModule;
+			shaderModules[1] = meshShaderModule;
+			return 2;
+		}
+
+		shaderModules[0] = vertexShaderModule;
+		return 1;
+	}
+	uint32_t VulkanMeshletCuller::AddMesh(const MeshletBuilder& builder, const float32_t* positions, size_t positionStride, uint32_t meshVertexCount) {
+		const vector<MeshletBuilder::Meshlet>& builderMeshlets = builder.GetMeshlets();
+		const vector<uint32_t>& builderVertices = builder.GetMeshletVertices();
+		const vector<uint32_t>& builderTriangles = builder.GetMeshletTriangles();
+
+		// Check if the mesh fits in the culler
+		if(meshletCount + builderMeshlets.size() > limits.maxMeshletCount)
+			throw Exception("Exceeded the Vulkan meshlet culler's capacity of %u meshlets!", limits.maxMeshletCount);
+		if(meshletVertexCount + builderVertices.size() > (size_t)limits.maxMeshletCount * MeshletBuilder::MAX_VERTEX_COUNT)
+			throw Exception("Exceeded the Vulkan meshlet culler's capacity of %u meshlet vertices!", limits.maxMeshletCount * MeshletBuilder::MAX_VERTEX_COUNT);
+		if(triangleCount + builderTriangles.size() > limits.maxTriangleCount)
+			throw Exception("Exceeded the Vulkan meshlet culler's capacity of %u triangles!", limits.maxTriangleCount);
+		if(vertexCount + meshVertexCount > limits.maxVertexCount)
+			throw Exception("Exceeded the Vulkan meshlet culler's capacity of %u vertices!", limits.maxVertexCount);
+
+		// Write the meshlets, offsetting their ranges to the culler's arrays
+		MeshletBuilder::Meshlet* meshlets = (MeshletBuilder::Meshlet*)meshletBuffer.stagingData + meshletCount;
+		for(size_t i = 0; i != builderMeshlets.size(); ++i) {
+			meshlets[i] = builderMeshlets[i];
+			meshlets[i].vertexOffset += meshletVertexCount;
+			meshlets[i].triangleOffset += triangleCount;
+		}
+
+		MarkUploadRange(meshletBuffer, meshletCount * sizeof(MeshletBuilder::Meshlet), builderMeshlets.size() * sizeof(MeshletBuilder::Meshlet));
+
+		// Write the meshlet vertices and indices, offsetting them to the mesh's first vertex
+		uint32_t* meshletVertices = (uint32_t*)meshletVertexBuffer.stagingData + meshletVertexCount;
+		for(size_t i = 0; i != builderVertices.size(); ++i)
+			meshletVertices[i] = builderVertices[i] + vertexCount;
+
+		MarkUploadRange(meshletVertexBuffer, meshletVertexCount * sizeof(uint32_t), builderVertices.size() * sizeof(uint32_t));
+
+		memcpy((uint32_t*)triangleBuffer.stagingData + triangleCount, builderTriangles.data(), builderTriangles.size() * sizeof(uint32_t));
+		MarkUploadRange(triangleBuffer, triangleCount * sizeof(uint32_t), builderTriangles.size() * sizeof(uint32_t));
+
+		if(!meshShading) {
+			const vector<uint32_t>& builderIndices = builder.GetMeshletIndices();
+
+			uint32_t* indices = (uint32_t*)indexBuffer.stagingData + triangleCount * 3;
+			for(size_t i = 0; i != builderIndices.size(); ++i)
+				indices[i] = builderIndices[i] + vertexCount;
+
+			MarkUploadRange(indexBuffer, triangleCount * 3 * sizeof(uint32_t), builderIndices.size() * sizeof(uint32_t));
+		}
+
+		// Write the tightly packed vertex positions
+		float32_t* packedPositions = (float32_t*)positionBuffer.stagingData + vertexCount * 3;
+		for(uint32_t i = 0; i != meshVertexCount; ++i)
+			memcpy(packedPositions + i * 3, (const uint8_t*)positions + i * positionStride, 3 * sizeof(float32_t));
+
+		MarkUploadRange(positionBuffer, vertexCount * 3 * sizeof(float32_t), meshVertexCount * 3 * sizeof(float32_t));
+
+		// Add the mesh
+		Mesh mesh;
+		mesh.firstMeshlet = meshletCount;
+		mesh.meshletCount = (uint32_t)builderMeshlets.size();
+		meshes.push_back(mesh);
+
+		meshletCount += (uint32_t)builderMeshlets.size();
+		meshletVertexCount += (uint32_t)builderVertices.size();
+		triangleCount += (uint32_t)builderTriangles.size();
+		vertexCount += meshVertexCount;
+
+		return (uint32_t)meshes.size() - 1;
+	}
+	void VulkanMeshletCuller::SetInstances(uint32_t firstInstance, uint32_t count, const Instance* instances) {
+		// Check if the instances fit in the culler
+		if(firstInstance + count > limits.maxInstanceCount)
+			throw Exception("Exceeded the Vulkan meshlet culler's capacity of %u instances!", limits.maxInstanceCount);
+
+		// Rebuild the groups if any instance's mesh changed
+		for(uint32_t i = 0; i != count; ++i) {
+			if(instances[i].meshIndex >= meshes.size())
+				throw Exception("Vulkan meshlet culler instance uses nonexistent mesh %u!", instances[i].meshIndex);
+
+			if(instanceMeshes[firstInstance + i] != instances[i].meshIndex) {
+				instanceMeshes[firstInstance + i] = instances[i].meshIndex;
+				groupsDirty = true;
+			}
+		}
+
+		// Write the instances to the staging buffer
+		memcpy((Instance*)instanceBuffer.stagingData + firstInstance, instances, count * sizeof(Instance));
+		MarkUploadRange(instanceBuffer, firstInstance * sizeof(Instance), count * sizeof(Instance));
+	}
+	void VulkanMeshletCuller::SetInstanceCount(uint32_t count) {
+		// Check if the instance count fits in the culler
+		if(count > limits.maxInstanceCount)
+			throw Exception("Exceeded the Vulkan meshlet culler's capacity of %u instances!", limits.maxInstanceCount);
+
+		if(count != instanceCount) {
+			instanceCount = count;
+			groupsDirty = true;
+		}
+	}
+
+	void VulkanMeshletCuller::RecordCull(VkCommandBuffer commandBuffer, size_t frameIndex, const float32_t* viewProjection, const float32_t* cameraPosition) {
+		// Rebuild the groups if the instances changed and upload every changed buffer
+		if(groupsDirty)
+			BuildGroups();
+
+		RecordUpload(commandBuffer, meshletBuffer);
+		RecordUpload(commandBuffer, meshletVertexBuffer);
+		RecordUpload(commandBuffer, triangleBuffer);
+		RecordUpload(commandBuffer, positionBuffer);
+		RecordUpload(commandBuffer, instanceBuffer);
+		RecordUpload(commandBuffer, groupBuffer);
+
+		// Save the view's push constants, which are also used by the draws
+		memcpy(pushConstants.viewProjection, viewProjection, sizeof(pushConstants.viewProjection));
+		memcpy(pushConstants.cameraPosition, cameraPosition, sizeof(pushConstants.cameraPosition));
+		pushConstants.groupCount = groupCount;
+		pushConstants.flags = drawCountSupported ? CULL_FLAG_COMPACT : 0;
+
+		if(meshShading) {
+			// Make the uploads visible to the task and mesh shaders
+			VkMemoryBarrier uploadBarrier {
+				.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+				.pNext = nullptr,
+				.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+				.dstAccessMask = VK_ACCESS_SHADER_READ_BIT
+			};
+
+			device->GetLoader()->vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TASK_SHADER_BIT_EXT | VK_PIPELINE_STAGE_MESH_SHADER_BIT_EXT, 0, 1, &uploadBarrier, 0, nullptr, 0, nullptr);
+			return;
+		}
+
+		// Upload the meshlet index buffer and reset the frame's draw count
+		RecordUpload(commandBuffer, indexBuffer);
+		device->GetLoader()->vkCmdFillBuffer(commandBuffer, countBuffers[frameIndex], 0, sizeof(uint32_t), 0);
+
+		// Make the transfers visible to the culling shader and the vertex shader's index and storage reads
+		VkMemoryBarrier uploadBarrier {
+			.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+			.pNext = nullptr,
+			.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+			.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_INDEX_READ_BIT
+		};
+
+		device->GetLoader()->vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, 0, 1, &uploadBarrier, 0, nullptr, 0, nullptr);
+
+		// Dispatch the culling shader, if there are any meshlet groups
+		if(groupCount) {
+			uint32_t groupCountX, groupCountY;
+			GetDispatchSize(groupCountX, groupCountY);
+
+			device->GetLoader()->vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+			device->GetLoader()->vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout->pipelineLayout, 0, 1, descriptorSets + frameIndex, 0, nullptr);
+			device->GetLoader()->vkCmdPushConstants(commandBuffer, pipelineLayout->pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants), &pushConstants);
+			device->GetLoader()->vkCmdDispatch(commandBuffer, groupCountX, groupCountY, 1);
+		}
+
+		// Make the draw commands and count visible to the indirect draws
+		VkMemoryBarrier drawBarrier {
+			.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+			.pNext = nullptr,
+			.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+			.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT
+		};
+
+		device->GetLoader()->vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, 1, &drawBarrier, 0, nullptr, 0, nullptr);
+	}
+	void VulkanMeshletCuller::RecordDraws(VkCommandBuffer commandBuffer, size_t frameIndex, const VulkanShaderLibrary::PipelineLayout* drawPipelineLayout) {
+		// Exit the function if there are no meshlets to draw
+		if(!groupCount)
+			return;
+
+		// Write a transient descriptor set for the bound pipeline's geometry stages
+		VulkanDescriptorAllocator::DescriptorWrite writes[6];
+		VkShaderStageFlags pushConstantStages;
+		uint32_t writeCount;
+
+		if(meshShading) {
+			VkBuffer buffers[] = { meshletBuffer.buffer, meshletVertexBuffer.buffer, triangleBuffer.buffer, positionBuffer.buffer, instanceBuffer.buffer, groupBuffer.buffer };
+			for(uint32_t i = 0; i != 6; ++i) {
+				writes[i].binding = i;
+				writes[i].arrayElement = 0;
+				writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+				writes[i].bufferInfo = { buffers[i], 0, VK_WHOLE_SIZE };
+			}
+
+			pushConstantStages = VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT;
+			writeCount = 6;
+		} else {
+			writes[0].binding = 3;
+			writes[0].arrayElement = 0;
+			writes[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			writes[0].bufferInfo = { positionBuffer.buffer, 0, VK_WHOLE_SIZE };
+			writes[1].binding = 4;
+			writes[1].arrayElement = 0;
+			writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			writes[1].bufferInfo = { instanceBuffer.buffer, 0, VK_WHOLE_SIZE };
+
+			pushConstantStages = VK_SHADER_STAGE_VERTEX_BIT;
+			writeCount = 2;
+		}
+
+		VkDescriptorSet descriptorSet = descriptorAllocator->AllocTransientDescriptorSet(drawPipelineLayout->setLayouts[0]);
+		descriptorAllocator->WriteDescriptorSet(descriptorSet, writeCount, writes);
+
+		device->GetLoader()->vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, drawPipelineLayout->pipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+		device->GetLoader()->vkCmdPushConstants(commandBuffer, drawPipelineLayout->pipelineLayout, pushConstantStages, 0, sizeof(PushConstants), &pushConstants);
+
+		// Launch a task shader workgroup for every meshlet group
+		if(meshShading) {
+			uint32_t groupCountX, groupCountY;
+			GetDispatchSize(groupCountX, groupCountY);
+
+			device->GetLoader()->vkCmdDrawMeshTasksEXT(commandBuffer, groupCountX, groupCountY, 1);
+			return;
+		}
+
+		// Draw the meshlets' index ranges, reading the draw count from the count buffer if it's supported
+		uint32_t maxDrawCount = groupCount * GROUP_SIZE;
+		device->GetLoader()->vkCmdBindIndexBuffer(commandBuffer, indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+
+		if(drawCountSupported) {
+			if(device->GetCapabilities().apiVersion >= VK_API_VERSION_1_2) {
+				device->GetLoader()->vkCmdDrawIndexedIndirectCount(commandBuffer, drawBuffers[frameIndex], 0, countBuffers[frameIndex], 0, maxDrawCount, sizeof(VkDrawIndexedIndirectCommand));
+			} else {
+				device->GetLoader()->vkCmdDrawIndexedIndirectCountKHR(commandBuffer, drawBuffers[frameIndex], 0, countBuffers[frameIndex], 0, maxDrawCount, sizeof(VkDrawIndexedIndirectCommand));
+			}
+
+			return;
+		}
+
+		// Draw every meshlet slot's command, with the culled meshlets having no instances to draw
+		if(device->GetDeviceFeatures().multiDrawIndirect) {
+			device->GetLoader()->vkCmdDrawIndexedIndirect(commandBuffer, drawBuffers[frameIndex], 0, maxDrawCount, sizeof(VkDrawIndexedIndirectCommand));
+		} else {
+			for(uint32_t i = 0; i != maxDrawCount; ++i)
+				device->GetLoader()->vkCmdDrawIndexedIndirect(commandBuffer, drawBuffers[frameIndex], i * sizeof(VkDrawIndexedIndirectCommand), 1, sizeof(VkDrawIndexedIndirectCommand));
+		}
+	}
+
+	VulkanMeshletCuller::~VulkanMeshletCuller() {
+		// Destroy the fallback's culling pipeline and every frame's buffers
+		if(!meshShading) {
+			device->GetLoader()->vkDestroyPipeline(device->GetDevice(), pipeline, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+
+			for(size_t i = 0; i != Renderer::MAX_FRAMES_IN_FLIGHT; ++i) {
+				device->GetLoader()->vkDestroyBuffer(device->GetDevice(), drawBuffers[i], &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+				allocator->FreeMemory(drawMemories[i]);
+				device->GetLoader()->vkDestroyBuffer(device->GetDevice(), countBuffers[i], &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+				allocator->FreeMemory(countMemories[i]);
+			}
+
+			DestroyUploadBuffer(indexBuffer);
+		}
+
+		// Destroy the geometry, instance and group buffers
+		DestroyUploadBuffer(meshletBuffer);
+		DestroyUploadBuffer(meshletVertexBuffer);
+		DestroyUploadBuffer(triangleBuffer);
+		DestroyUploadBuffer(positionBuffer);
+		DestroyUploadBuffer(instanceBuffer);
+		DestroyUploadBuffer(groupBuffer);
+	}
+}
\ No newline at end of file
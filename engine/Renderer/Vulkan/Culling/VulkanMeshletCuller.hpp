@@ -0,0 +1,212 @@
+#pragma once
+
+#include "Renderer/Geometry/MeshletBuilder.hpp"
+#include "Renderer/Renderer.hpp"
+#include "Renderer/Vulkan/Descriptor/VulkanDescriptorAllocator.hpp"
+#include "Renderer/Vulkan/Instance/VulkanAllocator.hpp"
+#include "Renderer/Vulkan/Instance/VulkanDevice.hpp"
+#include "Renderer/Vulkan/Shader/VulkanPipelineVariantCache.hpp"
+#include "Renderer/Vulkan/Shader/VulkanShaderLibrary.hpp"
+
+#include <Core.hpp>
+#include <vulkan/vk_platform.h>
+#include <vulkan/vulkan_core.h>
+
+namespace wfe {
+	/// @brief A GPU meshlet culler, which holds the meshlet geometry of dense meshes and culls every instance's meshlets against the frustum and their normal cones. If mesh shaders are supported, meshlets are culled by a task shader and drawn by a mesh shader; otherwise, a compute pass culls the meshlets and writes indexed indirect draws over the meshlets' index buffer.
+	class VulkanMeshletCuller {
+	public:
+		/// @brief The number of meshlets culled by a single workgroup. Every instance's meshlets are split into groups of at most this many meshlets.
+		static const uint32_t GROUP_SIZE = 32;
+
+		/// @brief A struct containing the culler's capacities.
+		struct Limits {
+			/// @brief The maximum total number of meshlets of all added meshes.
+			uint32_t maxMeshletCount;
+			/// @brief The maximum total number of meshlet triangles of all added meshes.
+			uint32_t maxTriangleCount;
+			/// @brief The maximum total number of vertices of all added meshes.
+			uint32_t maxVertexCount;
+			/// @brief The maximum number of instances.
+			uint32_t maxInstanceCount;
+			/// @brief The maximum total number of meshlet groups of all instances.
+			uint32_t maxGroupCount;
+		};
+		/// @brief A struct containing a single instance's info. Must match the instance struct in MeshletCommon.glsl.
+		struct Instance {
+			/// @brief The instance's row-major 3x4 world transform.
+			float32_t transform[12];
+			/// @brief The index of the instance's mesh, as returned by AddMesh.
+			uint32_t meshIndex;
+			/// @brief Padding to keep every instance 64 bytes large.
+			uint32_t padding[3];
+		};
+
+		/// @brief Creates a Vulkan meshlet culler.
+		/// @param device The Vulkan device to create the culler's resources for.
+		/// @param allocator The allocator used to allocate the culler's buffers.
+		/// @param shaderLibrary The shader library to load the meshlet shaders from.
+		/// @param pipelineVariantCache The pipeline variant cache whose pipeline cache is used to create the culling pipeline.
+		/// @param descriptorAllocator The descriptor allocator to get the culling and drawing descriptor sets from.
+		/// @param limits The culler's capacities.
+		VulkanMeshletCuller(VulkanDevice* device, VulkanAllocator* allocator, VulkanShaderLibrary* shaderLibrary, VulkanPipelineVariantCache* pipelineVariantCache, VulkanDescriptorAllocator* descriptorAllocator, const Limits& limits);
+		VulkanMeshletCuller(const VulkanMeshletCuller&) = delete;
+		VulkanMeshletCuller(VulkanMeshletCuller&&) noexcept = delete;
+
+		VulkanMeshletCuller& operator=(const VulkanMeshletCuller&) = delete;
+		VulkanMeshletCuller& operator=(VulkanMeshletCuller&&) = delete;
+
+		/// @brief Gets the Vulkan function loader used by the culler.
+		/// @return A pointer to the Vulkan loader used by the culler.
+		const VulkanLoader* GetLoader() const {
+			return device->GetLoader();
+		}
+		/// @brief Gets the Vulkan device that owns the culler.
+		/// @return A pointer to the Vulkan device wrapper object.
+		VulkanDevice* GetDevice() {
+			return device;
+		}
+		/// @brief Gets the Vulkan device that owns the culler.
+		/// @return A const pointer to the Vulkan device wrapper object.
+		const VulkanDevice* GetDevice() const {
+			return device;
+		}
+		/// @brief Gets the culler's capacities.
+		/// @return A const reference to the culler's limits.
+		const Limits& GetLimits() const {
+			return limits;
+		}
+		/// @brief Gets the number of added meshes.
+		/// @return The mesh count.
+		uint32_t GetMeshCount() const {
+			return (uint32_t)meshes.size();
+		}
+		/// @brief Gets the number of instances currently culled every frame.
+		/// @return The instance count.
+		uint32_t GetInstanceCount() const {
+			return instanceCount;
+		}
+		/// @brief Gets the number of meshlet groups culled every frame.
+		/// @return The meshlet group count.
+		uint32_t GetGroupCount() const {
+			return groupCount;
+		}
+		/// @brief Checks if meshlets are culled and drawn using task and mesh shaders.
+		/// @return True if mesh shaders are used, otherwise false.
+		bool8_t IsMeshShadingEnabled() const {
+			return meshShading;
+		}
+
+		/// @brief Gets the geometry shader modules to create meshlet graphics pipelines with: MeshletCull.task and Meshlet.mesh if mesh shading is enabled, otherwise Meshlet.vert. The pipelines' fragment shaders receive the world position, the vertex index and the instance index at locations 0, 1 and 2, and must not use descriptor set 0 or push constants. Pipelines without mesh shaders must use a triangle list with no vertex input.
+		/// @param shaderModules The array of at least 2 pointers in which the shader modules will be written.
+		/// @return The number of written shader modules.
+		uint32_t GetShaderModules(const VulkanShaderLibrary::ShaderModule** shaderModules) const;
+		/// @brief Adds a mesh split into meshlets to the culler. The mesh's geometry is uploaded by the next recorded cull.
+		/// @param builder The meshlet builder holding the mesh's meshlets.
+		/// @param positions A pointer to the first vertex's position, made out of three floats.
+		/// @param positionStride The distance between two vertices' positions, in bytes.
+		/// @param meshVertexCount The number of the mesh's vertices.
+		/// @return The mesh's index.
+		uint32_t AddMesh(const MeshletBuilder& builder, const float32_t* positions, size_t positionStride, uint32_t meshVertexCount);
+		/// @brief Sets the info of the given instances. The instances are uploaded by the next recorded cull.
+		/// @param firstInstance The index of the first instance to set.
+		/// @param count The number of instances to set.
+		/// @param instances A pointer to an array of the instances' info.
+		void SetInstances(uint32_t firstInstance, uint32_t count, const Instance* instances);
+		/// @brief Sets the number of instances culled every frame.
+		/// @param count The new instance count.
+		void SetInstanceCount(uint32_t count);
+
+		/// @brief Records the upload of the changed geometry and instances and, if mesh shading is disabled, the culling dispatch for the given frame. Must be recorded outside of a render pass.
+		/// @param commandBuffer The command buffer to record the commands in.
+		/// @param frameIndex The index of the frame in flight.
+		/// @param viewProjection The column-major view projection matrix, which maps depth to Vulkan's [0, 1] range.
+		/// @param cameraPosition The camera's world space position, used to cull backfacing meshlets.
+		void RecordCull(VkCommandBuffer commandBuffer, size_t frameIndex, const float32_t* viewProjection, const float32_t* cameraPosition);
+		/// @brief Records the meshlet draws for the view given to the last recorded cull. The caller must bind a graphics pipeline created with the shader modules from GetShaderModules beforehand.
+		/// @param commandBuffer The command buffer to record the draws in.
+		/// @param frameIndex The index of the frame in flight.
+		/// @param drawPipelineLayout The bound pipeline's layout.
+		void RecordDraws(VkCommandBuffer commandBuffer, size_t frameIndex, const VulkanShaderLibrary::PipelineLayout* drawPipelineLayout);
+
+		/// @brief Destroys the Vulkan meshlet culler.
+		~VulkanMeshletCuller();
+	private:
+		enum CullFlags {
+			CULL_FLAG_COMPACT = 1
+		};
+		struct Mesh {
+			uint32_t firstMeshlet;
+			uint32_t meshletCount;
+		};
+		struct Group {
+			uint32_t instanceIndex;
+			uint32_t firstMeshlet;
+			uint32_t meshletCount;
+			uint32_t padding;
+		};
+		struct PushConstants {
+			float32_t viewProjection[16];
+			float32_t cameraPosition[3];
+			uint32_t groupCount;
+			uint32_t flags;
+		};
+		struct UploadBuffer {
+			VkBuffer buffer;
+			VulkanAllocator::MemoryBlock memory;
+			VkBuffer stagingBuffer;
+			VulkanAllocator::MemoryBlock stagingMemory;
+			uint8_t* stagingData;
+			VkDeviceSize dirtyBegin;
+			VkDeviceSize dirtyEnd;
+		};
+
+		void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VulkanAllocator::MemoryType memoryType, VkBuffer& buffer, VulkanAllocator::MemoryBlock& memoryBlock);
+		void CreateUploadBuffer(VkDeviceSize size, VkBufferUsageFlags usage, UploadBuffer& uploadBuffer);
+		void MarkUploadRange(UploadBuffer& uploadBuffer, VkDeviceSize offset, VkDeviceSize size);
+		void RecordUpload(VkCommandBuffer commandBuffer, UploadBuffer& uploadBuffer);
+		void DestroyUploadBuffer(UploadBuffer& uploadBuffer);
+		void BuildGroups();
+		void GetDispatchSize(uint32_t& groupCountX, uint32_t& groupCountY) const;
+
+		VulkanDevice* device;
+		VulkanAllocator* allocator;
+		VulkanDescriptorAllocator* descriptorAllocator;
+
+		Limits limits;
+		bool8_t meshShading;
+		bool8_t drawCountSupported;
+
+		vector<Mesh> meshes;
+		uint32_t meshletCount;
+		uint32_t meshletVertexCount;
+		uint32_t triangleCount;
+		uint32_t vertexCount;
+
+		vector<uint32_t> instanceMeshes;
+		uint32_t instanceCount;
+		uint32_t groupCount;
+		bool8_t groupsDirty;
+		PushConstants pushConstants;
+
+		UploadBuffer meshletBuffer;
+		UploadBuffer meshletVertexBuffer;
+		UploadBuffer triangleBuffer;
+		UploadBuffer indexBuffer;
+		UploadBuffer positionBuffer;
+		UploadBuffer instanceBuffer;
+		UploadBuffer groupBuffer;
+
+		VkBuffer drawBuffers[Renderer::MAX_FRAMES_IN_FLIGHT];
+		VulkanAllocator::MemoryBlock drawMemories[Renderer::MAX_FRAMES_IN_FLIGHT];
+		VkBuffer countBuffers[Renderer::MAX_FRAMES_IN_FLIGHT];
+		VulkanAllocator::MemoryBlock countMemories[Renderer::MAX_FRAMES_IN_FLIGHT];
+		VkDescriptorSet descriptorSets[Renderer::MAX_FRAMES_IN_FLIGHT];
+
+		const VulkanShaderLibrary::ShaderModule* taskShaderModule;
+		const VulkanShaderLibrary::ShaderModule* meshShaderModule;
+		const VulkanShaderLibrary::ShaderModule* vertexShaderModule;
+		const VulkanShaderLibrary::PipelineLayout* pipelineLayout;
+		VkPipeline pipeline;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,225 @@
+#include "VulkanBindlessHeap.hpp"
+#include "Renderer/Vulkan/VulkanRenderer.hpp"
+
+#include <vulkan/vk_enum_string_helper.h>
+
+namespace wfe {
+	// Constants
+	static const VkDescriptorType RESOURCE_DESCRIPTOR_TYPES[VulkanBindlessHeap::RESOURCE_TYPE_COUNT] {
+		VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+		VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+		VK_DESCRIPTOR_TYPE_SAMPLER
+	};
+	static const VkDescriptorBindingFlags BINDLESS_BINDING_FLAGS = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
+
+	// Internal helper functions
+	static uint32_t MinCapacity(uint32_t capacity, uint32_t perStageLimit, uint32_t setLimit) {
+		if(perStageLimit < capacity)
+			capacity = perStageLimit;
+		if(setLimit < capacity)
+			capacity = setLimit;
+
+		return capacity;
+	}
+
+	VulkanBindlessHeap::Handle VulkanBindlessHeap::AllocHandle(ResourceType resourceType) {
+		// Reuse a recycled handle, if one exists
+		if(freeHandles[resourceType].size()) {
+			Handle handle = freeHandles[resourceType].back();
+			freeHandles[resourceType].pop_back();
+
+			return handle;
+		}
+
+		// Check if the heap has room for another descriptor of the given type
+		if(nextHandles[resourceType] == capacities[resourceType])
+			throw Exception("Exceeded the Vulkan bindless heap's capacity of %u %s descriptors!", capacities[resourceType], string_VkDescriptorType(RESOURCE_DESCRIPTOR_TYPES[resourceType]));
+
+		return nextHandles[resourceType]++;
+	}
+
+	// Public functions
+	bool8_t VulkanBindlessHeap::IsSupported(const VulkanDevice* device) {
+		const VulkanDevice::Capabilities& capabilities = device->GetCapabilities();
+		return capabilities.descriptorIndexing && capabilities.descriptorUpdateAfterBind;
+	}
+
+	VulkanBindlessHeap::VulkanBindlessHeap(VulkanDevice* device, VulkanDescriptorLayoutCache* layoutCache) : device(device), nextHandles{}, currentFrame(0) {
+		// Get the device's update after bind descriptor limits
+		VkPhysicalDeviceDescriptorIndexingProperties indexingProperties {
+			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES,
+			.pNext = nullptr
+		};
+		VkPhysicalDeviceProperties2 properties2 {
+			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+			.pNext = &indexingProperties
+		};
+
+		device->GetLoader()->vkGetPhysicalDeviceProperties2(device->GetPhysicalDevice(), &properties2);
+
+		// Clamp every resource type's capacity to the device's limits
+		capacities[RESOURCE_TYPE_SAMPLED_IMAGE] = MinCapacity(MAX_SAMPLED_IMAGE_COUNT, indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages, indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages);
+		capacities[RESOURCE_TYPE_STORAGE_BUFFER] = MinCapacity(MAX_STORAGE_BUFFER_COUNT, indexingProperties.maxPerStageDescriptorUpdateAfterBindStorageBuffers, indexingProperties.maxDescriptorSetUpdateAfterBindStorageBuffers);
+		capacities[RESOURCE_TYPE_SAMPLER] = MinCapacity(MAX_SAMPLER_COUNT, indexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers, indexingProperties.maxDescriptorSetUpdateAfterBindSamplers);
+
+		// Set the heap's bindings, one runtime array for every resource type
+		VkDescriptorSetLayoutBinding bindings[RESOURCE_TYPE_COUNT];
+		VkDescriptorBindingFlags bindingFlags[RESOURCE_TYPE_COUNT];
+		VkDescriptorPoolSize poolSizes[RESOURCE_TYPE_COUNT];
+
+		for(uint32_t i = 0; i != RESOURCE_TYPE_COUNT; ++i) {
+			bindings[i].binding = i;
+			bindings[i].descriptorType = RESOURCE_DESCRIPTOR_TYPES[i];
+			bindings[i].descriptorCount = capacities[i];
+			bindings[i].stageFlags = VK_SHADER_STAGE_ALL;
+			bindings[i].pImmutableSamplers = nullptr;
+
+			bindingFlags[i] = BINDLESS_BINDING_FLAGS;
+
+			poolSizes[i].type = RESOURCE_DESCRIPTOR_TYPES[i];
+			poolSizes[i].descriptorCount = capacities[i];
+		}
+
+		// Get the heap's set layout
+		setLayout = layoutCache->GetSetLayout(RESOURCE_TYPE_COUNT, bindings, VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT, bindingFlags);
+
+		// Set the descriptor pool's create info
+		VkDescriptorPoolCreateInfo poolInfo {
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+			.maxSets = 1,
+			.poolSizeCount = RESOURCE_TYPE_COUNT,
+			.pPoolSizes = poolSizes
+		};
+
+		// Create the descriptor pool
+		VkResult result = device->GetLoader()->vkCreateDescriptorPool(device->GetDevice(), &poolInfo, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS, &descriptorPool);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to create Vulkan bindless descriptor pool! Error code: %s", string_VkResult(result));
+
+		// Set the descriptor set's alloc info
+		VkDescriptorSetAllocateInfo allocInfo {
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+			.pNext = nullptr,
+			.descriptorPool = descriptorPool,
+			.descriptorSetCount = 1,
+			.pSetLayouts = &setLayout
+		};
+
+		// Allocate the descriptor set
+		result = device->GetLoader()->vkAllocateDescriptorSets(device->GetDevice(), &allocInfo, &descriptorSet);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to allocate Vulkan bindless descriptor set! Error code: %s", string_VkResult(result));
+	}
+
+	VulkanBindlessHeap::Handle VulkanBindlessHeap::AddSampledImage(VkImageView imageView, VkImageLayout imageLayout) {
+		// Allocate the image's handle
+		Handle handle = AllocHandle(RESOURCE_TYPE_SAMPLED_IMAGE);
+
+		// Write the image's descriptor; update after bind allows writing while the set is bound
+		VkDescriptorImageInfo imageInfo {
+			.sampler = VK_NULL_HANDLE,
+			.imageView = imageView,
+			.imageLayout = imageLayout
+		};
+
+		VkWriteDescriptorSet descriptorWrite {
+			.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+			.pNext = nullptr,
+			.dstSet = descriptorSet,
+			.dstBinding = RESOURCE_TYPE_SAMPLED_IMAGE,
+			.dstArrayElement = handle,
+			.descriptorCount = 1,
+			.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+			.pImageInfo = &imageInfo,
+			.pBufferInfo = nullptr,
+			.pTexelBufferView = nullptr
+		};
+
+		device->GetLoader()->vkUpdateDescriptorSets(device->GetDevice(), 1, &descriptorWrite, 0, nullptr);
+
+		return handle;
+	}
+	VulkanBindlessHeap::Handle VulkanBindlessHeap::AddStorageBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range) {
+		// Allocate the buffer's handle
+		Handle handle = AllocHandle(RESOURCE_TYPE_STORAGE_BUFFER);
+
+		// Write the buffer's descriptor
+		VkDescriptorBufferInfo bufferInfo {
+			.buffer = buffer,
+			.offset = offset,
+			.range = range
+		};
+
+		VkWriteDescriptorSet descriptorWrite {
+			.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+			.pNext = nullptr,
+			.dstSet = descriptorSet,
+			.dstBinding = RESOURCE_TYPE_STORAGE_BUFFER,
+			.dstArrayElement = handle,
+			.descriptorCount = 1,
+			.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+			.pImageInfo = nullptr,
+			.pBufferInfo = &bufferInfo,
+			.pTexelBufferView = nullptr
+		};
+
+		device->GetLoader()->vkUpdateDescriptorSets(device->GetDevice(), 1, &descriptorWrite, 0, nullptr);
+
+		return handle;
+	}
+	VulkanBindlessHeap::Handle VulkanBindlessHeap::AddSampler(VkSampler sampler) {
+		// Allocate the sampler's handle
+		Handle handle = AllocHandle(RESOURCE_TYPE_SAMPLER);
+
+		// Write the sampler's descriptor
+		VkDescriptorImageInfo imageInfo {
+			.sampler = sampler,
+			.imageView = VK_NULL_HANDLE,
+			.imageLayout = VK_IMAGE_LAYOUT_UNDEFINED
+		};
+
+		VkWriteDescriptorSet descriptorWrite {
+			.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+			.pNext = nullptr,
+			.dstSet = descriptorSet,
+			.dstBinding = RESOURCE_TYPE_SAMPLER,
+			.dstArrayElement = handle,
+			.descriptorCount = 1,
+			.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER,
+			.pImageInfo = &imageInfo,
+			.pBufferInfo = nullptr,
+			.pTexelBufferView = nullptr
+		};
+
+		device->GetLoader()->vkUpdateDescriptorSets(device->GetDevice(), 1, &descriptorWrite, 0, nullptr);
+
+		return handle;
+	}
+	void VulkanBindlessHeap::FreeHandle(ResourceType resourceType, Handle handle) {
+		// Defer the handle's recycling until the current frame's fence signals
+		pendingHandles[currentFrame][resourceType].push_back(handle);
+	}
+
+	void VulkanBindlessHeap::ResetFrame(size_t frameIndex) {
+		// Move every handle freed during the frame's previous recording to the free lists
+		for(uint32_t i = 0; i != RESOURCE_TYPE_COUNT; ++i) {
+			vector<Handle>& frameHandles = pendingHandles[frameIndex][i];
+			for(Handle handle : frameHandles)
+				freeHandles[i].push_back(handle);
+			frameHandles.clear();
+		}
+
+		// Set the current frame
+		currentFrame = frameIndex;
+	}
+	void VulkanBindlessHeap::Bind(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout, uint32_t setIndex) {
+		device->GetLoader()->vkCmdBindDescriptorSets(commandBuffer, bindPoint, pipelineLayout, setIndex, 1, &descriptorSet, 0, nullptr);
+	}
+
+	VulkanBindlessHeap::~VulkanBindlessHeap() {
+		// Destroy the descriptor pool, which also frees the descriptor set; the set layout is owned by the layout cache
+		device->GetLoader()->vkDestroyDescriptorPool(device->GetDevice(), descriptorPool, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "VulkanDescriptorLayoutCache.hpp"
+#include "Renderer/Renderer.hpp"
+#include "Renderer/Vulkan/Instance/VulkanDevice.hpp"
+
+#include <Core.hpp>
+#include <vulkan/vk_platform.h>
+#include <vulkan/vulkan_core.h>
+
+namespace wfe {
+	/// @brief A global bindless descriptor heap, whose resources are addressed in shaders by 32-bit handles.
+	class VulkanBindlessHeap {
+	public:
+		/// @brief A 32-bit handle to a resource in the heap, used by shaders as an index into the resource type's array.
+		typedef uint32_t Handle;
+
+		/// @brief An invalid bindless handle.
+		static const Handle INVALID_HANDLE = UINT32_T_MAX;
+		/// @brief The maximum number of sampled images in the heap, before being clamped to the device's limits.
+		static const uint32_t MAX_SAMPLED_IMAGE_COUNT = 1 << 16;
+		/// @brief The maximum number of storage buffers in the heap, before being clamped to the device's limits.
+		static const uint32_t MAX_STORAGE_BUFFER_COUNT = 1 << 16;
+		/// @brief The maximum number of samplers in the heap, before being clamped to the device's limits.
+		static const uint32_t MAX_SAMPLER_COUNT = 1 << 10;
+
+		/// @brief The types of resources stored in the heap. Every type's index is its binding in the heap's descriptor set.
+		enum ResourceType : uint32_t {
+			/// @brief Sampled images, read in shaders through a runtime array of textures.
+			RESOURCE_TYPE_SAMPLED_IMAGE,
+			/// @brief Storage buffers, accessed in shaders through a runtime array of buffers.
+			RESOURCE_TYPE_STORAGE_BUFFER,
+			/// @brief Samplers, combined in shaders with the sampled images.
+			RESOURCE_TYPE_SAMPLER,
+			/// @brief The number of resource types.
+			RESOURCE_TYPE_COUNT
+		};
+
+		/// @brief Checks if the given device supports the features required by the bindless heap.
+		/// @param device The Vulkan device to check.
+		/// @return True if the bindless heap can be created for the device, otherwise false.
+		static bool8_t IsSupported(const VulkanDevice* device);
+
+		/// @brief Creates a Vulkan bindless heap.
+		/// @param device The Vulkan device to create the heap for. It must support all features checked by IsSupported.
+		/// @param layoutCache The descriptor layout cache used to get the heap's set layout.
+		VulkanBindlessHeap(VulkanDevice* device, VulkanDescriptorLayoutCache* layoutCache);
+		VulkanBindlessHeap(const VulkanBindlessHeap&) = delete;
+		VulkanBindlessHeap(VulkanBindlessHeap&&) noexcept = delete;
+
+		VulkanBindlessHeap& operator=(const VulkanBindlessHeap&) = delete;
+		VulkanBindlessHeap& operator=(VulkanBindlessHeap&&) = delete;
+
+		/// @brief Gets the Vulkan function loader used by the heap.
+		/// @return A pointer to the Vulkan loader used by the heap.
+		const VulkanLoader* GetLoader() const {
+			return device->GetLoader();
+		}
+		/// @brief Gets the Vulkan device that owns the heap.
+		/// @return A pointer to the Vulkan device wrapper object.
+		VulkanDevice* GetDevice() {
+			return device;
+		}
+		/// @brief Gets the Vulkan device that owns the heap.
+		/// @return A const pointer to the Vulkan device wrapper object.
+		const VulkanDevice* GetDevice() const {
+			return device;
+		}
+		/// @brief Gets the heap's descriptor set layout, to be used in pipeline layouts.
+		/// @return A handle to the Vulkan descriptor set layout.
+		VkDescriptorSetLayout GetSetLayout() {
+			return setLayout;
+		}
+		/// @brief Gets the heap's descriptor set.
+		/// @return A handle to the Vulkan descriptor set.
+		VkDescriptorSet GetDescriptorSet() {
+			return descriptorSet;
+		}
+		/// @brief Gets the number of descriptors of the given type the heap can hold.
+		/// @param resourceType The resource type whose capacity to get.
+		/// @return The number of descriptors of the given type.
+		uint32_t GetCapacity(ResourceType resourceType) const {
+			return capacities[resourceType];
+		}
+
+		/// @brief Adds a sampled image to the heap.
+		/// @param imageView The image view to add.
+		/// @param imageLayout The layout the image will be in when accessed by shaders.
+		/// @return The sampled image's handle.
+		Handle AddSampledImage(VkImageView imageView, VkImageLayout imageLayout);
+		/// @brief Adds a storage buffer range to the heap.
+		/// @param buffer The buffer to add.
+		/// @param offset The offset of the buffer range, in bytes.
+		/// @param range The size of the buffer range, in bytes, or VK_WHOLE_SIZE to use the rest of the buffer.
+		/// @return The storage buffer's handle.
+		Handle AddStorageBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range);
+		/// @brief Adds a sampler to the heap.
+		/// @param sampler The sampler to add.
+		/// @return The sampler's handle.
+		Handle AddSampler(VkSampler sampler);
+		/// @brief Frees the given handle. The handle is recycled only after the current frame's fence signals again, as in-flight frames may still access it.
+		/// @param resourceType The type of the resource the handle refers to.
+		/// @param handle The handle to free.
+		void FreeHandle(ResourceType resourceType, Handle handle);
+
+		/// @brief Recycles every handle freed the last time the given frame was recorded and makes it the current frame. Must only be called after the frame's fence was signaled.
+		/// @param frameIndex The index of the frame in flight to reset.
+		void ResetFrame(size_t frameIndex);
+		/// @brief Binds the heap's descriptor set once for all draws recorded afterwards in the command buffer.
+		/// @param commandBuffer The command buffer to record the bind in.
+		/// @param bindPoint The pipeline bind point to bind the set to.
+		/// @param pipelineLayout The pipeline layout that uses the heap's set layout.
+		/// @param setIndex The heap set's index in the pipeline layout.
+		void Bind(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout, uint32_t setIndex);
+
+		/// @brief Destroys the Vulkan bindless heap.
+		~VulkanBindlessHeap();
+	private:
+		Handle AllocHandle(ResourceType resourceType);
+
+		VulkanDevice* device;
+		VkDescriptorSetLayout setLayout;
+		VkDescriptorPool descriptorPool;
+		VkDescriptorSet descriptorSet;
+
+		uint32_t capacities[RESOURCE_TYPE_COUNT];
+		uint32_t nextHandles[RESOURCE_TYPE_COUNT];
+		vector<Handle> freeHandles[RESOURCE_TYPE_COUNT];
+		vector<Handle> pendingHandles[Renderer::MAX_FRAMES_IN_FLIGHT][RESOURCE_TYPE_COUNT];
+		size_t currentFrame;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,414 @@
+#include "VulkanDescriptorAllocator.hpp"
+#include "Renderer/Vulkan/VulkanRenderer.hpp"
+#include "General/Hash.hpp"
+
+#include <vulkan/vk_enum_string_helper.h>
+
+namespace wfe {
+	// Internal structs
+	struct PoolSizeRatio {
+		VkDescriptorType descriptorType;
+		uint32_t ratio;
+	};
+
+	// Constants
+	static const PoolSizeRatio POOL_SIZE_RATIOS[] {
+		{ VK_DESCRIPTOR_TYPE_SAMPLER, 1 },
+		{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4 },
+		{ VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 2 },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1 },
+		{ VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 1 },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, 1 },
+		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2 },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2 },
+		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1 },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1 },
+		{ VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1 }
+	};
+	static const uint32_t POOL_SIZE_COUNT = sizeof(POOL_SIZE_RATIOS) / sizeof(PoolSizeRatio);
+
+	// Internal helper functions
+	static bool8_t IsBufferDescriptorType(VkDescriptorType descriptorType) {
+		return descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER || descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER || descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC || descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+	}
+	static bool8_t IsTexelBufferDescriptorType(VkDescriptorType descriptorType) {
+		return descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER || descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
+	}
+
+	uint64_t VulkanDescriptorAllocator::HashDescriptorSet(VkDescriptorSetLayout setLayout, uint32_t writeCount, const DescriptorWrite* writes) {
+		// Hash the set's layout and writes, skipping the unused bytes of every write's resource info
+		uint64_t hash = ComputeFNV1aHash(&setLayout, sizeof(VkDescriptorSetLayout));
+		for(uint32_t i = 0; i != writeCount; ++i) {
+			hash = ComputeFNV1aHash(&writes[i].binding, sizeof(uint32_t), hash);
+			hash = ComputeFNV1aHash(&writes[i].arrayElement, sizeof(uint32_t), hash);
+			hash = ComputeFNV1aHash(&writes[i].descriptorType, sizeof(VkDescriptorType), hash);
+
+			if(IsBufferDescriptorType(writes[i].descriptorType)) {
+				hash = ComputeFNV1aHash(&writes[i].bufferInfo, sizeof(VkDescriptorBufferInfo), hash);
+			} else if(IsTexelBufferDescriptorType(writes[i].descriptorType)) {
+				hash = ComputeFNV1aHash(&writes[i].texelBufferView, sizeof(VkBufferView), hash);
+			} else {
+				hash = ComputeFNV1aHash(&writes[i].imageInfo.sampler, sizeof(VkSampler), hash);
+				hash = ComputeFNV1aHash(&writes[i].imageInfo.imageView, sizeof(VkImageView), hash);
+				hash = ComputeFNV1aHash(&writes[i].imageInfo.imageLayout, sizeof(VkImageLayout), hash);
+			}
+		}
+
+		return hash;
+	}
+	bool8_t VulkanDescriptorAllocator::CompareDescriptorSet(const CachedSet* cachedSet, VkDescriptorSetLayout setLayout, uint32_t writeCount, const DescriptorWrite* writes) {
+		if(cachedSet->setLayout != setLayout || cachedSet->writes.size() != writeCount)
+			return false;
+
+		// Compare every write's fields, including only the resource info used by its descriptor type
+		for(uint32_t i = 0; i != writeCount; ++i) {
+			const DescriptorWrite& cachedWrite = cachedSet->writes[i];
+			if(cachedWrite.binding != writes[i].binding || cachedWrite.arrayElement != writes[i].arrayElement || cachedWrite.descriptorType != writes[i].descriptorType)
+				return false;
+
+			if(IsBufferDescriptorType(writes[i].descriptorType)) {
+				if(cachedWrite.bufferInfo.buffer != writes[i].bufferInfo.buffer || cachedWrite.bufferInfo.offset != writes[i].bufferInfo.offset || cachedWrite.bufferInfo.range != writes[i].bufferInfo.range)
+					return false;
+			} else if(IsTexelBufferDescriptorType(writes[i].descriptorType)) {
+				if(cachedWrite.texelBufferView != writes[i].texelBufferView)
+					return false;
+			} else {
+				if(cachedWrite.imageInfo.sampler != writes[i].imageInfo.sampler || cachedWrite.imageInfo.imageView != writes[i].imageInfo.imageView || cachedWrite.imageInfo.imageLayout != writes[i].imageInfo.imageLayout)
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	VkDescriptorPool VulkanDescriptorAllocator::CreatePool(uint32_t setCount) {
+		// Set the pool's sizes
+		VkDescriptorPoolSize poolSizes[POOL_SIZE_COUNT];
+		for(uint32_t i = 0; i != POOL_SIZE_COUNT; ++i) {
+			poolSizes[i].type = POOL_SIZE_RATIOS[i].descriptorType;
+			poolSizes[i].descriptorCount = POOL_SIZE_RATIOS[i].ratio * setCount;
+		}
+
+		// Set the pool's create info
+		VkDescriptorPoolCreateInfo createInfo {
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.maxSets = setCount,
+			.poolSizeCount = POOL_SIZE_COUNT,
+			.pPoolSizes = poolSizes
+		};
+
+		// Create the pool
+		VkDescriptorPool pool;
+		VkResult result = device->GetLoader()->vkCreateDescriptorPool(device->GetDevice(), &createInfo, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS, &pool);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to create Vulkan descriptor pool! Error code: %s", string_VkResult(result));
+
+		return pool;
+	}
+	VkDescriptorPool VulkanDescriptorAllocator::GetNextPool(PoolList& poolList) {
+		// Reuse a previously reset pool, if one exists
+		VkDescriptorPool pool;
+		if(poolList.freePools.size()) {
+			pool = poolList.freePools.back();
+			poolList.freePools.pop_back();
+		} else {
+			// Create a new pool and grow the next pool's set count
+			pool = CreatePool(poolList.nextPoolSetCount);
+
+			poolList.nextPoolSetCount <<= 1;
+			if(poolList.nextPoolSetCount > MAX_POOL_SET_COUNT)
+				poolList.nextPoolSetCount = MAX_POOL_SET_COUNT;
+		}
+
+		// Add the pool to the used pool list
+		poolList.usedPools.push_back(pool);
+
+		return pool;
+	}
+	VkDescriptorSet VulkanDescriptorAllocator::AllocFromPoolList(PoolList& poolList, VkDescriptorSetLayout setLayout) {
+		// Get the pool to allocate from
+		VkDescriptorPool pool;
+		if(poolList.usedPools.size()) {
+			pool = poolList.usedPools.back();
+		} else {
+			pool = GetNextPool(poolList);
+		}
+
+		// Set the descriptor set's alloc info
+		VkDescriptorSetAllocateInfo allocInfo {
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+			.pNext = nullptr,
+			.descriptorPool = pool,
+			.descriptorSetCount = 1,
+			.pSetLayouts = &setLayout
+		};
+
+		// Try to allocate the descriptor set
+		VkDescriptorSet descriptorSet;
+		VkResult result = device->GetLoader()->vkAllocateDescriptorSets(device->GetDevice(), &allocInfo, &descriptorSet);
+
+		// Retry using the next pool if the current one is exhausted
+		if(result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) {
+			allocInfo.descriptorPool = GetNextPool(poolList);
+			result = device->GetLoader()->vkAllocateDescriptorSets(device->GetDevice(), &allocInfo, &descriptorSet);
+		}
+
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to allocate Vulkan descriptor set! Error code: %s", string_VkResult(result));
+
+		return descriptorSet;
+	}
+
+	VkDescriptorSet VulkanDescriptorAllocator::AllocCachedSet(VkDescriptorSetLayout setLayout, uint32_t& poolIndex) {
+		// Set the descriptor set's alloc info
+		VkDescriptorSetAllocateInfo allocInfo {
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+			.pNext = nullptr,
+			.descriptorPool = VK_NULL_HANDLE,
+			.descriptorSetCount = 1,
+			.pSetLayouts = &setLayout
+		};
+
+		// Try to allocate the descriptor set from the current cached pool
+		VkDescriptorSet descriptorSet;
+		VkResult result = VK_ERROR_OUT_OF_POOL_MEMORY;
+
+		if(cachedPools.size()) {
+			allocInfo.descriptorPool = cachedPools[currentCachedPool].pool;
+			result = device->GetLoader()->vkAllocateDescriptorSets(device->GetDevice(), &allocInfo, &descriptorSet);
+		}
+
+		if(result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) {
+			// Move on to a pool whose sets were all released, or create a new one if every pool is in use
+			uint32_t newPoolIndex = (uint32_t)cachedPools.size();
+			for(uint32_t i = 0; i != (uint32_t)cachedPools.size(); ++i) {
+				if(i != currentCachedPool && !cachedPools[i].liveSetCount) {
+					newPoolIndex = i;
+					break;
+				}
+			}
+
+			if(newPoolIndex == cachedPools.size()) {
+				cachedPools.push_back({ CreatePool(nextCachedPoolSetCount), 0 });
+
+				nextCachedPoolSetCount <<= 1;
+				if(nextCachedPoolSetCount > MAX_POOL_SET_COUNT)
+					nextCachedPoolSetCount = MAX_POOL_SET_COUNT;
+			}
+
+			currentCachedPool = newPoolIndex;
+			allocInfo.descriptorPool = cachedPools[currentCachedPool].pool;
+			result = device->GetLoader()->vkAllocateDescriptorSets(device->GetDevice(), &allocInfo, &descriptorSet);
+		}
+
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to allocate Vulkan descriptor set! Error code: %s", string_VkResult(result));
+
+		poolIndex = currentCachedPool;
+		++cachedPools[currentCachedPool].liveSetCount;
+
+		return descriptorSet;
+	}
+	void VulkanDescriptorAllocator::EvictCachedSet(CachedSet* cachedSet) {
+		// Unlink the set from its hash's collision chain
+		auto setIter = cachedSets.find(cachedSet->hash);
+		if(setIter->second == cachedSet) {
+			if(cachedSet->nextCollision) {
+				setIter->second = cachedSet->nextCollision;
+			} else {
+				cachedSets.erase(cachedSet->hash);
+			}
+		} else {
+			CachedSet* previousSet = setIter->second;
+			while(previousSet->nextCollision != cachedSet)
+				previousSet = previousSet->nextCollision;
+			previousSet->nextCollision = cachedSet->nextCollision;
+		}
+
+		// Remove the set from the set list, moving the last set into its place
+		CachedSet* lastSet = cachedSetList.back();
+		cachedSetList[cachedSet->listIndex] = lastSet;
+		lastSet->listIndex = cachedSet->listIndex;
+		cachedSetList.pop_back();
+
+		// Release the set's pool slot once the frames in flight that might still bind it finish, which is the next time the current frame is reset
+		releasedPoolIndices[currentFrame].push_back(cachedSet->poolIndex);
+
+		DestroyObject(cachedSet);
+	}
+
+	// Public functions
+	VulkanDescriptorAllocator::VulkanDescriptorAllocator(VulkanDevice* device) : device(device), currentFrame(0), currentCachedPool(0), nextCachedPoolSetCount(INITIAL_POOL_SET_COUNT), frameCounter(0) {
+		// Set every pool list's initial pool set count
+		persistentPools.nextPoolSetCount = INITIAL_POOL_SET_COUNT;
+		for(size_t i = 0; i != Renderer::MAX_FRAMES_IN_FLIGHT; ++i)
+			framePools[i].nextPoolSetCount = INITIAL_POOL_SET_COUNT;
+	}
+
+	VkDescriptorSet VulkanDescriptorAllocator::AllocDescriptorSet(VkDescriptorSetLayout setLayout) {
+		return AllocFromPoolList(persistentPools, setLayout);
+	}
+	VkDescriptorSet VulkanDescriptorAllocator::AllocTransientDescriptorSet(VkDescriptorSetLayout setLayout) {
+		return AllocFromPoolList(framePools[currentFrame], setLayout);
+	}
+	VkDescriptorSet VulkanDescriptorAllocator::GetCachedDescriptorSet(VkDescriptorSetLayout setLayout, uint32_t writeCount, const DescriptorWrite* writes) {
+		uint64_t hash = HashDescriptorSet(setLayout, writeCount, writes);
+
+		// Return the existing set if an identical one was already written, comparing the writes of every set with the same hash
+		auto setIter = cachedSets.find(hash);
+		CachedSet* collidingSets = nullptr;
+		if(setIter != cachedSets.end()) {
+			collidingSets = setIter->second;
+			for(CachedSet* cachedSet = collidingSets; cachedSet; cachedSet = cachedSet->nextCollision) {
+				if(CompareDescriptorSet(cachedSet, setLayout, writeCount, writes)) {
+					cachedSet->lastUsedFrame = frameCounter;
+					return cachedSet->descriptorSet;
+				}
+			}
+		}
+
+		// Check if the write count is supported before allocating anything
+		if(writeCount > MAX_WRITE_COUNT)
+			throw Exception("Vulkan descriptor set write count %u exceeds the maximum of %u writes!", writeCount, MAX_WRITE_COUNT);
+
+		// Allocate and write the new set, keeping a copy of its writes to compare later requests against
+		PushMemoryUsageType(MEMORY_USAGE_TYPE_RENDERER);
+		CachedSet* cachedSet = NewObject<CachedSet>();
+		PopMemoryUsageType();
+
+		cachedSet->setLayout = setLayout;
+		cachedSet->descriptorSet = AllocCachedSet(setLayout, cachedSet->poolIndex);
+		cachedSet->listIndex = (uint32_t)cachedSetList.size();
+		cachedSet->hash = hash;
+		cachedSet->lastUsedFrame = frameCounter;
+		cachedSet->writes.resize(writeCount);
+		memcpy(cachedSet->writes.data(), writes, writeCount * sizeof(DescriptorWrite));
+
+		WriteDescriptorSet(cachedSet->descriptorSet, writeCount, writes);
+
+		// Add the set to the cache, chaining it to the sets with the same hash
+		cachedSet->nextCollision = collidingSets;
+		if(collidingSets) {
+			setIter->second = cachedSet;
+		} else {
+			cachedSets.insert({ hash, cachedSet });
+		}
+		cachedSetList.push_back(cachedSet);
+
+		return cachedSet->descriptorSet;
+	}
+	void VulkanDescriptorAllocator::InvalidateCachedBuffer(VkBuffer buffer) {
+		// Evict every set with a buffer write referencing the buffer. Evicting moves the last set into the current index, so the index only advances past kept sets
+		for(size_t i = 0; i != cachedSetList.size();) {
+			CachedSet* cachedSet = cachedSetList[i];
+			bool8_t referenced = false;
+			for(const DescriptorWrite& write : cachedSet->writes)
+				if(IsBufferDescriptorType(write.descriptorType) && write.bufferInfo.buffer == buffer)
+					referenced = true;
+
+			if(referenced) {
+				EvictCachedSet(cachedSet);
+			} else {
+				++i;
+			}
+		}
+	}
+	void VulkanDescriptorAllocator::InvalidateCachedImageView(VkImageView imageView) {
+		// Evict every set with an image write referencing the image view
+		for(size_t i = 0; i != cachedSetList.size();) {
+			CachedSet* cachedSet = cachedSetList[i];
+			bool8_t referenced = false;
+			for(const DescriptorWrite& write : cachedSet->writes)
+				if(!IsBufferDescriptorType(write.descriptorType) && !IsTexelBufferDescriptorType(write.descriptorType) && write.imageInfo.imageView == imageView)
+					referenced = true;
+
+			if(referenced) {
+				EvictCachedSet(cachedSet);
+			} else {
+				++i;
+			}
+		}
+	}
+	void VulkanDescriptorAllocator::WriteDescriptorSet(VkDescriptorSet descriptorSet, uint32_t writeCount, const DescriptorWrite* writes) {
+		// Check if the write count is supported
+		if(writeCount > MAX_WRITE_COUNT)
+			throw Exception("Vulkan descriptor set write count %u exceeds the maximum of %u writes!", writeCount, MAX_WRITE_COUNT);
+
+		// Convert every write to its Vulkan equivalent
+		VkWriteDescriptorSet descriptorWrites[MAX_WRITE_COUNT];
+		for(uint32_t i = 0; i != writeCount; ++i) {
+			descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			descriptorWrites[i].pNext = nullptr;
+			descriptorWrites[i].dstSet = descriptorSet;
+			descriptorWrites[i].dstBinding = writes[i].binding;
+			descriptorWrites[i].dstArrayElement = writes[i].arrayElement;
+			descriptorWrites[i].descriptorCount = 1;
+			descriptorWrites[i].descriptorType = writes[i].descriptorType;
+			descriptorWrites[i].pImageInfo = nullptr;
+			descriptorWrites[i].pBufferInfo = nullptr;
+			descriptorWrites[i].pTexelBufferView = nullptr;
+
+			if(IsBufferDescriptorType(writes[i].descriptorType)) {
+				descriptorWrites[i].pBufferInfo = &writes[i].bufferInfo;
+			} else if(IsTexelBufferDescriptorType(writes[i].descriptorType)) {
+				descriptorWrites[i].pTexelBufferView = &writes[i].texelBufferView;
+			} else {
+				descriptorWrites[i].pImageInfo = &writes[i].imageInfo;
+			}
+		}
+
+		// Update the descriptor set
+		device->GetLoader()->vkUpdateDescriptorSets(device->GetDevice(), writeCount, descriptorWrites, 0, nullptr);
+	}
+	void VulkanDescriptorAllocator::ResetFrame(size_t frameIndex) {
+		// Reset every pool used by the frame and move it to the free pool list
+		PoolList& poolList = framePools[frameIndex];
+		for(VkDescriptorPool pool : poolList.usedPools) {
+			device->GetLoader()->vkResetDescriptorPool(device->GetDevice(), pool, 0);
+			poolList.freePools.push_back(pool);
+		}
+		poolList.usedPools.clear();
+
+		// Release the pool slots of the sets evicted during the frame's previous use, resetting every cached pool left without live sets
+		for(uint32_t poolIndex : releasedPoolIndices[frameIndex]) {
+			if(!--cachedPools[poolIndex].liveSetCount)
+				device->GetLoader()->vkResetDescriptorPool(device->GetDevice(), cachedPools[poolIndex].pool, 0);
+		}
+		releasedPoolIndices[frameIndex].clear();
+
+		// Set the current frame
+		currentFrame = frameIndex;
+		++frameCounter;
+
+		// Evict every cached set that wasn't requested for too long
+		for(size_t i = 0; i != cachedSetList.size();) {
+			if(frameCounter - cachedSetList[i]->lastUsedFrame > MAX_CACHED_SET_UNUSED_FRAME_COUNT) {
+				EvictCachedSet(cachedSetList[i]);
+			} else {
+				++i;
+			}
+		}
+	}
+
+	VulkanDescriptorAllocator::~VulkanDescriptorAllocator() {
+		// Destroy every persistent pool
+		for(VkDescriptorPool pool : persistentPools.usedPools)
+			device->GetLoader()->vkDestroyDescriptorPool(device->GetDevice(), pool, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+
+		// Destroy every cached set and pool
+		for(CachedSet* cachedSet : cachedSetList)
+			DestroyObject(cachedSet);
+		for(const CachedPool& cachedPool : cachedPools)
+			device->GetLoader()->vkDestroyDescriptorPool(device->GetDevice(), cachedPool.pool, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+
+		// Destroy every transient pool
+		for(size_t i = 0; i != Renderer::MAX_FRAMES_IN_FLIGHT; ++i) {
+			for(VkDescriptorPool pool : framePools[i].usedPools)
+				device->GetLoader()->vkDestroyDescriptorPool(device->GetDevice(), pool, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+			for(VkDescriptorPool pool : framePools[i].freePools)
+				device->GetLoader()->vkDestroyDescriptorPool(device->GetDevice(), pool, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "Renderer/Renderer.hpp"
+#include "Renderer/Vulkan/Instance/VulkanDevice.hpp"
+
+#include <Core.hpp>
+#include <vulkan/vk_platform.h>
+#include <vulkan/vulkan_core.h>
+
+namespace wfe {
+	/// @brief A descriptor set allocator that grows its descriptor pools on demand, with per-frame transient pools and a cache of written sets.
+	class VulkanDescriptorAllocator {
+	public:
+		/// @brief The number of sets the first pool of every pool list can allocate.
+		static const uint32_t INITIAL_POOL_SET_COUNT = 64;
+		/// @brief The maximum number of sets a single pool can allocate. Every new pool doubles the previous pool's set count until this limit is reached.
+		static const uint32_t MAX_POOL_SET_COUNT = 4096;
+		/// @brief The maximum number of writes that can be applied to a descriptor set at once.
+		static const uint32_t MAX_WRITE_COUNT = 32;
+		/// @brief The number of frames a cached descriptor set can go unrequested before it's evicted from the write cache.
+		static const uint64_t MAX_CACHED_SET_UNUSED_FRAME_COUNT = 256;
+
+		/// @brief A struct containing the info of a single descriptor write.
+		struct DescriptorWrite {
+			/// @brief The binding's index in the descriptor set.
+			uint32_t binding;
+			/// @brief The element's index in the binding's array.
+			uint32_t arrayElement;
+			/// @brief The written descriptor's type.
+			VkDescriptorType descriptorType;
+			union {
+				/// @brief The buffer info used by uniform and storage buffer descriptors.
+				VkDescriptorBufferInfo bufferInfo;
+				/// @brief The image info used by sampler, image and input attachment descriptors.
+				VkDescriptorImageInfo imageInfo;
+				/// @brief The buffer view used by texel buffer descriptors.
+				VkBufferView texelBufferView;
+			};
+		};
+
+		/// @brief Creates a Vulkan descriptor allocator.
+		/// @param device The Vulkan device to create the descriptor pools for.
+		VulkanDescriptorAllocator(VulkanDevice* device);
+		VulkanDescriptorAllocator(const VulkanDescriptorAllocator&) = delete;
+		VulkanDescriptorAllocator(VulkanDescriptorAllocator&&) noexcept = delete;
+
+		VulkanDescriptorAllocator& operator=(const VulkanDescriptorAllocator&) = delete;
+		VulkanDescriptorAllocator& operator=(VulkanDescriptorAllocator&&) = delete;
+
+		/// @brief Gets the Vulkan function loader used by the descriptor allocator.
+		/// @return A pointer to the Vulkan loader used by the descriptor allocator.
+		const VulkanLoader* GetLoader() const {
+			return device->GetLoader();
+		}
+		/// @brief Gets the Vulkan device that owns the descriptor allocator.
+		/// @return A pointer to the Vulkan device wrapper object.
+		VulkanDevice* GetDevice() {
+			return device;
+		}
+		/// @brief Gets the Vulkan device that owns the descriptor allocator.
+		/// @return A const pointer to the Vulkan device wrapper object.
+		const VulkanDevice* GetDevice() const {
+			return device;
+		}
+		/// @brief Gets the number of descriptor sets in the write cache.
+		/// @return The number of cached descriptor sets.
+		size_t GetCachedSetCount() const {
+			return cachedSetList.size();
+		}
+
+		/// @brief Allocates a persistent descriptor set, which stays valid until the allocator is destroyed.
+		/// @param setLayout The descriptor set's layout.
+		/// @return A handle to the allocated Vulkan descriptor set.
+		VkDescriptorSet AllocDescriptorSet(VkDescriptorSetLayout setLayout);
+		/// @brief Allocates a transient descriptor set, which stays valid until the current frame's pools are reset.
+		/// @param setLayout The descriptor set's layout.
+		/// @return A handle to the allocated Vulkan descriptor set.
+		VkDescriptorSet AllocTransientDescriptorSet(VkDescriptorSetLayout setLayout);
+		/// @brief Gets a cached descriptor set with the given layout and writes, allocating and writing it only if no identical set is in the cache. The set stays valid until the end of the current frame; sets that aren't requested for MAX_CACHED_SET_UNUSED_FRAME_COUNT frames are evicted.
+		/// @param setLayout The descriptor set's layout.
+		/// @param writeCount The number of writes to apply to the set.
+		/// @param writes A pointer to an array of the writes to apply to the set. Every written buffer and image view must be invalidated before it's destroyed.
+		/// @return A handle to the cached Vulkan descriptor set.
+		VkDescriptorSet GetCachedDescriptorSet(VkDescriptorSetLayout setLayout, uint32_t writeCount, const DescriptorWrite* writes);
+		/// @brief Evicts every cached descriptor set that references the given buffer, so that a later buffer reusing its handle doesn't match them.
+		/// @param buffer The buffer that will be destroyed.
+		void InvalidateCachedBuffer(VkBuffer buffer);
+		/// @brief Evicts every cached descriptor set that references the given image view, so that a later image view reusing its handle doesn't match them.
+		/// @param imageView The image view that will be destroyed.
+		void InvalidateCachedImageView(VkImageView imageView);
+		/// @brief Applies the given writes to a descriptor set.
+		/// @param descriptorSet The descriptor set to write to.
+		/// @param writeCount The number of writes to apply to the set.
+		/// @param writes A pointer to an array of the writes to apply to the set.
+		void WriteDescriptorSet(VkDescriptorSet descriptorSet, uint32_t writeCount, const DescriptorWrite* writes);
+		/// @brief Resets all transient pools of the given frame, releases the cached sets evicted during the frame's previous use and makes it the current frame. Must only be called after the frame's fence was signaled.
+		/// @param frameIndex The index of the frame in flight to reset.
+		void ResetFrame(size_t frameIndex);
+
+		/// @brief Destroys the Vulkan descriptor allocator and all of its pools.
+		~VulkanDescriptorAllocator();
+	private:
+		struct PoolList {
+			vector<VkDescriptorPool> usedPools;
+			vector<VkDescriptorPool> freePools;
+			uint32_t nextPoolSetCount;
+		};
+		struct CachedPool {
+			VkDescriptorPool pool;
+			uint32_t liveSetCount;
+		};
+		struct CachedSet {
+			VkDescriptorSetLayout setLayout;
+			VkDescriptorSet descriptorSet;
+			uint32_t poolIndex;
+			uint32_t listIndex;
+			uint64_t hash;
+			uint64_t lastUsedFrame;
+			vector<DescriptorWrite> writes;
+			CachedSet* nextCollision;
+		};
+
+		static uint64_t HashDescriptorSet(VkDescriptorSetLayout setLayout, uint32_t writeCount, const DescriptorWrite* writes);
+		static bool8_t CompareDescriptorSet(const CachedSet* cachedSet, VkDescriptorSetLayout setLayout, uint32_t writeCount, const DescriptorWrite* writes);
+
+		VkDescriptorPool CreatePool(uint32_t setCount);
+		VkDescriptorPool GetNextPool(PoolList& poolList);
+		VkDescriptorSet AllocFromPoolList(PoolList& poolList, VkDescriptorSetLayout setLayout);
+		VkDescriptorSet AllocCachedSet(VkDescriptorSetLayout setLayout, uint32_t& poolIndex);
+		void EvictCachedSet(CachedSet* cachedSet);
+
+		VulkanDevice* device;
+
+		PoolList persistentPools;
+		PoolList framePools[Renderer::MAX_FRAMES_IN_FLIGHT];
+		size_t currentFrame;
+
+		vector<CachedPool> cachedPools;
+		uint32_t currentCachedPool;
+		uint32_t nextCachedPoolSetCount;
+		vector<uint32_t> releasedPoolIndices[Renderer::MAX_FRAMES_IN_FLIGHT];
+		uint64_t frameCounter;
+
+		unordered_map<uint64_t, CachedSet*> cachedSets;
+		vector<CachedSet*> cachedSetList;
+	};
+}
\ No newline at end of file
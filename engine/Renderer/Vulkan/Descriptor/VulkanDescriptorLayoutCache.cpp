@@ -0,0 +1,142 @@
+#include "VulkanDescriptorLayoutCache.hpp"
+#include "Renderer/Vulkan/VulkanRenderer.hpp"
+#include "General/Hash.hpp"
+
+#include <vulkan/vk_enum_string_helper.h>
+
+namespace wfe {
+	bool8_t VulkanDescriptorLayoutCache::SetLayoutMatches(const SetLayout* setLayout, uint32_t bindingCount, const VkDescriptorSetLayoutBinding* bindings, VkDescriptorSetLayoutCreateFlags flags, const VkDescriptorBindingFlags* bindingFlags) {
+		// Compare the set layouts' flags and binding counts
+		if(setLayout->flags != flags || setLayout->bindings.size() != bindingCount || setLayout->bindingFlags.size() != (bindingFlags ? bindingCount : 0))
+			return false;
+
+		// Compare every binding, with the immutable samplers stored contiguously in binding order
+		size_t samplerIndex = 0;
+		for(uint32_t i = 0; i != bindingCount; ++i) {
+			const VkDescriptorSetLayoutBinding& binding = setLayout->bindings[i];
+			if(binding.binding != bindings[i].binding || binding.descriptorType != bindings[i].descriptorType || binding.descriptorCount != bindings[i].descriptorCount || binding.stageFlags != bindings[i].stageFlags)
+				return false;
+
+			if(!binding.pImmutableSamplers != !bindings[i].pImmutableSamplers)
+				return false;
+			if(bindings[i].pImmutableSamplers) {
+				if(memcmp(setLayout->immutableSamplers.data() + samplerIndex, bindings[i].pImmutableSamplers, bindings[i].descriptorCount * sizeof(VkSampler)))
+					return false;
+				samplerIndex += bindings[i].descriptorCount;
+			}
+
+			if(bindingFlags && setLayout->bindingFlags[i] != bindingFlags[i])
+				return false;
+		}
+
+		return true;
+	}
+
+	// Public functions
+	VulkanDescriptorLayoutCache::VulkanDescriptorLayoutCache(VulkanDevice* device) : device(device), setLayoutCount(0) { }
+
+	VkDescriptorSetLayout VulkanDescriptorLayoutCache::GetSetLayout(uint32_t bindingCount, const VkDescriptorSetLayoutBinding* bindings, VkDescriptorSetLayoutCreateFlags flags, const VkDescriptorBindingFlags* bindingFlags) {
+		// Hash the set layout's flags and bindings
+		uint64_t hash = ComputeFNV1aHash(&flags, sizeof(VkDescriptorSetLayoutCreateFlags));
+		for(uint32_t i = 0; i != bindingCount; ++i) {
+			hash = ComputeFNV1aHash(&bindings[i].binding, sizeof(uint32_t), hash);
+			hash = ComputeFNV1aHash(&bindings[i].descriptorType, sizeof(VkDescriptorType), hash);
+			hash = ComputeFNV1aHash(&bindings[i].descriptorCount, sizeof(uint32_t), hash);
+			hash = ComputeFNV1aHash(&bindings[i].stageFlags, sizeof(VkShaderStageFlags), hash);
+
+			// Hash the binding's immutable samplers, if it has any
+			if(bindings[i].pImmutableSamplers)
+				hash = ComputeFNV1aHash(bindings[i].pImmutableSamplers, bindings[i].descriptorCount * sizeof(VkSampler), hash);
+		}
+
+		// Hash the bindings' descriptor indexing flags, if they have any
+		if(bindingFlags)
+			hash = ComputeFNV1aHash(bindingFlags, bindingCount * sizeof(VkDescriptorBindingFlags), hash);
+
+		// Return the existing set layout, if an identical one was already created; set layouts with colliding hashes are chained together
+		SetLayout* collidingSetLayouts = nullptr;
+		auto setLayoutIter = setLayouts.find(hash);
+		if(setLayoutIter != setLayouts.end()) {
+			for(SetLayout* setLayout = setLayoutIter->second; setLayout; setLayout = setLayout->nextCollision)
+				if(SetLayoutMatches(setLayout, bindingCount, bindings, flags, bindingFlags))
+					return setLayout->setLayout;
+
+			collidingSetLayouts = setLayoutIter->second;
+		}
+
+		// Set the set layout's binding flags info and create info
+		VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo {
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+			.pNext = nullptr,
+			.bindingCount = bindingCount,
+			.pBindingFlags = bindingFlags
+		};
+
+		VkDescriptorSetLayoutCreateInfo createInfo {
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+			.pNext = bindingFlags ? &bindingFlagsInfo : nullptr,
+			.flags = flags,
+			.bindingCount = bindingCount,
+			.pBindings = bindings
+		};
+
+		// Create the set layout
+		VkDescriptorSetLayout vulkanSetLayout;
+		VkResult result = device->GetLoader()->vkCreateDescriptorSetLayout(device->GetDevice(), &createInfo, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS, &vulkanSetLayout);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to create Vulkan descriptor set layout! Error code: %s", string_VkResult(result));
+
+		// Save the set layout's key, so that later requests with the same hash can be compared against it
+		PushMemoryUsageType(MEMORY_USAGE_TYPE_RENDERER);
+		SetLayout* setLayout = NewObject<SetLayout>();
+		PopMemoryUsageType();
+
+		setLayout->setLayout = vulkanSetLayout;
+		setLayout->flags = flags;
+		setLayout->bindings.resize(bindingCount);
+		if(bindingFlags)
+			setLayout->bindingFlags.resize(bindingCount);
+
+		for(uint32_t i = 0; i != bindingCount; ++i) {
+			setLayout->bindings[i] = bindings[i];
+			if(bindings[i].pImmutableSamplers)
+				for(uint32_t j = 0; j != bindings[i].descriptorCount; ++j)
+					setLayout->immutableSamplers.push_back(bindings[i].pImmutableSamplers[j]);
+			if(bindingFlags)
+				setLayout->bindingFlags[i] = bindingFlags[i];
+		}
+
+		// Point the saved bindings to the saved immutable samplers, as the given arrays may not outlive the cache
+		size_t samplerIndex = 0;
+		for(uint32_t i = 0; i != bindingCount; ++i) {
+			if(bindings[i].pImmutableSamplers) {
+				setLayout->bindings[i].pImmutableSamplers = setLayout->immutableSamplers.data() + samplerIndex;
+				samplerIndex += bindings[i].descriptorCount;
+			}
+		}
+
+		// Add the set layout to the map, chaining it to the set layouts with the same hash
+		setLayout->nextCollision = collidingSetLayouts;
+		if(collidingSetLayouts) {
+			setLayoutIter->second = setLayout;
+		} else {
+			setLayouts.insert({ hash, setLayout });
+		}
+		++setLayoutCount;
+
+		return vulkanSetLayout;
+	}
+
+	VulkanDescriptorLayoutCache::~VulkanDescriptorLayoutCache() {
+		// Destroy every descriptor set layout
+		for(auto& setLayoutPair : setLayouts) {
+			SetLayout* setLayout = setLayoutPair.second;
+			while(setLayout) {
+				SetLayout* nextCollision = setLayout->nextCollision;
+				device->GetLoader()->vkDestroyDescriptorSetLayout(device->GetDevice(), setLayout->setLayout, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+				DestroyObject(setLayout);
+				setLayout = nextCollision;
+			}
+		}
+	}
+}
\ No newline at end of file
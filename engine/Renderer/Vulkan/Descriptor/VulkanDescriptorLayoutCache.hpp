@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Renderer/Vulkan/Instance/VulkanDevice.hpp"
+
+#include <Core.hpp>
+#include <vulkan/vk_platform.h>
+#include <vulkan/vulkan_core.h>
+
+namespace wfe {
+	/// @brief A cache that deduplicates identical Vulkan descriptor set layouts.
+	class VulkanDescriptorLayoutCache {
+	public:
+		/// @brief Creates a Vulkan descriptor layout cache.
+		/// @param device The Vulkan device to create the descriptor set layouts for.
+		VulkanDescriptorLayoutCache(VulkanDevice* device);
+		VulkanDescriptorLayoutCache(const VulkanDescriptorLayoutCache&) = delete;
+		VulkanDescriptorLayoutCache(VulkanDescriptorLayoutCache&&) noexcept = delete;
+
+		VulkanDescriptorLayoutCache& operator=(const VulkanDescriptorLayoutCache&) = delete;
+		VulkanDescriptorLayoutCache& operator=(VulkanDescriptorLayoutCache&&) = delete;
+
+		/// @brief Gets the Vulkan function loader used by the layout cache.
+		/// @return A pointer to the Vulkan loader used by the layout cache.
+		const VulkanLoader* GetLoader() const {
+			return device->GetLoader();
+		}
+		/// @brief Gets the Vulkan device that owns the layout cache.
+		/// @return A pointer to the Vulkan device wrapper object.
+		VulkanDevice* GetDevice() {
+			return device;
+		}
+		/// @brief Gets the Vulkan device that owns the layout cache.
+		/// @return A const pointer to the Vulkan device wrapper object.
+		const VulkanDevice* GetDevice() const {
+			return device;
+		}
+		/// @brief Gets the number of unique descriptor set layouts in the cache.
+		/// @return The number of unique descriptor set layouts.
+		size_t GetSetLayoutCount() const {
+			return setLayoutCount;
+		}
+
+		/// @brief Gets the descriptor set layout with the given bindings, creating it if it doesn't exist.
+		/// @param bindingCount The number of bindings in the set layout.
+		/// @param bindings A pointer to an array of the set layout's bindings, sorted by their binding indices.
+		/// @param flags The flags to use when creating the set layout.
+		/// @param bindingFlags A pointer to an array of every binding's descriptor indexing flags, or nullptr if the bindings don't use any.
+		/// @return A handle to the Vulkan descriptor set layout.
+		VkDescriptorSetLayout GetSetLayout(uint32_t bindingCount, const VkDescriptorSetLayoutBinding* bindings, VkDescriptorSetLayoutCreateFlags flags = 0, const VkDescriptorBindingFlags* bindingFlags = nullptr);
+
+		/// @brief Destroys the Vulkan descriptor layout cache and all of its set layouts.
+		~VulkanDescriptorLayoutCache();
+	private:
+		struct SetLayout {
+			VkDescriptorSetLayout setLayout;
+			VkDescriptorSetLayoutCreateFlags flags;
+			vector<VkDescriptorSetLayoutBinding> bindings;
+			vector<VkSampler> immutableSamplers;
+			vector<VkDescriptorBindingFlags> bindingFlags;
+			SetLayout* nextCollision;
+		};
+
+		static bool8_t SetLayoutMatches(const SetLayout* setLayout, uint32_t bindingCount, const VkDescriptorSetLayoutBinding* bindings, VkDescriptorSetLayoutCreateFlags flags, const VkDescriptorBindingFlags* bindingFlags);
+
+		VulkanDevice* device;
+
+		unordered_map<uint64_t, SetLayout*> setLayouts;
+		size_t setLayoutCount;
+	};
+}
\ No newline at end of file
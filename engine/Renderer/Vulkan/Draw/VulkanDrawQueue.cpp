@@ -0,0 +1,212 @@
+#include "VulkanDrawQueue.hpp"
+#include "General/Hash.hpp"
+#include "General/RadixSort.hpp"
+
+namespace wfe {
+	// Constants
+	static const uint32_t DEPTH_SHIFT = 0;
+	static const uint32_t MATERIAL_SHIFT = DEPTH_SHIFT + VulkanDrawQueue::DEPTH_BITS;
+	static const uint32_t PIPELINE_SHIFT = MATERIAL_SHIFT + VulkanDrawQueue::MATERIAL_BITS;
+	static const uint32_t PASS_SHIFT = PIPELINE_SHIFT + VulkanDrawQueue::PIPELINE_BITS;
+
+	// Internal helper functions
+	uint64_t VulkanDrawQueue::ComputeBatchHash(uint64_t sortKey, const Draw& draw) {
+		// Hash the sort key's bits above the depth and every mesh state member, leaving out the instance parameters
+		uint64_t stateKey = sortKey >> DEPTH_BITS;
+		uint64_t hash = ComputeFNV1aHash(&stateKey, sizeof(uint64_t));
+		hash = ComputeFNV1aHash(&draw.pipeline, sizeof(VkPipeline), hash);
+		hash = ComputeFNV1aHash(&draw.pipelineLayout, sizeof(VkPipelineLayout), hash);
+		hash = ComputeFNV1aHash(&draw.descriptorSetIndex, sizeof(uint32_t), hash);
+		hash = ComputeFNV1aHash(&draw.descriptorSet, sizeof(VkDescriptorSet), hash);
+		hash = ComputeFNV1aHash(&draw.vertexBuffer, sizeof(VkBuffer), hash);
+		hash = ComputeFNV1aHash(&draw.vertexBufferOffset, sizeof(VkDeviceSize), hash);
+		hash = ComputeFNV1aHash(&draw.indexBuffer, sizeof(VkBuffer), hash);
+		hash = ComputeFNV1aHash(&draw.indexBufferOffset, sizeof(VkDeviceSize), hash);
+		hash = ComputeFNV1aHash(&draw.indexType, sizeof(VkIndexType), hash);
+		hash = ComputeFNV1aHash(&draw.indexCount, sizeof(uint32_t), hash);
+		hash = ComputeFNV1aHash(&draw.firstIndex, sizeof(uint32_t), hash);
+		hash = ComputeFNV1aHash(&draw.vertexOffset, sizeof(int32_t), hash);
+
+		return hash;
+	}
+	bool8_t VulkanDrawQueue::CanMergeDraws(uint64_t sortKey, const Draw& draw, uint64_t otherSortKey, const Draw& otherDraw) {
+		return (sortKey >> DEPTH_BITS) == (otherSortKey >> DEPTH_BITS) && draw.pipeline == otherDraw.pipeline && draw.pipelineLayout == otherDraw.pipelineLayout && draw.descriptorSetIndex == otherDraw.descriptorSetIndex && draw.descriptorSet == otherDraw.descriptorSet && draw.vertexBuffer == otherDraw.vertexBuffer && draw.vertexBufferOffset == otherDraw.vertexBufferOffset && draw.indexBuffer == otherDraw.indexBuffer && draw.indexBufferOffset == otherDraw.indexBufferOffset && draw.indexType == otherDraw.indexType && draw.indexCount == otherDraw.indexCount && draw.firstIndex == otherDraw.firstIndex && draw.vertexOffset == otherDraw.vertexOffset;
+	}
+
+	// Public functions
+	uint64_t VulkanDrawQueue::MakeSortKey(uint32_t passIndex, uint32_t pipelineIndex, uint32_t materialIndex, float32_t depth) {
+		// Quantize the clamped depth
+		if(!(depth > 0.f))
+			depth = 0.f;
+		else if(depth > 1.f)
+			depth = 1.f;
+
+		uint64_t quantizedDepth = (uint64_t)(depth * (float32_t)((1 << DEPTH_BITS) - 1));
+
+		// Pack every property in its bits
+		return ((uint64_t)(passIndex & ((1 << PASS_BITS) - 1)) << PASS_SHIFT) | ((uint64_t)(pipelineIndex & ((1 << PIPELINE_BITS) - 1)) << PIPELINE_SHIFT) | ((uint64_t)(materialIndex & ((1 << MATERIAL_BITS) - 1)) << MATERIAL_SHIFT) | (quantizedDepth << DEPTH_SHIFT);
+	}
+
+	VulkanDrawQueue::VulkanDrawQueue(VulkanDevice* device, VulkanTransientRing* transientRing, JobSystem* jobSystem) : device(device), transientRing(transientRing), jobSystem(jobSystem), stats{ 0, 0, 0, 0, 0, 0 } { }
+
+	void VulkanDrawQueue::Submit(uint64_t sortKey, const Draw& draw) {
+		// Add the draw and its key to the queue
+		draws.push_back(draw);
+		sortKeys.push_back(sortKey);
+		transformIndices.push_back(UINT32_T_MAX);
+	}
+	void VulkanDrawQueue::SubmitInstance(uint64_t sortKey, const Draw& draw, const InstanceTransform& transform) {
+		// Add the draw, its key and its transform to the queue
+		transformIndices.push_back((uint32_t)transforms.size());
+		transforms.push_back(transform);
+		draws.push_back(draw);
+		sortKeys.push_back(sortKey);
+	}
+	void VulkanDrawQueue::Sort() {
+		// Sort the draw indices by their keys, so that the draws themselves are never moved
+		size_t drawCount = draws.size();
+
+		drawIndices.resize(drawCount);
+		tempSortKeys.resize(drawCount);
+		tempDrawIndices.resize(drawCount);
+
+		for(size_t i = 0; i != drawCount; ++i)
+			drawIndices[i] = (uint32_t)i;
+
+		RadixSort(drawCount, sortKeys.data(), drawIndices.data(), tempSortKeys.data(), tempDrawIndices.data(), jobSystem);
+	}
+	VulkanDrawQueue::RecordStats VulkanDrawQueue::Record(VkCommandBuffer commandBuffer) {
+		stats = { (uint32_t)drawIndices.size(), 0, 0, 0, 0, 0 };
+
+		// Group the instanced draws into batches, each recorded at the position of its first draw; the sorted keys are in the same order as the draw indices. The batch map is kept between frames and only cleared, as building a new one every frame would allocate its buckets again
+		PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
+
+		batchIndices.clear();
+		batches.clear();
+		drawBatchIndices.resize(drawIndices.size());
+
+		for(size_t i = 0; i != drawIndices.size(); ++i) {
+			uint32_t drawIndex = drawIndices[i];
+
+			// Give every regular draw its own batch with no instances
+			if(transformIndices[drawIndex] == UINT32_T_MAX) {
+				drawBatchIndices[i] = (uint32_t)batches.size();
+				batches.push_back({ sortKeys[i], drawIndex, 0, 0, 0 });
+				continue;
+			}
+
+			// Add the instance to the existing batch with the same state; on a hash collision, the new batch replaces the old one in the map
+			uint64_t hash = ComputeBatchHash(sortKeys[i], draws[drawIndex]);
+			auto batchIter = batchIndices.find(hash);
+			if(batchIter != batchIndices.end()) {
+				Batch& batch = batches[batchIter->second];
+				if(CanMergeDraws(sortKeys[i], draws[drawIndex], batch.sortKey, draws[batch.drawIndex])) {
+					drawBatchIndices[i] = batchIter->second;
+					++batch.instanceCount;
+					continue;
+				}
+
+				batchIndices.erase(hash);
+			}
+
+			drawBatchIndices[i] = (uint32_t)batches.size();
+			batchIndices.insert({ hash, (uint32_t)batches.size() });
+			batches.push_back({ sortKeys[i], drawIndex, 1, 0, 0 });
+		}
+
+		PopMemoryUsageType();
+
+		// Assign every batch its range of the instance transforms
+		uint32_t instanceCount = 0;
+		for(size_t i = 0; i != batches.size(); ++i) {
+			batches[i].firstInstance = instanceCount;
+			instanceCount += batches[i].instanceCount;
+		}
+
+		// Write the instance transforms to the transient ring in batch order and bind them
+		if(instanceCount) {
+			VkDeviceSize instanceOffset;
+			InstanceTransform* instanceTransforms = (InstanceTransform*)transientRing->Allocate(instanceCount * sizeof(InstanceTransform), 16, instanceOffset);
+
+			for(size_t i = 0; i != drawIndices.size(); ++i) {
+				uint32_t transformIndex = transformIndices[drawIndices[i]];
+				if(transformIndex == UINT32_T_MAX)
+					continue;
+
+				Batch& batch = batches[drawBatchIndices[i]];
+				instanceTransforms[batch.firstInstance + batch.writtenInstanceCount++] = transforms[transformIndex];
+			}
+
+			VkBuffer instanceBuffer = transientRing->GetBuffer();
+			device->GetLoader()->vkCmdBindVertexBuffers(commandBuffer, INSTANCE_BINDING, 1, &instanceBuffer, &instanceOffset);
+			++stats.vertexBufferBindCount;
+		}
+
+		// Keep track of the currently bound state
+		VkPipeline boundPipeline = VK_NULL_HANDLE;
+		VkPipelineLayout boundPipelineLayout = VK_NULL_HANDLE;
+		uint32_t boundDescriptorSetIndex = UINT32_T_MAX;
+		VkDescriptorSet boundDescriptorSet = VK_NULL_HANDLE;
+		VkBuffer boundVertexBuffer = VK_NULL_HANDLE;
+		VkDeviceSize boundVertexBufferOffset = 0;
+		VkBuffer boundIndexBuffer = VK_NULL_HANDLE;
+		VkDeviceSize boundIndexBufferOffset = 0;
+		VkIndexType boundIndexType = VK_INDEX_TYPE_MAX_ENUM;
+
+		for(size_t i = 0; i != batches.size(); ++i) {
+			const Batch& batch = batches[i];
+			const Draw& draw = draws[batch.drawIndex];
+
+			// Bind the draw's pipeline, if it isn't already bound
+			if(draw.pipeline != boundPipeline) {
+				device->GetLoader()->vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, draw.pipeline);
+				boundPipeline = draw.pipeline;
+				++stats.pipelineBindCount;
+			}
+
+			// Bind the draw's descriptor set, if it isn't already bound; sets are conservatively rebound whenever the pipeline layout changes
+			if(draw.descriptorSet && (draw.descriptorSet != boundDescriptorSet || draw.descriptorSetIndex != boundDescriptorSetIndex || draw.pipelineLayout != boundPipelineLayout)) {
+				device->GetLoader()->vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, draw.pipelineLayout, draw.descriptorSetIndex, 1, &draw.descriptorSet, 0, nullptr);
+				boundPipelineLayout = draw.pipelineLayout;
+				boundDescriptorSetIndex = draw.descriptorSetIndex;
+				boundDescriptorSet = draw.descriptorSet;
+				++stats.descriptorSetBindCount;
+			}
+
+			// Bind the draw's vertex buffer, if it isn't already bound
+			if(draw.vertexBuffer && (draw.vertexBuffer != boundVertexBuffer || draw.vertexBufferOffset != boundVertexBufferOffset)) {
+				device->GetLoader()->vkCmdBindVertexBuffers(commandBuffer, 0, 1, &draw.vertexBuffer, &draw.vertexBufferOffset);
+				boundVertexBuffer = draw.vertexBuffer;
+				boundVertexBufferOffset = draw.vertexBufferOffset;
+				++stats.vertexBufferBindCount;
+			}
+
+			// Bind the draw's index buffer, if it isn't already bound
+			if(draw.indexBuffer != boundIndexBuffer || draw.indexBufferOffset != boundIndexBufferOffset || draw.indexType != boundIndexType) {
+				device->GetLoader()->vkCmdBindIndexBuffer(commandBuffer, draw.indexBuffer, draw.indexBufferOffset, draw.indexType);
+				boundIndexBuffer = draw.indexBuffer;
+				boundIndexBufferOffset = draw.indexBufferOffset;
+				boundIndexType = draw.indexType;
+				++stats.indexBufferBindCount;
+			}
+
+			// Record the draw, using the batch's instance range for merged draws
+			if(batch.instanceCount) {
+				device->GetLoader()->vkCmdDrawIndexed(commandBuffer, draw.indexCount, batch.instanceCount, draw.firstIndex, draw.vertexOffset, batch.firstInstance);
+			} else {
+				device->GetLoader()->vkCmdDrawIndexed(commandBuffer, draw.indexCount, draw.instanceCount, draw.firstIndex, draw.vertexOffset, draw.firstInstance);
+			}
+			++stats.drawCount;
+		}
+
+		return stats;
+	}
+	void VulkanDrawQueue::Clear() {
+		// Clear the draws, their keys and their transforms
+		draws.clear();
+		sortKeys.clear();
+		transformIndices.clear();
+		transforms.clear();
+		drawIndices.clear();
+	}
+}
\ No newline at end of file
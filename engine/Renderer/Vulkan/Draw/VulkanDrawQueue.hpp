@@ -0,0 +1,175 @@
+#pragma once
+
+#include "Renderer/Vulkan/Instance/VulkanDevice.hpp"
+#include "Renderer/Vulkan/Instance/VulkanTransientRing.hpp"
+
+#include <Core.hpp>
+#include <vulkan/vk_platform.h>
+#include <vulkan/vulkan_core.h>
+
+namespace wfe {
+	/// @brief A queue of draws, which are sorted by a 64-bit key before being recorded so that draws sharing state are recorded together and redundant binds are skipped. Instanced draws of the same mesh with the same state are merged into a single draw.
+	class VulkanDrawQueue {
+	public:
+		/// @brief The number of sort key bits used by the pass index, which are the most significant.
+		static const uint32_t PASS_BITS = 8;
+		/// @brief The number of sort key bits used by the pipeline index.
+		static const uint32_t PIPELINE_BITS = 16;
+		/// @brief The number of sort key bits used by the material index.
+		static const uint32_t MATERIAL_BITS = 20;
+		/// @brief The number of sort key bits used by the quantized depth, which are the least significant.
+		static const uint32_t DEPTH_BITS = 20;
+		/// @brief The vertex input binding the instance transforms of merged draws are bound to, with a per-instance input rate.
+		static const uint32_t INSTANCE_BINDING = 1;
+
+		/// @brief A struct containing a single draw's state and parameters.
+		struct Draw {
+			/// @brief The graphics pipeline to draw with.
+			VkPipeline pipeline;
+			/// @brief The layout of the graphics pipeline.
+			VkPipelineLayout pipelineLayout;
+			/// @brief The index of the set the descriptor set is bound to.
+			uint32_t descriptorSetIndex;
+			/// @brief The descriptor set to bind, or VK_NULL_HANDLE if no set should be bound.
+			VkDescriptorSet descriptorSet;
+			/// @brief The vertex buffer to bind at binding 0, or VK_NULL_HANDLE if the vertices are fetched from a storage buffer.
+			VkBuffer vertexBuffer;
+			/// @brief The offset of the vertices in the vertex buffer.
+			VkDeviceSize vertexBufferOffset;
+			/// @brief The index buffer to bind.
+			VkBuffer indexBuffer;
+			/// @brief The offset of the indices in the index buffer.
+			VkDeviceSize indexBufferOffset;
+			/// @brief The type of the indices in the index buffer.
+			VkIndexType indexType;
+			/// @brief The number of indices to draw.
+			uint32_t indexCount;
+			/// @brief The number of instances to draw.
+			uint32_t instanceCount;
+			/// @brief The first index to draw.
+			uint32_t firstIndex;
+			/// @brief The offset added to every vertex index.
+			int32_t vertexOffset;
+			/// @brief The first instance to draw.
+			uint32_t firstInstance;
+		};
+		/// @brief A struct containing a single instance's row-major 3x4 object to world transform, as read from the instance binding.
+		struct InstanceTransform {
+			/// @brief The transform's rows, each holding the rotation and scale in the first three columns and the translation in the last.
+			float32_t rows[3][4];
+		};
+		/// @brief A struct containing the number of commands recorded for the queue's draws.
+		struct RecordStats {
+			/// @brief The number of draws submitted to the queue.
+			uint32_t submittedDrawCount;
+			/// @brief The number of recorded draws, after merging instanced draws.
+			uint32_t drawCount;
+			/// @brief The number of pipeline binds that weren't skipped.
+			uint32_t pipelineBindCount;
+			/// @brief The number of descriptor set binds that weren't skipped.
+			uint32_t descriptorSetBindCount;
+			/// @brief The number of vertex buffer binds that weren't skipped.
+			uint32_t vertexBufferBindCount;
+			/// @brief The number of index buffer binds that weren't skipped.
+			uint32_t indexBufferBindCount;
+		};
+
+		/// @brief Packs the given draw properties into a sort key, sorting draws by pass, then by pipeline, then by material, then from front to back.
+		/// @param passIndex The index of the draw's pass, which must fit in PASS_BITS.
+		/// @param pipelineIndex The index of the draw's pipeline, which must fit in PIPELINE_BITS.
+		/// @param materialIndex The index of the draw's material, which must fit in MATERIAL_BITS.
+		/// @param depth The draw's normalized view depth, clamped to [0, 1]. Pass 1 - depth to sort transparent draws from back to front.
+		/// @return The packed sort key.
+		static uint64_t MakeSortKey(uint32_t passIndex, uint32_t pipelineIndex, uint32_t materialIndex, float32_t depth);
+
+		/// @brief Creates a Vulkan draw queue.
+		/// @param device The Vulkan device whose commands the queue records.
+		/// @param transientRing The transient ring the instance transforms of merged draws are written to, whose buffer must have vertex buffer usage.
+		/// @param jobSystem The job system used to sort the queue's draws, or nullptr to sort on the calling thread.
+		VulkanDrawQueue(VulkanDevice* device, VulkanTransientRing* transientRing, JobSystem* jobSystem);
+		VulkanDrawQueue(const VulkanDrawQueue&) = delete;
+		VulkanDrawQueue(VulkanDrawQueue&&) noexcept = delete;
+
+		VulkanDrawQueue& operator=(const VulkanDrawQueue&) = delete;
+		VulkanDrawQueue& operator=(VulkanDrawQueue&&) = delete;
+
+		/// @brief Gets the Vulkan function loader used by the queue.
+		/// @return A pointer to the Vulkan loader used by the queue.
+		const VulkanLoader* GetLoader() const {
+			return device->GetLoader();
+		}
+		/// @brief Gets the Vulkan device that owns the queue.
+		/// @return A pointer to the Vulkan device wrapper object.
+		VulkanDevice* GetDevice() {
+			return device;
+		}
+		/// @brief Gets the Vulkan device that owns the queue.
+		/// @return A const pointer to the Vulkan device wrapper object.
+		const VulkanDevice* GetDevice() const {
+			return device;
+		}
+		/// @brief Gets the job system used to sort the queue's draws.
+		/// @return A pointer to the job system, or nullptr if draws are sorted on the calling thread.
+		JobSystem* GetJobSystem() const {
+			return jobSystem;
+		}
+		/// @brief Gets the number of draws submitted since the queue was last cleared.
+		/// @return The queue's draw count.
+		size_t GetDrawCount() const {
+			return draws.size();
+		}
+		/// @brief Gets the number of draws and binds recorded by the last call to Record.
+		/// @return A const reference to the record stats struct.
+		const RecordStats& GetStats() const {
+			return stats;
+		}
+
+		/// @brief Submits a draw to the queue.
+		/// @param sortKey The draw's sort key, usually created using MakeSortKey.
+		/// @param draw The draw's state and parameters.
+		void Submit(uint64_t sortKey, const Draw& draw);
+		/// @brief Submits a single instance of a mesh to the queue, which will be merged with every other instance with the same sort key bits above the depth and the same draw state.
+		/// @param sortKey The draw's sort key, usually created using MakeSortKey.
+		/// @param draw The draw's state and parameters. Its instance count and first instance are ignored.
+		/// @param transform The instance's transform, which will be bound at INSTANCE_BINDING.
+		void SubmitInstance(uint64_t sortKey, const Draw& draw, const InstanceTransform& transform);
+		/// @brief Sorts the submitted draws by their keys, keeping the submission order of draws with equal keys.
+		void Sort();
+		/// @brief Records the draws in their sorted order, merging instanced draws and skipping every bind of already bound state. Must be called after sorting the queue.
+		/// @param commandBuffer The command buffer to record the draws in, inside a render pass or dynamic rendering scope.
+		/// @return The number of submitted and recorded draws and binds.
+		RecordStats Record(VkCommandBuffer commandBuffer);
+		/// @brief Removes every draw from the queue, keeping its memory for the next frame.
+		void Clear();
+
+		/// @brief Destroys the Vulkan draw queue.
+		~VulkanDrawQueue() = default;
+	private:
+		struct Batch {
+			uint64_t sortKey;
+			uint32_t drawIndex;
+			uint32_t instanceCount;
+			uint32_t firstInstance;
+			uint32_t writtenInstanceCount;
+		};
+
+		static uint64_t ComputeBatchHash(uint64_t sortKey, const Draw& draw);
+		static bool8_t CanMergeDraws(uint64_t sortKey, const Draw& draw, uint64_t otherSortKey, const Draw& otherDraw);
+
+		VulkanDevice* device;
+		VulkanTransientRing* transientRing;
+		JobSystem* jobSystem;
+		RecordStats stats;
+
+		vector<Draw> draws;
+		vector<uint32_t> transformIndices;
+		vector<InstanceTransform> transforms;
+		vector<uint64_t> sortKeys;
+		vector<uint32_t> drawIndices;
+		vector<uint64_t> tempSortKeys;
+		vector<uint32_t> tempDrawIndices;
+		vector<Batch> batches;
+		vector<uint32_t> drawBatchIndices;
+		unordered_map<uint64_t, uint32_t> batchIndices;
+	};
+}
\ No newline at end of file
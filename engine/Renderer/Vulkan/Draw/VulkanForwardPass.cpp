@@ -0,0 +1,238 @@
+#include "VulkanForwardPass.hpp"
+
+namespace wfe {
+	// Constants
+	static const char_t VERTEX_SHADER_NAME[] = "Forward.vert";
+	static const char_t FRAGMENT_SHADER_NAME[] = "Forward.frag";
+	static const VkClearColorValue CLEAR_COLOR { { 0.02f, 0.02f, 0.025f, 1.f } };
+
+	const char_t* const VulkanForwardPass::BASE_PIPELINE_NAME = "Forward";
+
+	// Internal helper functions
+	void VulkanForwardPass::SetViewState(VkCommandBuffer commandBuffer, const Matrix4& viewProjection) {
+		// Cover the whole swap chain image
+		VkExtent2D extent = swapChain->GetVulkanSwapChainExtent();
+		VkViewport viewport { 0.f, 0.f, (float32_t)extent.width, (float32_t)extent.height, 0.f, 1.f };
+		VkRect2D scissor { { 0, 0 }, extent };
+
+		device->GetLoader()->vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+		device->GetLoader()->vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+		// Push the view projection once, as every forward pipeline shares the same layout
+		PushConstants pushConstants { viewProjection };
+		device->GetLoader()->vkCmdPushConstants(commandBuffer, pipelineLayout->pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstants), &pushConstants);
+
+		// Bind the bindless heap once if the forward layout reads from it, leaving the other set indices to the draws' own sets
+		if(bindlessHeap && pipelineLayout->bindlessSetIndex != UINT32_T_MAX)
+			bindlessHeap->Bind(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout->pipelineLayout, pipelineLayout->bindlessSetIndex);
+	}
+
+	// Public functions
+	VulkanForwardPass::VulkanForwardPass(VulkanDevice* device, VulkanSwapChain* swapChain, VulkanShaderLibrary* shaderLibrary, VulkanPipelineVariantCache* pipelineVariantCache, VulkanBindlessHeap* bindlessHeap) : device(device), swapChain(swapChain), pipelineVariantCache(pipelineVariantCache), bindlessHeap(bindlessHeap) {
+		// Load the forward shaders and get their pipeline layout
+		const VulkanShaderLibrary::ShaderModule* shaderModules[] {
+			shaderLibrary->GetShaderModule(VERTEX_SHADER_NAME),
+			shaderLibrary->GetShaderModule(FRAGMENT_SHADER_NAME)
+		};
+		pipelineLayout = shaderLibrary->GetPipelineLayout(2, shaderModules);
+
+		// Set the base pipeline's state, which is kept in the pass, as the variant cache reads it every time it creates a variant
+		stages[0] = {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.stage = VK_SHADER_STAGE_VERTEX_BIT,
+			.module = shaderModules[0]->shaderModule,
+			.pName = "main",
+			.pSpecializationInfo = nullptr
+		};
+		stages[1] = {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.stage = VK_SHADER_STAGE_FRAGMENT_BIT,
+			.module = shaderModules[1]->shaderModule,
+			.pName = "main",
+			.pSpecializationInfo = nullptr
+		};
+
+		// Read the vertices from binding 0 and the instance transforms written by the draw queue from the instance binding
+		vertexBindings[0] = { 0, VERTEX_STRIDE, VK_VERTEX_INPUT_RATE_VERTEX };
+		vertexBindings[1] = { VulkanDrawQueue::INSTANCE_BINDING, sizeof(VulkanDrawQueue::InstanceTransform), VK_VERTEX_INPUT_RATE_INSTANCE };
+
+		vertexAttributes[0] = { 0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0 };
+		vertexAttributes[1] = { 1, 0, VK_FORMAT_R32G32B32_SFLOAT, 3 * sizeof(float32_t) };
+		for(uint32_t i = 0; i != 3; ++i)
+			vertexAttributes[2 + i] = { 2 + i, VulkanDrawQueue::INSTANCE_BINDING, VK_FORMAT_R32G32B32A32_SFLOAT, i * 4 * (uint32_t)sizeof(float32_t) };
+
+		vertexInputState = {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.vertexBindingDescriptionCount = 2,
+			.pVertexBindingDescriptions = vertexBindings,
+			.vertexAttributeDescriptionCount = 5,
+			.pVertexAttributeDescriptions = vertexAttributes
+		};
+		inputAssemblyState = {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+			.primitiveRestartEnable = VK_FALSE
+		};
+
+		// The viewport and scissor are dynamic, so that the pipelines stay valid when the swap chain is resized
+		viewportState = {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.viewportCount = 1,
+			.pViewports = nullptr,
+			.scissorCount = 1,
+			.pScissors = nullptr
+		};
+		rasterizationState = {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.depthClampEnable = VK_FALSE,
+			.rasterizerDiscardEnable = VK_FALSE,
+			.polygonMode = VK_POLYGON_MODE_FILL,
+			.cullMode = VK_CULL_MODE_BACK_BIT,
+			.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE,
+			.depthBiasEnable = VK_FALSE,
+			.depthBiasConstantFactor = 0.f,
+			.depthBiasClamp = 0.f,
+			.depthBiasSlopeFactor = 0.f,
+			.lineWidth = 1.f
+		};
+		multisampleState = {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT,
+			.sampleShadingEnable = VK_FALSE,
+			.minSampleShading = 0.f,
+			.pSampleMask = nullptr,
+			.alphaToCoverageEnable = VK_FALSE,
+			.alphaToOneEnable = VK_FALSE
+		};
+		depthStencilState = {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.depthTestEnable = VK_TRUE,
+			.depthWriteEnable = VK_TRUE,
+			.depthCompareOp = VK_COMPARE_OP_LESS,
+			.depthBoundsTestEnable = VK_FALSE,
+			.stencilTestEnable = VK_FALSE,
+			.front = {},
+			.back = {},
+			.minDepthBounds = 0.f,
+			.maxDepthBounds = 1.f
+		};
+		colorBlendAttachment = {
+			.blendEnable = VK_FALSE,
+			.srcColorBlendFactor = VK_BLEND_FACTOR_ONE,
+			.dstColorBlendFactor = VK_BLEND_FACTOR_ZERO,
+			.colorBlendOp = VK_BLEND_OP_ADD,
+			.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
+			.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO,
+			.alphaBlendOp = VK_BLEND_OP_ADD,
+			.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
+		};
+		colorBlendState = {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.logicOpEnable = VK_FALSE,
+			.logicOp = VK_LOGIC_OP_COPY,
+			.attachmentCount = 1,
+			.pAttachments = &colorBlendAttachment,
+			.blendConstants = { 0.f, 0.f, 0.f, 0.f }
+		};
+
+		dynamicStates[0] = VK_DYNAMIC_STATE_VIEWPORT;
+		dynamicStates[1] = VK_DYNAMIC_STATE_SCISSOR;
+		dynamicState = {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.dynamicStateCount = 2,
+			.pDynamicStates = dynamicStates
+		};
+
+		// Target the swap chain's attachment formats through dynamic rendering if it's used, otherwise through the swap chain's render pass
+		bool8_t dynamicRendering = swapChain->UsesDynamicRendering();
+
+		createInfo = {
+			.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+			.pNext = dynamicRendering ? &swapChain->GetPipelineRenderingCreateInfo() : nullptr,
+			.flags = 0,
+			.stageCount = 2,
+			.pStages = stages,
+			.pVertexInputState = &vertexInputState,
+			.pInputAssemblyState = &inputAssemblyState,
+			.pTessellationState = nullptr,
+			.pViewportState = &viewportState,
+			.pRasterizationState = &rasterizationState,
+			.pMultisampleState = &multisampleState,
+			.pDepthStencilState = &depthStencilState,
+			.pColorBlendState = &colorBlendState,
+			.pDynamicState = &dynamicState,
+			.layout = pipelineLayout->pipelineLayout,
+			.renderPass = dynamicRendering ? VK_NULL_HANDLE : swapChain->GetRenderPass(),
+			.subpass = 0,
+			.basePipelineHandle = VK_NULL_HANDLE,
+			.basePipelineIndex = -1
+		};
+
+		// Register the base pipeline, whose variants are created when first requested
+		basePipelineIndex = pipelineVariantCache->RegisterGraphicsPipeline(BASE_PIPELINE_NAME, &createInfo);
+	}
+
+	VkPipeline VulkanForwardPass::GetPipeline(uint64_t featureMask) {
+		return pipelineVariantCache->GetPipeline(VulkanPipelineVariantCache::CreateVariantKey(basePipelineIndex, featureMask));
+	}
+	void VulkanForwardPass::Record(VkCommandBuffer commandBuffer, uint32_t imageIndex, const Matrix4& viewProjection, VulkanDrawQueue* drawQueue, bool8_t transitionImages) {
+		// Begin rendering to the swap chain image, clearing its previous contents
+		swapChain->BeginRendering(commandBuffer, imageIndex, CLEAR_COLOR, transitionImages);
+		SetViewState(commandBuffer, viewProjection);
+
+		// Sort and record the queued draws
+		drawQueue->Sort();
+		drawQueue->Record(commandBuffer);
+
+		// End rendering, transitioning the image for presentation unless the render graph does
+		swapChain->EndRendering(commandBuffer, imageIndex, transitionImages);
+	}
+	void VulkanForwardPass::RecordCulled(VkCommandBuffer commandBuffer, uint32_t imageIndex, const Matrix4& viewProjection, const VulkanDrawQueue::Draw& draw, VkBuffer instanceBuffer, VkDeviceSize instanceOffset, VulkanGpuCuller* gpuCuller, size_t frameIndex, VulkanGpuCuller::Phase phase, VulkanDrawQueue* drawQueue) {
+		// Clear the swap chain image before the early phase's draws, and keep the early phase's color and depth for the late phase's draws
+		if(phase == VulkanGpuCuller::PHASE_EARLY) {
+			swapChain->BeginRendering(commandBuffer, imageIndex, CLEAR_COLOR);
+		} else {
+			swapChain->ResumeRendering(commandBuffer, imageIndex);
+		}
+		SetViewState(commandBuffer, viewProjection);
+
+		// Bind the shared draw state; the culler writes every instance's index as its draw's first instance, which selects its transform
+		device->GetLoader()->vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, draw.pipeline);
+		if(draw.descriptorSet)
+			device->GetLoader()->vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, draw.pipelineLayout, draw.descriptorSetIndex, 1, &draw.descriptorSet, 0, nullptr);
+		if(draw.vertexBuffer)
+			device->GetLoader()->vkCmdBindVertexBuffers(commandBuffer, 0, 1, &draw.vertexBuffer, &draw.vertexBufferOffset);
+		device->GetLoader()->vkCmdBindVertexBuffers(commandBuffer, VulkanDrawQueue::INSTANCE_BINDING, 1, &instanceBuffer, &instanceOffset);
+		device->GetLoader()->vkCmdBindIndexBuffer(commandBuffer, draw.indexBuffer, draw.indexBufferOffset, draw.indexType);
+
+		gpuCuller->RecordDraws(commandBuffer, frameIndex, phase);
+
+		// Record the draws that weren't culled on the GPU after the late phase's draws, as the draw queue rebinds the instance binding
+		if(drawQueue) {
+			drawQueue->Sort();
+			drawQueue->Record(commandBuffer);
+		}
+
+		swapChain->EndRendering(commandBuffer, imageIndex);
+	}
+}
\ No newline at end of file
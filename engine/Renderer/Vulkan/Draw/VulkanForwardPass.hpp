@@ -0,0 +1,122 @@
+#pragma once
+
+#include "VulkanDrawQueue.hpp"
+#include "Math/Matrix.hpp"
+#include "Renderer/Vulkan/Culling/VulkanGpuCuller.hpp"
+#include "Renderer/Vulkan/Descriptor/VulkanBindlessHeap.hpp"
+#include "Renderer/Vulkan/Instance/VulkanDevice.hpp"
+#include "Renderer/Vulkan/Instance/VulkanSwapChain.hpp"
+#include "Renderer/Vulkan/Shader/VulkanPipelineVariantCache.hpp"
+#include "Renderer/Vulkan/Shader/VulkanShaderLibrary.hpp"
+
+#include <Core.hpp>
+#include <vulkan/vk_platform.h>
+#include <vulkan/vulkan_core.h>
+
+namespace wfe {
+	/// @brief The forward pass, which draws the draw queue's sorted draws straight to the swap chain's images. Its base pipeline targets the swap chain's attachment formats, chaining the swap chain's rendering create info if it uses dynamic rendering and using its render pass otherwise.
+	class VulkanForwardPass {
+	public:
+		/// @brief The name of the forward pass's base pipeline in the pipeline variant cache.
+		static const char_t* const BASE_PIPELINE_NAME;
+		/// @brief The stride of a forward pass vertex, which holds a position followed by a normal.
+		static const uint32_t VERTEX_STRIDE = 6 * sizeof(float32_t);
+
+		/// @brief A struct containing the forward pass's push constants. Must match the push constants in Forward.vert.
+		struct PushConstants {
+			/// @brief The view projection matrix, which maps depth to Vulkan's [0, 1] range.
+			Matrix4 viewProjection;
+		};
+
+		/// @brief Creates the forward pass, loading its shaders and registering its base pipeline. The pass's pipelines depend on the swap chain's attachment formats, which must not change afterwards.
+		/// @param device The Vulkan device to record the pass for.
+		/// @param swapChain The swap chain whose images the pass renders to.
+		/// @param shaderLibrary The shader library to load the forward shaders from.
+		/// @param pipelineVariantCache The pipeline variant cache to register the base pipeline with.
+		/// @param bindlessHeap The bindless heap bound for the forward pipelines if their layout uses it, or nullptr if bindless resources aren't supported.
+		VulkanForwardPass(VulkanDevice* device, VulkanSwapChain* swapChain, VulkanShaderLibrary* shaderLibrary, VulkanPipelineVariantCache* pipelineVariantCache, VulkanBindlessHeap* bindlessHeap);
+		VulkanForwardPass(const VulkanForwardPass&) = delete;
+		VulkanForwardPass(VulkanForwardPass&&) noexcept = delete;
+
+		VulkanForwardPass& operator=(const VulkanForwardPass&) = delete;
+		VulkanForwardPass& operator=(VulkanForwardPass&&) = delete;
+
+		/// @brief Gets the Vulkan function loader used by the pass.
+		/// @return A pointer to the Vulkan loader used by the pass.
+		const VulkanLoader* GetLoader() const {
+			return device->GetLoader();
+		}
+		/// @brief Gets the Vulkan device that owns the pass.
+		/// @return A pointer to the Vulkan device wrapper object.
+		VulkanDevice* GetDevice() {
+			return device;
+		}
+		/// @brief Gets the Vulkan device that owns the pass.
+		/// @return A const pointer to the Vulkan device wrapper object.
+		const VulkanDevice* GetDevice() const {
+			return device;
+		}
+		/// @brief Gets the layout shared by every forward pipeline, which draws using it must set as their pipeline layout.
+		/// @return A const pointer to the pipeline layout's info.
+		const VulkanShaderLibrary::PipelineLayout* GetPipelineLayout() const {
+			return pipelineLayout;
+		}
+		/// @brief Gets the index of the forward pass's base pipeline in the pipeline variant cache.
+		/// @return The base pipeline's index.
+		uint32_t GetBasePipelineIndex() const {
+			return basePipelineIndex;
+		}
+
+		/// @brief Gets the forward pipeline variant with the given features, creating it if it doesn't exist.
+		/// @param featureMask A bitmask of the variant's enabled features.
+		/// @return A handle to the Vulkan pipeline.
+		VkPipeline GetPipeline(uint64_t featureMask);
+		/// @brief Records the pass, clearing the given swap chain image and drawing the draw queue's draws to it. The bindless heap is bound once before the draws if the forward layout uses it.
+		/// @param commandBuffer The command buffer to record the pass in.
+		/// @param imageIndex The index of the swap chain image to render to.
+		/// @param viewProjection The view projection matrix, which maps depth to Vulkan's [0, 1] range.
+		/// @param drawQueue The draw queue whose draws to sort and record.
+		/// @param transitionImages True if the pass should transition the swap chain image's attachments itself, or false if a render graph generates the transitions.
+		void Record(VkCommandBuffer commandBuffer, uint32_t imageIndex, const Matrix4& viewProjection, VulkanDrawQueue* drawQueue, bool8_t transitionImages = true);
+		/// @brief Records one of the GPU culler's phases, drawing its culled instances with a single draw state. The early phase clears the swap chain image, while the late phase loads the early phase's results and is followed by the draw queue's draws.
+		/// @param commandBuffer The command buffer to record the pass in.
+		/// @param imageIndex The index of the swap chain image to render to.
+		/// @param viewProjection The view projection matrix, which maps depth to Vulkan's [0, 1] range.
+		/// @param draw The draw state shared by every culled instance. Its index and instance parameters are ignored.
+		/// @param instanceBuffer The buffer holding every culled instance's transform, indexed by the instance's index in the culler.
+		/// @param instanceOffset The offset of the first instance's transform in the instance buffer.
+		/// @param gpuCuller The GPU culler whose phase's draws to record. The phase's cull must already be recorded.
+		/// @param frameIndex The index of the frame in flight.
+		/// @param phase The culling phase whose draws to record.
+		/// @param drawQueue The draw queue whose draws to sort and record after the late phase's draws, or nullptr if there are none.
+		void RecordCulled(VkCommandBuffer commandBuffer, uint32_t imageIndex, const Matrix4& viewProjection, const VulkanDrawQueue::Draw& draw, VkBuffer instanceBuffer, VkDeviceSize instanceOffset, VulkanGpuCuller* gpuCuller, size_t frameIndex, VulkanGpuCuller::Phase phase, VulkanDrawQueue* drawQueue);
+
+		/// @brief Destroys the forward pass. Its pipelines are owned and destroyed by the pipeline variant cache.
+		~VulkanForwardPass() = default;
+	private:
+		void SetViewState(VkCommandBuffer commandBuffer, const Matrix4& viewProjection);
+
+		VulkanDevice* device;
+		VulkanSwapChain* swapChain;
+		VulkanPipelineVariantCache* pipelineVariantCache;
+		VulkanBindlessHeap* bindlessHeap;
+
+		const VulkanShaderLibrary::PipelineLayout* pipelineLayout;
+		uint32_t basePipelineIndex;
+
+		VkPipelineShaderStageCreateInfo stages[2];
+		VkVertexInputBindingDescription vertexBindings[2];
+		VkVertexInputAttributeDescription vertexAttributes[5];
+		VkPipelineVertexInputStateCreateInfo vertexInputState;
+		VkPipelineInputAssemblyStateCreateInfo inputAssemblyState;
+		VkPipelineViewportStateCreateInfo viewportState;
+		VkPipelineRasterizationStateCreateInfo rasterizationState;
+		VkPipelineMultisampleStateCreateInfo multisampleState;
+		VkPipelineDepthStencilStateCreateInfo depthStencilState;
+		VkPipelineColorBlendAttachmentState colorBlendAttachment;
+		VkPipelineColorBlendStateCreateInfo colorBlendState;
+		VkDynamicState dynamicStates[2];
+		VkPipelineDynamicStateCreateInfo dynamicState;
+		VkGraphicsPipelineCreateInfo createInfo;
+	};
+}
\ No newline at end of file
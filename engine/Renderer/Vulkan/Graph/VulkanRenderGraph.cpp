@@ -0,0 +1,695 @@
+#include "VulkanRenderGraph.hpp"
+#include "General/HeapMemory.hpp"
+#include "Renderer/Vulkan/VulkanRenderer.hpp"
+
+#include <vulkan/vk_enum_string_helper.h>
+
+namespace wfe {
+	// Internal structs
+	struct AccessInfo {
+		VkPipelineStageFlags2 stageMask;
+		VkAccessFlags2 accessMask;
+		VkImageLayout layout;
+		VkImageUsageFlags imageUsage;
+		VkBufferUsageFlags bufferUsage;
+		bool8_t write;
+	};
+	struct ResourceState {
+		VkPipelineStageFlags2 writeStages;
+		VkAccessFlags2 writeAccess;
+		VkPipelineStageFlags2 readStages;
+		VkAccessFlags2 readAccess;
+		VkImageLayout layout;
+		bool8_t external;
+	};
+
+	// Constants
+	static const VkPipelineStageFlags2 SHADER_STAGES = VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+	static const VkPipelineStageFlags2 DEPTH_STAGES = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+	static const VkAccessFlags2 READ_ACCESS_MASK = VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_SHADER_SAMPLED_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_2_TRANSFER_READ_BIT;
+	static const VkAccessFlags2 WRITE_ACCESS_MASK = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT;
+
+	static const AccessInfo ACCESS_INFOS[VulkanRenderGraph::ACCESS_TYPE_COUNT] {
+		{ VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, 0, true },
+		{ DEPTH_STAGES, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, 0, true },
+		{ DEPTH_STAGES, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, 0, false },
+		{ SHADER_STAGES, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT, 0, false },
+		{ SHADER_STAGES, VK_ACCESS_2_SHADER_STORAGE_READ_BIT, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, false },
+		{ SHADER_STAGES, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, true },
+		{ VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, false },
+		{ VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, false },
+		{ VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT, VK_BUFFER_USAGE_TRANSFER_DST_BIT, true }
+	};
+
+	// Internal helper functions
+	static VkImageAspectFlags GetFormatAspectFlags(VkFormat format) {
+		switch(format) {
+		case VK_FORMAT_D16_UNORM:
+		case VK_FORMAT_X8_D24_UNORM_PACK32:
+		case VK_FORMAT_D32_SFLOAT:
+			return VK_IMAGE_ASPECT_DEPTH_BIT;
+		case VK_FORMAT_S8_UINT:
+			return VK_IMAGE_ASPECT_STENCIL_BIT;
+		case VK_FORMAT_D16_UNORM_S8_UINT:
+		case VK_FORMAT_D24_UNORM_S8_UINT:
+		case VK_FORMAT_D32_SFLOAT_S8_UINT:
+			return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+		default:
+			return VK_IMAGE_ASPECT_COLOR_BIT;
+		}
+	}
+
+	VulkanRenderGraph::ResourceHandle VulkanRenderGraph::AddResource(const Resource& resource) {
+		// Add the resource and return its index
+		resources.push_back(resource);
+		return (ResourceHandle)resources.size() - 1;
+	}
+	void VulkanRenderGraph::CullPasses() {
+		// Mark the graph's outputs as needed
+		PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
+		bool8_t* needed = (bool8_t*)AllocHeapMemory(resources.size() * sizeof(bool8_t));
+		PopMemoryUsageType();
+		if(!needed)
+			throw BadAllocException("Failed to allocate Vulkan render graph culling array!");
+
+		for(size_t i = 0; i != resources.size(); ++i)
+			needed[i] = resources[i].output;
+
+		// Walk the passes backwards, culling every pass that writes resources, none of which are needed by a later pass or the graph's outputs
+		for(size_t i = passes.size(); i--;) {
+			Pass& pass = passes[i];
+
+			bool8_t writes = false;
+			bool8_t used = false;
+			for(const auto& access : pass.accesses) {
+				if(access.write) {
+					writes = true;
+					used |= needed[access.resource];
+				}
+			}
+
+			pass.culled = writes && !used;
+			if(pass.culled) {
+				++stats.culledPassCount;
+				continue;
+			}
+
+			// Writes that discard the resource's contents make earlier producers unnecessary, while every access that reads, including attachment loads and read-write storage accesses, keeps them alive
+			for(const auto& access : pass.accesses)
+				if(access.write && !(ACCESS_INFOS[access.accessType].accessMask & READ_ACCESS_MASK))
+					needed[access.resource] = false;
+			for(const auto& access : pass.accesses)
+				if(ACCESS_INFOS[access.accessType].accessMask & READ_ACCESS_MASK)
+					needed[access.resource] = true;
+		}
+
+		// Free the needed array
+		FreeMemory(needed);
+	}
+	void VulkanRenderGraph::ComputeLifetimes() {
+		// Reset every resource's lifetime
+		for(auto& resource : resources) {
+			resource.firstPass = UINT32_T_MAX;
+			resource.lastPass = UINT32_T_MAX;
+		}
+
+		// Set every resource's first and last pass, in execution order
+		for(uint32_t i = 0; i != (uint32_t)passes.size(); ++i) {
+			if(passes[i].culled)
+				continue;
+
+			for(const auto& access : passes[i].accesses) {
+				Resource& resource = resources[access.resource];
+				if(resource.firstPass == UINT32_T_MAX)
+					resource.firstPass = i;
+				resource.lastPass = i;
+			}
+		}
+	}
+	void VulkanRenderGraph::CreateTransientResources() {
+		// Deduce every transient resource's usage from the accesses of the passes that weren't culled
+		PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
+		uint32_t* usages = (uint32_t*)AllocHeapMemory(resources.size() * (sizeof(uint32_t) + sizeof(VkMemoryRequirements) + sizeof(ResourceHandle)));
+		PopMemoryUsageType();
+		if(!usages)
+			throw BadAllocException("Failed to allocate Vulkan render graph transient resource arrays!");
+
+		VkMemoryRequirements* memRequirements = (VkMemoryRequirements*)(usages + resources.size());
+		ResourceHandle* sortedResources = (ResourceHandle*)(memRequirements + resources.size());
+
+		memset(usages, 0, resources.size() * sizeof(uint32_t));
+		for(const auto& pass : passes) {
+			if(pass.culled)
+				continue;
+
+			for(const auto& access : pass.accesses) {
+				const AccessInfo& accessInfo = ACCESS_INFOS[access.accessType];
+				usages[access.resource] |= resources[access.resource].isImage ? accessInfo.imageUsage : accessInfo.bufferUsage;
+			}
+		}
+
+		// Create every used transient resource
+		size_t transientCount = 0;
+		for(size_t i = 0; i != resources.size(); ++i) {
+			Resource& resource = resources[i];
+			if(resource.imported || resource.firstPass == UINT32_T_MAX)
+				continue;
+
+			if(resource.isImage) {
+				// Set the image's create info
+				VkImageCreateInfo createInfo {
+					.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+					.pNext = nullptr,
+					.flags = 0,
+					.imageType = VK_IMAGE_TYPE_2D,
+					.format = resource.imageDesc.format,
+					.extent = { resource.imageDesc.width, resource.imageDesc.height, 1 },
+					.mipLevels = 1,
+					.arrayLayers = 1,
+					.samples = resource.imageDesc.samples,
+					.tiling = VK_IMAGE_TILING_OPTIMAL,
+					.usage = resource.imageDesc.usage | usages[i],
+					.sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+					.queueFamilyIndexCount = 0,
+					.pQueueFamilyIndices = nullptr,
+					.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+				};
+
+				// Create the image and get its memory requirements
+				VkResult result = device->GetLoader()->vkCreateImage(device->GetDevice(), &createInfo, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS, &resource.image);
+				if(result != VK_SUCCESS) {
+					FreeMemory(usages);
+					throw Exception("Failed to create Vulkan render graph image \"%s\"! Error code: %s", resource.name, string_VkResult(result));
+				}
+
+				device->GetLoader()->vkGetImageMemoryRequirements(device->GetDevice(), resource.image, memRequirements + i);
+			} else {
+				// Set the buffer's create info
+				VkBufferCreateInfo createInfo {
+					.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+					.pNext = nullptr,
+					.flags = 0,
+					.size = resource.bufferDesc.size,
+					.usage = resource.bufferDesc.usage | usages[i],
+					.sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+					.queueFamilyIndexCount = 0,
+					.pQueueFamilyIndices = nullptr
+				};
+
+				// Create the buffer and get its memory requirements
+				VkResult result = device->GetLoader()->vkCreateBuffer(device->GetDevice(), &createInfo, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS, &resource.buffer);
+				if(result != VK_SUCCESS) {
+					FreeMemory(usages);
+					throw Exception("Failed to create Vulkan render graph buffer \"%s\"! Error code: %s", resource.name, string_VkResult(result));
+				}
+
+				device->GetLoader()->vkGetBufferMemoryRequirements(device->GetDevice(), resource.buffer, memRequirements + i);
+			}
+
+			// Insert the resource in the sorted array, keeping the largest resources first
+			size_t index = transientCount++;
+			for(; index && memRequirements[sortedResources[index - 1]].size < memRequirements[i].size; --index)
+				sortedResources[index] = sortedResources[index - 1];
+			sortedResources[index] = (ResourceHandle)i;
+
+			stats.unaliasedMemorySize += memRequirements[i].size;
+		}
+
+		// Assign every transient resource to the first alias slot whose resources have compatible memory and non-overlapping lifetimes
+		for(size_t i = 0; i != transientCount; ++i) {
+			Resource& resource = resources[sortedResources[i]];
+			const VkMemoryRequirements& resourceRequirements = memRequirements[sortedResources[i]];
+
+			uint32_t slotIndex = 0;
+			for(; slotIndex != (uint32_t)aliasSlots.size(); ++slotIndex) {
+				AliasSlot& slot = aliasSlots[slotIndex];
+				if(slot.isImage != resource.isImage || !(slot.memRequirements.memoryTypeBits & resourceRequirements.memoryTypeBits))
+					continue;
+
+				// Check if the resource's lifetime overlaps any of the slot's resources
+				bool8_t overlaps = false;
+				for(size_t j = 0; j != i; ++j) {
+					const Resource& slotResource = resources[sortedResources[j]];
+					if(slotResource.aliasSlot == slotIndex && slotResource.firstPass <= resource.lastPass && resource.firstPass <= slotResource.lastPass) {
+						overlaps = true;
+						break;
+					}
+				}
+
+				if(!overlaps)
+					break;
+			}
+
+			if(slotIndex == aliasSlots.size()) {
+				// Add a new slot for the resource
+				AliasSlot slot;
+				slot.memRequirements = resourceRequirements;
+				slot.isImage = resource.isImage;
+				aliasSlots.push_back(slot);
+			} else {
+				// Grow the existing slot to fit the resource
+				VkMemoryRequirements& slotRequirements = aliasSlots[slotIndex].memRequirements;
+				if(resourceRequirements.size > slotRequirements.size)
+					slotRequirements.size = resourceRequirements.size;
+				if(resourceRequirements.alignment > slotRequirements.alignment)
+					slotRequirements.alignment = resourceRequirements.alignment;
+				slotRequirements.memoryTypeBits &= resourceRequirements.memoryTypeBits;
+			}
+
+			resource.aliasSlot = slotIndex;
+		}
+
+		// Free the temporary arrays
+		FreeMemory(usages);
+
+		// Allocate every alias slot's memory
+		for(auto& slot : aliasSlots) {
+			VkResult result = allocator->AllocAliasedMemory(slot.memRequirements, VulkanAllocator::MEMORY_TYPE_GPU, slot.isImage, slot.memoryBlock);
+			if(result != VK_SUCCESS)
+				throw Exception("Failed to allocate Vulkan render graph transient memory! Error code: %s", string_VkResult(result));
+
+			stats.transientMemorySize += slot.memRequirements.size;
+		}
+
+		// Bind every transient resource to its slot's memory and create the image views
+		for(auto& resource : resources) {
+			if(resource.imported || resource.firstPass == UINT32_T_MAX)
+				continue;
+
+			const VulkanAllocator::MemoryBlock& memoryBlock = aliasSlots[resource.aliasSlot].memoryBlock;
+			if(!resource.isImage) {
+				VkResult result = allocator->BindBufferMemories(1, &resource.buffer, &memoryBlock);
+				if(result != VK_SUCCESS)
+					throw Exception("Failed to bind Vulkan render graph buffer memory! Error code: %s", string_VkResult(result));
+
+				continue;
+			}
+
+			VkResult result = allocator->BindImageMemories(1, &resource.image, &memoryBlock);
+			if(result != VK_SUCCESS)
+				throw Exception("Failed to bind Vulkan render graph image memory! Error code: %s", string_VkResult(result));
+
+			// Set the image view's create info, viewing only the depth aspect of depth/stencil images
+			VkImageAspectFlags viewAspectMask = resource.aspectMask;
+			if(viewAspectMask & VK_IMAGE_ASPECT_DEPTH_BIT)
+				viewAspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+
+			VkImageViewCreateInfo createInfo {
+				.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+				.pNext = nullptr,
+				.flags = 0,
+				.image = resource.image,
+				.viewType = VK_IMAGE_VIEW_TYPE_2D,
+				.format = resource.imageDesc.format,
+				.components = { VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY },
+				.subresourceRange = { viewAspectMask, 0, 1, 0, 1 }
+			};
+
+			// Create the image view
+			result = device->GetLoader()->vkCreateImageView(device->GetDevice(), &createInfo, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS, &resource.imageView);
+			if(result != VK_SUCCESS)
+				throw Exception("Failed to create Vulkan render graph image view \"%s\"! Error code: %s", resource.name, string_VkResult(result));
+		}
+	}
+	void VulkanRenderGraph::DestroyTransientResources() {
+		// Destroy every transient resource
+		for(auto& resource : resources) {
+			if(resource.imported)
+				continue;
+
+			if(resource.imageView)
+				device->GetLoader()->vkDestroyImageView(device->GetDevice(), resource.imageView, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+			if(resource.image)
+				device->GetLoader()->vkDestroyImage(device->GetDevice(), resource.image, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+			if(resource.buffer)
+				device->GetLoader()->vkDestroyBuffer(device->GetDevice(), resource.buffer, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+
+			resource.imageView = VK_NULL_HANDLE;
+			resource.image = VK_NULL_HANDLE;
+			resource.buffer = VK_NULL_HANDLE;
+		}
+
+		// Free every alias slot's memory
+		for(auto& slot : aliasSlots)
+			allocator->FreeMemory(slot.memoryBlock);
+		aliasSlots.clear();
+	}
+	void VulkanRenderGraph::GenerateBarriers() {
+		// Set every resource's initial state
+		PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
+		ResourceState* states = (ResourceState*)AllocHeapMemory(resources.size() * sizeof(ResourceState));
+		PopMemoryUsageType();
+		if(!states)
+			throw BadAllocException("Failed to allocate Vulkan render graph resource states array!");
+
+		memset(states, 0, resources.size() * sizeof(ResourceState));
+		for(size_t i = 0; i != resources.size(); ++i) {
+			const Resource& resource = resources[i];
+			if(resource.imported) {
+				// Imported images are synchronized externally, like swap chain images with their acquire semaphore
+				states[i].layout = resource.initialLayout;
+				states[i].external = resource.isImage;
+				continue;
+			}
+
+			states[i].layout = VK_IMAGE_LAYOUT_UNDEFINED;
+			if(resource.firstPass == UINT32_T_MAX)
+				continue;
+
+			// Find the previous occupant of the resource's alias slot, which is the last one to finish before the resource's first pass or, for the slot's first occupant, its last occupant in the previous execution
+			ResourceHandle previousResource = INVALID_RESOURCE;
+			ResourceHandle lastResource = INVALID_RESOURCE;
+			for(size_t j = 0; j != resources.size(); ++j) {
+				const Resource& slotResource = resources[j];
+				if(slotResource.imported || slotResource.firstPass == UINT32_T_MAX || slotResource.aliasSlot != resource.aliasSlot)
+					continue;
+
+				if(slotResource.lastPass < resource.firstPass && (previousResource == INVALID_RESOURCE || resources[previousResource].lastPass < slotResource.lastPass))
+					previousResource = (ResourceHandle)j;
+				if(lastResource == INVALID_RESOURCE || resources[lastResource].lastPass < slotResource.lastPass)
+					lastResource = (ResourceHandle)j;
+			}
+
+			if(previousResource == INVALID_RESOURCE)
+				previousResource = lastResource;
+
+			// Make the resource's first access wait for every access of the previous occupant, as their memory overlaps
+			for(const auto& pass : passes) {
+				if(pass.culled)
+					continue;
+
+				for(const auto& access : pass.accesses) {
+					if(access.resource != previousResource)
+						continue;
+
+					states[i].writeStages |= ACCESS_INFOS[access.accessType].stageMask;
+					states[i].writeAccess |= ACCESS_INFOS[access.accessType].accessMask & WRITE_ACCESS_MASK;
+				}
+			}
+		}
+
+		// Generate every pass's barriers
+		imageBarriers.clear();
+		imageBarrierResources.clear();
+		bufferBarriers.clear();
+		bufferBarrierResources.clear();
+
+		for(auto& pass : passes) {
+			pass.firstImageBarrier = imageBarriers.size();
+			pass.firstBufferBarrier = bufferBarriers.size();
+
+			if(!pass.culled) {
+				for(const auto& access : pass.accesses) {
+					const Resource& resource = resources[access.resource];
+					const AccessInfo& accessInfo = ACCESS_INFOS[access.accessType];
+					ResourceState& state = states[access.resource];
+
+					VkImageLayout layout = resource.isImage ? accessInfo.layout : VK_IMAGE_LAYOUT_UNDEFINED;
+					bool8_t layoutChange = resource.isImage && layout != state.layout;
+
+					// Get the barrier's source scope based on the hazard
+					VkPipelineStageFlags2 srcStageMask;
+					VkAccessFlags2 srcAccessMask = state.writeAccess;
+					bool8_t barrierRequired;
+
+					if(accessInfo.write) {
+						// Write after write and write after read hazards
+						srcStageMask = state.writeStages | state.readStages;
+						barrierRequired = srcStageMask || layoutChange;
+					} else if(layoutChange) {
+						// Layout transitions are writes, so previous reads must finish as well
+						srcStageMask = state.writeStages | state.readStages;
+						barrierRequired = true;
+					} else {
+						// Read after write hazards, skipping reads the previous write was already made visible to
+						bool8_t visible = !(accessInfo.stageMask & ~state.readStages) && !(accessInfo.accessMask & ~state.readAccess);
+						srcStageMask = state.writeStages;
+						barrierRequired = state.writeStages && !visible;
+					}
+
+					if(layoutChange && state.external)
+						srcStageMask |= VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+					// Add the barrier
+					if(barrierRequired) {
+						if(resource.isImage) {
+							VkImageMemoryBarrier2 barrier {
+								.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+								.pNext = nullptr,
+								.srcStageMask = srcStageMask,
+								.srcAccessMask = srcAccessMask,
+								.dstStageMask = accessInfo.stageMask,
+								.dstAccessMask = accessInfo.accessMask,
+								.oldLayout = state.layout,
+								.newLayout = layout,
+								.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+								.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+								.image = VK_NULL_HANDLE,
+								.subresourceRange = { resource.aspectMask, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS }
+							};
+
+							imageBarriers.push_back(barrier);
+							imageBarrierResources.push_back(access.resource);
+						} else {
+							VkBufferMemoryBarrier2 barrier {
+								.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+								.pNext = nullptr,
+								.srcStageMask = srcStageMask,
+								.srcAccessMask = srcAccessMask,
+								.dstStageMask = accessInfo.stageMask,
+								.dstAccessMask = accessInfo.accessMask,
+								.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+								.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+								.buffer = VK_NULL_HANDLE,
+								.offset = 0,
+								.size = VK_WHOLE_SIZE
+							};
+
+							bufferBarriers.push_back(barrier);
+							bufferBarrierResources.push_back(access.resource);
+						}
+					}
+
+					// Update the resource's state
+					if(accessInfo.write) {
+						state.writeStages = accessInfo.stageMask;
+						state.writeAccess = accessInfo.accessMask;
+						state.readStages = 0;
+						state.readAccess = 0;
+					} else if(layoutChange) {
+						// The previous write was made available, so later reads only need to wait for the transition
+						state.writeStages = accessInfo.stageMask;
+						state.writeAccess = 0;
+						state.readStages = accessInfo.stageMask;
+						state.readAccess = accessInfo.accessMask;
+					} else if(barrierRequired) {
+						state.readStages |= accessInfo.stageMask;
+						state.readAccess |= accessInfo.accessMask;
+					}
+
+					state.layout = layout;
+					state.external = false;
+				}
+			}
+
+			pass.imageBarrierCount = imageBarriers.size() - pass.firstImageBarrier;
+			pass.bufferBarrierCount = bufferBarriers.size() - pass.firstBufferBarrier;
+
+			stats.barrierBatchCount += pass.imageBarrierCount || pass.bufferBarrierCount;
+			stats.barrierCount += (uint32_t)(pass.imageBarrierCount + pass.bufferBarrierCount);
+		}
+
+		// Transition every imported image to its final layout
+		size_t firstFinalBarrier = imageBarriers.size();
+		for(size_t i = 0; i != resources.size(); ++i) {
+			const Resource& resource = resources[i];
+			if(!resource.imported || !resource.isImage || resource.finalLayout == VK_IMAGE_LAYOUT_UNDEFINED || resource.finalLayout == states[i].layout)
+				continue;
+
+			VkImageMemoryBarrier2 barrier {
+				.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+				.pNext = nullptr,
+				.srcStageMask = states[i].writeStages | states[i].readStages,
+				.srcAccessMask = states[i].writeAccess,
+				.dstStageMask = VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT,
+				.dstAccessMask = 0,
+				.oldLayout = states[i].layout,
+				.newLayout = resource.finalLayout,
+				.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+				.image = VK_NULL_HANDLE,
+				.subresourceRange = { resource.aspectMask, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS }
+			};
+
+			imageBarriers.push_back(barrier);
+			imageBarrierResources.push_back((ResourceHandle)i);
+		}
+
+		finalImageBarrierCount = imageBarriers.size() - firstFinalBarrier;
+		stats.barrierBatchCount += finalImageBarrierCount != 0;
+		stats.barrierCount += (uint32_t)finalImageBarrierCount;
+
+		// Free the resource states array
+		FreeMemory(states);
+	}
+	void VulkanRenderGraph::RecordBarriers(VkCommandBuffer commandBuffer, size_t firstImageBarrier, size_t imageBarrierCount, size_t firstBufferBarrier, size_t bufferBarrierCount) {
+		// Exit the function if there are no barriers to record
+		if(!imageBarrierCount && !bufferBarrierCount)
+			return;
+
+		// Set the barriers' current resource handles, as imported resources may change between executions
+		for(size_t i = firstImageBarrier; i != firstImageBarrier + imageBarrierCount; ++i)
+			imageBarriers[i].image = resources[imageBarrierResources[i]].image;
+		for(size_t i = firstBufferBarrier; i != firstBufferBarrier + bufferBarrierCount; ++i)
+			bufferBarriers[i].buffer = resources[bufferBarrierResources[i]].buffer;
+
+		// Record all barriers in a single command
+		VkDependencyInfo dependencyInfo {
+			.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+			.pNext = nullptr,
+			.dependencyFlags = 0,
+			.memoryBarrierCount = 0,
+			.pMemoryBarriers = nullptr,
+			.bufferMemoryBarrierCount = (uint32_t)bufferBarrierCount,
+			.pBufferMemoryBarriers = bufferBarriers.data() + firstBufferBarrier,
+			.imageMemoryBarrierCount = (uint32_t)imageBarrierCount,
+			.pImageMemoryBarriers = imageBarriers.data() + firstImageBarrier
+		};
+
+		if(device->GetCapabilities().apiVersion >= VK_API_VERSION_1_3) {
+			device->GetLoader()->vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+		} else {
+			device->GetLoader()->vkCmdPipelineBarrier2KHR(commandBuffer, &dependencyInfo);
+		}
+	}
+
+	// Public functions
+	VulkanRenderGraph::VulkanRenderGraph(VulkanDevice* device, VulkanAllocator* allocator) : device(device), allocator(allocator), finalImageBarrierCount(0), stats() {
+		// Check if synchronization2 is enabled, as it is required for the generated barriers
+		if(!device->GetCapabilities().synchronization2)
+			throw Exception("Vulkan render graphs require synchronization2 to be enabled on the device!");
+	}
+
+	VulkanRenderGraph::ResourceHandle VulkanRenderGraph::CreateImage(const char_t* name, const ImageDesc& imageDesc) {
+		Resource resource {};
+		resource.name = name;
+		resource.isImage = true;
+		resource.imageDesc = imageDesc;
+		resource.aspectMask = GetFormatAspectFlags(imageDesc.format);
+
+		return AddResource(resource);
+	}
+	VulkanRenderGraph::ResourceHandle VulkanRenderGraph::CreateBuffer(const char_t* name, const BufferDesc& bufferDesc) {
+		Resource resource {};
+		resource.name = name;
+		resource.bufferDesc = bufferDesc;
+
+		return AddResource(resource);
+	}
+	VulkanRenderGraph::ResourceHandle VulkanRenderGraph::ImportImage(const char_t* name, VkImageAspectFlags aspectMask, VkImageLayout initialLayout, VkImageLayout finalLayout) {
+		Resource resource {};
+		resource.name = name;
+		resource.isImage = true;
+		resource.imported = true;
+		resource.aspectMask = aspectMask;
+		resource.initialLayout = initialLayout;
+		resource.finalLayout = finalLayout;
+
+		return AddResource(resource);
+	}
+	VulkanRenderGraph::ResourceHandle VulkanRenderGraph::ImportBuffer(const char_t* name) {
+		Resource resource {};
+		resource.name = name;
+		resource.imported = true;
+
+		return AddResource(resource);
+	}
+	void VulkanRenderGraph::SetImportedImage(ResourceHandle resource, VkImage image, VkImageView imageView) {
+		resources[resource].image = image;
+		resources[resource].imageView = imageView;
+	}
+	void VulkanRenderGraph::SetImportedBuffer(ResourceHandle resource, VkBuffer buffer) {
+		resources[resource].buffer = buffer;
+	}
+	void VulkanRenderGraph::MarkOutput(ResourceHandle resource) {
+		resources[resource].output = true;
+	}
+
+	uint32_t VulkanRenderGraph::AddPass(const char_t* name, ExecuteCallback callback, void* userData) {
+		// Add the pass and return its index
+		passes.push_back({});
+
+		Pass& pass = passes.back();
+		pass.name = name;
+		pass.callback = callback;
+		pass.userData = userData;
+
+		return (uint32_t)passes.size() - 1;
+	}
+	void VulkanRenderGraph::AddPassRead(uint32_t pass, ResourceHandle resource, AccessType accessType) {
+		// Check if the access type is a read
+		if(ACCESS_INFOS[accessType].write)
+			throw Exception("Vulkan render graph pass \"%s\" declared a write access as a read of \"%s\"!", passes[pass].name, resources[resource].name);
+
+		// Check if the pass already accesses the resource, as a pass may only access a resource once
+		for(const auto& access : passes[pass].accesses)
+			if(access.resource == resource)
+				throw Exception("Vulkan render graph pass \"%s\" accesses \"%s\" more than once!", passes[pass].name, resources[resource].name);
+
+		passes[pass].accesses.push_back({ resource, accessType, false });
+	}
+	void VulkanRenderGraph::AddPassWrite(uint32_t pass, ResourceHandle resource, AccessType accessType) {
+		// Check if the access type is a write
+		if(!ACCESS_INFOS[accessType].write)
+			throw Exception("Vulkan render graph pass \"%s\" declared a read access as a write of \"%s\"!", passes[pass].name, resources[resource].name);
+
+		// Check if the pass already accesses the resource, as a pass may only access a resource once
+		for(const auto& access : passes[pass].accesses)
+			if(access.resource == resource)
+				throw Exception("Vulkan render graph pass \"%s\" accesses \"%s\" more than once!", passes[pass].name, resources[resource].name);
+
+		passes[pass].accesses.push_back({ resource, accessType, true });
+	}
+
+	void VulkanRenderGraph::Compile() {
+		// Destroy the previously compiled transient resources and reset the stats
+		DestroyTransientResources();
+		stats = {};
+
+		// Cull the unused passes, then create the transient resources and generate the barriers for the remaining ones
+		CullPasses();
+		ComputeLifetimes();
+		CreateTransientResources();
+		GenerateBarriers();
+	}
+	void VulkanRenderGraph::Execute(VkCommandBuffer commandBuffer) {
+		// Record every pass that wasn't culled, preceded by its batched barriers
+		for(auto& pass : passes) {
+			if(pass.culled)
+				continue;
+
+			RecordBarriers(commandBuffer, pass.firstImageBarrier, pass.imageBarrierCount, pass.firstBufferBarrier, pass.bufferBarrierCount);
+			pass.callback(commandBuffer, this, pass.userData);
+		}
+
+		// Record the imported images' final transitions
+		RecordBarriers(commandBuffer, imageBarriers.size() - finalImageBarrierCount, finalImageBarrierCount, 0, 0);
+	}
+	void VulkanRenderGraph::Reset() {
+		// Destroy the transient resources and remove every pass and resource
+		DestroyTransientResources();
+
+		passes.clear();
+		resources.clear();
+		imageBarriers.clear();
+		imageBarrierResources.clear();
+		bufferBarriers.clear();
+		bufferBarrierResources.clear();
+		finalImageBarrierCount = 0;
+	}
+
+	VulkanRenderGraph::~VulkanRenderGraph() {
+		// Destroy the transient resources
+		DestroyTransientResources();
+	}
+}
\ No newline at end of file
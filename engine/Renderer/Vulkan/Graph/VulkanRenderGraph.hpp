@@ -0,0 +1,260 @@
+#pragma once
+
+#include "Renderer/Vulkan/Instance/VulkanAllocator.hpp"
+#include "Renderer/Vulkan/Instance/VulkanDevice.hpp"
+
+#include <Core.hpp>
+#include <vulkan/vk_platform.h>
+#include <vulkan/vulkan_core.h>
+
+namespace wfe {
+	/// @brief A frame graph whose passes declare the resources they read and write, used to cull unused passes, generate batched barriers and alias transient resources.
+	class VulkanRenderGraph {
+	public:
+		/// @brief A handle to a resource in the graph.
+		typedef uint32_t ResourceHandle;
+		/// @brief A function that records a pass's commands.
+		/// @param commandBuffer The command buffer to record the commands in.
+		/// @param graph The graph the pass belongs to, used to get the handles of the pass's resources.
+		/// @param userData The user data given when the pass was added.
+		typedef void(*ExecuteCallback)(VkCommandBuffer commandBuffer, VulkanRenderGraph* graph, void* userData);
+
+		/// @brief An invalid resource handle.
+		static const ResourceHandle INVALID_RESOURCE = UINT32_T_MAX;
+
+		/// @brief The ways in which a pass can access a resource.
+		enum AccessType : uint32_t {
+			/// @brief The image is written as a color attachment.
+			ACCESS_TYPE_COLOR_ATTACHMENT_WRITE,
+			/// @brief The image is written as a depth/stencil attachment.
+			ACCESS_TYPE_DEPTH_ATTACHMENT_WRITE,
+			/// @brief The image is read as a read-only depth/stencil attachment.
+			ACCESS_TYPE_DEPTH_ATTACHMENT_READ,
+			/// @brief The image is sampled in vertex, fragment or compute shaders.
+			ACCESS_TYPE_SHADER_SAMPLED_READ,
+			/// @brief The image or buffer is read as a storage resource in vertex, fragment or compute shaders.
+			ACCESS_TYPE_SHADER_STORAGE_READ,
+			/// @brief The image or buffer is written as a storage resource in vertex, fragment or compute shaders.
+			ACCESS_TYPE_SHADER_STORAGE_WRITE,
+			/// @brief The buffer is read as indirect draw or dispatch arguments.
+			ACCESS_TYPE_INDIRECT_READ,
+			/// @brief The image or buffer is the source of a transfer command.
+			ACCESS_TYPE_TRANSFER_READ,
+			/// @brief The image or buffer is the destination of a transfer command.
+			ACCESS_TYPE_TRANSFER_WRITE,
+			/// @brief The number of access types.
+			ACCESS_TYPE_COUNT
+		};
+
+		/// @brief A struct describing a transient image owned by the graph.
+		struct ImageDesc {
+			/// @brief The image's format.
+			VkFormat format;
+			/// @brief The image's width.
+			uint32_t width;
+			/// @brief The image's height.
+			uint32_t height;
+			/// @brief The image's sample count.
+			VkSampleCountFlagBits samples;
+			/// @brief Additional usage flags, besides the ones deduced from the image's accesses.
+			VkImageUsageFlags usage;
+		};
+		/// @brief A struct describing a transient buffer owned by the graph.
+		struct BufferDesc {
+			/// @brief The buffer's size, in bytes.
+			VkDeviceSize size;
+			/// @brief Additional usage flags, besides the ones deduced from the buffer's accesses.
+			VkBufferUsageFlags usage;
+		};
+		/// @brief A struct containing the statistics of the last compiled graph.
+		struct Stats {
+			/// @brief The number of passes removed because none of their outputs were used.
+			uint32_t culledPassCount;
+			/// @brief The number of pipeline barrier commands recorded per execution.
+			uint32_t barrierBatchCount;
+			/// @brief The total number of image and buffer barriers recorded per execution.
+			uint32_t barrierCount;
+			/// @brief The device memory used by all transient resources, with aliasing.
+			VkDeviceSize transientMemorySize;
+			/// @brief The device memory the transient resources would use without aliasing.
+			VkDeviceSize unaliasedMemorySize;
+		};
+
+		/// @brief Creates a Vulkan render graph.
+		/// @param device The Vulkan device to create the graph's resources for. It must have synchronization2 enabled.
+		/// @param allocator The allocator used to allocate the transient resources' memory.
+		VulkanRenderGraph(VulkanDevice* device, VulkanAllocator* allocator);
+		VulkanRenderGraph(const VulkanRenderGraph&) = delete;
+		VulkanRenderGraph(VulkanRenderGraph&&) noexcept = delete;
+
+		VulkanRenderGraph& operator=(const VulkanRenderGraph&) = delete;
+		VulkanRenderGraph& operator=(VulkanRenderGraph&&) = delete;
+
+		/// @brief Gets the Vulkan function loader used by the graph.
+		/// @return A pointer to the Vulkan loader used by the graph.
+		const VulkanLoader* GetLoader() const {
+			return device->GetLoader();
+		}
+		/// @brief Gets the Vulkan device that owns the graph.
+		/// @return A pointer to the Vulkan device wrapper object.
+		VulkanDevice* GetDevice() {
+			return device;
+		}
+		/// @brief Gets the Vulkan device that owns the graph.
+		/// @return A const pointer to the Vulkan device wrapper object.
+		const VulkanDevice* GetDevice() const {
+			return device;
+		}
+		/// @brief Gets the statistics of the last compiled graph.
+		/// @return A struct containing the graph's statistics.
+		const Stats& GetStats() const {
+			return stats;
+		}
+
+		/// @brief Declares a transient image, owned by the graph and aliased with other transient images whose lifetimes don't overlap.
+		/// @param name The image's name.
+		/// @param imageDesc The image's description.
+		/// @return The image's handle.
+		ResourceHandle CreateImage(const char_t* name, const ImageDesc& imageDesc);
+		/// @brief Declares a transient buffer, owned by the graph and aliased with other transient buffers whose lifetimes don't overlap.
+		/// @param name The buffer's name.
+		/// @param bufferDesc The buffer's description.
+		/// @return The buffer's handle.
+		ResourceHandle CreateBuffer(const char_t* name, const BufferDesc& bufferDesc);
+		/// @brief Imports an external image into the graph.
+		/// @param name The image's name.
+		/// @param aspectMask The image's aspect flags.
+		/// @param initialLayout The layout the image is in before the graph is executed.
+		/// @param finalLayout The layout the image will be transitioned to after the graph is executed.
+		/// @return The image's handle.
+		ResourceHandle ImportImage(const char_t* name, VkImageAspectFlags aspectMask, VkImageLayout initialLayout, VkImageLayout finalLayout);
+		/// @brief Imports an external buffer into the graph.
+		/// @param name The buffer's name.
+		/// @return The buffer's handle.
+		ResourceHandle ImportBuffer(const char_t* name);
+		/// @brief Sets the handles of an imported image, which may change every execution, like swap chain images.
+		/// @param resource The imported image's handle.
+		/// @param image The Vulkan image.
+		/// @param imageView The Vulkan image view.
+		void SetImportedImage(ResourceHandle resource, VkImage image, VkImageView imageView);
+		/// @brief Sets the handle of an imported buffer.
+		/// @param resource The imported buffer's handle.
+		/// @param buffer The Vulkan buffer.
+		void SetImportedBuffer(ResourceHandle resource, VkBuffer buffer);
+		/// @brief Marks the given resource as an output of the graph, keeping every pass that contributes to it.
+		/// @param resource The resource to mark.
+		void MarkOutput(ResourceHandle resource);
+
+		/// @brief Adds a pass to the graph. Passes are executed in the order they were added.
+		/// @param name The pass's name.
+		/// @param callback The function that records the pass's commands.
+		/// @param userData The user data to pass to the callback.
+		/// @return The pass's index.
+		uint32_t AddPass(const char_t* name, ExecuteCallback callback, void* userData);
+		/// @brief Declares that the given pass reads the given resource.
+		/// @param pass The pass's index.
+		/// @param resource The read resource.
+		/// @param accessType The way in which the pass reads the resource.
+		void AddPassRead(uint32_t pass, ResourceHandle resource, AccessType accessType);
+		/// @brief Declares that the given pass writes the given resource.
+		/// @param pass The pass's index.
+		/// @param resource The written resource.
+		/// @param accessType The way in which the pass writes the resource.
+		void AddPassWrite(uint32_t pass, ResourceHandle resource, AccessType accessType);
+
+		/// @brief Compiles the graph, culling unused passes, creating and aliasing the transient resources and generating the barriers. Must be called again after the graph's passes or transient resources change.
+		void Compile();
+		/// @brief Records every pass of the compiled graph and its barriers in the given command buffer.
+		/// @param commandBuffer The command buffer to record in.
+		void Execute(VkCommandBuffer commandBuffer);
+		/// @brief Removes every pass and resource from the graph, destroying all transient resources.
+		void Reset();
+
+		/// @brief Gets the given image resource's Vulkan image.
+		/// @param resource The image's handle.
+		/// @return A handle to the Vulkan image.
+		VkImage GetImage(ResourceHandle resource) {
+			return resources[resource].image;
+		}
+		/// @brief Gets the given image resource's Vulkan image view.
+		/// @param resource The image's handle.
+		/// @return A handle to the Vulkan image view.
+		VkImageView GetImageView(ResourceHandle resource) {
+			return resources[resource].imageView;
+		}
+		/// @brief Gets the given buffer resource's Vulkan buffer.
+		/// @param resource The buffer's handle.
+		/// @return A handle to the Vulkan buffer.
+		VkBuffer GetBuffer(ResourceHandle resource) {
+			return resources[resource].buffer;
+		}
+
+		/// @brief Destroys the Vulkan render graph and all of its transient resources.
+		~VulkanRenderGraph();
+	private:
+		struct Resource {
+			const char_t* name;
+			bool8_t isImage;
+			bool8_t imported;
+			bool8_t output;
+			ImageDesc imageDesc;
+			BufferDesc bufferDesc;
+			VkImageAspectFlags aspectMask;
+			VkImageLayout initialLayout;
+			VkImageLayout finalLayout;
+
+			VkImage image;
+			VkImageView imageView;
+			VkBuffer buffer;
+
+			uint32_t firstPass;
+			uint32_t lastPass;
+			uint32_t aliasSlot;
+		};
+		struct PassAccess {
+			ResourceHandle resource;
+			AccessType accessType;
+			bool8_t write;
+		};
+		struct Pass {
+			const char_t* name;
+			ExecuteCallback callback;
+			void* userData;
+			vector<PassAccess> accesses;
+
+			bool8_t culled;
+			size_t firstImageBarrier;
+			size_t imageBarrierCount;
+			size_t firstBufferBarrier;
+			size_t bufferBarrierCount;
+		};
+		struct AliasSlot {
+			VkMemoryRequirements memRequirements;
+			bool8_t isImage;
+			VulkanAllocator::MemoryBlock memoryBlock;
+		};
+
+		ResourceHandle AddResource(const Resource& resource);
+		void CullPasses();
+		void ComputeLifetimes();
+		void CreateTransientResources();
+		void DestroyTransientResources();
+		void GenerateBarriers();
+		void RecordBarriers(VkCommandBuffer commandBuffer, size_t firstImageBarrier, size_t imageBarrierCount, size_t firstBufferBarrier, size_t bufferBarrierCount);
+
+		VulkanDevice* device;
+		VulkanAllocator* allocator;
+
+		vector<Resource> resources;
+		vector<Pass> passes;
+		vector<AliasSlot> aliasSlots;
+
+		vector<VkImageMemoryBarrier2> imageBarriers;
+		vector<ResourceHandle> imageBarrierResources;
+		vector<VkBufferMemoryBarrier2> bufferBarriers;
+		vector<ResourceHandle> bufferBarrierResources;
+		size_t finalImageBarrierCount;
+
+		Stats stats;
+	};
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "VulkanAllocator.hpp"
+#include "General/LinearArena.hpp"
 #include "Renderer/Vulkan/VulkanRenderer.hpp"
 
 namespace wfe {
@@ -233,8 +234,9 @@ namespace wfe {
 				continue;
 			}
 			
-			// Remove the current memory block from the memory type unordered map
+			// Remove the current memory block from the memory type and mapped memory unordered maps
 			memoryTypeIndices.erase(freeBlocks[freeBlockIndex].block.memory);
+			mappedMemories.erase(freeBlocks[freeBlockIndex].block.memory);
 
 			// Free the current block's memory
 			device->GetLoader()->vkFreeMemory(device->GetDevice(), freeBlocks[freeBlockIndex].block.memory, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
@@ -485,6 +487,18 @@ namespace wfe {
 		// Allocate the memory using the allocator's internal function
 		return InternalAllocMemory(memRequirements, imageFreeLists[memoryTypeIndex], imageMemoryTypeIndices, memoryTypeIndex, memoryBlock);
 	}
+	VkResult VulkanAllocator::AllocAliasedMemory(const VkMemoryRequirements& memRequirements, MemoryType memoryType, bool8_t image, MemoryBlock& memoryBlock) {
+		// Get the memory type index valid for every aliasing resource
+		uint32_t memoryTypeIndex = GetMemoryTypeIndex(memoryType, memRequirements.memoryTypeBits);
+		if(memoryTypeIndex == UINT32_T_MAX)
+			return VK_ERROR_FEATURE_NOT_PRESENT;
+
+		// Allocate the memory from the free list of the resources' kind, keeping buffers and images apart to respect the buffer image granularity
+		if(image)
+			return InternalAllocMemory(memRequirements, imageFreeLists[memoryTypeIndex], imageMemoryTypeIndices, memoryTypeIndex, memoryBlock);
+
+		return InternalAllocMemory(memRequirements, bufferFreeLists[memoryTypeIndex], bufferMemoryTypeIndices, memoryTypeIndex, memoryBlock);
+	}
 	void VulkanAllocator::FreeMemory(const MemoryBlock& memoryBlock) {
 		// Get the memory block's memory type index
 		FreeList* freeList;
@@ -500,6 +514,7 @@ namespace wfe {
 				freeList = imageFreeLists.data() + memoryTypeIndexIter->second;
 			} else {
 				// The memory must have been allocated separately; free it separately and exit the function
+				mappedMemories.erase(memoryBlock.memory);
 				device->GetLoader()->vkFreeMemory(device->GetDevice(), memoryBlock.memory, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
 
 				return;
@@ -609,13 +624,33 @@ namespace wfe {
 		}
 	}
 
+	VkResult VulkanAllocator::MapMemory(const MemoryBlock& memoryBlock, void*& data) {
+		// Check if the block's device memory was already mapped
+		auto mappedMemoryIter = mappedMemories.find(memoryBlock.memory);
+		if(mappedMemoryIter != mappedMemories.end()) {
+			data = (char_t*)mappedMemoryIter->second + memoryBlock.offset;
+			return VK_SUCCESS;
+		}
+
+		// Map the entire device memory, as Vulkan doesn't allow mapping the same memory more than once
+		void* mappedMemory;
+		VkResult result = device->GetLoader()->vkMapMemory(device->GetDevice(), memoryBlock.memory, 0, VK_WHOLE_SIZE, 0, &mappedMemory);
+		if(result != VK_SUCCESS)
+			return result;
+
+		// Add the mapped memory to the map; freeing the memory unmaps it implicitly
+		mappedMemories.insert({ memoryBlock.memory, mappedMemory });
+		data = (char_t*)mappedMemory + memoryBlock.offset;
+
+		return VK_SUCCESS;
+	}
+
 	VkResult VulkanAllocator::BindBufferMemories(size_t bufferCount, VkBuffer* buffers, const MemoryBlock* memoryBlocks) const {
 		// Check if bind2 is supported
 		if(bind2Supported) {
-			// Allocate the buffer memory bind infos array
-			PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
-			VkBindBufferMemoryInfoKHR* bindInfos = (VkBindBufferMemoryInfoKHR*)wfe::AllocMemory(bufferCount * sizeof(VkBindBufferMemoryInfoKHR));
-			PopMemoryUsageType();
+			// Allocate the buffer memory bind infos array in scratch memory
+			ScratchScope scratch;
+			VkBindBufferMemoryInfoKHR* bindInfos = (VkBindBufferMemoryInfoKHR*)scratch.Allocate(bufferCount * sizeof(VkBindBufferMemoryInfoKHR), alignof(VkBindBufferMemoryInfoKHR));
 			if(!bindInfos)
 				return VK_ERROR_OUT_OF_HOST_MEMORY;
 			
@@ -629,12 +664,7 @@ namespace wfe {
 			}
 
 			// Bind the buffer memories
-			VkResult result = device->GetLoader()->vkBindBufferMemory2KHR(device->GetDevice(), (uint32_t)bufferCount, bindInfos);
-
-			// Free the buffer memory bind infos array
-			wfe::FreeMemory(bindInfos);
-
-			return result;
+			return device->GetLoader()->vkBindBufferMemory2KHR(device->GetDevice(), (uint32_t)bufferCount, bindInfos);
 		} else {
 			// Loop through every buffer and bind its corresponding memory block
 			for(size_t i = 0; i != bufferCount; ++i) {
@@ -650,10 +680,9 @@ namespace wfe {
 	VkResult VulkanAllocator::BindImageMemories(size_t imageCount, VkImage* images, const MemoryBlock* memoryBlocks) const {
 		// Check if bind2 is supported
 		if(bind2Supported) {
-			// Allocate the image memory bind infos array
-			PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
-			VkBindImageMemoryInfoKHR* bindInfos = (VkBindImageMemoryInfoKHR*)wfe::AllocMemory(imageCount * sizeof(VkBindImageMemoryInfoKHR));
-			PopMemoryUsageType();
+			// Allocate the image memory bind infos array in scratch memory
+			ScratchScope scratch;
+			VkBindImageMemoryInfoKHR* bindInfos = (VkBindImageMemoryInfoKHR*)scratch.Allocate(imageCount * sizeof(VkBindImageMemoryInfoKHR), alignof(VkBindImageMemoryInfoKHR));
 			if(!bindInfos)
 				return VK_ERROR_OUT_OF_HOST_MEMORY;
 			
@@ -667,12 +696,7 @@ namespace wfe {
 			}
 
 			// Bind the image memories
-			VkResult result = device->GetLoader()->vkBindImageMemory2KHR(device->GetDevice(), (uint32_t)imageCount, bindInfos);
-
-			// Free the image memory bind infos array
-			wfe::FreeMemory(bindInfos);
-
-			return result;
+			return device->GetLoader()->vkBindImageMemory2KHR(device->GetDevice(), (uint32_t)imageCount, bindInfos);
 		} else {
 			// Loop through every image and bind its corresponding memory block
 			for(size_t i = 0; i != imageCount; ++i) {
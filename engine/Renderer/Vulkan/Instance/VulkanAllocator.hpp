@@ -79,9 +79,21 @@ namespace wfe {
 		/// @param memoryBlock A reference to the variable in which the final memory block's info will be written.
 		/// @return VK_SUCCESS if the operation was completed successfully, otherwise a corresponding error code.
 		VkResult AllocImageMemory(VkImage image, MemoryType memoryType, MemoryBlock& memoryBlock);
+		/// @brief Allocates a memory block satisfying the given requirements, to be shared by multiple aliased resources.
+		/// @param memRequirements The combined memory requirements of all resources that will alias the memory block.
+		/// @param memoryType The memory type required for the resources.
+		/// @param image True if the memory block will be bound to images, or false if it will be bound to buffers.
+		/// @param memoryBlock A reference to the variable in which the final memory block's info will be written.
+		/// @return VK_SUCCESS if the operation was completed successfully, otherwise a corresponding error code.
+		VkResult AllocAliasedMemory(const VkMemoryRequirements& memRequirements, MemoryType memoryType, bool8_t image, MemoryBlock& memoryBlock);
 		/// @brief Frees the given memory block.
 		/// @param memoryBlock The memory block to free.
 		void FreeMemory(const MemoryBlock& memoryBlock);
+		/// @brief Gets a host pointer to the given memory block, which must be CPU visible. The block's device memory stays persistently mapped until it is freed.
+		/// @param memoryBlock The memory block to map.
+		/// @param data A reference to the pointer in which the memory block's host address will be written.
+		/// @return VK_SUCCESS if the operation was completed successfully, otherwise a corresponding error code.
+		VkResult MapMemory(const MemoryBlock& memoryBlock, void*& data);
 
 		/// @brief Binds the given buffers with their corresponding memory blocks.
 		/// @param bufferCount The number of buffers to bind.
@@ -142,5 +154,6 @@ namespace wfe {
 
 		MemoryTypeIndicesMap bufferMemoryTypeIndices;
 		MemoryTypeIndicesMap imageMemoryTypeIndices;
+		unordered_map<VkDeviceMemory, void*, MemoryHash> mappedMemories;
 	};
 }
\ No newline at end of file
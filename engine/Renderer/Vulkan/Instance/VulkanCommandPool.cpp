@@ -16,7 +16,7 @@ namespace wfe {
 
 		// Create the command pools
 		for(size_t i = 0; i != Renderer::MAX_FRAMES_IN_FLIGHT; ++i) {
-			VkResult result = device->GetLoader()->vkCreateCommandPool(device->GetDevice(), &createInfo, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS, commandPools + 1);
+			VkResult result = device->GetLoader()->vkCreateCommandPool(device->GetDevice(), &createInfo, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS, commandPools + i);
 			if(result != VK_SUCCESS)
 				throw Exception("Failed to create Vulkan command pool! Error code: %s", string_VkResult(result));
 		}
@@ -1,4 +1,5 @@
 #include "VulkanDevice.hpp"
+#include "General/HeapMemory.hpp"
 #include "Renderer/Vulkan/VulkanRenderer.hpp"
 #include "Renderer/Renderer.hpp"
 
@@ -25,7 +26,13 @@ namespace wfe {
 		VK_KHR_GET_MEMORY_REQUIREMENTS_2_EXTENSION_NAME,
 		VK_KHR_DEDICATED_ALLOCATION_EXTENSION_NAME,
 		VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME,
-		VK_KHR_BIND_MEMORY_2_EXTENSION_NAME
+		VK_KHR_BIND_MEMORY_2_EXTENSION_NAME,
+		VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME,
+		VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME,
+		VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME,
+		VK_KHR_SHADER_FLOAT_CONTROLS_EXTENSION_NAME,
+		VK_KHR_SPIRV_1_4_EXTENSION_NAME,
+		VK_EXT_MESH_SHADER_EXTENSION_NAME
 	};
 
 	// Internal helper functions
@@ -157,6 +164,89 @@ namespace wfe {
 			--queueFamilies[index].queueCount;
 		}
 	}
+	static void SelectVulkan11Features(VkPhysicalDeviceVulkan11Features& features) {
+		// Keep only the performance-relevant supported features
+		VkPhysicalDeviceVulkan11Features selected {};
+		selected.sType = features.sType;
+		selected.pNext = features.pNext;
+		selected.storageBuffer16BitAccess = features.storageBuffer16BitAccess;
+		selected.uniformAndStorageBuffer16BitAccess = features.uniformAndStorageBuffer16BitAccess;
+		selected.shaderDrawParameters = features.shaderDrawParameters;
+
+		features = selected;
+	}
+	static void SelectVulkan12Features(VkPhysicalDeviceVulkan12Features& features) {
+		// Keep only the performance-relevant supported features
+		VkPhysicalDeviceVulkan12Features selected {};
+		selected.sType = features.sType;
+		selected.pNext = features.pNext;
+		selected.drawIndirectCount = features.drawIndirectCount;
+		selected.storageBuffer8BitAccess = features.storageBuffer8BitAccess;
+		selected.uniformAndStorageBuffer8BitAccess = features.uniformAndStorageBuffer8BitAccess;
+		selected.shaderSubgroupExtendedTypes = features.shaderSubgroupExtendedTypes;
+		selected.hostQueryReset = features.hostQueryReset;
+		selected.timelineSemaphore = features.timelineSemaphore;
+		selected.bufferDeviceAddress = features.bufferDeviceAddress;
+
+		// Keep the descriptor indexing features only if runtime descriptor arrays can be partially bound
+		if(features.runtimeDescriptorArray && features.descriptorBindingPartiallyBound) {
+			selected.descriptorIndexing = features.descriptorIndexing;
+			selected.shaderSampledImageArrayNonUniformIndexing = features.shaderSampledImageArrayNonUniformIndexing;
+			selected.shaderStorageBufferArrayNonUniformIndexing = features.shaderStorageBufferArrayNonUniformIndexing;
+			selected.descriptorBindingSampledImageUpdateAfterBind = features.descriptorBindingSampledImageUpdateAfterBind;
+			selected.descriptorBindingStorageBufferUpdateAfterBind = features.descriptorBindingStorageBufferUpdateAfterBind;
+			selected.descriptorBindingUpdateUnusedWhilePending = features.descriptorBindingUpdateUnusedWhilePending;
+			selected.descriptorBindingPartiallyBound = features.descriptorBindingPartiallyBound;
+			selected.descriptorBindingVariableDescriptorCount = features.descriptorBindingVariableDescriptorCount;
+			selected.runtimeDescriptorArray = features.runtimeDescriptorArray;
+		}
+
+		features = selected;
+	}
+	static void SelectVulkan13Features(VkPhysicalDeviceVulkan13Features& features) {
+		// Keep only the performance-relevant supported features
+		VkPhysicalDeviceVulkan13Features selected {};
+		selected.sType = features.sType;
+		selected.pNext = features.pNext;
+		selected.pipelineCreationCacheControl = features.pipelineCreationCacheControl;
+		selected.synchronization2 = features.synchronization2;
+		selected.dynamicRendering = features.dynamicRendering;
+		selected.maintenance4 = features.maintenance4;
+
+		features = selected;
+	}
+	static void SelectMeshShaderFeatures(VkPhysicalDeviceMeshShaderFeaturesEXT& features) {
+		// Keep only the task and mesh shader stages, as the other features require further extensions
+		VkPhysicalDeviceMeshShaderFeaturesEXT selected {};
+		selected.sType = features.sType;
+		selected.pNext = features.pNext;
+
+		if(features.taskShader && features.meshShader) {
+			selected.taskShader = VK_TRUE;
+			selected.meshShader = VK_TRUE;
+		}
+
+		features = selected;
+	}
+	static void SelectDescriptorIndexingFeatures(VkPhysicalDeviceDescriptorIndexingFeatures& features) {
+		// Keep the descriptor indexing features only if runtime descriptor arrays can be partially bound
+		VkPhysicalDeviceDescriptorIndexingFeatures selected {};
+		selected.sType = features.sType;
+		selected.pNext = features.pNext;
+
+		if(features.runtimeDescriptorArray && features.descriptorBindingPartiallyBound) {
+			selected.shaderSampledImageArrayNonUniformIndexing = features.shaderSampledImageArrayNonUniformIndexing;
+			selected.shaderStorageBufferArrayNonUniformIndexing = features.shaderStorageBufferArrayNonUniformIndexing;
+			selected.descriptorBindingSampledImageUpdateAfterBind = features.descriptorBindingSampledImageUpdateAfterBind;
+			selected.descriptorBindingStorageBufferUpdateAfterBind = features.descriptorBindingStorageBufferUpdateAfterBind;
+			selected.descriptorBindingUpdateUnusedWhilePending = features.descriptorBindingUpdateUnusedWhilePending;
+			selected.descriptorBindingPartiallyBound = features.descriptorBindingPartiallyBound;
+			selected.descriptorBindingVariableDescriptorCount = features.descriptorBindingVariableDescriptorCount;
+			selected.runtimeDescriptorArray = features.runtimeDescriptorArray;
+		}
+
+		features = selected;
+	}
 
 	void VulkanDevice::GetPhysicalDeviceInfo(const set<const char_t*>& requiredExtensions, const set<const char_t*>& optionalExtensions) {
 		// Get the physical device's properties and features
@@ -169,7 +259,7 @@ namespace wfe {
 
 		// Allocate all required arrays
 		PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
-		VkExtensionProperties* supportedExtensions = (VkExtensionProperties*)AllocMemory(supportedCount * sizeof(VkExtensionProperties) + optionalExtensions.size() * sizeof(bool8_t));
+		VkExtensionProperties* supportedExtensions = (VkExtensionProperties*)AllocHeapMemory(supportedCount * sizeof(VkExtensionProperties) + optionalExtensions.size() * sizeof(bool8_t));
 		PopMemoryUsageType();
 		if(!supportedExtensions)
 			throw BadAllocException("Failed to allocate Vulkan supported device extensions array!");
@@ -193,6 +283,123 @@ namespace wfe {
 
 		// Free the allocated arrays
 		FreeMemory(supportedExtensions);
+
+		// Get the physical device's extended features
+		GetExtendedFeatures();
+	}
+	void VulkanDevice::GetExtendedFeatures() {
+		// Reset every extended feature struct and the capabilities
+		memset(&vulkan11Features, 0, sizeof(VkPhysicalDeviceVulkan11Features));
+		vulkan11Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
+		memset(&vulkan12Features, 0, sizeof(VkPhysicalDeviceVulkan12Features));
+		vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+		memset(&vulkan13Features, 0, sizeof(VkPhysicalDeviceVulkan13Features));
+		vulkan13Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+		memset(&descriptorIndexingFeatures, 0, sizeof(VkPhysicalDeviceDescriptorIndexingFeatures));
+		descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+		memset(&synchronization2Features, 0, sizeof(VkPhysicalDeviceSynchronization2Features));
+		synchronization2Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES;
+		memset(&dynamicRenderingFeatures, 0, sizeof(VkPhysicalDeviceDynamicRenderingFeatures));
+		dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES;
+		memset(&meshShaderFeatures, 0, sizeof(VkPhysicalDeviceMeshShaderFeaturesEXT));
+		meshShaderFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT;
+
+		memset(&capabilities, 0, sizeof(Capabilities));
+		capabilities.apiVersion = properties.apiVersion;
+
+		// Chain the core feature structs of the device's version, falling back to the extension structs for features that weren't promoted yet
+		bool8_t vulkan12 = properties.apiVersion >= VK_API_VERSION_1_2;
+		bool8_t vulkan13 = properties.apiVersion >= VK_API_VERSION_1_3;
+		bool8_t descriptorIndexingExtension = !vulkan12 && extensions.find(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) != extensions.end();
+		bool8_t synchronization2Extension = !vulkan13 && extensions.find(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME) != extensions.end();
+		bool8_t dynamicRenderingExtension = !vulkan13 && extensions.find(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME) != extensions.end();
+		bool8_t meshShaderExtension = extensions.find(VK_EXT_MESH_SHADER_EXTENSION_NAME) != extensions.end() && (vulkan12 || extensions.find(VK_KHR_SPIRV_1_4_EXTENSION_NAME) != extensions.end());
+
+		featureChain = nullptr;
+		if(vulkan12) {
+			vulkan11Features.pNext = featureChain;
+			featureChain = &vulkan11Features;
+			vulkan12Features.pNext = featureChain;
+			featureChain = &vulkan12Features;
+		}
+		if(vulkan13) {
+			vulkan13Features.pNext = featureChain;
+			featureChain = &vulkan13Features;
+		}
+		if(descriptorIndexingExtension) {
+			descriptorIndexingFeatures.pNext = featureChain;
+			featureChain = &descriptorIndexingFeatures;
+		}
+		if(synchronization2Extension) {
+			synchronization2Features.pNext = featureChain;
+			featureChain = &synchronization2Features;
+		}
+		if(dynamicRenderingExtension) {
+			dynamicRenderingFeatures.pNext = featureChain;
+			featureChain = &dynamicRenderingFeatures;
+		}
+		if(meshShaderExtension) {
+			meshShaderFeatures.pNext = featureChain;
+			featureChain = &meshShaderFeatures;
+		}
+
+		// Query the chained features
+		if(featureChain) {
+			VkPhysicalDeviceFeatures2 features2 {
+				.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+				.pNext = featureChain
+			};
+
+			loader->vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+		}
+
+		// Keep only the performance-relevant supported features, which will be enabled on the device
+		if(vulkan12) {
+			SelectVulkan11Features(vulkan11Features);
+			SelectVulkan12Features(vulkan12Features);
+		}
+		if(vulkan13)
+			SelectVulkan13Features(vulkan13Features);
+		if(descriptorIndexingExtension)
+			SelectDescriptorIndexingFeatures(descriptorIndexingFeatures);
+		if(meshShaderExtension)
+			SelectMeshShaderFeatures(meshShaderFeatures);
+
+		// Set the capabilities based on the enabled features
+		capabilities.timelineSemaphores = vulkan12Features.timelineSemaphore;
+		capabilities.bufferDeviceAddress = vulkan12Features.bufferDeviceAddress;
+		capabilities.dynamicRendering = vulkan13Features.dynamicRendering || dynamicRenderingFeatures.dynamicRendering;
+		capabilities.synchronization2 = vulkan13Features.synchronization2 || synchronization2Features.synchronization2;
+		capabilities.drawIndirectCount = vulkan12Features.drawIndirectCount || (!vulkan12 && extensions.find(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME) != extensions.end());
+		capabilities.storage8Bit = vulkan12Features.storageBuffer8BitAccess;
+		capabilities.storage16Bit = vulkan11Features.storageBuffer16BitAccess;
+		capabilities.meshShader = meshShaderFeatures.meshShader;
+
+		if(vulkan12) {
+			capabilities.descriptorIndexing = vulkan12Features.runtimeDescriptorArray;
+			capabilities.descriptorUpdateAfterBind = vulkan12Features.descriptorBindingSampledImageUpdateAfterBind && vulkan12Features.descriptorBindingStorageBufferUpdateAfterBind;
+		} else {
+			capabilities.descriptorIndexing = descriptorIndexingFeatures.runtimeDescriptorArray;
+			capabilities.descriptorUpdateAfterBind = descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind && descriptorIndexingFeatures.descriptorBindingStorageBufferUpdateAfterBind;
+		}
+
+		// Get the device's subgroup properties, which are core since Vulkan 1.1
+		if(properties.apiVersion >= VK_API_VERSION_1_1) {
+			VkPhysicalDeviceSubgroupProperties subgroupProperties {
+				.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES,
+				.pNext = nullptr
+			};
+			VkPhysicalDeviceProperties2 properties2 {
+				.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+				.pNext = &subgroupProperties
+			};
+
+			loader->vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+
+			capabilities.subgroupSize = subgroupProperties.subgroupSize;
+			capabilities.subgroupSupportedStages = subgroupProperties.supportedStages;
+			capabilities.subgroupSupportedOperations = subgroupProperties.supportedOperations;
+		}
 	}
 	void VulkanDevice::CreateDevice(VulkanSurface* surface, bool8_t setQueueFamilyIndices) {
 		// Get the number of queue families
@@ -201,7 +408,7 @@ namespace wfe {
 
 		// Get the queue families
 		PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
-		VkQueueFamilyProperties* queueFamilies = (VkQueueFamilyProperties*)AllocMemory(queueFamilyCount * sizeof(VkQueueFamilyProperties));
+		VkQueueFamilyProperties* queueFamilies = (VkQueueFamilyProperties*)AllocHeapMemory(queueFamilyCount * sizeof(VkQueueFamilyProperties));
 		PopMemoryUsageType();
 		if(!queueFamilies)
 			throw BadAllocException("Failed to allocate Vulkan physical device queue families array!");
@@ -223,10 +430,10 @@ namespace wfe {
 		AddQueueCreateInfo(indices.transferIndex, queueInfoCount, queueInfos, queuePriorities, queueFamilies);
 		AddQueueCreateInfo(indices.computeIndex, queueInfoCount, queueInfos, queuePriorities, queueFamilies);
 
-		// Set the device's create info
+		// Set the device's create info, enabling the selected extended features
 		VkDeviceCreateInfo createInfo {
 			.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
-			.pNext = nullptr,
+			.pNext = featureChain,
 			.flags = 0,
 			.queueCreateInfoCount = queueInfoCount,
 			.pQueueCreateInfos = queueInfos,
@@ -281,7 +488,7 @@ namespace wfe {
 
 		// Get the queue families
 		PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
-		VkQueueFamilyProperties* queueFamilies = (VkQueueFamilyProperties*)AllocMemory(queueFamilyCount * sizeof(VkQueueFamilyProperties));
+		VkQueueFamilyProperties* queueFamilies = (VkQueueFamilyProperties*)AllocHeapMemory(queueFamilyCount * sizeof(VkQueueFamilyProperties));
 		PopMemoryUsageType();
 		if(!queueFamilies)
 			throw BadAllocException("Failed to allocate Vulkan physical device queue families array!");
@@ -303,7 +510,7 @@ namespace wfe {
 
 		// Get the supported extensions
 		PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
-		VkExtensionProperties* supportedExtensions = (VkExtensionProperties*)AllocMemory(supportedCount * sizeof(VkExtensionProperties));
+		VkExtensionProperties* supportedExtensions = (VkExtensionProperties*)AllocHeapMemory(supportedCount * sizeof(VkExtensionProperties));
 		PopMemoryUsageType();
 		if(!supportedExtensions)
 			throw BadAllocException("Failed to allocate Vulkan supported device extensions array!");
@@ -335,7 +542,7 @@ namespace wfe {
 
 		// Get the supported extensions
 		PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
-		VkExtensionProperties* supportedExtensions = (VkExtensionProperties*)AllocMemory(supportedExtensionCount * sizeof(VkExtensionProperties));
+		VkExtensionProperties* supportedExtensions = (VkExtensionProperties*)AllocHeapMemory(supportedExtensionCount * sizeof(VkExtensionProperties));
 		PopMemoryUsageType();
 		if(!supportedExtensions)
 			throw BadAllocException("Failed to allocate Vulkan supported device extensions array!");
@@ -377,7 +584,7 @@ namespace wfe {
 
 		// Get the physical devices
 		PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
-		VkPhysicalDevice* devices = (VkPhysicalDevice*)AllocMemory(deviceCount * sizeof(VkPhysicalDevice));
+		VkPhysicalDevice* devices = (VkPhysicalDevice*)AllocHeapMemory(deviceCount * sizeof(VkPhysicalDevice));
 		PopMemoryUsageType();
 		if(!devices)
 			throw BadAllocException("Failed to allocate Vulkan physical devices array!");
@@ -429,6 +636,7 @@ namespace wfe {
 		// Get the physical device's properties and features
 		loader->vkGetPhysicalDeviceProperties(physicalDevice, &properties);
 		loader->vkGetPhysicalDeviceFeatures(physicalDevice, &features);
+		GetExtendedFeatures();
 
 		// Create the logical device and get its queues
 		CreateDevice(nullptr, false);
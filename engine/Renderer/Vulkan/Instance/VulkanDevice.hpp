@@ -22,6 +22,37 @@ namespace wfe {
 			/// @brief The compute queue family's index, or UINT32_T_MAX if one wasn't found.
 			uint32_t computeIndex = UINT32_T_MAX;
 		};
+		/// @brief A struct containing the performance-relevant capabilities enabled on a device, used by higher layers to choose fast paths.
+		struct Capabilities {
+			/// @brief The Vulkan API version supported by the physical device.
+			uint32_t apiVersion;
+			/// @brief True if timeline semaphores are enabled, otherwise false.
+			bool8_t timelineSemaphores;
+			/// @brief True if buffer device addresses are enabled, otherwise false.
+			bool8_t bufferDeviceAddress;
+			/// @brief True if dynamic rendering is enabled, otherwise false.
+			bool8_t dynamicRendering;
+			/// @brief True if the synchronization2 commands are enabled, otherwise false.
+			bool8_t synchronization2;
+			/// @brief True if partially bound runtime descriptor arrays are enabled, otherwise false.
+			bool8_t descriptorIndexing;
+			/// @brief True if sampled image and storage buffer descriptors can be updated after being bound, otherwise false.
+			bool8_t descriptorUpdateAfterBind;
+			/// @brief True if indirect draws can read their draw count from a buffer, otherwise false.
+			bool8_t drawIndirectCount;
+			/// @brief True if 8-bit types can be used in storage buffers, otherwise false.
+			bool8_t storage8Bit;
+			/// @brief True if 16-bit types can be used in storage buffers, otherwise false.
+			bool8_t storage16Bit;
+			/// @brief True if task and mesh shaders are enabled, otherwise false.
+			bool8_t meshShader;
+			/// @brief The default number of invocations in a subgroup.
+			uint32_t subgroupSize;
+			/// @brief The shader stages that support subgroup operations.
+			VkShaderStageFlags subgroupSupportedStages;
+			/// @brief The supported subgroup operations.
+			VkSubgroupFeatureFlags subgroupSupportedOperations;
+		};
 
 		/// @brief Gets the extensions required by the Vulkan device implementation by default.
 		/// @return A set containing the names of all Vulkan required extensions.
@@ -151,11 +182,17 @@ namespace wfe {
 		const VkPhysicalDeviceFeatures& GetDeviceFeatures() const {
 			return features;
 		}
+		/// @brief Gets the performance-relevant capabilities enabled on the device.
+		/// @return The struct containing the device's enabled capabilities.
+		const Capabilities& GetCapabilities() const {
+			return capabilities;
+		}
 
 		/// @brief Destroys the Vulkan logical device.
 		~VulkanDevice();
 	private:
 		void GetPhysicalDeviceInfo(const set<const char_t*>& requiredExtensions, const set<const char_t*>& optionalExtensions);
+		void GetExtendedFeatures();
 		void CreateDevice(VulkanSurface* surface, bool8_t setQueueFamilyIndices);
 
 		const VulkanLoader* loader;
@@ -172,5 +209,14 @@ namespace wfe {
 		QueueFamilyIndices indices;
 		VkPhysicalDeviceProperties properties;
 		VkPhysicalDeviceFeatures features;
+		VkPhysicalDeviceVulkan11Features vulkan11Features;
+		VkPhysicalDeviceVulkan12Features vulkan12Features;
+		VkPhysicalDeviceVulkan13Features vulkan13Features;
+		VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures;
+		VkPhysicalDeviceSynchronization2Features synchronization2Features;
+		VkPhysicalDeviceDynamicRenderingFeatures dynamicRenderingFeatures;
+		VkPhysicalDeviceMeshShaderFeaturesEXT meshShaderFeatures;
+		void* featureChain;
+		Capabilities capabilities;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,251 @@
+#include "VulkanHostAllocator.hpp"
+#include "General/HeapMemory.hpp"
+#include "Platform/Thread.hpp"
+
+#include <string.h>
+
+namespace wfe {
+	// Constants
+	static const size_t MIN_ALIGNMENT = 16;
+	static const size_t SIZE_CLASS_COUNT = 7;
+	static const size_t MIN_SIZE_CLASS_SHIFT = 6;
+	static const size_t POOL_PAGE_SIZE = 64 << 10;
+	static const uint16_t HEAP_SIZE_CLASS = 0xffff;
+	static const size_t SCOPE_COUNT = VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE + 1;
+
+	// Internal structs
+	struct alignas(MIN_ALIGNMENT) AllocationHeader {
+		size_t size;
+		uint32_t offset;
+		uint16_t allocScope;
+		uint16_t sizeClass;
+	};
+	struct PoolSlot {
+		PoolSlot* next;
+	};
+	struct PoolPage {
+		PoolPage* next;
+	};
+	struct SizeClassPool {
+		atomic_uint32_t lock;
+		PoolSlot* freeSlots;
+		PoolPage* pages;
+		size_t liveSlotCount;
+	};
+	struct ScopeCounters {
+		atomic_uint64_t allocationCount;
+		atomic_uint64_t allocatedSize;
+		atomic_uint64_t pooledAllocationCount;
+		atomic_uint64_t liveAllocationCount;
+		atomic_uint64_t liveSize;
+	};
+
+	// Internal variables
+	static SizeClassPool sizeClassPools[SIZE_CLASS_COUNT];
+	static ScopeCounters scopeCounters[SCOPE_COUNT];
+
+	// Internal helper functions
+	static void LockPool(SizeClassPool& pool) {
+		while(pool.lock.exchange(1))
+			Thread::YieldCurrentThread();
+	}
+	static void UnlockPool(SizeClassPool& pool) {
+		pool.lock = 0;
+	}
+	static size_t GetSizeClassSize(uint16_t sizeClass) {
+		return (size_t)1 << (sizeClass + MIN_SIZE_CLASS_SHIFT);
+	}
+	static uint16_t GetSizeClass(size_t size) {
+		// Find the smallest size class the given size fits in
+		for(uint16_t sizeClass = 0; sizeClass != SIZE_CLASS_COUNT; ++sizeClass)
+			if(size <= GetSizeClassSize(sizeClass))
+				return sizeClass;
+
+		return HEAP_SIZE_CLASS;
+	}
+	static void* AllocSlot(uint16_t sizeClass) {
+		SizeClassPool& pool = sizeClassPools[sizeClass];
+		LockPool(pool);
+
+		if(!pool.freeSlots) {
+			// Allocate a new page, padded so that its slots can start on an aligned address
+			PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
+			PoolPage* page = (PoolPage*)AllocHeapMemory(POOL_PAGE_SIZE + MIN_ALIGNMENT);
+			PopMemoryUsageType();
+
+			if(!page) {
+				UnlockPool(pool);
+				return nullptr;
+			}
+
+			page->next = pool.pages;
+			pool.pages = page;
+
+			// Split the page into slots and push them to the free list in address order
+			size_t slotSize = GetSizeClassSize(sizeClass);
+			size_t slotCount = (POOL_PAGE_SIZE - sizeof(PoolPage)) / slotSize;
+			uintptr_t slotStart = ((uintptr_t)(page + 1) + MIN_ALIGNMENT - 1) & ~(uintptr_t)(MIN_ALIGNMENT - 1);
+
+			for(size_t i = slotCount; i--; ) {
+				PoolSlot* slot = (PoolSlot*)(slotStart + i * slotSize);
+				slot->next = pool.freeSlots;
+				pool.freeSlots = slot;
+			}
+		}
+
+		// Pop a slot from the free list
+		PoolSlot* slot = pool.freeSlots;
+		pool.freeSlots = slot->next;
+		++pool.liveSlotCount;
+
+		UnlockPool(pool);
+
+		return slot;
+	}
+	static void FreeSlot(uint16_t sizeClass, void* memory) {
+		SizeClassPool& pool = sizeClassPools[sizeClass];
+		LockPool(pool);
+
+		// Push the slot back to the free list
+		PoolSlot* slot = (PoolSlot*)memory;
+		slot->next = pool.freeSlots;
+		pool.freeSlots = slot;
+		--pool.liveSlotCount;
+
+		UnlockPool(pool);
+	}
+
+	// Public functions
+	void* AllocVulkanHostMemory(size_t size, size_t alignment, VkSystemAllocationScope allocScope) {
+		// Every allocation is aligned to at least the header's alignment, so that the header can be placed right before it
+		if(alignment < MIN_ALIGNMENT)
+			alignment = MIN_ALIGNMENT;
+
+		// Try to find a size class for command scope allocations; slots are already aligned to the minimum alignment, so only larger alignments need padding
+		uint16_t sizeClass = HEAP_SIZE_CLASS;
+		if(allocScope == VK_SYSTEM_ALLOCATION_SCOPE_COMMAND)
+			sizeClass = GetSizeClass(sizeof(AllocationHeader) + size + alignment - MIN_ALIGNMENT);
+
+		void* block;
+		if(sizeClass != HEAP_SIZE_CLASS) {
+			block = AllocSlot(sizeClass);
+		} else {
+			// Set the memory usage type based on the alloc scope
+			MemoryUsageType memoryUsageType;
+			if(allocScope == VK_SYSTEM_ALLOCATION_SCOPE_COMMAND)
+				memoryUsageType = MEMORY_USAGE_TYPE_COMMAND;
+			else
+				memoryUsageType = MEMORY_USAGE_TYPE_RENDERER;
+
+			// Allocate the requested memory, padded for any alignment of the returned block
+			PushMemoryUsageType(memoryUsageType);
+			block = AllocHeapMemory(sizeof(AllocationHeader) + size + alignment - 1);
+			PopMemoryUsageType();
+		}
+
+		if(!block)
+			return nullptr;
+
+		// Align the allocation past its header
+		uintptr_t address = ((uintptr_t)block + sizeof(AllocationHeader) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+
+		AllocationHeader* header = (AllocationHeader*)address - 1;
+		header->size = size;
+		header->offset = (uint32_t)(address - (uintptr_t)block);
+		header->allocScope = (uint16_t)allocScope;
+		header->sizeClass = sizeClass;
+
+		// Update the scope's counters
+		ScopeCounters& counters = scopeCounters[allocScope];
+		++counters.allocationCount;
+		counters.allocatedSize += size;
+		if(sizeClass != HEAP_SIZE_CLASS)
+			++counters.pooledAllocationCount;
+		++counters.liveAllocationCount;
+		counters.liveSize += size;
+
+		return (void*)address;
+	}
+	void* ReallocVulkanHostMemory(void* original, size_t size, size_t alignment, VkSystemAllocationScope allocScope) {
+		// Allocate new memory if no original memory is given, or free the original memory if the new size is 0
+		if(!original)
+			return AllocVulkanHostMemory(size, alignment, allocScope);
+		if(!size) {
+			FreeVulkanHostMemory(original);
+			return nullptr;
+		}
+
+		if(alignment < MIN_ALIGNMENT)
+			alignment = MIN_ALIGNMENT;
+
+		// Keep pooled memory in place if it's still aligned and its slot can hold the new size
+		AllocationHeader* header = (AllocationHeader*)original - 1;
+		if(header->sizeClass != HEAP_SIZE_CLASS && header->allocScope == allocScope && !((uintptr_t)original & (alignment - 1)) && header->offset + size <= GetSizeClassSize(header->sizeClass)) {
+			ScopeCounters& counters = scopeCounters[allocScope];
+			++counters.allocationCount;
+			counters.allocatedSize += size;
+			counters.liveSize -= header->size;
+			counters.liveSize += size;
+			header->size = size;
+
+			return original;
+		}
+
+		// Move the contents to a new allocation, as the general heap's reallocation wouldn't keep the requested alignment
+		void* memory = AllocVulkanHostMemory(size, alignment, allocScope);
+		if(!memory)
+			return nullptr;
+
+		memcpy(memory, original, header->size < size ? header->size : size);
+		FreeVulkanHostMemory(original);
+
+		return memory;
+	}
+	void FreeVulkanHostMemory(void* memory) {
+		// Exit the function if no memory is given
+		if(!memory)
+			return;
+
+		AllocationHeader* header = (AllocationHeader*)memory - 1;
+
+		// Update the scope's counters
+		ScopeCounters& counters = scopeCounters[header->allocScope];
+		--counters.liveAllocationCount;
+		counters.liveSize -= header->size;
+
+		// Free the allocation's block
+		void* block = (uint8_t*)memory - header->offset;
+		if(header->sizeClass != HEAP_SIZE_CLASS) {
+			FreeSlot(header->sizeClass, block);
+		} else {
+			FreeMemory(block);
+		}
+	}
+	void TrimVulkanHostMemoryPools() {
+		for(SizeClassPool& pool : sizeClassPools) {
+			LockPool(pool);
+
+			// Free the pool's pages only if none of their slots are in use
+			if(!pool.liveSlotCount) {
+				while(pool.pages) {
+					PoolPage* next = pool.pages->next;
+					FreeMemory(pool.pages);
+					pool.pages = next;
+				}
+				pool.freeSlots = nullptr;
+			}
+
+			UnlockPool(pool);
+		}
+	}
+	VulkanHostMemoryStats GetVulkanHostMemoryStats(VkSystemAllocationScope allocScope) {
+		const ScopeCounters& counters = scopeCounters[allocScope];
+		return {
+			counters.allocationCount,
+			counters.allocatedSize,
+			counters.pooledAllocationCount,
+			counters.liveAllocationCount,
+			counters.liveSize
+		};
+	}
+}
\ No newline at end of file
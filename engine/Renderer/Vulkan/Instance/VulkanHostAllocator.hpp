@@ -0,0 +1,44 @@
+#pragma once
+
+#include <Core.hpp>
+#include <vulkan/vk_platform.h>
+#include <vulkan/vulkan_core.h>
+
+namespace wfe {
+	/// @brief A struct containing the host allocation statistics of a single Vulkan system allocation scope.
+	struct VulkanHostMemoryStats {
+		/// @brief The number of allocations made in the scope, including every reallocation.
+		uint64_t allocationCount;
+		/// @brief The total number of bytes requested by the scope's allocations.
+		uint64_t allocatedSize;
+		/// @brief The number of the scope's allocations served by a size class pool instead of the general heap.
+		uint64_t pooledAllocationCount;
+		/// @brief The number of the scope's allocations that weren't freed yet.
+		uint64_t liveAllocationCount;
+		/// @brief The number of bytes held by the scope's allocations that weren't freed yet.
+		uint64_t liveSize;
+	};
+
+	/// @brief Allocates host memory for a Vulkan driver. Command scope allocations small enough are served from size class pools, while every other allocation goes to the general heap.
+	/// @param size The size of the allocation.
+	/// @param alignment The alignment of the allocation, which must be a power of 2.
+	/// @param allocScope The system allocation scope of the allocation.
+	/// @return A pointer to the allocated memory, or nullptr if the allocation failed.
+	void* AllocVulkanHostMemory(size_t size, size_t alignment, VkSystemAllocationScope allocScope);
+	/// @brief Reallocates host memory for a Vulkan driver, keeping the original contents up to the smaller of the two sizes.
+	/// @param original A pointer to the original memory, or nullptr to make a new allocation.
+	/// @param size The new size of the allocation, or 0 to free the original memory.
+	/// @param alignment The alignment of the allocation, which must be a power of 2.
+	/// @param allocScope The system allocation scope of the allocation.
+	/// @return A pointer to the reallocated memory, or nullptr if the allocation failed or the memory was freed.
+	void* ReallocVulkanHostMemory(void* original, size_t size, size_t alignment, VkSystemAllocationScope allocScope);
+	/// @brief Frees host memory allocated for a Vulkan driver.
+	/// @param memory A pointer to the memory to free, or nullptr.
+	void FreeVulkanHostMemory(void* memory);
+	/// @brief Frees the pages of every size class pool that has no live allocations.
+	void TrimVulkanHostMemoryPools();
+	/// @brief Gets the host allocation statistics of the given system allocation scope.
+	/// @param allocScope The system allocation scope to get the statistics of.
+	/// @return The scope's host allocation statistics.
+	VulkanHostMemoryStats GetVulkanHostMemoryStats(VkSystemAllocationScope allocScope);
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "VulkanInstance.hpp"
+#include "General/HeapMemory.hpp"
 #include "Renderer/Vulkan/VulkanRenderer.hpp"
 #include "ProjectInfo.hpp"
 
@@ -121,7 +122,7 @@ namespace wfe {
 		loader->vkEnumerateInstanceLayerProperties(&supportedLayerCount, nullptr);
 
 		// Allocate all required arrays
-		VkExtensionProperties* supportedExtensions = (VkExtensionProperties*)AllocMemory(supportedExtensionCount * sizeof(VkExtensionProperties) + supportedLayerCount * sizeof(VkLayerProperties) + (optionalExtensions.size() + optionalDebugExtensions.size() + optionalLayers.size()) * sizeof(bool8_t));
+		VkExtensionProperties* supportedExtensions = (VkExtensionProperties*)AllocHeapMemory(supportedExtensionCount * sizeof(VkExtensionProperties) + supportedLayerCount * sizeof(VkLayerProperties) + (optionalExtensions.size() + optionalDebugExtensions.size() + optionalLayers.size()) * sizeof(bool8_t));
 		if(!supportedExtensions)
 			throw BadAllocException("Failed to allocate Vulkan instance support arrays!");
 		
@@ -285,7 +286,7 @@ namespace wfe {
 
 		// Get the supported extensions
 		PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
-		VkExtensionProperties* supportedExtensions = (VkExtensionProperties*)AllocMemory(supportedCount * sizeof(VkExtensionProperties));
+		VkExtensionProperties* supportedExtensions = (VkExtensionProperties*)AllocHeapMemory(supportedCount * sizeof(VkExtensionProperties));
 		PopMemoryUsageType();
 		if(!supportedExtensions)
 			throw BadAllocException("Failed to allocate Vulkan supported instance extensions array!");
@@ -307,7 +308,7 @@ namespace wfe {
 
 		// Get the supported extensions
 		PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
-		VkLayerProperties* supportedLayers = (VkLayerProperties*)AllocMemory(supportedCount * sizeof(VkLayerProperties));
+		VkLayerProperties* supportedLayers = (VkLayerProperties*)AllocHeapMemory(supportedCount * sizeof(VkLayerProperties));
 		PopMemoryUsageType();
 		if(!supportedLayers)
 			throw BadAllocException("Failed to allocate Vulkan supported instance layers array!");
@@ -1,4 +1,6 @@
 #include "VulkanSwapChain.hpp"
+#include "General/HeapMemory.hpp"
+#include "General/LinearArena.hpp"
 #include "Renderer/Vulkan/VulkanRenderer.hpp"
 
 #include <vulkan/vk_enum_string_helper.h>
@@ -6,6 +8,7 @@
 namespace wfe {
 	// Constants
 	static const vector<VkFormat> DEPTH_FORMATS = { VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT };
+	static const VkFormatFeatureFlags DEPTH_FORMAT_FEATURES = VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
 	static const VkCompositeAlphaFlagBitsKHR COMPOSITE_ALPHA = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
 	static const VkBool32 CLIPPED = VK_TRUE;
 
@@ -19,6 +22,14 @@ namespace wfe {
 	}
 
 	// Internal helper functions
+	static VkImageAspectFlags GetDepthAspectFlags(VkFormat depthFormat) {
+		// Add the stencil aspect for combined depth stencil formats
+		if(depthFormat == VK_FORMAT_D16_UNORM_S8_UINT || depthFormat == VK_FORMAT_D24_UNORM_S8_UINT || depthFormat == VK_FORMAT_D32_SFLOAT_S8_UINT)
+			return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+
+		return VK_IMAGE_ASPECT_DEPTH_BIT;
+	}
+
 	void VulkanSwapChain::CreateSwapChain(VkSwapchainKHR oldSwapChain) {
 		// Get the surface's capabilities
 		VkSurfaceCapabilitiesKHR surfaceCapabilities;
@@ -109,22 +120,18 @@ namespace wfe {
 		uint32_t imageCount;
 		device->GetLoader()->vkGetSwapchainImagesKHR(device->GetDevice(), swapChain, &imageCount, nullptr);
 
-		// Get the swap chain's images
-		PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
-		VkImage* swapChainImagesArr = (VkImage*)AllocMemory(sizeof(VkImage) * imageCount);
-		PopMemoryUsageType();
-		if(!swapChainImagesArr)
-			throw BadAllocException("Failed to allocate Vulkan swap chain images array!");
+		// Get the swap chain's images in scratch memory
+		ScratchScope scratch;
+		VkImage* swapChainImagesArr = (VkImage*)scratch.Allocate(sizeof(VkImage) * imageCount, alignof(VkImage));
 		
 		device->GetLoader()->vkGetSwapchainImagesKHR(device->GetDevice(), swapChain, &imageCount, swapChainImagesArr);
 
 		// Copy the images to the swap chain image vector
 		swapChainImages.resize(imageCount);
-		for(uint32_t i = 0; i != imageCount; ++i)
+		for(uint32_t i = 0; i != imageCount; ++i) {
 			swapChainImages[i].image = swapChainImagesArr[i];
-		
-		// Free the swap chain image array
-		FreeMemory(swapChainImagesArr);
+			swapChainImages[i].framebuffer = VK_NULL_HANDLE;
+		}
 		
 		// Set the swap chain image views' create infos
 		VkImageViewCreateInfo createInfo {
@@ -191,7 +198,7 @@ namespace wfe {
 			.arrayLayers = 1,
 			.samples = VK_SAMPLE_COUNT_1_BIT,
 			.tiling = VK_IMAGE_TILING_OPTIMAL,
-			.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+			.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
 			.sharingMode = depthImageSharingMode,
 			.queueFamilyIndexCount = depthImageIndexCount,
 			.pQueueFamilyIndices = depthImageIndices,
@@ -241,7 +248,7 @@ namespace wfe {
 
 		// Allocate the depth image and memory arrays
 		PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
-		VkImage* depthImages = (VkImage*)AllocMemory(sizeof(VkImage) * swapChainImages.size() + sizeof(VulkanAllocator::MemoryBlock) * swapChainImages.size());
+		VkImage* depthImages = (VkImage*)AllocHeapMemory(sizeof(VkImage) * swapChainImages.size() + sizeof(VulkanAllocator::MemoryBlock) * swapChainImages.size());
 		PopMemoryUsageType();
 		if(!depthImages)
 			throw BadAllocException("Failed to allocate Vulkan swap chain depth image and memory bind array!");
@@ -263,9 +270,22 @@ namespace wfe {
 		FreeMemory(depthImages);
 	}
 	void VulkanSwapChain::CreateRenderPass() {
-		// Exit hte function if the swap chain does not exist
-		if(!swapChain)
+		// Set the pipeline rendering info instead of creating a render pass if dynamic rendering is used, as pipelines only depend on the attachment formats
+		if(dynamicRendering) {
+			VkImageAspectFlags depthAspectFlags = GetDepthAspectFlags(settings.depthFormat);
+
+			pipelineRenderingInfo = {
+				.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+				.pNext = nullptr,
+				.viewMask = 0,
+				.colorAttachmentCount = 1,
+				.pColorAttachmentFormats = &settings.imageFormat,
+				.depthAttachmentFormat = settings.depthFormat,
+				.stencilAttachmentFormat = (depthAspectFlags & VK_IMAGE_ASPECT_STENCIL_BIT) ? settings.depthFormat : VK_FORMAT_UNDEFINED
+			};
+
 			return;
+		}
 
 		// Set the attachment descriptions
 		VkAttachmentDescription attachments[] = {
@@ -285,7 +305,7 @@ namespace wfe {
 				.format = settings.depthFormat,
 				.samples = VK_SAMPLE_COUNT_1_BIT,
 				.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
-				.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+				.storeOp = VK_ATTACHMENT_STORE_OP_STORE,
 				.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
 				.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
 				.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
@@ -334,10 +354,20 @@ namespace wfe {
 		VkResult result = device->GetLoader()->vkCreateRenderPass(device->GetDevice(), &createInfo, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS, &renderPass);
 		if(result != VK_SUCCESS)
 			throw Exception("Failed to create Vulkan render pass! Error code: %s", string_VkResult(result));
+
+		// Create the compatible render pass that loads the attachments' previous contents, used to resume rendering
+		attachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+		attachments[0].initialLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		attachments[1].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+		attachments[1].initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+		result = device->GetLoader()->vkCreateRenderPass(device->GetDevice(), &createInfo, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS, &loadRenderPass);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to create Vulkan render pass! Error code: %s", string_VkResult(result));
 	}
 	void VulkanSwapChain::CreateFramebuffers() {
-		// Exit hte function if the swap chain does not exist
-		if(!swapChain)
+		// Exit hte function if the swap chain does not exist or if dynamic rendering is used
+		if(!swapChain || dynamicRendering)
 			return;
 
 		// Set the framebffer create info
@@ -364,6 +394,112 @@ namespace wfe {
 				throw Exception("Failed to create Vulkan swap chain framebuffer! Error code: %s", string_VkResult(result));
 		}
 	}
+	void VulkanSwapChain::RecordBeginRendering(VkCommandBuffer commandBuffer, uint32_t imageIndex, VkAttachmentLoadOp loadOp, const VkClearColorValue& clearColor, bool8_t transitionImages) {
+		const SwapChainImage& swapChainImage = swapChainImages[imageIndex];
+
+		// Set the attachments' clear values
+		VkClearValue clearValues[2];
+		clearValues[0].color = clearColor;
+		clearValues[1].depthStencil = { 1.f, 0 };
+
+		// Begin the render pass if dynamic rendering isn't used
+		if(!dynamicRendering) {
+			VkRenderPassBeginInfo beginInfo {
+				.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+				.pNext = nullptr,
+				.renderPass = loadOp == VK_ATTACHMENT_LOAD_OP_LOAD ? loadRenderPass : renderPass,
+				.framebuffer = swapChainImage.framebuffer,
+				.renderArea = { { 0, 0 }, swapChainExtent },
+				.clearValueCount = 2,
+				.pClearValues = clearValues
+			};
+
+			device->GetLoader()->vkCmdBeginRenderPass(commandBuffer, &beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+			return;
+		}
+
+		// Transition the attachments to their rendering layouts if the caller didn't, discarding their previous contents unless they're loaded
+		VkImageAspectFlags depthAspectFlags = GetDepthAspectFlags(settings.depthFormat);
+
+		if(transitionImages) {
+			VkImageMemoryBarrier barriers[] {
+				{
+					.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+					.pNext = nullptr,
+					.srcAccessMask = 0,
+					.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+					.oldLayout = loadOp == VK_ATTACHMENT_LOAD_OP_LOAD ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR : VK_IMAGE_LAYOUT_UNDEFINED,
+					.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+					.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+					.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+					.image = swapChainImage.image,
+					.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 }
+				},
+				{
+					.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+					.pNext = nullptr,
+					.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+					.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+					.oldLayout = loadOp == VK_ATTACHMENT_LOAD_OP_LOAD ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED,
+					.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+					.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+					.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+					.image = swapChainImage.depthImage,
+					.subresourceRange = { depthAspectFlags, 0, 1, 0, 1 }
+				}
+			};
+
+			VkPipelineStageFlags stageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+			device->GetLoader()->vkCmdPipelineBarrier(commandBuffer, stageMask, stageMask, 0, 0, nullptr, 0, nullptr, 2, barriers);
+		}
+
+		// Set the attachments' infos
+		VkRenderingAttachmentInfo colorAttachment {
+			.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+			.pNext = nullptr,
+			.imageView = swapChainImage.imageView,
+			.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+			.resolveMode = VK_RESOLVE_MODE_NONE,
+			.resolveImageView = VK_NULL_HANDLE,
+			.resolveImageLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+			.loadOp = loadOp,
+			.storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+			.clearValue = clearValues[0]
+		};
+		VkRenderingAttachmentInfo depthAttachment {
+			.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+			.pNext = nullptr,
+			.imageView = swapChainImage.depthImageView,
+			.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+			.resolveMode = VK_RESOLVE_MODE_NONE,
+			.resolveImageView = VK_NULL_HANDLE,
+			.resolveImageLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+			.loadOp = loadOp,
+			.storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+			.clearValue = clearValues[1]
+		};
+
+		// Set the rendering info
+		VkRenderingInfo renderingInfo {
+			.sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.renderArea = { { 0, 0 }, swapChainExtent },
+			.layerCount = 1,
+			.viewMask = 0,
+			.colorAttachmentCount = 1,
+			.pColorAttachments = &colorAttachment,
+			.pDepthAttachment = &depthAttachment,
+			.pStencilAttachment = (depthAspectFlags & VK_IMAGE_ASPECT_STENCIL_BIT) ? &depthAttachment : nullptr
+		};
+
+		// Begin rendering
+		if(device->GetCapabilities().apiVersion >= VK_API_VERSION_1_3) {
+			device->GetLoader()->vkCmdBeginRendering(commandBuffer, &renderingInfo);
+		} else {
+			device->GetLoader()->vkCmdBeginRenderingKHR(commandBuffer, &renderingInfo);
+		}
+	}
 
 	// Public functions
 	VulkanSwapChain::SwapChainSettings VulkanSwapChain::GetDefaultSwapChainSettings(VulkanSurface* surface, VulkanDevice* device) {
@@ -372,14 +508,10 @@ namespace wfe {
 		device->GetLoader()->vkGetPhysicalDeviceSurfaceFormatsKHR(device->GetPhysicalDevice(), surface->GetSurface(), &formatCount, nullptr);
 		device->GetLoader()->vkGetPhysicalDeviceSurfacePresentModesKHR(device->GetPhysicalDevice(), surface->GetSurface(), &presentModeCount, nullptr);
 
-		// Allocate all required arrays
-		PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
-		VkSurfaceFormatKHR* surfaceFormats = (VkSurfaceFormatKHR*)AllocMemory(sizeof(VkSurfaceFormatKHR) * formatCount + sizeof(VkPresentModeKHR) * presentModeCount);
-		PopMemoryUsageType();
-		if(!surfaceFormats)
-			throw BadAllocException("Failed to allocate supported Vulkan surface formats and present modes array!");
-		
-		VkPresentModeKHR* presentModes = (VkPresentModeKHR*)(surfaceFormats + formatCount);
+		// Allocate all required arrays in scratch memory
+		ScratchScope scratch;
+		VkSurfaceFormatKHR* surfaceFormats = (VkSurfaceFormatKHR*)scratch.Allocate(sizeof(VkSurfaceFormatKHR) * formatCount, alignof(VkSurfaceFormatKHR));
+		VkPresentModeKHR* presentModes = (VkPresentModeKHR*)scratch.Allocate(sizeof(VkPresentModeKHR) * presentModeCount, alignof(VkPresentModeKHR));
 
 		// Get the supported surface formats and present modes
 		device->GetLoader()->vkGetPhysicalDeviceSurfaceFormatsKHR(device->GetPhysicalDevice(), surface->GetSurface(), &formatCount, surfaceFormats);
@@ -412,8 +544,8 @@ namespace wfe {
 			VkFormatProperties depthProperties;
 			device->GetLoader()->vkGetPhysicalDeviceFormatProperties(device->GetPhysicalDevice(), depthFormat, &depthProperties);
 
-			// Set the depth format if it has the depth stencil feature
-			if(depthProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) {
+			// Set the depth format if it can be both rendered to and sampled by the depth pyramid
+			if((depthProperties.optimalTilingFeatures & DEPTH_FORMAT_FEATURES) == DEPTH_FORMAT_FEATURES) {
 				settings.depthFormat = depthFormat;
 				break;
 			}
@@ -441,14 +573,10 @@ namespace wfe {
 		device->GetLoader()->vkGetPhysicalDeviceSurfaceFormatsKHR(device->GetPhysicalDevice(), surface->GetSurface(), &formatCount, nullptr);
 		device->GetLoader()->vkGetPhysicalDeviceSurfacePresentModesKHR(device->GetPhysicalDevice(), surface->GetSurface(), &presentModeCount, nullptr);
 
-		// Allocate all required arrays
-		PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
-		VkSurfaceFormatKHR* surfaceFormats = (VkSurfaceFormatKHR*)AllocMemory(sizeof(VkSurfaceFormatKHR) * formatCount + sizeof(VkPresentModeKHR) * presentModeCount);
-		PopMemoryUsageType();
-		if(!surfaceFormats)
-			throw BadAllocException("Failed to allocate supported Vulkan surface formats and present modes array!");
-		
-		VkPresentModeKHR* presentModes = (VkPresentModeKHR*)(surfaceFormats + formatCount);
+		// Allocate all required arrays in scratch memory
+		ScratchScope scratch;
+		VkSurfaceFormatKHR* surfaceFormats = (VkSurfaceFormatKHR*)scratch.Allocate(sizeof(VkSurfaceFormatKHR) * formatCount, alignof(VkSurfaceFormatKHR));
+		VkPresentModeKHR* presentModes = (VkPresentModeKHR*)scratch.Allocate(sizeof(VkPresentModeKHR) * presentModeCount, alignof(VkPresentModeKHR));
 		
 		// Get the supported surface formats and present modes
 		device->GetLoader()->vkGetPhysicalDeviceSurfaceFormatsKHR(device->GetPhysicalDevice(), surface->GetSurface(), &formatCount, surfaceFormats);
@@ -464,10 +592,8 @@ namespace wfe {
 		}
 
 		// Exit the function if the surface format is not supported
-		if(!supported) {
-			FreeMemory(surfaceFormats);
+		if(!supported)
 			return false;
-		}
 		
 		// Check if the settings' present mode is supported
 		for(uint32_t i = 0; i != presentModeCount; ++i) {
@@ -478,23 +604,18 @@ namespace wfe {
 		}
 
 		// Exit the function if the present mode is not supported
-		if(!supported) {
-			FreeMemory(surfaceFormats);
+		if(!supported)
 			return false;
-		}
-
-		// Free the supported surface format and present modes array
-		FreeMemory(surfaceFormats);
 		
 		// Get the depth format's properties
 		VkFormatProperties depthProperties;
 		device->GetLoader()->vkGetPhysicalDeviceFormatProperties(device->GetPhysicalDevice(), settings.depthFormat, &depthProperties);
 
-		// Check if the depth format has the depth stencil feature
-		return depthProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT;
+		// Check if the depth format has the depth stencil and sampled image features
+		return (depthProperties.optimalTilingFeatures & DEPTH_FORMAT_FEATURES) == DEPTH_FORMAT_FEATURES;
 	}
 
-	VulkanSwapChain::VulkanSwapChain(VulkanSurface* surface, VulkanDevice* device, VulkanAllocator* allocator) : surface(surface), device(device), allocator(allocator), settings(GetDefaultSwapChainSettings(surface, device)) {
+	VulkanSwapChain::VulkanSwapChain(VulkanSurface* surface, VulkanDevice* device, VulkanAllocator* allocator) : surface(surface), device(device), allocator(allocator), settings(GetDefaultSwapChainSettings(surface, device)), renderPass(VK_NULL_HANDLE), loadRenderPass(VK_NULL_HANDLE), dynamicRendering(device->GetCapabilities().dynamicRendering) {
 		// Create the swap chain's components
 		CreateSwapChain(VK_NULL_HANDLE);
 		GetSwapChainImageViews();
@@ -505,7 +626,7 @@ namespace wfe {
 		// Add the window resize event listener
 		surface->GetWindow()->GetResizeEvent().AddListener(Event::Listener(WindowResizeEventCallback, this));
 	}
-	VulkanSwapChain::VulkanSwapChain(VulkanSurface* surface, VulkanDevice* device, VulkanAllocator* allocator, const SwapChainSettings& swapChainSettings) : surface(surface), device(device), allocator(allocator), settings(swapChainSettings) {
+	VulkanSwapChain::VulkanSwapChain(VulkanSurface* surface, VulkanDevice* device, VulkanAllocator* allocator, const SwapChainSettings& swapChainSettings) : surface(surface), device(device), allocator(allocator), settings(swapChainSettings), renderPass(VK_NULL_HANDLE), loadRenderPass(VK_NULL_HANDLE), dynamicRendering(device->GetCapabilities().dynamicRendering) {
 		// Check if the given settings are supported
 		if(!CheckSwapChainSettingsSupport(surface, device, settings))
 			throw Exception("Unsupported Vulkan swap chain settings!");
@@ -524,10 +645,14 @@ namespace wfe {
 	void VulkanSwapChain::RecreateSwapChain() {
 		// Destroy the old swap chain's components, if it exists
 		if(swapChain) {
+			// Wait for the device to finish every frame in flight, as they may still render to the old images
+			device->GetLoader()->vkDeviceWaitIdle(device->GetDevice());
+
 			// Destroy the swap chain's images
 			for(auto& swapChainImage : swapChainImages) {
-				// Destroy the framebuffer
-				device->GetLoader()->vkDestroyFramebuffer(device->GetDevice(), swapChainImage.framebuffer, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+				// Destroy the framebuffer, if it exists
+				if(swapChainImage.framebuffer)
+					device->GetLoader()->vkDestroyFramebuffer(device->GetDevice(), swapChainImage.framebuffer, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
 
 				// Destroy the depth image
 				device->GetLoader()->vkDestroyImageView(device->GetDevice(), swapChainImage.depthImageView, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
@@ -537,9 +662,6 @@ namespace wfe {
 				// Destroy the color image view
 				device->GetLoader()->vkDestroyImageView(device->GetDevice(), swapChainImage.imageView, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
 			}
-
-			// Destroy the render pass
-			device->GetLoader()->vkDestroyRenderPass(device->GetDevice(), renderPass, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
 		}
 
 		// Save the old swap chain
@@ -552,10 +674,11 @@ namespace wfe {
 		if(oldSwapChain)
 			device->GetLoader()->vkDestroySwapchainKHR(device->GetDevice(), oldSwapChain, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
 		
-		// Create the swap chain's components
+		// Create the swap chain's components, keeping the render pass, as it only depends on the swap chain's formats
 		GetSwapChainImageViews();
 		CreateSwapChainDepthImages();
-		CreateRenderPass();
+		if(!renderPass)
+			CreateRenderPass();
 		CreateFramebuffers();
 	}
 
@@ -564,6 +687,14 @@ namespace wfe {
 		if(!CheckSwapChainSettingsSupport(surface, device, newSettings))
 			return false;
 
+		// Destroy the render pass if the attachment formats changed
+		if(renderPass && (newSettings.imageFormat != settings.imageFormat || newSettings.depthFormat != settings.depthFormat)) {
+			device->GetLoader()->vkDestroyRenderPass(device->GetDevice(), renderPass, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+			device->GetLoader()->vkDestroyRenderPass(device->GetDevice(), loadRenderPass, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+			renderPass = VK_NULL_HANDLE;
+			loadRenderPass = VK_NULL_HANDLE;
+		}
+
 		// Set the new settings and recreate the swap chain
 		settings = newSettings;
 		RecreateSwapChain();
@@ -571,6 +702,53 @@ namespace wfe {
 		return true;
 	}
 
+	VkImageAspectFlags VulkanSwapChain::GetDepthImageAspectFlags() const {
+		return GetDepthAspectFlags(settings.depthFormat);
+	}
+
+	void VulkanSwapChain::BeginRendering(VkCommandBuffer commandBuffer, uint32_t imageIndex, const VkClearColorValue& clearColor, bool8_t transitionImages) {
+		// Begin rendering, clearing both attachments
+		RecordBeginRendering(commandBuffer, imageIndex, VK_ATTACHMENT_LOAD_OP_CLEAR, clearColor, transitionImages);
+	}
+	void VulkanSwapChain::ResumeRendering(VkCommandBuffer commandBuffer, uint32_t imageIndex) {
+		// Begin rendering, loading both attachments' previous contents
+		RecordBeginRendering(commandBuffer, imageIndex, VK_ATTACHMENT_LOAD_OP_LOAD, { { 0.f, 0.f, 0.f, 0.f } }, true);
+	}
+	void VulkanSwapChain::EndRendering(VkCommandBuffer commandBuffer, uint32_t imageIndex, bool8_t transitionImages) {
+		// End the render pass if dynamic rendering isn't used, as its final layout already transitions the image for presentation
+		if(!dynamicRendering) {
+			device->GetLoader()->vkCmdEndRenderPass(commandBuffer);
+			return;
+		}
+
+		// End rendering
+		if(device->GetCapabilities().apiVersion >= VK_API_VERSION_1_3) {
+			device->GetLoader()->vkCmdEndRendering(commandBuffer);
+		} else {
+			device->GetLoader()->vkCmdEndRenderingKHR(commandBuffer);
+		}
+
+		// Exit the function if the caller transitions the color image for presentation
+		if(!transitionImages)
+			return;
+
+		// Transition the color image for presentation
+		VkImageMemoryBarrier barrier {
+			.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+			.pNext = nullptr,
+			.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+			.dstAccessMask = 0,
+			.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+			.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+			.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+			.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+			.image = swapChainImages[imageIndex].image,
+			.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 }
+		};
+
+		device->GetLoader()->vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+	}
+
 	VulkanSwapChain::~VulkanSwapChain() {
 		// Remove the window resize event listener
 		surface->GetWindow()->GetResizeEvent().AddListener(Event::Listener(WindowResizeEventCallback, this));
@@ -579,8 +757,9 @@ namespace wfe {
 		if(swapChain) {
 			// Destroy the swap chain's images
 			for(auto& swapChainImage : swapChainImages) {
-				// Destroy the framebuffer
-				device->GetLoader()->vkDestroyFramebuffer(device->GetDevice(), swapChainImage.framebuffer, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+				// Destroy the framebuffer, if it exists
+				if(swapChainImage.framebuffer)
+					device->GetLoader()->vkDestroyFramebuffer(device->GetDevice(), swapChainImage.framebuffer, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
 
 				// Destroy the depth image
 				device->GetLoader()->vkDestroyImageView(device->GetDevice(), swapChainImage.depthImageView, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
@@ -591,11 +770,14 @@ namespace wfe {
 				device->GetLoader()->vkDestroyImageView(device->GetDevice(), swapChainImage.imageView, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
 			}
 
-			// Destroy the render pass
-			device->GetLoader()->vkDestroyRenderPass(device->GetDevice(), renderPass, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
-
 			// Destroy the swap chain
 			device->GetLoader()->vkDestroySwapchainKHR(device->GetDevice(), swapChain, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
 		}
+
+		// Destroy the render pass, if it exists
+		if(renderPass) {
+			device->GetLoader()->vkDestroyRenderPass(device->GetDevice(), renderPass, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+			device->GetLoader()->vkDestroyRenderPass(device->GetDevice(), loadRenderPass, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+		}
 	}
 }
\ No newline at end of file
@@ -38,7 +38,7 @@ namespace wfe {
 			VulkanAllocator::MemoryBlock depthImageMemory;
 			/// @brief The depth image's view.
 			VkImageView depthImageView;
-			/// @brief The swap chain image's framebuffer.
+			/// @brief The swap chain image's framebuffer, or VK_NULL_HANDLE if dynamic rendering is used.
 			VkFramebuffer framebuffer;
 		};
 
@@ -101,10 +101,40 @@ namespace wfe {
 			return swapChainImages;
 		}
 		/// @brief Gets the Vulkan render pass's handle.
-		/// @return The Vulkan render pass's handle.
+		/// @return The Vulkan render pass's handle, or VK_NULL_HANDLE if dynamic rendering is used.
 		VkRenderPass GetRenderPass() {
 			return renderPass;
 		}
+		/// @brief Checks if the swap chain renders using dynamic rendering instead of a render pass and framebuffers.
+		/// @return True if dynamic rendering is used, otherwise false.
+		bool8_t UsesDynamicRendering() const {
+			return dynamicRendering;
+		}
+		/// @brief Gets the rendering create info to chain into the graphics pipelines' create infos when dynamic rendering is used.
+		/// @return A const reference to the pipeline rendering create info, which only depends on the swap chain's attachment formats.
+		const VkPipelineRenderingCreateInfo& GetPipelineRenderingCreateInfo() const {
+			return pipelineRenderingInfo;
+		}
+
+		/// @brief Gets the aspects of the swap chain's depth images, which include the stencil aspect for combined depth stencil formats.
+		/// @return The depth images' aspect flags.
+		VkImageAspectFlags GetDepthImageAspectFlags() const;
+
+		/// @brief Begins rendering to the given swap chain image, clearing its color and depth attachments.
+		/// @param commandBuffer The command buffer to record the commands in.
+		/// @param imageIndex The index of the swap chain image to render to.
+		/// @param clearColor The color to clear the color attachment with.
+		/// @param transitionImages True if the attachments should be transitioned to their rendering layouts, or false if the caller already did, like a render graph. Ignored if dynamic rendering isn't used.
+		void BeginRendering(VkCommandBuffer commandBuffer, uint32_t imageIndex, const VkClearColorValue& clearColor, bool8_t transitionImages = true);
+		/// @brief Resumes rendering to the given swap chain image after it was ended, loading its color and depth attachments' previous contents. Used to draw the late culling phase after building the depth pyramid from the early phase's depth.
+		/// @param commandBuffer The command buffer to record the commands in.
+		/// @param imageIndex The index of the swap chain image to render to.
+		void ResumeRendering(VkCommandBuffer commandBuffer, uint32_t imageIndex);
+		/// @brief Ends rendering to the given swap chain image, transitioning it for presentation.
+		/// @param commandBuffer The command buffer to record the commands in.
+		/// @param imageIndex The index of the swap chain image rendered to.
+		/// @param transitionImages True if the color image should be transitioned for presentation, or false if the caller does it afterwards. Ignored if dynamic rendering isn't used.
+		void EndRendering(VkCommandBuffer commandBuffer, uint32_t imageIndex, bool8_t transitionImages = true);
 
 		/// @brief Destroys the Vulkan swap chain.
 		~VulkanSwapChain();
@@ -115,6 +145,7 @@ namespace wfe {
 		void CreateRenderPass();
 		void CreateFramebuffers();
 		void DestroySwapChain();
+		void RecordBeginRendering(VkCommandBuffer commandBuffer, uint32_t imageIndex, VkAttachmentLoadOp loadOp, const VkClearColorValue& clearColor, bool8_t transitionImages);
 
 		VulkanSurface* surface;
 		VulkanDevice* device;
@@ -125,5 +156,8 @@ namespace wfe {
 		VkSwapchainKHR swapChain;
 		vector<SwapChainImage> swapChainImages;
 		VkRenderPass renderPass;
+		VkRenderPass loadRenderPass;
+		bool8_t dynamicRendering;
+		VkPipelineRenderingCreateInfo pipelineRenderingInfo;
 	};
 }
\ No newline at end of file
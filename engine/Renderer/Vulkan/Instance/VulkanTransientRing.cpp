@@ -0,0 +1,103 @@
+#include "VulkanTransientRing.hpp"
+#include "Renderer/Vulkan/VulkanRenderer.hpp"
+
+#include <vulkan/vk_enum_string_helper.h>
+
+namespace wfe {
+	// Public functions
+	VulkanTransientRing::VulkanTransientRing(VulkanDevice* device, VulkanAllocator* allocator, VkDeviceSize capacity, VkBufferUsageFlags usage) : device(device), allocator(allocator), capacity(capacity), head(0), tail(0), allocatedSize(0), freedSize(0), currentFrame(0) {
+		// Set the buffer's create info
+		VkBufferCreateInfo createInfo {
+			.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.size = capacity,
+			.usage = usage,
+			.sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+			.queueFamilyIndexCount = 0,
+			.pQueueFamilyIndices = nullptr
+		};
+
+		// Create the buffer
+		VkResult result = device->GetLoader()->vkCreateBuffer(device->GetDevice(), &createInfo, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS, &buffer);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to create Vulkan transient ring buffer! Error code: %s", string_VkResult(result));
+
+		// Allocate, bind and map the buffer's memory
+		result = allocator->AllocBufferMemory(buffer, VulkanAllocator::MEMORY_TYPE_CPU_GPU_VISIBLE, memory);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to allocate Vulkan transient ring memory! Error code: %s", string_VkResult(result));
+
+		result = allocator->BindBufferMemories(1, &buffer, &memory);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to bind Vulkan transient ring memory! Error code: %s", string_VkResult(result));
+
+		void* data;
+		result = allocator->MapMemory(memory, data);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to map Vulkan transient ring memory! Error code: %s", string_VkResult(result));
+		mappedData = (uint8_t*)data;
+
+		// Mark every frame as having nothing to free
+		for(size_t i = 0; i != Renderer::MAX_FRAMES_IN_FLIGHT; ++i)
+			frameEnds[i] = { 0, 0 };
+	}
+
+	void* VulkanTransientRing::Allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset) {
+		// Rewind to the buffer's start if every allocation was freed, as the whole buffer is free and wrapping around would waste the space before the head
+		if(allocatedSize == freedSize) {
+			head = 0;
+			tail = 0;
+		}
+
+		VkDeviceSize alignedHead = (head + alignment - 1) & ~(alignment - 1);
+		VkDeviceSize newHead;
+
+		if(head > tail || allocatedSize == freedSize) {
+			// The free space is split between the buffer's end and start; wrap around if the range doesn't fit at the end
+			if(alignedHead + size <= capacity) {
+				offset = alignedHead;
+			} else if(size <= tail) {
+				offset = 0;
+			} else {
+				throw Exception("Exceeded the Vulkan transient ring's capacity of %llu bytes!", (unsigned long long)capacity);
+			}
+		} else {
+			// The free space is the gap between the head and the tail
+			if(alignedHead + size <= tail) {
+				offset = alignedHead;
+			} else {
+				throw Exception("Exceeded the Vulkan transient ring's capacity of %llu bytes!", (unsigned long long)capacity);
+			}
+		}
+
+		// Advance the head, counting any skipped padding as used until the frame is reset
+		newHead = offset + size;
+		if(newHead > head) {
+			allocatedSize += newHead - head;
+		} else {
+			allocatedSize += capacity - head + newHead;
+		}
+		head = newHead;
+
+		return mappedData + offset;
+	}
+	void VulkanTransientRing::ResetFrame(size_t frameIndex) {
+		// Save where the current frame's allocations end
+		frameEnds[currentFrame] = { head, allocatedSize };
+
+		// Free everything up to the end of the given frame's previous allocations, as the frames are reset in submission order
+		if(frameEnds[frameIndex].allocatedSize > freedSize) {
+			tail = frameEnds[frameIndex].head;
+			freedSize = frameEnds[frameIndex].allocatedSize;
+		}
+
+		currentFrame = frameIndex;
+	}
+
+	VulkanTransientRing::~VulkanTransientRing() {
+		// Destroy the buffer and free its memory
+		device->GetLoader()->vkDestroyBuffer(device->GetDevice(), buffer, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+		allocator->FreeMemory(memory);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Renderer/Renderer.hpp"
+#include "Renderer/Vulkan/Instance/VulkanAllocator.hpp"
+#include "Renderer/Vulkan/Instance/VulkanDevice.hpp"
+
+#include <Core.hpp>
+#include <vulkan/vk_platform.h>
+#include <vulkan/vulkan_core.h>
+
+namespace wfe {
+	/// @brief A persistently mapped ring buffer for per-frame data written by the CPU and read by the GPU. Every allocation stays valid until the frame it was made in is reset again.
+	class VulkanTransientRing {
+	public:
+		/// @brief Creates a Vulkan transient ring.
+		/// @param device The Vulkan device to create the ring's buffer for.
+		/// @param allocator The allocator used to allocate the ring's memory.
+		/// @param capacity The size of the ring's buffer, in bytes.
+		/// @param usage The usage flags of the ring's buffer, which determine what its allocations can be bound as.
+		VulkanTransientRing(VulkanDevice* device, VulkanAllocator* allocator, VkDeviceSize capacity, VkBufferUsageFlags usage);
+		VulkanTransientRing(const VulkanTransientRing&) = delete;
+		VulkanTransientRing(VulkanTransientRing&&) noexcept = delete;
+
+		VulkanTransientRing& operator=(const VulkanTransientRing&) = delete;
+		VulkanTransientRing& operator=(VulkanTransientRing&&) = delete;
+
+		/// @brief Gets the Vulkan function loader used by the ring.
+		/// @return A pointer to the Vulkan loader used by the ring.
+		const VulkanLoader* GetLoader() const {
+			return device->GetLoader();
+		}
+		/// @brief Gets the Vulkan device that owns the ring.
+		/// @return A pointer to the Vulkan device wrapper object.
+		VulkanDevice* GetDevice() {
+			return device;
+		}
+		/// @brief Gets the Vulkan device that owns the ring.
+		/// @return A const pointer to the Vulkan device wrapper object.
+		const VulkanDevice* GetDevice() const {
+			return device;
+		}
+		/// @brief Gets the ring's buffer, which every allocation is a range of.
+		/// @return A handle to the Vulkan buffer.
+		VkBuffer GetBuffer() {
+			return buffer;
+		}
+		/// @brief Gets the size of the ring's buffer.
+		/// @return The ring's capacity, in bytes.
+		VkDeviceSize GetCapacity() const {
+			return capacity;
+		}
+		/// @brief Gets the number of bytes used by the frames in flight, including the padding skipped when wrapping around.
+		/// @return The ring's used size, in bytes.
+		VkDeviceSize GetUsedSize() const {
+			return allocatedSize - freedSize;
+		}
+
+		/// @brief Allocates a range of the ring's buffer for the current frame.
+		/// @param size The size of the range, in bytes.
+		/// @param alignment The required alignment of the range's offset, which must be a power of two.
+		/// @param offset A reference to the variable in which the range's offset in the buffer will be written.
+		/// @return A pointer to the range's mapped memory.
+		void* Allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset);
+		/// @brief Frees the allocations of the given frame's previous use and makes it the current frame. Must only be called after the frame's fence was signaled.
+		/// @param frameIndex The index of the frame in flight to reset.
+		void ResetFrame(size_t frameIndex);
+
+		/// @brief Destroys the Vulkan transient ring.
+		~VulkanTransientRing();
+	private:
+		struct FrameEnd {
+			VkDeviceSize head;
+			VkDeviceSize allocatedSize;
+		};
+
+		VulkanDevice* device;
+		VulkanAllocator* allocator;
+
+		VkDeviceSize capacity;
+		VkBuffer buffer;
+		VulkanAllocator::MemoryBlock memory;
+		uint8_t* mappedData;
+
+		VkDeviceSize head;
+		VkDeviceSize tail;
+		VkDeviceSize allocatedSize;
+		VkDeviceSize freedSize;
+		FrameEnd frameEnds[Renderer::MAX_FRAMES_IN_FLIGHT];
+		size_t currentFrame;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,343 @@
+#include "VulkanPipelineVariantCache.hpp"
+#include "General/HeapMemory.hpp"
+#include "Renderer/Vulkan/VulkanRenderer.hpp"
+
+#include <stdio.h>
+#include <vulkan/vk_enum_string_helper.h>
+
+namespace wfe {
+	// Internal helper functions
+	static void* ReadFile(const char_t* path, size_t& size) {
+		// Open the file
+		FILE* file = fopen(path, "rb");
+		if(!file)
+			return nullptr;
+
+		// Get the file's size
+		fseek(file, 0, SEEK_END);
+		long fileSize = ftell(file);
+		fseek(file, 0, SEEK_SET);
+
+		if(fileSize <= 0) {
+			fclose(file);
+			return nullptr;
+		}
+		size = (size_t)fileSize;
+
+		// Read the file's contents, leaving room for a null terminator so that text files can be parsed in place
+		PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
+		void* data = AllocHeapMemory(size + 1);
+		PopMemoryUsageType();
+		if(!data) {
+			fclose(file);
+			throw BadAllocException("Failed to allocate file contents buffer!");
+		}
+
+		if(fread(data, 1, size, file) != size) {
+			FreeMemory(data);
+			fclose(file);
+			return nullptr;
+		}
+		((char_t*)data)[size] = 0;
+
+		// Close the file
+		fclose(file);
+
+		return data;
+	}
+	static bool8_t IsPipelineCacheCompatible(const void* data, size_t size, const VkPhysicalDeviceProperties& properties) {
+		// Check if the data is large enough to contain the header
+		if(size < sizeof(VkPipelineCacheHeaderVersionOne))
+			return false;
+
+		// Check if the cache was created for the same device and driver
+		const VkPipelineCacheHeaderVersionOne* header = (const VkPipelineCacheHeaderVersionOne*)data;
+		return header->headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE && header->vendorID == properties.vendorID && header->deviceID == properties.deviceID && !memcmp(header->pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+	}
+
+	uint32_t VulkanPipelineVariantCache::RegisterBasePipeline(const char_t* name, const VkGraphicsPipelineCreateInfo* graphicsCreateInfo, const VkComputePipelineCreateInfo* computeCreateInfo) {
+		// Check if another base pipeline has the same name
+		if(FindBasePipeline(name) != UINT32_T_MAX)
+			throw Exception("Vulkan base pipeline \"%s\" was already registered!", name);
+
+		// Check if there is room for another base pipeline
+		if(basePipelines.size() == MAX_BASE_PIPELINE_COUNT)
+			throw Exception("Exceeded the maximum of %u Vulkan base pipelines!", MAX_BASE_PIPELINE_COUNT);
+
+		// Add the base pipeline
+		basePipelines.push_back({ name, graphicsCreateInfo, computeCreateInfo });
+
+		return (uint32_t)basePipelines.size() - 1;
+	}
+
+	// Public functions
+	VulkanPipelineVariantCache::VulkanPipelineVariantCache(VulkanDevice* device, const char_t* pipelineCachePath) : device(device), pipelineCachePath(pipelineCachePath) {
+		// Try to load the on-disk pipeline cache
+		size_t cacheSize = 0;
+		void* cacheData = ReadFile(pipelineCachePath, cacheSize);
+
+		// Discard the loaded data if it was created by a different device or driver
+		if(cacheData && !IsPipelineCacheCompatible(cacheData, cacheSize, device->GetDeviceProperties())) {
+			FreeMemory(cacheData);
+			cacheData = nullptr;
+			cacheSize = 0;
+		}
+
+		// Set the pipeline cache's create info
+		VkPipelineCacheCreateInfo createInfo {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.initialDataSize = cacheSize,
+			.pInitialData = cacheData
+		};
+
+		// Create the pipeline cache
+		VkResult result = device->GetLoader()->vkCreatePipelineCache(device->GetDevice(), &createInfo, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS, &pipelineCache);
+
+		// Free the loaded data
+		if(cacheData)
+			FreeMemory(cacheData);
+
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to create Vulkan pipeline cache! Error code: %s", string_VkResult(result));
+	}
+
+	uint32_t VulkanPipelineVariantCache::RegisterGraphicsPipeline(const char_t* name, const VkGraphicsPipelineCreateInfo* createInfo) {
+		// Check if the pipeline's stage count is supported
+		if(createInfo->stageCount > MAX_STAGE_COUNT)
+			throw Exception("Vulkan base pipeline \"%s\" exceeds the maximum of %u stages!", name, MAX_STAGE_COUNT);
+
+		return RegisterBasePipeline(name, createInfo, nullptr);
+	}
+	uint32_t VulkanPipelineVariantCache::RegisterComputePipeline(const char_t* name, const VkComputePipelineCreateInfo* createInfo) {
+		return RegisterBasePipeline(name, nullptr, createInfo);
+	}
+	uint32_t VulkanPipelineVariantCache::FindBasePipeline(const char_t* name) const {
+		// Look for a base pipeline with the given name
+		for(size_t i = 0; i != basePipelines.size(); ++i)
+			if(!strcmp(basePipelines[i].name.c_str(), name))
+				return (uint32_t)i;
+
+		return UINT32_T_MAX;
+	}
+
+	VkPipeline VulkanPipelineVariantCache::GetPipeline(VariantKey variantKey) {
+		// Return the variant if it was already created
+		auto variantIter = variants.find(variantKey);
+		if(variantIter != variants.end())
+			return variantIter->second;
+
+		// Get the variant's base pipeline
+		uint32_t basePipelineIndex = (uint32_t)(variantKey >> MAX_FEATURE_COUNT);
+		if(basePipelineIndex >= basePipelines.size())
+			throw Exception("Invalid Vulkan base pipeline index %u!", basePipelineIndex);
+
+		const BasePipeline& basePipeline = basePipelines[basePipelineIndex];
+
+		// Set every feature's specialization constant; map entries for IDs not used by a stage are ignored by Vulkan
+		VkBool32 featureValues[MAX_FEATURE_COUNT];
+		VkSpecializationMapEntry mapEntries[MAX_FEATURE_COUNT];
+
+		for(uint32_t i = 0; i != MAX_FEATURE_COUNT; ++i) {
+			featureValues[i] = (VkBool32)((variantKey >> i) & 1);
+			mapEntries[i].constantID = i;
+			mapEntries[i].offset = i * sizeof(VkBool32);
+			mapEntries[i].size = sizeof(VkBool32);
+		}
+
+		VkSpecializationInfo specializationInfo {
+			.mapEntryCount = MAX_FEATURE_COUNT,
+			.pMapEntries = mapEntries,
+			.dataSize = sizeof(featureValues),
+			.pData = featureValues
+		};
+
+		// Create the variant based on the base pipeline's type
+		VkPipeline pipeline;
+		VkResult result;
+
+		if(basePipeline.graphicsCreateInfo) {
+			// Copy the base pipeline's stages and set their specialization info
+			VkPipelineShaderStageCreateInfo stages[MAX_STAGE_COUNT];
+			for(uint32_t i = 0; i != basePipeline.graphicsCreateInfo->stageCount; ++i) {
+				stages[i] = basePipeline.graphicsCreateInfo->pStages[i];
+				stages[i].pSpecializationInfo = &specializationInfo;
+			}
+
+			// Copy the base pipeline's create info and create the variant
+			VkGraphicsPipelineCreateInfo createInfo = *basePipeline.graphicsCreateInfo;
+			createInfo.pStages = stages;
+
+			result = device->GetLoader()->vkCreateGraphicsPipelines(device->GetDevice(), pipelineCache, 1, &createInfo, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS, &pipeline);
+		} else {
+			// Copy the base pipeline's create info, set its stage's specialization info and create the variant
+			VkComputePipelineCreateInfo createInfo = *basePipeline.computeCreateInfo;
+			createInfo.stage.pSpecializationInfo = &specializationInfo;
+
+			result = device->GetLoader()->vkCreateComputePipelines(device->GetDevice(), pipelineCache, 1, &createInfo, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS, &pipeline);
+		}
+
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to create Vulkan pipeline variant! Error code: %s", string_VkResult(result));
+
+		// Add the variant to the map
+		variants.insert({ variantKey, pipeline });
+
+		return pipeline;
+	}
+	size_t VulkanPipelineVariantCache::PrecompileManifest(const char_t* manifestPath) {
+		// Read the manifest's contents
+		size_t manifestSize = 0;
+		char_t* manifest = (char_t*)ReadFile(manifestPath, manifestSize);
+		if(!manifest)
+			throw Exception("Failed to read Vulkan pipeline variant manifest \"%s\"!", manifestPath);
+
+		// Parse every line in the manifest
+		size_t variantCount = 0;
+		size_t lineIndex = 0;
+		char_t* manifestEnd = manifest + manifestSize;
+
+		for(char_t* line = manifest; line < manifestEnd;) {
+			++lineIndex;
+
+			// Find the line's end and terminate the line; the manifest's buffer has room for the last line's terminator
+			char_t* lineEnd = line;
+			while(lineEnd != manifestEnd && *lineEnd != '\n')
+				++lineEnd;
+
+			char_t* nextLine = lineEnd + 1;
+			if(lineEnd != line && *(lineEnd - 1) == '\r')
+				--lineEnd;
+			*lineEnd = 0;
+
+			// Skip leading whitespace
+			while(line != lineEnd && (*line == ' ' || *line == '\t'))
+				++line;
+
+			// Skip empty and comment lines
+			if(line == lineEnd || *line == '#') {
+				line = nextLine;
+				continue;
+			}
+
+			// Find the base pipeline name's end and skip the whitespace after it
+			char_t* nameEnd = line;
+			while(nameEnd != lineEnd && *nameEnd != ' ' && *nameEnd != '\t')
+				++nameEnd;
+
+			char_t* maskBegin = nameEnd;
+			while(maskBegin != lineEnd && (*maskBegin == ' ' || *maskBegin == '\t'))
+				++maskBegin;
+
+			// Trim the whitespace after the mask
+			char_t* maskEnd = lineEnd;
+			while(maskEnd != maskBegin && (*(maskEnd - 1) == ' ' || *(maskEnd - 1) == '\t'))
+				--maskEnd;
+
+			// Skip the mask's optional hexadecimal prefix
+			if(maskEnd - maskBegin > 2 && maskBegin[0] == '0' && (maskBegin[1] == 'x' || maskBegin[1] == 'X'))
+				maskBegin += 2;
+
+			// Parse the hexadecimal feature mask, rejecting masks wider than the supported feature count
+			uint64_t featureMask = 0;
+			bool8_t maskValid = maskBegin != maskEnd;
+
+			for(char_t* digit = maskBegin; maskValid && digit != maskEnd; ++digit) {
+				uint64_t digitValue;
+				if(*digit >= '0' && *digit <= '9') {
+					digitValue = (uint64_t)(*digit - '0');
+				} else if(*digit >= 'a' && *digit <= 'f') {
+					digitValue = (uint64_t)(*digit - 'a' + 10);
+				} else if(*digit >= 'A' && *digit <= 'F') {
+					digitValue = (uint64_t)(*digit - 'A' + 10);
+				} else {
+					maskValid = false;
+					break;
+				}
+
+				featureMask = (featureMask << 4) | digitValue;
+				if(featureMask >> MAX_FEATURE_COUNT)
+					maskValid = false;
+			}
+
+			if(!maskValid) {
+				FreeMemory(manifest);
+				throw Exception("Vulkan pipeline variant manifest \"%s\" line %zu has an invalid feature mask! Masks must be hexadecimal and at most %u bits wide.", manifestPath, lineIndex, MAX_FEATURE_COUNT);
+			}
+
+			// Terminate the name and find the base pipeline
+			*nameEnd = 0;
+
+			uint32_t basePipelineIndex = FindBasePipeline(line);
+			if(basePipelineIndex == UINT32_T_MAX) {
+				// Format the exception before freeing the manifest, as the name points inside it
+				Exception exception("Vulkan pipeline variant manifest \"%s\" line %zu references unknown base pipeline \"%s\"!", manifestPath, lineIndex, line);
+				FreeMemory(manifest);
+				throw exception;
+			}
+
+			// Create the variant
+			GetPipeline(CreateVariantKey(basePipelineIndex, featureMask));
+			++variantCount;
+
+			// Move on to the next line
+			line = nextLine;
+		}
+
+		// Free the manifest's contents
+		FreeMemory(manifest);
+
+		// Persist the warmed up pipeline cache
+		SavePipelineCache();
+
+		return variantCount;
+	}
+	bool8_t VulkanPipelineVariantCache::SavePipelineCache() {
+		// Get the pipeline cache's data size
+		size_t cacheSize;
+		VkResult result = device->GetLoader()->vkGetPipelineCacheData(device->GetDevice(), pipelineCache, &cacheSize, nullptr);
+		if(result != VK_SUCCESS || !cacheSize)
+			return false;
+
+		// Get the pipeline cache's data
+		PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
+		void* cacheData = AllocHeapMemory(cacheSize);
+		PopMemoryUsageType();
+		if(!cacheData)
+			throw BadAllocException("Failed to allocate Vulkan pipeline cache data buffer!");
+
+		result = device->GetLoader()->vkGetPipelineCacheData(device->GetDevice(), pipelineCache, &cacheSize, cacheData);
+		if(result != VK_SUCCESS) {
+			FreeMemory(cacheData);
+			return false;
+		}
+
+		// Write the data to the cache's file
+		FILE* file = fopen(pipelineCachePath.c_str(), "wb");
+		if(!file) {
+			FreeMemory(cacheData);
+			return false;
+		}
+
+		bool8_t written = fwrite(cacheData, 1, cacheSize, file) == cacheSize;
+
+		// Close the file and free the data
+		fclose(file);
+		FreeMemory(cacheData);
+
+		return written;
+	}
+
+	VulkanPipelineVariantCache::~VulkanPipelineVariantCache() {
+		// Save the pipeline cache
+		SavePipelineCache();
+
+		// Destroy every variant
+		for(auto& variantPair : variants)
+			device->GetLoader()->vkDestroyPipeline(device->GetDevice(), variantPair.second, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+
+		// Destroy the pipeline cache
+		device->GetLoader()->vkDestroyPipelineCache(device->GetDevice(), pipelineCache, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+	}
+}
\ No newline at end of file
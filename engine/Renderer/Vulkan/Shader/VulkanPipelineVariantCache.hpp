@@ -0,0 +1,124 @@
+#pragma once
+
+#include "Renderer/Vulkan/Instance/VulkanDevice.hpp"
+
+#include <Core.hpp>
+#include <vulkan/vk_platform.h>
+#include <vulkan/vulkan_core.h>
+
+namespace wfe {
+	/// @brief A cache of pipeline variants, specialized from registered base pipelines using boolean specialization constants.
+	class VulkanPipelineVariantCache {
+	public:
+		/// @brief A 64-bit key identifying a pipeline variant. The low 48 bits contain the enabled feature mask, while the high 16 bits contain the base pipeline's index.
+		typedef uint64_t VariantKey;
+
+		/// @brief The maximum number of feature toggles a base pipeline can have.
+		static const uint32_t MAX_FEATURE_COUNT = 48;
+		/// @brief The maximum number of base pipelines the cache can hold.
+		static const uint32_t MAX_BASE_PIPELINE_COUNT = 1 << 16;
+		/// @brief The maximum number of shader stages a base pipeline can have.
+		static const uint32_t MAX_STAGE_COUNT = 8;
+
+		/// @brief Feature toggles shared by all engine materials. Feature N is read in shaders from the bool specialization constant with constant_id = N.
+		enum Feature : uint32_t {
+			/// @brief The vertices are skinned using bone matrices.
+			FEATURE_SKINNED = 0,
+			/// @brief Fragments below the alpha threshold are discarded.
+			FEATURE_ALPHA_TEST = 1,
+			/// @brief The pipeline renders depth only for a shadow pass.
+			FEATURE_SHADOW_PASS = 2,
+			/// @brief The first feature index free to be used by specific materials.
+			FEATURE_CUSTOM_BEGIN = 3
+		};
+
+		/// @brief Creates a variant key from the given base pipeline index and feature mask.
+		/// @param basePipelineIndex The base pipeline's index, as returned on registration.
+		/// @param featureMask A bitmask of the enabled features.
+		/// @return The resulting variant key.
+		static constexpr VariantKey CreateVariantKey(uint32_t basePipelineIndex, uint64_t featureMask) {
+			return ((VariantKey)basePipelineIndex << MAX_FEATURE_COUNT) | (featureMask & ((1ull << MAX_FEATURE_COUNT) - 1));
+		}
+
+		/// @brief Creates a Vulkan pipeline variant cache.
+		/// @param device The Vulkan device to create the pipelines for.
+		/// @param pipelineCachePath The path of the on-disk pipeline cache, which will be loaded if valid and saved when the variant cache is destroyed.
+		VulkanPipelineVariantCache(VulkanDevice* device, const char_t* pipelineCachePath);
+		VulkanPipelineVariantCache(const VulkanPipelineVariantCache&) = delete;
+		VulkanPipelineVariantCache(VulkanPipelineVariantCache&&) noexcept = delete;
+
+		VulkanPipelineVariantCache& operator=(const VulkanPipelineVariantCache&) = delete;
+		VulkanPipelineVariantCache& operator=(VulkanPipelineVariantCache&&) = delete;
+
+		/// @brief Gets the Vulkan function loader used by the variant cache.
+		/// @return A pointer to the Vulkan loader used by the variant cache.
+		const VulkanLoader* GetLoader() const {
+			return device->GetLoader();
+		}
+		/// @brief Gets the Vulkan device that owns the variant cache.
+		/// @return A pointer to the Vulkan device wrapper object.
+		VulkanDevice* GetDevice() {
+			return device;
+		}
+		/// @brief Gets the Vulkan device that owns the variant cache.
+		/// @return A const pointer to the Vulkan device wrapper object.
+		const VulkanDevice* GetDevice() const {
+			return device;
+		}
+		/// @brief Gets the Vulkan pipeline cache used when creating variants.
+		/// @return A handle to the Vulkan pipeline cache.
+		VkPipelineCache GetPipelineCache() {
+			return pipelineCache;
+		}
+		/// @brief Gets the number of pipeline variants created so far.
+		/// @return The number of pipeline variants.
+		size_t GetVariantCount() const {
+			return variants.size();
+		}
+
+		/// @brief Registers a base graphics pipeline whose variants can be requested.
+		/// @param name The base pipeline's unique name, used by variant manifests.
+		/// @param createInfo The base pipeline's create info. It must remain valid for the variant cache's lifetime, and its stages must not have their own specialization info.
+		/// @return The base pipeline's index.
+		uint32_t RegisterGraphicsPipeline(const char_t* name, const VkGraphicsPipelineCreateInfo* createInfo);
+		/// @brief Registers a base compute pipeline whose variants can be requested.
+		/// @param name The base pipeline's unique name, used by variant manifests.
+		/// @param createInfo The base pipeline's create info. It must remain valid for the variant cache's lifetime, and its stage must not have its own specialization info.
+		/// @return The base pipeline's index.
+		uint32_t RegisterComputePipeline(const char_t* name, const VkComputePipelineCreateInfo* createInfo);
+		/// @brief Finds the index of the base pipeline with the given name.
+		/// @param name The base pipeline's name.
+		/// @return The base pipeline's index, or UINT32_T_MAX if no base pipeline has the given name.
+		uint32_t FindBasePipeline(const char_t* name) const;
+
+		/// @brief Gets the pipeline variant with the given key, creating it if it doesn't exist.
+		/// @param variantKey The key of the wanted variant.
+		/// @return A handle to the Vulkan pipeline variant.
+		VkPipeline GetPipeline(VariantKey variantKey);
+		/// @brief Creates every variant listed in the given manifest, warming up the pipeline cache.
+		/// @param manifestPath The path of the manifest. Every line contains a base pipeline's name followed by a hexadecimal feature mask of at most 48 bits, with lines starting with '#' ignored. Malformed lines throw an exception naming the line.
+		/// @return The number of variants listed in the manifest.
+		size_t PrecompileManifest(const char_t* manifestPath);
+		/// @brief Saves the pipeline cache's data to its on-disk file.
+		/// @return True if the cache was saved successfully, otherwise false.
+		bool8_t SavePipelineCache();
+
+		/// @brief Destroys the Vulkan pipeline variant cache, saving the pipeline cache and destroying all variants.
+		~VulkanPipelineVariantCache();
+	private:
+		struct BasePipeline {
+			string name;
+			const VkGraphicsPipelineCreateInfo* graphicsCreateInfo;
+			const VkComputePipelineCreateInfo* computeCreateInfo;
+		};
+
+		uint32_t RegisterBasePipeline(const char_t* name, const VkGraphicsPipelineCreateInfo* graphicsCreateInfo, const VkComputePipelineCreateInfo* computeCreateInfo);
+
+		VulkanDevice* device;
+		string pipelineCachePath;
+		VkPipelineCache pipelineCache;
+
+		vector<BasePipeline> basePipelines;
+		unordered_map<VariantKey, VkPipeline> variants;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,396 @@
+#include "VulkanShaderLibrary.hpp"
+#include "Renderer/Vulkan/VulkanRenderer.hpp"
+#include "General/Hash.hpp"
+#include "General/HeapMemory.hpp"
+
+#if defined(WFE_PLATFORM_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(WFE_PLATFORM_LINUX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <vulkan/vk_enum_string_helper.h>
+
+namespace wfe {
+	// Constants
+	static const char_t SHADER_EXTENSION[] = ".spv";
+	static const uint32_t MAX_SET_BINDING_COUNT = 64;
+
+	// Internal structs
+	struct MappedFile {
+		const void* data;
+		size_t size;
+#if defined(WFE_PLATFORM_WINDOWS)
+		HANDLE file;
+		HANDLE mapping;
+#endif
+	};
+
+	// Internal helper functions
+	static bool8_t MapFile(const char_t* path, MappedFile& mappedFile) {
+#if defined(WFE_PLATFORM_WINDOWS)
+		// Open the file
+		mappedFile.file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if(mappedFile.file == INVALID_HANDLE_VALUE)
+			return false;
+
+		// Get the file's size
+		LARGE_INTEGER fileSize;
+		if(!GetFileSizeEx(mappedFile.file, &fileSize) || !fileSize.QuadPart) {
+			CloseHandle(mappedFile.file);
+			return false;
+		}
+		mappedFile.size = (size_t)fileSize.QuadPart;
+
+		// Create the file's mapping and map its view
+		mappedFile.mapping = CreateFileMappingA(mappedFile.file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if(!mappedFile.mapping) {
+			CloseHandle(mappedFile.file);
+			return false;
+		}
+
+		mappedFile.data = MapViewOfFile(mappedFile.mapping, FILE_MAP_READ, 0, 0, 0);
+		if(!mappedFile.data) {
+			CloseHandle(mappedFile.mapping);
+			CloseHandle(mappedFile.file);
+			return false;
+		}
+
+		return true;
+#elif defined(WFE_PLATFORM_LINUX)
+		// Open the file
+		int32_t file = open(path, O_RDONLY);
+		if(file == -1)
+			return false;
+
+		// Get the file's size
+		struct stat fileStats;
+		if(fstat(file, &fileStats) == -1 || !fileStats.st_size) {
+			close(file);
+			return false;
+		}
+		mappedFile.size = (size_t)fileStats.st_size;
+
+		// Map the file's contents; the mapping stays valid after the file is closed
+		void* data = mmap(nullptr, mappedFile.size, PROT_READ, MAP_PRIVATE, file, 0);
+		close(file);
+		if(data == MAP_FAILED)
+			return false;
+
+		mappedFile.data = data;
+
+		return true;
+#endif
+	}
+	static void UnmapFile(MappedFile& mappedFile) {
+#if defined(WFE_PLATFORM_WINDOWS)
+		// Unmap the file's view and close its handles
+		UnmapViewOfFile(mappedFile.data);
+		CloseHandle(mappedFile.mapping);
+		CloseHandle(mappedFile.file);
+#elif defined(WFE_PLATFORM_LINUX)
+		// Unmap the file's contents
+		munmap((void*)mappedFile.data, mappedFile.size);
+#endif
+	}
+
+	// Public functions
+	VulkanShaderLibrary::VulkanShaderLibrary(VulkanDevice* device, VulkanDescriptorLayoutCache* layoutCache, VulkanBindlessHeap* bindlessHeap, const char_t* shaderDirectory) : device(device), layoutCache(layoutCache), bindlessHeap(bindlessHeap), shaderDirectory(shaderDirectory), shaderModuleCount(0) { }
+
+	const VulkanShaderLibrary::ShaderModule* VulkanShaderLibrary::GetShaderModule(const char_t* name) {
+		// Return the shader module if it was already requested under the same name
+		size_t nameLength = strlen(name);
+		uint64_t nameHash = ComputeFNV1aHash(name, nameLength);
+
+		NamedShaderModule* collidingNamedModules = nullptr;
+		auto namedModuleIter = namedShaderModules.find(nameHash);
+		if(namedModuleIter != namedShaderModules.end()) {
+			for(NamedShaderModule* namedModule = namedModuleIter->second; namedModule; namedModule = namedModule->nextCollision)
+				if(!strcmp(namedModule->name.c_str(), name))
+					return &namedModule->shaderModule->shaderModule;
+
+			collidingNamedModules = namedModuleIter->second;
+		}
+
+		// Set the shader's full path
+		size_t directoryLength = shaderDirectory.size();
+		size_t pathLength = directoryLength + 1 + nameLength + sizeof(SHADER_EXTENSION);
+
+		PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
+		char_t* path = (char_t*)AllocHeapMemory(pathLength);
+		PopMemoryUsageType();
+		if(!path)
+			throw BadAllocException("Failed to allocate Vulkan shader path string!");
+
+		memcpy(path, shaderDirectory.c_str(), directoryLength);
+		path[directoryLength] = '/';
+		memcpy(path + directoryLength + 1, name, nameLength);
+		memcpy(path + directoryLength + 1 + nameLength, SHADER_EXTENSION, sizeof(SHADER_EXTENSION));
+
+		// Map the shader's file
+		MappedFile mappedFile;
+		if(!MapFile(path, mappedFile)) {
+			FreeMemory(path);
+			throw Exception("Failed to map Vulkan shader file \"%s\"!", name);
+		}
+		FreeMemory(path);
+
+		// Hash the shader's code and size and check if an identical shader module was already loaded, comparing the code of every module with the same hash
+		uint64_t codeHash = ComputeFNV1aHash(mappedFile.data, mappedFile.size);
+		codeHash = ComputeFNV1aHash(&mappedFile.size, sizeof(size_t), codeHash);
+
+		LoadedShaderModule* shaderModule = nullptr;
+		LoadedShaderModule* collidingModules = nullptr;
+		auto moduleIter = shaderModules.find(codeHash);
+		if(moduleIter != shaderModules.end()) {
+			for(shaderModule = moduleIter->second; shaderModule; shaderModule = shaderModule->nextCollision)
+				if(shaderModule->shaderModule.codeSize == mappedFile.size && !memcmp(shaderModule->code.data(), mappedFile.data, mappedFile.size))
+					break;
+
+			collidingModules = moduleIter->second;
+		}
+
+		if(shaderModule) {
+			// Unmap the shader's file, as the existing shader module will be aliased under the current name
+			UnmapFile(mappedFile);
+		} else {
+			// Create the new shader module's info
+			PushMemoryUsageType(MEMORY_USAGE_TYPE_RENDERER);
+			shaderModule = NewObject<LoadedShaderModule>();
+			PopMemoryUsageType();
+
+			shaderModule->shaderModule.codeHash = codeHash;
+			shaderModule->shaderModule.codeSize = mappedFile.size;
+
+			// Reflect the shader's code
+			if(!VulkanShaderReflection::Reflect(mappedFile.size, (const uint32_t*)mappedFile.data, shaderModule->shaderModule.reflection)) {
+				UnmapFile(mappedFile);
+				DestroyObject(shaderModule);
+				throw Exception("Failed to reflect Vulkan shader \"%s\"! The file does not contain valid SPIR-V code.", name);
+			}
+
+			// Set the shader module's create info
+			VkShaderModuleCreateInfo createInfo {
+				.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+				.pNext = nullptr,
+				.flags = 0,
+				.codeSize = mappedFile.size,
+				.pCode = (const uint32_t*)mappedFile.data
+			};
+
+			// Create the shader module
+			VkResult result = device->GetLoader()->vkCreateShaderModule(device->GetDevice(), &createInfo, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS, &shaderModule->shaderModule.shaderModule);
+			if(result != VK_SUCCESS) {
+				UnmapFile(mappedFile);
+				DestroyObject(shaderModule);
+				throw Exception("Failed to create Vulkan shader module! Error code: %s", string_VkResult(result));
+			}
+
+			// Keep a copy of the code to tell apart later shaders with the same hash, then unmap the file
+			shaderModule->code.resize((mappedFile.size + 3) >> 2);
+			memcpy(shaderModule->code.data(), mappedFile.data, mappedFile.size);
+			UnmapFile(mappedFile);
+
+			// Add the shader module to the code map, chaining it to the modules with the same hash
+			shaderModule->nextCollision = collidingModules;
+			if(collidingModules) {
+				moduleIter->second = shaderModule;
+			} else {
+				shaderModules.insert({ codeHash, shaderModule });
+			}
+			++shaderModuleCount;
+		}
+
+		// Add the shader module to the name map, chaining it to the names with the same hash
+		PushMemoryUsageType(MEMORY_USAGE_TYPE_RENDERER);
+		NamedShaderModule* namedModule = NewObject<NamedShaderModule>();
+		PopMemoryUsageType();
+
+		namedModule->name = name;
+		namedModule->shaderModule = shaderModule;
+		namedModule->nextCollision = collidingNamedModules;
+		if(collidingNamedModules) {
+			namedModuleIter->second = namedModule;
+		} else {
+			namedShaderModules.insert({ nameHash, namedModule });
+		}
+
+		return &shaderModule->shaderModule;
+	}
+	const VulkanShaderLibrary::PipelineLayout* VulkanShaderLibrary::GetPipelineLayout(size_t shaderModuleCount, const ShaderModule* const* shaderModules) {
+		// Merge every shader module's bindings and push constant ranges
+		VkDescriptorSetLayoutBinding setBindings[MAX_DESCRIPTOR_SET_COUNT][MAX_SET_BINDING_COUNT];
+		uint32_t setBindingCounts[MAX_DESCRIPTOR_SET_COUNT] {};
+		bool8_t bindlessSets[MAX_DESCRIPTOR_SET_COUNT] {};
+		uint32_t setCount = 0;
+
+		VkPushConstantRange pushConstantRanges[MAX_PUSH_CONSTANT_RANGE_COUNT];
+		uint32_t pushConstantRangeCount = 0;
+
+		for(size_t i = 0; i != shaderModuleCount; ++i) {
+			const VulkanShaderReflection& reflection = shaderModules[i]->reflection;
+
+			// Add the shader module's bindings
+			for(const auto& binding : reflection.bindings) {
+				// Check if the binding's set is supported
+				if(binding.set >= MAX_DESCRIPTOR_SET_COUNT)
+					throw Exception("Vulkan shader uses descriptor set %u, exceeding the maximum of %u sets!", binding.set, MAX_DESCRIPTOR_SET_COUNT);
+				if(binding.set >= setCount)
+					setCount = binding.set + 1;
+
+				// Mark the binding's set as bindless if the binding is a runtime array
+				if(!binding.descriptorCount)
+					bindlessSets[binding.set] = true;
+
+				// Check if the binding was already added by a previous stage
+				VkDescriptorSetLayoutBinding* setBindingsBegin = setBindings[binding.set];
+				VkDescriptorSetLayoutBinding* setBindingsEnd = setBindingsBegin + setBindingCounts[binding.set];
+				VkDescriptorSetLayoutBinding* setBinding = setBindingsBegin;
+
+				for(; setBinding != setBindingsEnd; ++setBinding)
+					if(setBinding->binding == binding.binding)
+						break;
+
+				if(setBinding != setBindingsEnd) {
+					// Check if the two stages' bindings match
+					if(setBinding->descriptorType != binding.descriptorType)
+						throw Exception("Vulkan shader stages use different descriptor types for set %u, binding %u!", binding.set, binding.binding);
+
+					// Add the current stage to the binding
+					setBinding->stageFlags |= binding.stageFlags;
+					continue;
+				}
+
+				// Check if the set has room for another binding
+				if(setBindingCounts[binding.set] == MAX_SET_BINDING_COUNT)
+					throw Exception("Vulkan shader descriptor set %u exceeds the maximum of %u bindings!", binding.set, MAX_SET_BINDING_COUNT);
+
+				// Insert the binding, keeping the set's bindings sorted
+				while(setBinding != setBindingsBegin && (setBinding - 1)->binding > binding.binding) {
+					*setBinding = *(setBinding - 1);
+					--setBinding;
+				}
+
+				setBinding->binding = binding.binding;
+				setBinding->descriptorType = binding.descriptorType;
+				setBinding->descriptorCount = binding.descriptorCount ? binding.descriptorCount : 1;
+				setBinding->stageFlags = binding.stageFlags;
+				setBinding->pImmutableSamplers = nullptr;
+
+				++setBindingCounts[binding.set];
+			}
+
+			// Add the shader module's push constant range, one range per stage
+			if(reflection.pushConstantSize) {
+				if(pushConstantRangeCount == MAX_PUSH_CONSTANT_RANGE_COUNT)
+					throw Exception("Vulkan pipeline exceeds the maximum of %u push constant ranges!", MAX_PUSH_CONSTANT_RANGE_COUNT);
+
+				pushConstantRanges[pushConstantRangeCount].stageFlags = reflection.stage;
+				pushConstantRanges[pushConstantRangeCount].offset = 0;
+				pushConstantRanges[pushConstantRangeCount].size = reflection.pushConstantSize;
+				++pushConstantRangeCount;
+			}
+		}
+
+		// Get every set's layout and hash the pipeline layout
+		PipelineLayout pipelineLayout;
+		pipelineLayout.setLayoutCount = setCount;
+		pipelineLayout.bindlessSetIndex = UINT32_T_MAX;
+
+		uint64_t hash = FNV1A_HASH_OFFSET;
+		for(uint32_t i = 0; i != setCount; ++i) {
+			// Use the bindless heap's set layout for sets containing runtime arrays, if bindless resources are supported
+			if(bindlessSets[i] && bindlessHeap) {
+				pipelineLayout.setLayouts[i] = bindlessHeap->GetSetLayout();
+				if(pipelineLayout.bindlessSetIndex == UINT32_T_MAX)
+					pipelineLayout.bindlessSetIndex = i;
+			} else {
+				pipelineLayout.setLayouts[i] = layoutCache->GetSetLayout(setBindingCounts[i], setBindings[i]);
+			}
+			hash = ComputeFNV1aHash(pipelineLayout.setLayouts + i, sizeof(VkDescriptorSetLayout), hash);
+		}
+		hash = ComputeFNV1aHash(pushConstantRanges, pushConstantRangeCount * sizeof(VkPushConstantRange), hash);
+
+		// Return the existing pipeline layout, if an identical one was already created
+		CachedPipelineLayout* collidingPipelineLayouts = nullptr;
+		auto pipelineLayoutIter = pipelineLayouts.find(hash);
+		if(pipelineLayoutIter != pipelineLayouts.end()) {
+			for(CachedPipelineLayout* cachedLayout = pipelineLayoutIter->second; cachedLayout; cachedLayout = cachedLayout->nextCollision)
+				if(cachedLayout->pipelineLayout.setLayoutCount == setCount && cachedLayout->pushConstantRangeCount == pushConstantRangeCount && !memcmp(cachedLayout->pipelineLayout.setLayouts, pipelineLayout.setLayouts, setCount * sizeof(VkDescriptorSetLayout)) && !memcmp(cachedLayout->pushConstantRanges, pushConstantRanges, pushConstantRangeCount * sizeof(VkPushConstantRange)))
+					return &cachedLayout->pipelineLayout;
+
+			collidingPipelineLayouts = pipelineLayoutIter->second;
+		}
+
+		// Set the pipeline layout's create info
+		VkPipelineLayoutCreateInfo createInfo {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.setLayoutCount = setCount,
+			.pSetLayouts = pipelineLayout.setLayouts,
+			.pushConstantRangeCount = pushConstantRangeCount,
+			.pPushConstantRanges = pushConstantRanges
+		};
+
+		// Create the pipeline layout
+		VkResult result = device->GetLoader()->vkCreatePipelineLayout(device->GetDevice(), &createInfo, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS, &pipelineLayout.pipelineLayout);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to create Vulkan pipeline layout! Error code: %s", string_VkResult(result));
+
+		// Save the pipeline layout with its key, chaining it to the pipeline layouts with the same hash
+		PushMemoryUsageType(MEMORY_USAGE_TYPE_RENDERER);
+		CachedPipelineLayout* cachedLayout = NewObject<CachedPipelineLayout>();
+		PopMemoryUsageType();
+
+		cachedLayout->pipelineLayout = pipelineLayout;
+		cachedLayout->pushConstantRangeCount = pushConstantRangeCount;
+		memcpy(cachedLayout->pushConstantRanges, pushConstantRanges, pushConstantRangeCount * sizeof(VkPushConstantRange));
+		cachedLayout->nextCollision = collidingPipelineLayouts;
+
+		if(collidingPipelineLayouts) {
+			pipelineLayoutIter->second = cachedLayout;
+		} else {
+			pipelineLayouts.insert({ hash, cachedLayout });
+		}
+
+		return &cachedLayout->pipelineLayout;
+	}
+
+	VulkanShaderLibrary::~VulkanShaderLibrary() {
+		// Destroy every pipeline layout
+		for(auto& pipelineLayoutPair : pipelineLayouts) {
+			CachedPipelineLayout* cachedLayout = pipelineLayoutPair.second;
+			while(cachedLayout) {
+				CachedPipelineLayout* nextCollision = cachedLayout->nextCollision;
+				device->GetLoader()->vkDestroyPipelineLayout(device->GetDevice(), cachedLayout->pipelineLayout.pipelineLayout, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+				DestroyObject(cachedLayout);
+				cachedLayout = nextCollision;
+			}
+		}
+
+		// Destroy every shader module name
+		for(auto& namedModulePair : namedShaderModules) {
+			NamedShaderModule* namedModule = namedModulePair.second;
+			while(namedModule) {
+				NamedShaderModule* nextCollision = namedModule->nextCollision;
+				DestroyObject(namedModule);
+				namedModule = nextCollision;
+			}
+		}
+
+		// Destroy every unique shader module
+		for(auto& shaderModulePair : shaderModules) {
+			LoadedShaderModule* shaderModule = shaderModulePair.second;
+			while(shaderModule) {
+				LoadedShaderModule* nextCollision = shaderModule->nextCollision;
+				device->GetLoader()->vkDestroyShaderModule(device->GetDevice(), shaderModule->shaderModule.shaderModule, &VulkanRenderer::VULKAN_ALLOC_CALLBACKS);
+				DestroyObject(shaderModule);
+				shaderModule = nextCollision;
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "VulkanShaderReflection.hpp"
+#include "Renderer/Vulkan/Descriptor/VulkanBindlessHeap.hpp"
+#include "Renderer/Vulkan/Descriptor/VulkanDescriptorLayoutCache.hpp"
+#include "Renderer/Vulkan/Instance/VulkanDevice.hpp"
+
+#include <Core.hpp>
+#include <vulkan/vk_platform.h>
+#include <vulkan/vulkan_core.h>
+
+namespace wfe {
+	/// @brief A library that lazily loads, deduplicates and reflects the compiled SPIR-V shaders.
+	class VulkanShaderLibrary {
+	public:
+		/// @brief The maximum number of descriptor sets a pipeline layout generated by the library can use.
+		static const uint32_t MAX_DESCRIPTOR_SET_COUNT = 4;
+		/// @brief The maximum number of push constant ranges a pipeline layout generated by the library can use.
+		static const uint32_t MAX_PUSH_CONSTANT_RANGE_COUNT = 8;
+
+		/// @brief A struct containing a loaded shader module's info.
+		struct ShaderModule {
+			/// @brief The Vulkan shader module's handle.
+			VkShaderModule shaderModule;
+			/// @brief The hash of the shader module's SPIR-V code.
+			uint64_t codeHash;
+			/// @brief The size of the shader module's SPIR-V code, in bytes.
+			size_t codeSize;
+			/// @brief The reflected info of the shader module.
+			VulkanShaderReflection reflection;
+		};
+		/// @brief A struct containing a generated pipeline layout's info.
+		struct PipelineLayout {
+			/// @brief The Vulkan pipeline layout's handle.
+			VkPipelineLayout pipelineLayout;
+			/// @brief The number of descriptor set layouts used by the pipeline layout.
+			uint32_t setLayoutCount;
+			/// @brief The descriptor set layouts used by the pipeline layout.
+			VkDescriptorSetLayout setLayouts[MAX_DESCRIPTOR_SET_COUNT];
+			/// @brief The index of the set using the bindless heap's set layout, or UINT32_T_MAX if no set uses it.
+			uint32_t bindlessSetIndex;
+		};
+
+		/// @brief Creates a Vulkan shader library.
+		/// @param device The Vulkan device to create the shader modules for.
+		/// @param layoutCache The descriptor layout cache used to get the pipeline layouts' set layouts.
+		/// @param bindlessHeap The bindless heap whose set layout replaces every set containing runtime arrays, or nullptr if bindless resources aren't supported.
+		/// @param shaderDirectory The directory containing the compiled SPIR-V shaders.
+		VulkanShaderLibrary(VulkanDevice* device, VulkanDescriptorLayoutCache* layoutCache, VulkanBindlessHeap* bindlessHeap, const char_t* shaderDirectory);
+		VulkanShaderLibrary(const VulkanShaderLibrary&) = delete;
+		VulkanShaderLibrary(VulkanShaderLibrary&&) noexcept = delete;
+
+		VulkanShaderLibrary& operator=(const VulkanShaderLibrary&) = delete;
+		VulkanShaderLibrary& operator=(VulkanShaderLibrary&&) = delete;
+
+		/// @brief Gets the Vulkan function loader used by the shader library.
+		/// @return A pointer to the Vulkan loader used by the shader library.
+		const VulkanLoader* GetLoader() const {
+			return device->GetLoader();
+		}
+		/// @brief Gets the Vulkan device that owns the shader library.
+		/// @return A pointer to the Vulkan device wrapper object.
+		VulkanDevice* GetDevice() {
+			return device;
+		}
+		/// @brief Gets the Vulkan device that owns the shader library.
+		/// @return A const pointer to the Vulkan device wrapper object.
+		const VulkanDevice* GetDevice() const {
+			return device;
+		}
+		/// @brief Gets the number of unique shader modules currently loaded.
+		/// @return The number of unique shader modules.
+		size_t GetLoadedShaderModuleCount() const {
+			return shaderModuleCount;
+		}
+
+		/// @brief Gets the shader module with the given name, loading it if it wasn't previously requested.
+		/// @param name The shader's source file name, like "Basic.vert", without the ".spv" extension.
+		/// @return A const pointer to the shader module's info.
+		const ShaderModule* GetShaderModule(const char_t* name);
+		/// @brief Gets the pipeline layout matching the reflected resources of the given shader modules, creating it if it doesn't exist.
+		/// @param shaderModuleCount The number of shader modules used by the pipeline.
+		/// @param shaderModules A pointer to an array of the pipeline's shader modules.
+		/// @return A const pointer to the pipeline layout's info.
+		const PipelineLayout* GetPipelineLayout(size_t shaderModuleCount, const ShaderModule* const* shaderModules);
+
+		/// @brief Destroys the Vulkan shader library and all of its shader modules and pipeline layouts.
+		~VulkanShaderLibrary();
+	private:
+		struct LoadedShaderModule {
+			ShaderModule shaderModule;
+			vector<uint32_t> code;
+			LoadedShaderModule* nextCollision;
+		};
+		struct NamedShaderModule {
+			string name;
+			LoadedShaderModule* shaderModule;
+			NamedShaderModule* nextCollision;
+		};
+		struct CachedPipelineLayout {
+			PipelineLayout pipelineLayout;
+			uint32_t pushConstantRangeCount;
+			VkPushConstantRange pushConstantRanges[MAX_PUSH_CONSTANT_RANGE_COUNT];
+			CachedPipelineLayout* nextCollision;
+		};
+
+		VulkanDevice* device;
+		VulkanDescriptorLayoutCache* layoutCache;
+		VulkanBindlessHeap* bindlessHeap;
+		string shaderDirectory;
+
+		unordered_map<uint64_t, NamedShaderModule*> namedShaderModules;
+		unordered_map<uint64_t, LoadedShaderModule*> shaderModules;
+		unordered_map<uint64_t, CachedPipelineLayout*> pipelineLayouts;
+		size_t shaderModuleCount;
+	};
+}
\ No newline at end of file
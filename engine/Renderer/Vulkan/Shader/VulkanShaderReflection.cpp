@@ -0,0 +1,441 @@
+#include "VulkanShaderReflection.hpp"
+
+namespace wfe {
+	// Constants
+	static const uint32_t SPIRV_MAGIC_NUMBER = 0x07230203;
+	static const size_t SPIRV_HEADER_WORD_COUNT = 5;
+
+	static const uint32_t SPIRV_OP_ENTRY_POINT = 15;
+	static const uint32_t SPIRV_OP_TYPE_BOOL = 20;
+	static const uint32_t SPIRV_OP_TYPE_INT = 21;
+	static const uint32_t SPIRV_OP_TYPE_FLOAT = 22;
+	static const uint32_t SPIRV_OP_TYPE_VECTOR = 23;
+	static const uint32_t SPIRV_OP_TYPE_MATRIX = 24;
+	static const uint32_t SPIRV_OP_TYPE_IMAGE = 25;
+	static const uint32_t SPIRV_OP_TYPE_SAMPLER = 26;
+	static const uint32_t SPIRV_OP_TYPE_SAMPLED_IMAGE = 27;
+	static const uint32_t SPIRV_OP_TYPE_ARRAY = 28;
+	static const uint32_t SPIRV_OP_TYPE_RUNTIME_ARRAY = 29;
+	static const uint32_t SPIRV_OP_TYPE_STRUCT = 30;
+	static const uint32_t SPIRV_OP_TYPE_POINTER = 32;
+	static const uint32_t SPIRV_OP_CONSTANT = 43;
+	static const uint32_t SPIRV_OP_VARIABLE = 59;
+	static const uint32_t SPIRV_OP_DECORATE = 71;
+	static const uint32_t SPIRV_OP_MEMBER_DECORATE = 72;
+
+	static const uint32_t SPIRV_DECORATION_BLOCK = 2;
+	static const uint32_t SPIRV_DECORATION_BUFFER_BLOCK = 3;
+	static const uint32_t SPIRV_DECORATION_ARRAY_STRIDE = 6;
+	static const uint32_t SPIRV_DECORATION_MATRIX_STRIDE = 7;
+	static const uint32_t SPIRV_DECORATION_BINDING = 33;
+	static const uint32_t SPIRV_DECORATION_DESCRIPTOR_SET = 34;
+	static const uint32_t SPIRV_DECORATION_OFFSET = 35;
+
+	static const uint32_t SPIRV_STORAGE_CLASS_UNIFORM_CONSTANT = 0;
+	static const uint32_t SPIRV_STORAGE_CLASS_UNIFORM = 2;
+	static const uint32_t SPIRV_STORAGE_CLASS_PUSH_CONSTANT = 9;
+	static const uint32_t SPIRV_STORAGE_CLASS_STORAGE_BUFFER = 12;
+
+	static const uint32_t SPIRV_DIM_BUFFER = 5;
+	static const uint32_t SPIRV_DIM_SUBPASS_DATA = 6;
+
+	// Internal structs
+	struct SpirvID {
+		uint32_t opcode = 0;
+		size_t wordOffset = 0;
+		uint32_t set = UINT32_T_MAX;
+		uint32_t binding = UINT32_T_MAX;
+		uint32_t arrayStride = 0;
+		bool8_t block = false;
+		bool8_t bufferBlock = false;
+	};
+	struct SpirvMemberDecoration {
+		uint32_t structID;
+		uint32_t member;
+		uint32_t offset;
+		uint32_t matrixStride;
+	};
+
+	// Internal helper functions
+	static VkShaderStageFlagBits GetExecutionModelStage(uint32_t executionModel) {
+		switch(executionModel) {
+		case 0:
+			return VK_SHADER_STAGE_VERTEX_BIT;
+		case 1:
+			return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+		case 2:
+			return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+		case 3:
+			return VK_SHADER_STAGE_GEOMETRY_BIT;
+		case 4:
+			return VK_SHADER_STAGE_FRAGMENT_BIT;
+		case 5:
+			return VK_SHADER_STAGE_COMPUTE_BIT;
+		case 5364:
+			return VK_SHADER_STAGE_TASK_BIT_EXT;
+		case 5365:
+			return VK_SHADER_STAGE_MESH_BIT_EXT;
+		default:
+			return VK_SHADER_STAGE_FLAG_BITS_MAX_ENUM;
+		}
+	}
+	static SpirvMemberDecoration* FindMemberDecoration(vector<SpirvMemberDecoration>& memberDecorations, uint32_t structID, uint32_t member) {
+		// Look for the wanted struct member's decoration
+		for(auto& memberDecoration : memberDecorations)
+			if(memberDecoration.structID == structID && memberDecoration.member == member)
+				return &memberDecoration;
+
+		return nullptr;
+	}
+	static uint32_t GetMinInstructionLength(uint32_t opcode) {
+		// Get the number of words an instruction needs to hold every operand read during reflection
+		switch(opcode) {
+		case SPIRV_OP_ENTRY_POINT:
+		case SPIRV_OP_TYPE_BOOL:
+		case SPIRV_OP_TYPE_SAMPLER:
+		case SPIRV_OP_TYPE_STRUCT:
+			return 2;
+		case SPIRV_OP_TYPE_INT:
+		case SPIRV_OP_TYPE_FLOAT:
+		case SPIRV_OP_TYPE_SAMPLED_IMAGE:
+		case SPIRV_OP_TYPE_RUNTIME_ARRAY:
+		case SPIRV_OP_DECORATE:
+			return 3;
+		case SPIRV_OP_TYPE_VECTOR:
+		case SPIRV_OP_TYPE_MATRIX:
+		case SPIRV_OP_TYPE_ARRAY:
+		case SPIRV_OP_TYPE_POINTER:
+		case SPIRV_OP_CONSTANT:
+		case SPIRV_OP_VARIABLE:
+		case SPIRV_OP_MEMBER_DECORATE:
+			return 4;
+		case SPIRV_OP_TYPE_IMAGE:
+			return 9;
+		default:
+			return 1;
+		}
+	}
+	static bool8_t IsEarlierType(const vector<SpirvID>& ids, uint32_t typeID, size_t wordOffset) {
+		// Types must be declared before the instructions using them, which also rules out cycles between types
+		if(typeID >= ids.size())
+			return false;
+
+		const SpirvID& type = ids[typeID];
+		return type.opcode >= SPIRV_OP_TYPE_BOOL && type.opcode <= SPIRV_OP_TYPE_POINTER && type.wordOffset < wordOffset;
+	}
+	static bool8_t GetConstantValue(const uint32_t* code, const vector<SpirvID>& ids, uint32_t id, uint32_t& value) {
+		// Check if the given ID exists
+		if(id >= ids.size())
+			return false;
+
+		// Use 1 if the given ID is not a constant, otherwise use the constant's first word, which is enough for all array lengths
+		if(ids[id].opcode != SPIRV_OP_CONSTANT) {
+			value = 1;
+		} else {
+			value = code[ids[id].wordOffset + 3];
+		}
+
+		return true;
+	}
+	static bool8_t GetTypeSize(const uint32_t* code, const vector<SpirvID>& ids, vector<SpirvMemberDecoration>& memberDecorations, uint32_t typeID, uint32_t matrixStride, uint32_t& size) {
+		// Get the type's instruction
+		const SpirvID& type = ids[typeID];
+		const uint32_t* instruction = code + type.wordOffset;
+
+		switch(type.opcode) {
+		case SPIRV_OP_TYPE_BOOL:
+			size = 4;
+			return true;
+		case SPIRV_OP_TYPE_INT:
+		case SPIRV_OP_TYPE_FLOAT:
+			size = instruction[2] >> 3;
+			return true;
+		case SPIRV_OP_TYPE_VECTOR:
+			if(!IsEarlierType(ids, instruction[2], type.wordOffset) || !GetTypeSize(code, ids, memberDecorations, instruction[2], 0, size))
+				return false;
+
+			size *= instruction[3];
+			return true;
+		case SPIRV_OP_TYPE_MATRIX:
+			// Use the matrix stride, if one was given
+			if(!IsEarlierType(ids, instruction[2], type.wordOffset))
+				return false;
+			if(matrixStride) {
+				size = matrixStride * instruction[3];
+				return true;
+			}
+			if(!GetTypeSize(code, ids, memberDecorations, instruction[2], 0, size))
+				return false;
+
+			size *= instruction[3];
+			return true;
+		case SPIRV_OP_TYPE_ARRAY: {
+			// Use the array stride, if one was given
+			uint32_t length;
+			if(!IsEarlierType(ids, instruction[2], type.wordOffset) || !GetConstantValue(code, ids, instruction[3], length))
+				return false;
+			if(type.arrayStride) {
+				size = type.arrayStride * length;
+				return true;
+			}
+			if(!GetTypeSize(code, ids, memberDecorations, instruction[2], matrixStride, size))
+				return false;
+
+			size *= length;
+			return true;
+		}
+		case SPIRV_OP_TYPE_STRUCT: {
+			// Find the end of the struct's furthest member
+			uint32_t memberCount = (instruction[0] >> 16) - 2;
+			size = 0;
+
+			for(uint32_t i = 0; i != memberCount; ++i) {
+				// Check if the member's type was declared; pointers may be forward declared, but their sizes are never followed
+				uint32_t memberTypeID = instruction[i + 2];
+				if(memberTypeID >= ids.size() || (ids[memberTypeID].opcode != SPIRV_OP_TYPE_POINTER && !IsEarlierType(ids, memberTypeID, type.wordOffset)))
+					return false;
+
+				// Get the member's decoration
+				SpirvMemberDecoration* memberDecoration = FindMemberDecoration(memberDecorations, typeID, i);
+				uint32_t memberOffset = memberDecoration ? memberDecoration->offset : size;
+				uint32_t memberMatrixStride = memberDecoration ? memberDecoration->matrixStride : 0;
+
+				// Calculate the member's end
+				uint32_t memberSize;
+				if(!GetTypeSize(code, ids, memberDecorations, memberTypeID, memberMatrixStride, memberSize))
+					return false;
+
+				uint32_t memberEnd = memberOffset + memberSize;
+				if(memberEnd > size)
+					size = memberEnd;
+			}
+
+			return true;
+		}
+		default:
+			size = 0;
+			return true;
+		}
+	}
+
+	// Public functions
+	bool8_t VulkanShaderReflection::Reflect(size_t codeSize, const uint32_t* code, VulkanShaderReflection& reflection) {
+		// Check if the code is valid SPIR-V
+		size_t wordCount = codeSize >> 2;
+		if(wordCount < SPIRV_HEADER_WORD_COUNT || code[0] != SPIRV_MAGIC_NUMBER)
+			return false;
+
+		// Reset the reflection info
+		reflection.stage = VK_SHADER_STAGE_FLAG_BITS_MAX_ENUM;
+		reflection.bindings.clear();
+		reflection.pushConstantSize = 0;
+
+		// Create the ID vector based on the bound in the SPIR-V header; every ID needs its own instruction, so a larger bound than the word count is invalid
+		if(code[3] > wordCount)
+			return false;
+		vector<SpirvID> ids(code[3]);
+		vector<SpirvMemberDecoration> memberDecorations;
+
+		// Loop through every instruction and save the info required for reflection
+		for(size_t wordIndex = SPIRV_HEADER_WORD_COUNT; wordIndex < wordCount;) {
+			// Get the instruction's opcode and length
+			uint32_t opcode = code[wordIndex] & 0xffff;
+			uint32_t instructionLength = code[wordIndex] >> 16;
+			if(!instructionLength || wordIndex + instructionLength > wordCount || instructionLength < GetMinInstructionLength(opcode))
+				return false;
+
+			const uint32_t* instruction = code + wordIndex;
+
+			switch(opcode) {
+			case SPIRV_OP_ENTRY_POINT:
+				// Set the shader's stage based on the first entry point
+				if(reflection.stage == VK_SHADER_STAGE_FLAG_BITS_MAX_ENUM)
+					reflection.stage = GetExecutionModelStage(instruction[1]);
+				break;
+			case SPIRV_OP_TYPE_BOOL:
+			case SPIRV_OP_TYPE_INT:
+			case SPIRV_OP_TYPE_FLOAT:
+			case SPIRV_OP_TYPE_VECTOR:
+			case SPIRV_OP_TYPE_MATRIX:
+			case SPIRV_OP_TYPE_IMAGE:
+			case SPIRV_OP_TYPE_SAMPLER:
+			case SPIRV_OP_TYPE_SAMPLED_IMAGE:
+			case SPIRV_OP_TYPE_ARRAY:
+			case SPIRV_OP_TYPE_RUNTIME_ARRAY:
+			case SPIRV_OP_TYPE_STRUCT:
+			case SPIRV_OP_TYPE_POINTER:
+				// Save the type's instruction, with its result ID being the first operand
+				if(instruction[1] >= ids.size())
+					return false;
+				ids[instruction[1]].opcode = opcode;
+				ids[instruction[1]].wordOffset = wordIndex;
+				break;
+			case SPIRV_OP_CONSTANT:
+			case SPIRV_OP_VARIABLE:
+				// Save the instruction, with its result ID being the second operand
+				if(instruction[2] >= ids.size())
+					return false;
+				ids[instruction[2]].opcode = opcode;
+				ids[instruction[2]].wordOffset = wordIndex;
+				break;
+			case SPIRV_OP_DECORATE: {
+				// Save the relevant decoration
+				if(instruction[1] >= ids.size())
+					return false;
+				SpirvID& id = ids[instruction[1]];
+
+				// Check if the decoration's literal operand exists
+				if((instruction[2] == SPIRV_DECORATION_ARRAY_STRIDE || instruction[2] == SPIRV_DECORATION_BINDING || instruction[2] == SPIRV_DECORATION_DESCRIPTOR_SET) && instructionLength < 4)
+					return false;
+
+				switch(instruction[2]) {
+				case SPIRV_DECORATION_BLOCK:
+					id.block = true;
+					break;
+				case SPIRV_DECORATION_BUFFER_BLOCK:
+					id.bufferBlock = true;
+					break;
+				case SPIRV_DECORATION_ARRAY_STRIDE:
+					id.arrayStride = instruction[3];
+					break;
+				case SPIRV_DECORATION_BINDING:
+					id.binding = instruction[3];
+					break;
+				case SPIRV_DECORATION_DESCRIPTOR_SET:
+					id.set = instruction[3];
+					break;
+				}
+
+				break;
+			}
+			case SPIRV_OP_MEMBER_DECORATE: {
+				// Skip all irrelevant member decorations
+				if(instruction[3] != SPIRV_DECORATION_OFFSET && instruction[3] != SPIRV_DECORATION_MATRIX_STRIDE)
+					break;
+				if(instructionLength < 5)
+					return false;
+
+				// Get the member's decoration, or create it if it doesn't exist
+				SpirvMemberDecoration* memberDecoration = FindMemberDecoration(memberDecorations, instruction[1], instruction[2]);
+				if(!memberDecoration) {
+					memberDecorations.push_back({ instruction[1], instruction[2], 0, 0 });
+					memberDecoration = &memberDecorations.back();
+				}
+
+				// Set the member's decoration
+				if(instruction[3] == SPIRV_DECORATION_OFFSET) {
+					memberDecoration->offset = instruction[4];
+				} else {
+					memberDecoration->matrixStride = instruction[4];
+				}
+
+				break;
+			}
+			}
+
+			// Move on to the next instruction
+			wordIndex += instructionLength;
+		}
+
+		// Exit the function if no entry point was found
+		if(reflection.stage == VK_SHADER_STAGE_FLAG_BITS_MAX_ENUM)
+			return false;
+
+		// Loop through every variable and reflect the resource variables
+		for(uint32_t id = 0; id != ids.size(); ++id) {
+			// Skip the current ID if it is not a variable
+			if(ids[id].opcode != SPIRV_OP_VARIABLE)
+				continue;
+
+			// Get the variable's storage class and skip it if it is not a resource
+			uint32_t storageClass = code[ids[id].wordOffset + 3];
+			if(storageClass != SPIRV_STORAGE_CLASS_UNIFORM_CONSTANT && storageClass != SPIRV_STORAGE_CLASS_UNIFORM && storageClass != SPIRV_STORAGE_CLASS_PUSH_CONSTANT && storageClass != SPIRV_STORAGE_CLASS_STORAGE_BUFFER)
+				continue;
+
+			// Get the type the variable's pointer type points to
+			uint32_t pointerTypeID = code[ids[id].wordOffset + 1];
+			if(!IsEarlierType(ids, pointerTypeID, ids[id].wordOffset) || ids[pointerTypeID].opcode != SPIRV_OP_TYPE_POINTER)
+				return false;
+
+			uint32_t typeID = code[ids[pointerTypeID].wordOffset + 3];
+			if(!IsEarlierType(ids, typeID, ids[pointerTypeID].wordOffset))
+				return false;
+
+			// Set the push constant size if the variable is a push constant block
+			if(storageClass == SPIRV_STORAGE_CLASS_PUSH_CONSTANT) {
+				if(!GetTypeSize(code, ids, memberDecorations, typeID, 0, reflection.pushConstantSize))
+					return false;
+				continue;
+			}
+
+			// Unwrap all array types and calculate the descriptor count
+			uint32_t descriptorCount = 1;
+			while(ids[typeID].opcode == SPIRV_OP_TYPE_ARRAY || ids[typeID].opcode == SPIRV_OP_TYPE_RUNTIME_ARRAY) {
+				const uint32_t* arrayInstruction = code + ids[typeID].wordOffset;
+				if(ids[typeID].opcode == SPIRV_OP_TYPE_ARRAY) {
+					uint32_t length;
+					if(!GetConstantValue(code, ids, arrayInstruction[3], length))
+						return false;
+					descriptorCount *= length;
+				} else {
+					descriptorCount = 0;
+				}
+
+				if(!IsEarlierType(ids, arrayInstruction[2], ids[typeID].wordOffset))
+					return false;
+				typeID = arrayInstruction[2];
+			}
+
+			// Get the descriptor's type based on the variable's storage class and type
+			const uint32_t* typeInstruction = code + ids[typeID].wordOffset;
+			VkDescriptorType descriptorType;
+
+			switch(ids[typeID].opcode) {
+			case SPIRV_OP_TYPE_IMAGE:
+				if(typeInstruction[3] == SPIRV_DIM_BUFFER) {
+					descriptorType = (typeInstruction[7] == 2) ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+				} else if(typeInstruction[3] == SPIRV_DIM_SUBPASS_DATA) {
+					descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+				} else {
+					descriptorType = (typeInstruction[7] == 2) ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+				}
+				break;
+			case SPIRV_OP_TYPE_SAMPLER:
+				descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+				break;
+			case SPIRV_OP_TYPE_SAMPLED_IMAGE:
+				descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+				break;
+			case SPIRV_OP_TYPE_STRUCT:
+				if(storageClass == SPIRV_STORAGE_CLASS_STORAGE_BUFFER || ids[typeID].bufferBlock) {
+					descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+				} else {
+					descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+				}
+				break;
+			default:
+				// Skip the variable, as its type is not supported
+				continue;
+			}
+
+			// Add the binding to the reflection info, keeping the bindings sorted
+			DescriptorBinding descriptorBinding {
+				.set = ids[id].set == UINT32_T_MAX ? 0 : ids[id].set,
+				.binding = ids[id].binding == UINT32_T_MAX ? 0 : ids[id].binding,
+				.descriptorType = descriptorType,
+				.descriptorCount = descriptorCount,
+				.stageFlags = (VkShaderStageFlags)reflection.stage
+			};
+
+			size_t insertIndex = reflection.bindings.size();
+			reflection.bindings.push_back(descriptorBinding);
+			while(insertIndex && (reflection.bindings[insertIndex - 1].set > descriptorBinding.set || (reflection.bindings[insertIndex - 1].set == descriptorBinding.set && reflection.bindings[insertIndex - 1].binding > descriptorBinding.binding))) {
+				reflection.bindings[insertIndex] = reflection.bindings[insertIndex - 1];
+				--insertIndex;
+			}
+			reflection.bindings[insertIndex] = descriptorBinding;
+		}
+
+		return true;
+	}
+}
\ No newline at end of file
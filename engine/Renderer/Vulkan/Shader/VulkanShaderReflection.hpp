@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Core.hpp>
+#include <vulkan/vk_platform.h>
+#include <vulkan/vulkan_core.h>
+
+namespace wfe {
+	/// @brief A struct containing the reflected info of a SPIR-V shader module.
+	struct VulkanShaderReflection {
+		/// @brief A struct containing the info of a descriptor binding used by a shader.
+		struct DescriptorBinding {
+			/// @brief The index of the descriptor set the binding is in.
+			uint32_t set;
+			/// @brief The binding's index in its descriptor set.
+			uint32_t binding;
+			/// @brief The binding's descriptor type.
+			VkDescriptorType descriptorType;
+			/// @brief The number of descriptors in the binding, or 0 if the binding is a runtime array.
+			uint32_t descriptorCount;
+			/// @brief The shader stages that access the binding.
+			VkShaderStageFlags stageFlags;
+		};
+
+		/// @brief The shader module's stage.
+		VkShaderStageFlagBits stage;
+		/// @brief The descriptor bindings used by the shader, sorted by their set and binding indices.
+		vector<DescriptorBinding> bindings;
+		/// @brief The size of the shader's push constant block, or 0 if the shader doesn't use push constants.
+		uint32_t pushConstantSize;
+
+		/// @brief Reflects the given SPIR-V code.
+		/// @param codeSize The size of the SPIR-V code, in bytes.
+		/// @param code A pointer to the SPIR-V code.
+		/// @param reflection A reference to the struct in which the reflected info will be written.
+		/// @return True if the SPIR-V code was reflected successfully, otherwise false, including when an instruction is truncated or references an out of bounds or undeclared ID.
+		static bool8_t Reflect(size_t codeSize, const uint32_t* code, VulkanShaderReflection& reflection);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#version 450
+
+const vec3 LIGHT_DIRECTION = vec3(0.267261, 0.801784, 0.534522);
+const vec3 ALBEDO = vec3(0.8);
+const float AMBIENT = 0.15;
+
+layout(location = 0) in vec3 inNormal;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+	// Shade with a single directional light, so that meshes are readable without any material setup
+	float diffuse = max(dot(normalize(inNormal), LIGHT_DIRECTION), 0.0);
+	outColor = vec4(ALBEDO * (AMBIENT + diffuse), 1.0);
+}
\ No newline at end of file
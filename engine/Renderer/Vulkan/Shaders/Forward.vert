@@ -0,0 +1,24 @@
+#version 450
+
+// Must match the forward pass's vertex input state in VulkanForwardPass
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+// The instance's row-major 3x4 transform, bound per instance by the draw queue
+layout(location = 2) in vec4 inTransform0;
+layout(location = 3) in vec4 inTransform1;
+layout(location = 4) in vec4 inTransform2;
+
+// Must match VulkanForwardPass::PushConstants
+layout(push_constant) uniform PushConstants {
+	mat4 viewProjection;
+} pushConstants;
+
+layout(location = 0) out vec3 outNormal;
+
+void main() {
+	vec4 position = vec4(inPosition, 1.0);
+	vec3 worldPosition = vec3(dot(inTransform0, position), dot(inTransform1, position), dot(inTransform2, position));
+
+	gl_Position = pushConstants.viewProjection * vec4(worldPosition, 1.0);
+	outNormal = vec3(dot(inTransform0.xyz, inNormal), dot(inTransform1.xyz, inNormal), dot(inTransform2.xyz, inNormal));
+}
\ No newline at end of file
@@ -0,0 +1,221 @@
+// Shared by InstanceCull.comp and InstanceOcclusionCull.comp, which define OCCLUSION_CULLING before including this file
+
+layout(local_size_x = 64) in;
+
+// Must match VulkanGpuCuller::Instance
+struct Instance {
+	vec4 boundingSphere;
+	uint meshIndex;
+	uint padding[3];
+};
+
+// Must match VulkanGpuCuller::MeshLod
+struct MeshLod {
+	uint indexCount;
+	uint firstIndex;
+	float error;
+	uint padding;
+};
+
+// Must match VulkanGpuCuller::Mesh
+const uint MAX_LOD_COUNT = 8;
+
+struct Mesh {
+	MeshLod lods[MAX_LOD_COUNT];
+	int vertexOffset;
+	uint lodCount;
+	uint padding[2];
+};
+
+// Must match VkDrawIndexedIndirectCommand
+struct DrawCommand {
+	uint indexCount;
+	uint instanceCount;
+	uint firstIndex;
+	int vertexOffset;
+	uint firstInstance;
+};
+
+// Must match VulkanGpuCuller::PushConstants
+const uint CULL_FLAG_COMPACT = 1;
+const uint CULL_FLAG_LATE_PHASE = 2;
+
+// The fraction of the allowed error a coarser LOD than last frame's must stay under, which stops instances near a threshold from switching LODs every frame
+const float LOD_HYSTERESIS = 0.25;
+
+layout(set = 0, binding = 0) readonly buffer InstanceBuffer {
+	Instance instances[];
+};
+layout(set = 0, binding = 1) writeonly buffer DrawBuffer {
+	DrawCommand draws[];
+};
+// Must match VulkanGpuCuller::Stats
+layout(set = 0, binding = 2) buffer CountBuffer {
+	uint drawCounts[2];
+	uint visibleCount;
+	uint frustumCulledCount;
+	uint occlusionCulledCount;
+};
+// Every instance's last visibility in bit 0 and last LOD in the remaining bits
+layout(set = 0, binding = 3) buffer VisibilityBuffer {
+	uint visibility[];
+};
+#if OCCLUSION_CULLING
+layout(set = 0, binding = 4) uniform sampler2D depthPyramid;
+#endif
+layout(set = 0, binding = 5) readonly buffer MeshBuffer {
+	Mesh meshes[];
+};
+
+layout(push_constant) uniform PushConstants {
+	mat4 viewProjection;
+	vec3 cameraPosition;
+	float lodScale;
+	vec2 pyramidSize;
+	uint instanceCount;
+	uint flags;
+	uint lateDrawOffset;
+} pushConstants;
+
+shared uint groupVisibleCount;
+shared uint groupFrustumCulledCount;
+shared uint groupOcclusionCulledCount;
+
+bool IsInFrustum(vec4 boundingSphere) {
+	// Extract the frustum planes from the view projection matrix's rows, using Vulkan's [0, 1] depth range
+	mat4 rows = transpose(pushConstants.viewProjection);
+	vec4 planes[6] = vec4[6](rows[3] + rows[0], rows[3] - rows[0], rows[3] + rows[1], rows[3] - rows[1], rows[2], rows[3] - rows[2]);
+
+	// Test the bounding sphere against every normalized plane
+	for(uint i = 0; i != 6; ++i)
+		if(dot(planes[i].xyz, boundingSphere.xyz) + planes[i].w < -boundingSphere.w * length(planes[i].xyz))
+			return false;
+
+	return true;
+}
+
+uint SelectLod(Mesh mesh, vec4 boundingSphere, uint lastLod) {
+	// Use the distance to the sphere's surface, so that LODs never switch while the camera is inside the instance
+	float distance = max(length(boundingSphere.xyz - pushConstants.cameraPosition) - boundingSphere.w, 1e-4);
+	float errorScale = pushConstants.lodScale / distance;
+
+	// Pick the coarsest LOD whose projected error is within the allowed error, tightening the limit for LODs coarser than last frame's
+	uint lod = 0;
+	for(uint i = 1; i < mesh.lodCount; ++i) {
+		float threshold = i > lastLod ? 1.0 - LOD_HYSTERESIS : 1.0;
+		if(mesh.lods[i].error * errorScale > threshold)
+			break;
+		lod = i;
+	}
+
+	return lod;
+}
+
+#if OCCLUSION_CULLING
+bool IsOccluded(vec4 boundingSphere) {
+	// Project the corners of the sphere's bounding box to get its screen rectangle and nearest depth
+	vec2 minUV = vec2(1.0);
+	vec2 maxUV = vec2(0.0);
+	float nearestDepth = 1.0;
+
+	for(uint i = 0; i != 8; ++i) {
+		vec3 corner = boundingSphere.xyz + boundingSphere.w * vec3((i & 1) != 0 ? 1.0 : -1.0, (i & 2) != 0 ? 1.0 : -1.0, (i & 4) != 0 ? 1.0 : -1.0);
+		vec4 clip = pushConstants.viewProjection * vec4(corner, 1.0);
+
+		// Never occlude instances crossing the near plane
+		if(clip.w <= 0.0)
+			return false;
+
+		vec3 ndc = clip.xyz / clip.w;
+		minUV = min(minUV, ndc.xy * 0.5 + 0.5);
+		maxUV = max(maxUV, ndc.xy * 0.5 + 0.5);
+		nearestDepth = min(nearestDepth, ndc.z);
+	}
+
+	minUV = clamp(minUV, 0.0, 1.0);
+	maxUV = clamp(maxUV, 0.0, 1.0);
+
+	// Pick the mip level at which the rectangle covers at most 2x2 texels
+	vec2 size = (maxUV - minUV) * pushConstants.pyramidSize;
+	float level = ceil(log2(max(max(size.x, size.y), 1.0)));
+
+	// Get the farthest occluder depth in the rectangle and compare it with the instance's nearest depth
+	float occluderDepth = max(max(textureLod(depthPyramid, minUV, level).r, textureLod(depthPyramid, vec2(maxUV.x, minUV.y), level).r), max(textureLod(depthPyramid, vec2(minUV.x, maxUV.y), level).r, textureLod(depthPyramid, maxUV, level).r));
+
+	return nearestDepth > occluderDepth;
+}
+#endif
+
+void main() {
+	uint instanceIndex = gl_GlobalInvocationID.x;
+	bool latePhase = (pushConstants.flags & CULL_FLAG_LATE_PHASE) != 0;
+
+	if(gl_LocalInvocationIndex == 0) {
+		groupVisibleCount = 0;
+		groupFrustumCulledCount = 0;
+		groupOcclusionCulledCount = 0;
+	}
+	barrier();
+
+	if(instanceIndex < pushConstants.instanceCount) {
+		Instance instance = instances[instanceIndex];
+		uint lastVisibility = visibility[instanceIndex];
+		bool lastVisible = (lastVisibility & 1) != 0;
+
+		// Cull the instance against the frustum and, in the late phase, against the depth pyramid
+		bool visible = IsInFrustum(instance.boundingSphere);
+		bool draw;
+
+		// Select the LOD to draw the instance with
+		Mesh mesh = meshes[instance.meshIndex];
+		uint lod = SelectLod(mesh, instance.boundingSphere, lastVisibility >> 1);
+
+		if(latePhase) {
+			if(!visible) {
+				atomicAdd(groupFrustumCulledCount, 1);
+			}
+#if OCCLUSION_CULLING
+			else if(IsOccluded(instance.boundingSphere)) {
+				visible = false;
+				atomicAdd(groupOcclusionCulledCount, 1);
+			}
+#endif
+			if(visible)
+				atomicAdd(groupVisibleCount, 1);
+
+			// Draw the visible instances that weren't drawn in the early phase, and save the visibility and LOD for the next frame
+			draw = visible && !lastVisible;
+			visibility[instanceIndex] = (visible ? 1 : 0) | (lod << 1);
+		} else {
+			// Draw the instances that were visible last frame, which act as occluders for the late phase
+			draw = visible && lastVisible;
+		}
+
+		// Write the draw command, compacting the draws if the draw count is read from the count buffer
+		uint drawOffset = latePhase ? pushConstants.lateDrawOffset : 0;
+		uint drawIndex = instanceIndex;
+		bool write = true;
+
+		if((pushConstants.flags & CULL_FLAG_COMPACT) != 0) {
+			write = draw;
+			if(draw)
+				drawIndex = atomicAdd(drawCounts[latePhase ? 1 : 0], 1);
+		}
+
+		if(write) {
+			draws[drawOffset + drawIndex].indexCount = mesh.lods[lod].indexCount;
+			draws[drawOffset + drawIndex].instanceCount = draw ? 1 : 0;
+			draws[drawOffset + drawIndex].firstIndex = mesh.lods[lod].firstIndex;
+			draws[drawOffset + drawIndex].vertexOffset = mesh.vertexOffset;
+			draws[drawOffset + drawIndex].firstInstance = instanceIndex;
+		}
+	}
+
+	// Add the workgroup's statistics using a single atomic per counter
+	barrier();
+	if(latePhase && gl_LocalInvocationIndex == 0) {
+		atomicAdd(visibleCount, groupVisibleCount);
+		atomicAdd(frustumCulledCount, groupFrustumCulledCount);
+		atomicAdd(occlusionCulledCount, groupOcclusionCulledCount);
+	}
+}
\ No newline at end of file
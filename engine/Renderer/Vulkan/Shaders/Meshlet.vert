@@ -0,0 +1,19 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "MeshletCommon.glsl"
+
+// Must match the outputs of Meshlet.mesh
+layout(location = 0) out vec3 outWorldPosition;
+layout(location = 1) flat out uint outVertexIndex;
+layout(location = 2) flat out uint outInstanceIndex;
+
+void main() {
+	// The meshlet index buffer holds mesh vertex indices and every draw's first instance is its instance's index
+	vec3 worldPosition = TransformPoint(instances[gl_InstanceIndex], GetPosition(gl_VertexIndex));
+
+	gl_Position = pushConstants.viewProjection * vec4(worldPosition, 1.0);
+	outWorldPosition = worldPosition;
+	outVertexIndex = gl_VertexIndex;
+	outInstanceIndex = gl_InstanceIndex;
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+// Shared by MeshletCull.comp, MeshletCull.task, Meshlet.mesh and Meshlet.vert
+
+// Must match VulkanMeshletCuller::GROUP_SIZE
+const uint MESHLET_GROUP_SIZE = 32;
+
+// Must match MeshletBuilder::Meshlet
+struct Meshlet {
+	vec3 center;
+	float radius;
+	vec3 coneApex;
+	float coneCutoff;
+	vec3 coneAxis;
+	uint vertexOffset;
+	uint triangleOffset;
+	uint vertexCount;
+	uint triangleCount;
+	uint padding;
+};
+
+// Must match VulkanMeshletCuller::Instance
+struct Instance {
+	vec4 transform[3];
+	uint meshIndex;
+	uint padding[3];
+};
+
+// Must match VulkanMeshletCuller::Group
+struct MeshletGroup {
+	uint instanceIndex;
+	uint firstMeshlet;
+	uint meshletCount;
+	uint padding;
+};
+
+// Passed from the task shader to its mesh shader workgroups
+struct MeshletPayload {
+	uint instanceIndex;
+	uint meshletIndices[MESHLET_GROUP_SIZE];
+};
+
+// Must match VulkanMeshletCuller::PushConstants
+const uint CULL_FLAG_COMPACT = 1;
+
+layout(set = 0, binding = 0) readonly buffer MeshletBuffer {
+	Meshlet meshlets[];
+};
+layout(set = 0, binding = 1) readonly buffer MeshletVertexBuffer {
+	uint meshletVertices[];
+};
+// Every triangle's three meshlet-local vertex indices, packed into the low three bytes
+layout(set = 0, binding = 2) readonly buffer MeshletTriangleBuffer {
+	uint meshletTriangles[];
+};
+// Tightly packed vertex positions, three floats per vertex
+layout(set = 0, binding = 3) readonly buffer PositionBuffer {
+	float positions[];
+};
+layout(set = 0, binding = 4) readonly buffer InstanceBuffer {
+	Instance instances[];
+};
+layout(set = 0, binding = 5) readonly buffer GroupBuffer {
+	MeshletGroup groups[];
+};
+
+layout(push_constant) uniform PushConstants {
+	mat4 viewProjection;
+	vec3 cameraPosition;
+	uint groupCount;
+	uint flags;
+} pushConstants;
+
+vec3 GetPosition(uint vertexIndex) {
+	return vec3(positions[vertexIndex * 3], positions[vertexIndex * 3 + 1], positions[vertexIndex * 3 + 2]);
+}
+
+vec3 TransformPoint(Instance instance, vec3 point) {
+	return vec3(dot(instance.transform[0], vec4(point, 1.0)), dot(instance.transform[1], vec4(point, 1.0)), dot(instance.transform[2], vec4(point, 1.0)));
+}
+
+vec3 TransformVector(Instance instance, vec3 vector) {
+	return vec3(dot(instance.transform[0].xyz, vector), dot(instance.transform[1].xyz, vector), dot(instance.transform[2].xyz, vector));
+}
+
+bool IsMeshletVisible(Meshlet meshlet, Instance instance) {
+	// Get the instance's scale on every axis from the transform's columns
+	vec3 column0 = vec3(instance.transform[0].x, instance.transform[1].x, instance.transform[2].x);
+	vec3 column1 = vec3(instance.transform[0].y, instance.transform[1].y, instance.transform[2].y);
+	vec3 column2 = vec3(instance.transform[0].z, instance.transform[1].z, instance.transform[2].z);
+	vec3 scale = vec3(length(column0), length(column1), length(column2));
+	float maxScale = max(max(scale.x, scale.y), scale.z);
+	float minScale = min(min(scale.x, scale.y), scale.z);
+
+	// Cull the meshlet's world space bounding sphere against the frustum planes, extracted using Vulkan's [0, 1] depth range
+	vec3 center = TransformPoint(instance, meshlet.center);
+	float radius = meshlet.radius * maxScale;
+
+	mat4 rows = transpose(pushConstants.viewProjection);
+	vec4 planes[6] = vec4[6](rows[3] + rows[0], rows[3] - rows[0], rows[3] + rows[1], rows[3] - rows[1], rows[2], rows[3] - rows[2]);
+
+	for(uint i = 0; i != 6; ++i)
+		if(dot(planes[i].xyz, center) + planes[i].w < -radius * length(planes[i].xyz))
+			return false;
+
+	// Cull backfacing meshlets using their normal cone, which only keeps its shape under uniform scales without mirroring
+	if(meshlet.coneCutoff < 1.0 && maxScale <= minScale * 1.01 && dot(cross(column0, column1), column2) > 0.0) {
+		vec3 apex = TransformPoint(instance, meshlet.coneApex);
+		vec3 axis = normalize(TransformVector(instance, meshlet.coneAxis));
+
+		if(dot(normalize(apex - pushConstants.cameraPosition), axis) >= meshlet.coneCutoff)
+			return false;
+	}
+
+	return true;
+}
\ No newline at end of file
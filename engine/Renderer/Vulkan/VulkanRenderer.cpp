@@ -1,29 +1,50 @@
 #include "VulkanRenderer.hpp"
 
+#include <math.h>
+#include <vulkan/vk_enum_string_helper.h>
+
 namespace wfe {
+	// Constants
+	static const char_t SHADER_DIRECTORY[] = "assets/shaders";
+	static const char_t PIPELINE_CACHE_PATH[] = "pipeline_cache.bin";
+	static const char_t VARIANT_MANIFEST_PATH[] = "assets/shaders/Forward.variants";
+	static const uint32_t MAX_GPU_INSTANCE_COUNT = 1 << 18;
+	static const uint32_t MAX_GPU_MESH_COUNT = 1 << 12;
+	static const uint32_t GPU_INSTANCE_BLOCK_SIZE = 256;
+	static const VulkanMeshletCuller::Limits MESHLET_CULLER_LIMITS {
+		.maxMeshletCount = 1 << 14,
+		.maxTriangleCount = 1 << 20,
+		.maxVertexCount = 1 << 19,
+		.maxInstanceCount = 1 << 14,
+		.maxGroupCount = 1 << 16
+	};
+	static const VkDeviceSize TRANSIENT_RING_CAPACITY = 16 << 20;
+	static const size_t HOST_ALLOC_SCOPE_COUNT = VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE + 1;
+	static const char_t* const HOST_ALLOC_SCOPE_NAMES[HOST_ALLOC_SCOPE_COUNT] { "command", "object", "cache", "device", "instance" };
+
+	// Internal helper functions
+	static bool8_t SharesDrawState(const VulkanDrawQueue::Draw& draw, const VulkanDrawQueue::Draw& other) {
+		// Every bound state must match, while the index range may differ, as the GPU culler writes it per instance
+		return draw.pipeline == other.pipeline && draw.pipelineLayout == other.pipelineLayout && draw.descriptorSetIndex == other.descriptorSetIndex && draw.descriptorSet == other.descriptorSet && draw.vertexBuffer == other.vertexBuffer && draw.vertexBufferOffset == other.vertexBufferOffset && draw.indexBuffer == other.indexBuffer && draw.indexBufferOffset == other.indexBufferOffset && draw.indexType == other.indexType;
+	}
+	static float32_t ComputeProjectionScale(const Matrix4& viewProjection) {
+		// The view's rows are unit length, so the length of the view projection's second row is the projection's vertical scale
+		const Vector4* columns = viewProjection.columns;
+		return sqrtf(columns[0].y * columns[0].y + columns[1].y * columns[1].y + columns[2].y * columns[2].y);
+	}
+
 	// Alloc callbacks
 	static void* VKAPI_CALL AllocCallback(void* pUserData, size_t size, size_t alignment, VkSystemAllocationScope allocScope) {
-		// Set the memory usage type based on the alloc scope
-		MemoryUsageType memoryUsageType;
-		if(allocScope == VK_SYSTEM_ALLOCATION_SCOPE_COMMAND)
-			memoryUsageType = MEMORY_USAGE_TYPE_COMMAND;
-		else
-			memoryUsageType = MEMORY_USAGE_TYPE_RENDERER;
-
-		// Allocate the requested memory
-		PushMemoryUsageType(memoryUsageType);
-		void* mem = AllocMemory(size);
-		PopMemoryUsageType();
-
-		return mem;
+		// Allocate the requested memory from the host allocator, which pools command scope allocations
+		return AllocVulkanHostMemory(size, alignment, allocScope);
 	}
 	static void* VKAPI_CALL ReallocCallback(void* pUserData, void* pOriginal, size_t size, size_t alignment, VkSystemAllocationScope allocScope) {
-		// Reallocate the given memory
-		return ReallocMemory(pOriginal, size);
+		// Reallocate the given memory, keeping the requested alignment
+		return ReallocVulkanHostMemory(pOriginal, size, alignment, allocScope);
 	}
 	static void VKAPI_CALL FreeCallback(void* pUserData, void* pMemory) {
 		// Free the given memory
-		FreeMemory(pMemory);
+		FreeVulkanHostMemory(pMemory);
 	}
 
 	const VkAllocationCallbacks VulkanRenderer::VULKAN_ALLOC_CALLBACKS = {
@@ -35,8 +56,15 @@ namespace wfe {
 		nullptr
 	};
 
+	// Render graph callbacks
+	void VulkanRenderer::RecordForwardGraphPass(VkCommandBuffer commandBuffer, VulkanRenderGraph* graph, void* userData) {
+		// Record the forward pass, leaving the attachments' transitions to the graph
+		ForwardGraphPass* forwardGraphPass = (ForwardGraphPass*)userData;
+		forwardGraphPass->forwardPass->Record(commandBuffer, forwardGraphPass->imageIndex, forwardGraphPass->viewProjection, forwardGraphPass->drawQueue, false);
+	}
+
 	// Public functions
-	VulkanRenderer::VulkanRenderer(Window* window, bool8_t debugEnabled, Logger* logger) : window(window), logger(logger) {
+	VulkanRenderer::VulkanRenderer(Window* window, bool8_t debugEnabled, Logger* logger, JobSystem* jobSystem) : window(window), logger(logger), jobSystem(jobSystem) {
 		// Set the renderer memory usage
 		PushMemoryUsageType(MEMORY_USAGE_TYPE_RENDERER);
 
@@ -87,12 +115,406 @@ namespace wfe {
 			swapChain = nullptr;
 		}
 
+		// Create the descriptor layout cache and allocator
+		descriptorLayoutCache = NewObject<VulkanDescriptorLayoutCache>(device);
+		descriptorAllocator = NewObject<VulkanDescriptorAllocator>(device);
+
+		// Create the bindless heap, if the device supports it
+		if(VulkanBindlessHeap::IsSupported(device)) {
+			bindlessHeap = NewObject<VulkanBindlessHeap>(device, descriptorLayoutCache);
+		} else {
+			bindlessHeap = nullptr;
+		}
+
+		// Create the shader library; shaders are loaded lazily when first requested
+		shaderLibrary = NewObject<VulkanShaderLibrary>(device, descriptorLayoutCache, bindlessHeap, SHADER_DIRECTORY);
+
+		// Create the pipeline variant cache, loading the on-disk pipeline cache if it exists
+		pipelineVariantCache = NewObject<VulkanPipelineVariantCache>(device, PIPELINE_CACHE_PATH);
+
+		// The GPU culler, meshlet culler and depth pyramid allocate large buffers and compile their pipelines, so they're only created when first requested
+		gpuCuller = nullptr;
+		meshletCuller = nullptr;
+		depthPyramid = nullptr;
+		gpuCulledPacket = nullptr;
+		gpuInterpolationFactor = 1.f;
+
+		// Create the CPU frustum culler, culling large scenes on the job system
+		frustumCuller = NewObject<FrustumCuller>(jobSystem);
+
+		// Create the transient ring used for per-frame buffer data
+		transientRing = NewObject<VulkanTransientRing>(device, allocator, TRANSIENT_RING_CAPACITY, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
+		// Create the draw queue, sorting its draws on the job system
+		drawQueue = NewObject<VulkanDrawQueue>(device, transientRing, jobSystem);
+
+		// Create the forward pass, which registers its base pipeline, then create every variant listed in the manifest, so that the first frames drawing them don't wait for their pipelines to compile. The render graph recording the pass is only created when the first frame is rendered
+		forwardPass = nullptr;
+		renderGraph = nullptr;
+
+		if(GetForwardPass()) {
+			size_t variantCount = pipelineVariantCache->PrecompileManifest(VARIANT_MANIFEST_PATH);
+			logger->LogInfoMessage("Precompiled %zu Vulkan pipeline variants.", variantCount);
+		}
+
+		// Create every frame in flight's command buffer and synchronization objects. The fences start signaled, so that the first frames don't wait for frames that were never submitted
+		VkFenceCreateInfo fenceInfo {
+			.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = VK_FENCE_CREATE_SIGNALED_BIT
+		};
+		VkSemaphoreCreateInfo semaphoreInfo {
+			.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0
+		};
+
+		for(size_t i = 0; i != MAX_FRAMES_IN_FLIGHT; ++i) {
+			VkCommandBufferAllocateInfo commandBufferInfo {
+				.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+				.pNext = nullptr,
+				.commandPool = graphicsCommandPool->GetCommandPool(i),
+				.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+				.commandBufferCount = 1
+			};
+
+			VkResult result = loader->vkAllocateCommandBuffers(device->GetDevice(), &commandBufferInfo, commandBuffers + i);
+			if(result != VK_SUCCESS)
+				throw Exception("Failed to allocate Vulkan frame command buffer! Error code: %s", string_VkResult(result));
+
+			result = loader->vkCreateFence(device->GetDevice(), &fenceInfo, &VULKAN_ALLOC_CALLBACKS, inFlightFences + i);
+			if(result != VK_SUCCESS)
+				throw Exception("Failed to create Vulkan frame fence! Error code: %s", string_VkResult(result));
+
+			result = loader->vkCreateSemaphore(device->GetDevice(), &semaphoreInfo, &VULKAN_ALLOC_CALLBACKS, imageAvailableSemaphores + i);
+			if(result != VK_SUCCESS)
+				throw Exception("Failed to create Vulkan frame semaphore! Error code: %s", string_VkResult(result));
+
+			result = loader->vkCreateSemaphore(device->GetDevice(), &semaphoreInfo, &VULKAN_ALLOC_CALLBACKS, renderFinishedSemaphores + i);
+			if(result != VK_SUCCESS)
+				throw Exception("Failed to create Vulkan frame semaphore! Error code: %s", string_VkResult(result));
+		}
+		frameIndex = 0;
+
 		// Pop the memory usage
 		PopMemoryUsageType();
 	}
 
+	VulkanGpuCuller* VulkanRenderer::GetGpuCuller() {
+		// Create the GPU culler, which culls instances and writes their draws in compute shaders, if it wasn't already created and the device supports it
+		if(!gpuCuller && VulkanGpuCuller::IsSupported(device)) {
+			PushMemoryUsageType(MEMORY_USAGE_TYPE_RENDERER);
+			gpuCuller = NewObject<VulkanGpuCuller>(device, allocator, shaderLibrary, pipelineVariantCache, descriptorAllocator, MAX_GPU_INSTANCE_COUNT, MAX_GPU_MESH_COUNT);
+			PopMemoryUsageType();
+		}
+
+		return gpuCuller;
+	}
+	VulkanMeshletCuller* VulkanRenderer::GetMeshletCuller() {
+		// Create the meshlet culler, which uses mesh shaders if they're supported, if it wasn't already created
+		if(!meshletCuller) {
+			PushMemoryUsageType(MEMORY_USAGE_TYPE_RENDERER);
+			meshletCuller = NewObject<VulkanMeshletCuller>(device, allocator, shaderLibrary, pipelineVariantCache, descriptorAllocator, MESHLET_CULLER_LIMITS);
+			PopMemoryUsageType();
+		}
+
+		return meshletCuller;
+	}
+	VulkanDepthPyramid* VulkanRenderer::GetDepthPyramid() {
+		// Create the depth pyramid used for occlusion culling, if it wasn't already created and the swap chain exists
+		if(!depthPyramid && swapChain) {
+			PushMemoryUsageType(MEMORY_USAGE_TYPE_RENDERER);
+			depthPyramid = NewObject<VulkanDepthPyramid>(device, allocator, shaderLibrary, pipelineVariantCache, descriptorAllocator);
+			PopMemoryUsageType();
+		}
+
+		return depthPyramid;
+	}
+	VulkanForwardPass* VulkanRenderer::GetForwardPass() {
+		// Create the forward pass, which targets the swap chain's attachment formats, if it wasn't already created and the swap chain exists
+		if(!forwardPass && swapChain) {
+			PushMemoryUsageType(MEMORY_USAGE_TYPE_RENDERER);
+			forwardPass = NewObject<VulkanForwardPass>(device, swapChain, shaderLibrary, pipelineVariantCache, bindlessHeap);
+			PopMemoryUsageType();
+		}
+
+		return forwardPass;
+	}
+	VulkanRenderGraph* VulkanRenderer::GetRenderGraph() {
+		// Exit the function if the graph was already created, or if it can't be used
+		if(renderGraph || !swapChain || !device->GetCapabilities().synchronization2 || !swapChain->UsesDynamicRendering())
+			return renderGraph;
+
+		PushMemoryUsageType(MEMORY_USAGE_TYPE_RENDERER);
+		renderGraph = NewObject<VulkanRenderGraph>(device, allocator);
+		PopMemoryUsageType();
+
+		// Import the swap chain's attachments, whose previous contents are cleared by the forward pass
+		graphColorImage = renderGraph->ImportImage("SwapChainColor", VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+		graphDepthImage = renderGraph->ImportImage("SwapChainDepth", swapChain->GetDepthImageAspectFlags(), VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+		renderGraph->MarkOutput(graphColorImage);
+
+		// Add the forward pass, which writes both attachments
+		forwardGraphPass.forwardPass = GetForwardPass();
+		forwardGraphPass.drawQueue = drawQueue;
+
+		uint32_t pass = renderGraph->AddPass("Forward", RecordForwardGraphPass, &forwardGraphPass);
+		renderGraph->AddPassWrite(pass, graphColorImage, VulkanRenderGraph::ACCESS_TYPE_COLOR_ATTACHMENT_WRITE);
+		renderGraph->AddPassWrite(pass, graphDepthImage, VulkanRenderGraph::ACCESS_TYPE_DEPTH_ATTACHMENT_WRITE);
+
+		// Compile the graph once, as only the imported images change between frames
+		renderGraph->Compile();
+
+		return renderGraph;
+	}
+	void VulkanRenderer::RecordGpuCulledFrame(VkCommandBuffer commandBuffer, uint32_t imageIndex, const Matrix4& viewProjection) {
+		// Write the packet's interpolated instance transforms in instance order, as every culled draw uses its instance's index as its first instance
+		size_t meshInstanceCount = gpuCulledPacket->GetMeshInstanceCount();
+
+		VkDeviceSize transformOffset;
+		VulkanDrawQueue::InstanceTransform* transforms = (VulkanDrawQueue::InstanceTransform*)transientRing->Allocate(meshInstanceCount * sizeof(VulkanDrawQueue::InstanceTransform), 16, transformOffset);
+		for(size_t i = 0; i != meshInstanceCount; ++i)
+			transforms[i] = gpuCulledPacket->GetInterpolatedTransform(i, gpuInterpolationFactor);
+
+		VkBuffer transformBuffer = transientRing->GetBuffer();
+
+		// Set the view the instances are culled and their LODs are selected for
+		Vector3 cameraPosition = gpuCulledPacket->GetInterpolatedCamera(gpuInterpolationFactor).position;
+		VulkanGpuCuller::View view;
+		for(size_t i = 0; i != 4; ++i) {
+			view.viewProjection[i * 4] = viewProjection.columns[i].x;
+			view.viewProjection[i * 4 + 1] = viewProjection.columns[i].y;
+			view.viewProjection[i * 4 + 2] = viewProjection.columns[i].z;
+			view.viewProjection[i * 4 + 3] = viewProjection.columns[i].w;
+		}
+		view.cameraPosition[0] = cameraPosition.x;
+		view.cameraPosition[1] = cameraPosition.y;
+		view.cameraPosition[2] = cameraPosition.z;
+		view.projectionScale = ComputeProjectionScale(viewProjection);
+		view.viewportExtent = swapChain->GetVulkanSwapChainExtent();
+
+		// Draw the instances that were visible last frame, which occlude the rest
+		const VulkanDrawQueue::Draw& draw = gpuCulledPacket->GetDraws()[0];
+		VulkanForwardPass* pass = GetForwardPass();
+
+		gpuCuller->RecordCull(commandBuffer, frameIndex, VulkanGpuCuller::PHASE_EARLY, view);
+		pass->RecordCulled(commandBuffer, imageIndex, viewProjection, draw, transformBuffer, transformOffset, gpuCuller, frameIndex, VulkanGpuCuller::PHASE_EARLY, nullptr);
+
+		// Reduce the early draws' depth into the pyramid, then occlusion cull every instance against it and draw the ones that became visible, followed by the draws submitted to the draw queue
+		VulkanDepthPyramid* pyramid = GetDepthPyramid();
+		pyramid->RecordBuild(commandBuffer, swapChain, imageIndex);
+
+		gpuCuller->RecordCull(commandBuffer, frameIndex, VulkanGpuCuller::PHASE_LATE, view, pyramid);
+		pass->RecordCulled(commandBuffer, imageIndex, viewProjection, draw, transformBuffer, transformOffset, gpuCuller, frameIndex, VulkanGpuCuller::PHASE_LATE, drawQueue);
+	}
+	void VulkanRenderer::SubmitFramePacket(const FramePacket* packet, float32_t interpolationFactor) {
+		const VulkanDrawQueue::Draw* draws = packet->GetDraws();
+		size_t drawCount = packet->GetDrawCount();
+		const FramePacket::MeshInstance* meshInstances = packet->GetMeshInstances();
+		size_t meshInstanceCount = packet->GetMeshInstanceCount();
+
+		// Cull the packet's instances on the GPU if the culler is supported, the packet fits in it and its draws can all be recorded as the culler's indirect draws
+		gpuCulledPacket = nullptr;
+
+		bool8_t gpuCulled = swapChain && drawCount && meshInstanceCount && drawCount <= MAX_GPU_MESH_COUNT && meshInstanceCount <= MAX_GPU_INSTANCE_COUNT && GetGpuCuller();
+		for(size_t i = 1; gpuCulled && i != drawCount; ++i)
+			gpuCulled = SharesDrawState(draws[0], draws[i]);
+
+		if(!gpuCulled) {
+			for(size_t i = 0; i != meshInstanceCount; ++i)
+				drawQueue->SubmitInstance(meshInstances[i].sortKey, draws[meshInstances[i].drawIndex], packet->GetInterpolatedTransform(i, interpolationFactor));
+			return;
+		}
+
+		// Give every draw a mesh with a single LOD, only setting the meshes whose index ranges changed since the last GPU culled packet
+		while(gpuMeshes.size() < drawCount)
+			gpuMeshes.push_back({});
+
+		for(size_t i = 0; i != drawCount; ++i) {
+			VulkanGpuCuller::Mesh& mesh = gpuMeshes[i];
+			if(mesh.lodCount && mesh.lods[0].indexCount == draws[i].indexCount && mesh.lods[0].firstIndex == draws[i].firstIndex && mesh.vertexOffset == draws[i].vertexOffset)
+				continue;
+
+			mesh = {};
+			mesh.lods[0].indexCount = draws[i].indexCount;
+			mesh.lods[0].firstIndex = draws[i].firstIndex;
+			mesh.vertexOffset = draws[i].vertexOffset;
+			mesh.lodCount = 1;
+
+			gpuCuller->SetMeshes((uint32_t)i, 1, &mesh);
+		}
+
+		// Copy the instances' bounds and meshes to the culler a block at a time, moving the spheres along with the interpolated translations; the transforms are written when the frame is recorded
+		VulkanGpuCuller::Instance instances[GPU_INSTANCE_BLOCK_SIZE] {};
+		for(size_t i = 0; i < meshInstanceCount; i += GPU_INSTANCE_BLOCK_SIZE) {
+			uint32_t blockSize = (uint32_t)(meshInstanceCount - i < GPU_INSTANCE_BLOCK_SIZE ? meshInstanceCount - i : GPU_INSTANCE_BLOCK_SIZE);
+			for(uint32_t j = 0; j != blockSize; ++j) {
+				const FramePacket::MeshInstance& meshInstance = meshInstances[i + j];
+				for(size_t k = 0; k != 3; ++k)
+					instances[j].boundingSphere[k] = meshInstance.boundingSphere[k] + (meshInstance.previousTransform.rows[k][3] - meshInstance.transform.rows[k][3]) * (1.f - interpolationFactor);
+				instances[j].boundingSphere[3] = meshInstance.boundingSphere[3];
+				instances[j].meshIndex = meshInstance.drawIndex;
+			}
+
+			gpuCuller->SetInstances((uint32_t)i, blockSize, instances);
+		}
+
+		gpuCuller->SetInstanceCount((uint32_t)meshInstanceCount);
+		gpuCulledPacket = packet;
+		gpuInterpolationFactor = interpolationFactor;
+	}
+
+	void VulkanRenderer::RenderFrame(const Matrix4& viewProjection) {
+		// Skip the frame if there's nothing to present to, either because the renderer is compute only or because the window is minimized
+		if(!swapChain || !swapChain->GetVulkanSwapChain()) {
+			drawQueue->Clear();
+			gpuCulledPacket = nullptr;
+			return;
+		}
+
+		// Wait for the GPU to finish the last frame that used the current frame in flight's objects
+		VkResult result = loader->vkWaitForFences(device->GetDevice(), 1, inFlightFences + frameIndex, VK_TRUE, UINT64_T_MAX);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to wait for Vulkan frame fence! Error code: %s", string_VkResult(result));
+
+		// Free the transient ring's allocations, descriptor sets and retired pyramid images from the last use of the frame in flight, which the GPU is done reading
+		transientRing->ResetFrame(frameIndex);
+		descriptorAllocator->ResetFrame(frameIndex);
+		if(bindlessHeap)
+			bindlessHeap->ResetFrame(frameIndex);
+		if(depthPyramid)
+			depthPyramid->ResetFrame(frameIndex);
+
+		// Acquire the next swap chain image, recreating the swap chain and skipping the frame if it no longer matches the surface
+		uint32_t imageIndex;
+		result = loader->vkAcquireNextImageKHR(device->GetDevice(), swapChain->GetVulkanSwapChain(), UINT64_T_MAX, imageAvailableSemaphores[frameIndex], VK_NULL_HANDLE, &imageIndex);
+		if(result == VK_ERROR_OUT_OF_DATE_KHR) {
+			swapChain->RecreateSwapChain();
+			drawQueue->Clear();
+			gpuCulledPacket = nullptr;
+			return;
+		}
+		if(result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+			throw Exception("Failed to acquire Vulkan swap chain image! Error code: %s", string_VkResult(result));
+
+		// Reset the fence only once a submit is certain, as skipped frames would otherwise leave it unsignaled forever
+		result = loader->vkResetFences(device->GetDevice(), 1, inFlightFences + frameIndex);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to reset Vulkan frame fence! Error code: %s", string_VkResult(result));
+
+		// Reset the frame's command pool, recycling its command buffer's memory
+		result = loader->vkResetCommandPool(device->GetDevice(), graphicsCommandPool->GetCommandPool(frameIndex), 0);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to reset Vulkan frame command pool! Error code: %s", string_VkResult(result));
+
+		// Record the frame's commands
+		VkCommandBuffer commandBuffer = commandBuffers[frameIndex];
+		VkCommandBufferBeginInfo beginInfo {
+			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+			.pNext = nullptr,
+			.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+			.pInheritanceInfo = nullptr
+		};
+
+		result = loader->vkBeginCommandBuffer(commandBuffer, &beginInfo);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to begin Vulkan frame command buffer! Error code: %s", string_VkResult(result));
+
+		// Record the GPU culled phases if the packet's instances are culled on the GPU, otherwise record the forward pass through the render graph if it's supported, or with the swap chain's own transitions
+		VulkanRenderGraph* graph = GetRenderGraph();
+		if(gpuCulledPacket) {
+			RecordGpuCulledFrame(commandBuffer, imageIndex, viewProjection);
+		} else if(graph) {
+			const VulkanSwapChain::SwapChainImage& swapChainImage = swapChain->GetSwapChainImages()[imageIndex];
+			graph->SetImportedImage(graphColorImage, swapChainImage.image, swapChainImage.imageView);
+			graph->SetImportedImage(graphDepthImage, swapChainImage.depthImage, swapChainImage.depthImageView);
+
+			forwardGraphPass.imageIndex = imageIndex;
+			forwardGraphPass.viewProjection = viewProjection;
+			graph->Execute(commandBuffer);
+		} else {
+			GetForwardPass()->Record(commandBuffer, imageIndex, viewProjection, drawQueue);
+		}
+
+		result = loader->vkEndCommandBuffer(commandBuffer);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to end Vulkan frame command buffer! Error code: %s", string_VkResult(result));
+
+		// Submit the frame, waiting for the acquired image before writing to it
+		VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		VkSubmitInfo submitInfo {
+			.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+			.pNext = nullptr,
+			.waitSemaphoreCount = 1,
+			.pWaitSemaphores = imageAvailableSemaphores + frameIndex,
+			.pWaitDstStageMask = &waitStage,
+			.commandBufferCount = 1,
+			.pCommandBuffers = &commandBuffer,
+			.signalSemaphoreCount = 1,
+			.pSignalSemaphores = renderFinishedSemaphores + frameIndex
+		};
+
+		result = loader->vkQueueSubmit(device->GetGraphicsQueue(), 1, &submitInfo, inFlightFences[frameIndex]);
+		if(result != VK_SUCCESS)
+			throw Exception("Failed to submit Vulkan frame command buffer! Error code: %s", string_VkResult(result));
+
+		// Present the image once the frame finished rendering, recreating the swap chain if it no longer matches the surface
+		VkSwapchainKHR presentSwapChain = swapChain->GetVulkanSwapChain();
+		VkPresentInfoKHR presentInfo {
+			.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
+			.pNext = nullptr,
+			.waitSemaphoreCount = 1,
+			.pWaitSemaphores = renderFinishedSemaphores + frameIndex,
+			.swapchainCount = 1,
+			.pSwapchains = &presentSwapChain,
+			.pImageIndices = &imageIndex,
+			.pResults = nullptr
+		};
+
+		result = loader->vkQueuePresentKHR(device->GetPresentQueue(), &presentInfo);
+		if(result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
+			swapChain->RecreateSwapChain();
+		} else if(result != VK_SUCCESS) {
+			throw Exception("Failed to present Vulkan swap chain image! Error code: %s", string_VkResult(result));
+		}
+
+		// Clear the draw queue and the culled packet for the next frame and move on to the next frame in flight
+		drawQueue->Clear();
+		gpuCulledPacket = nullptr;
+		frameIndex = (frameIndex + 1) % MAX_FRAMES_IN_FLIGHT;
+	}
+
 	VulkanRenderer::~VulkanRenderer() {
+		// Wait for every frame in flight to finish before destroying the objects they use
+		loader->vkDeviceWaitIdle(device->GetDevice());
+
+		// Destroy every frame in flight's synchronization objects. The command buffers are freed along with their pools
+		for(size_t i = 0; i != MAX_FRAMES_IN_FLIGHT; ++i) {
+			loader->vkDestroyFence(device->GetDevice(), inFlightFences[i], &VULKAN_ALLOC_CALLBACKS);
+			loader->vkDestroySemaphore(device->GetDevice(), imageAvailableSemaphores[i], &VULKAN_ALLOC_CALLBACKS);
+			loader->vkDestroySemaphore(device->GetDevice(), renderFinishedSemaphores[i], &VULKAN_ALLOC_CALLBACKS);
+		}
+
 		// Destroy the core objects
+		if(renderGraph)
+			DestroyObject(renderGraph);
+		if(forwardPass)
+			DestroyObject(forwardPass);
+		DestroyObject(drawQueue);
+		DestroyObject(transientRing);
+		DestroyObject(frustumCuller);
+		if(depthPyramid)
+			DestroyObject(depthPyramid);
+		if(meshletCuller)
+			DestroyObject(meshletCuller);
+		if(gpuCuller)
+			DestroyObject(gpuCuller);
+		DestroyObject(pipelineVariantCache);
+		DestroyObject(shaderLibrary);
+		if(bindlessHeap)
+			DestroyObject(bindlessHeap);
+		DestroyObject(descriptorAllocator);
+		DestroyObject(descriptorLayoutCache);
 		if(swapChain)
 			DestroyObject(swapChain);
 		DestroyObject(allocator);
@@ -107,5 +529,12 @@ namespace wfe {
 
 		// Destroy the loader
 		DestroyObject(loader);
+
+		// Log the driver's host allocations per scope and free the unused host memory pools
+		for(size_t i = 0; i != HOST_ALLOC_SCOPE_COUNT; ++i) {
+			VulkanHostMemoryStats stats = GetVulkanHostMemoryStats((VkSystemAllocationScope)i);
+			logger->LogInfoMessage("Vulkan host memory: %s scope made %llu allocations totaling %llu bytes, %llu of them pooled; %llu allocations of %llu bytes still live.", HOST_ALLOC_SCOPE_NAMES[i], (unsigned long long)stats.allocationCount, (unsigned long long)stats.allocatedSize, (unsigned long long)stats.pooledAllocationCount, (unsigned long long)stats.liveAllocationCount, (unsigned long long)stats.liveSize);
+		}
+		TrimVulkanHostMemoryPools();
 	}
 }
\ No newline at end of file
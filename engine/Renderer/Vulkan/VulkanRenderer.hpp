@@ -1,12 +1,27 @@
 #pragma once
 
+#include "Renderer/Culling/FrustumCuller.hpp"
+#include "Renderer/FramePacket.hpp"
+#include "Culling/VulkanDepthPyramid.hpp"
+#include "Culling/VulkanGpuCuller.hpp"
+#include "Culling/VulkanMeshletCuller.hpp"
+#include "Descriptor/VulkanBindlessHeap.hpp"
+#include "Draw/VulkanDrawQueue.hpp"
+#include "Draw/VulkanForwardPass.hpp"
+#include "Descriptor/VulkanDescriptorAllocator.hpp"
+#include "Descriptor/VulkanDescriptorLayoutCache.hpp"
+#include "Graph/VulkanRenderGraph.hpp"
 #include "Instance/VulkanAllocator.hpp"
 #include "Instance/VulkanCommandPool.hpp"
 #include "Instance/VulkanDevice.hpp"
+#include "Instance/VulkanHostAllocator.hpp"
 #include "Instance/VulkanInstance.hpp"
 #include "Instance/VulkanSurface.hpp"
 #include "Instance/VulkanSwapChain.hpp"
+#include "Instance/VulkanTransientRing.hpp"
 #include "Loader/VulkanLoader.hpp"
+#include "Shader/VulkanPipelineVariantCache.hpp"
+#include "Shader/VulkanShaderLibrary.hpp"
 
 #include <Core.hpp>
 #include <vulkan/vk_platform.h>
@@ -25,18 +40,96 @@ namespace wfe {
 		/// @param window The window the renderer will display to, or nullptr if the renderer will be compute only.
 		/// @param debugEnabled True if debugging should be enabled, otherwise false.
 		/// @param logger The logger to use for general messages.
-		VulkanRenderer(Window* window, bool8_t debugEnabled, Logger* logger);
+		/// @param jobSystem The job system used to split CPU culling and draw sorting between threads.
+		VulkanRenderer(Window* window, bool8_t debugEnabled, Logger* logger, JobSystem* jobSystem);
 		VulkanRenderer(const VulkanRenderer&) = delete;
 		VulkanRenderer(VulkanRenderer&&) noexcept = delete;
 
 		VulkanRenderer& operator=(const VulkanRenderer&) = delete;
 		VulkanRenderer& operator=(VulkanRenderer&&) = delete;
 
+		/// @brief Gets the Vulkan renderer's descriptor layout cache.
+		/// @return A pointer to the Vulkan descriptor layout cache.
+		VulkanDescriptorLayoutCache* GetDescriptorLayoutCache() {
+			return descriptorLayoutCache;
+		}
+		/// @brief Gets the Vulkan renderer's descriptor allocator.
+		/// @return A pointer to the Vulkan descriptor allocator.
+		VulkanDescriptorAllocator* GetDescriptorAllocator() {
+			return descriptorAllocator;
+		}
+		/// @brief Gets the Vulkan renderer's bindless heap.
+		/// @return A pointer to the Vulkan bindless heap, or nullptr if the device doesn't support bindless resources.
+		VulkanBindlessHeap* GetBindlessHeap() {
+			return bindlessHeap;
+		}
+		/// @brief Gets the Vulkan renderer's shader library.
+		/// @return A pointer to the Vulkan shader library.
+		VulkanShaderLibrary* GetShaderLibrary() {
+			return shaderLibrary;
+		}
+		/// @brief Gets the Vulkan renderer's pipeline variant cache.
+		/// @return A pointer to the Vulkan pipeline variant cache.
+		VulkanPipelineVariantCache* GetPipelineVariantCache() {
+			return pipelineVariantCache;
+		}
+		/// @brief Gets the Vulkan renderer's GPU culler, creating it on first use.
+		/// @return A pointer to the Vulkan GPU culler, or nullptr if the device doesn't support GPU culling.
+		VulkanGpuCuller* GetGpuCuller();
+		/// @brief Gets the Vulkan renderer's meshlet culler, which culls and draws dense meshes split into meshlets, creating it on first use. RenderFrame doesn't record it, as frame packets carry no meshlet meshes and no meshlet graphics pipeline is registered yet; its owner records its cull and draws instead.
+		/// @return A pointer to the Vulkan meshlet culler.
+		VulkanMeshletCuller* GetMeshletCuller();
+		/// @brief Gets the Vulkan renderer's depth pyramid, used for occlusion culling, creating it on first use.
+		/// @return A pointer to the Vulkan depth pyramid, or nullptr if the renderer has no swap chain.
+		VulkanDepthPyramid* GetDepthPyramid();
+		/// @brief Gets the Vulkan renderer's transient ring, used for per-frame buffer data.
+		/// @return A pointer to the Vulkan transient ring.
+		VulkanTransientRing* GetTransientRing() {
+			return transientRing;
+		}
+		/// @brief Gets the Vulkan renderer's CPU frustum culler, whose visible indices select the draws submitted to the draw queue.
+		/// @return A pointer to the frustum culler.
+		FrustumCuller* GetFrustumCuller() {
+			return frustumCuller;
+		}
+		/// @brief Gets the Vulkan renderer's draw queue.
+		/// @return A pointer to the Vulkan draw queue.
+		VulkanDrawQueue* GetDrawQueue() {
+			return drawQueue;
+		}
+
+		/// @brief Gets the Vulkan renderer's forward pass, which draws the draw queue to the swap chain. It's created along with the renderer, right before the variant manifest is precompiled.
+		/// @return A pointer to the Vulkan forward pass, or nullptr if the renderer has no swap chain.
+		VulkanForwardPass* GetForwardPass();
+		/// @brief Gets the Vulkan renderer's render graph, which records the forward pass and generates its attachments' barriers, creating it on first use.
+		/// @return A pointer to the Vulkan render graph, or nullptr if the renderer has no swap chain or the device doesn't support synchronization2 and dynamic rendering.
+		VulkanRenderGraph* GetRenderGraph();
+
+		/// @brief Submits every mesh instance in the given frame packet. If the GPU culler is supported and every draw in the packet shares its state except for its index range, the instances are handed to the GPU culler, which culls them again against the frame's view and against the depth of the instances drawn first; otherwise they're submitted to the draw queue. Reads nothing but the packet, so the simulation may keep changing the game state the packet was built from.
+		/// @param packet The frame packet to submit. When its instances are culled on the GPU, their transforms are read from it by the next RenderFrame call, so it must stay unchanged until then.
+		/// @param interpolationFactor The factor to blend the instances' previous and current transforms with, where 1 draws the packet's tick as is.
+		void SubmitFramePacket(const FramePacket* packet, float32_t interpolationFactor);
+		/// @brief Renders and presents a frame, drawing every draw submitted since the last frame through the forward pass, then clears the draw queue. Frames whose packet is culled on the GPU draw the instances visible last frame, build the depth pyramid from their depth, then draw the instances that became visible. Waits for the GPU to finish the frame that last used the same frame in flight slot, so no more than MAX_FRAMES_IN_FLIGHT frames are ever queued.
+		/// @param viewProjection The view projection matrix to draw the frame with.
+		void RenderFrame(const Matrix4& viewProjection);
+
 		/// @brief Destroys the Vulkan renderer.
 		~VulkanRenderer();
 	private:
+		struct ForwardGraphPass {
+			VulkanForwardPass* forwardPass;
+			VulkanDrawQueue* drawQueue;
+			uint32_t imageIndex;
+			Matrix4 viewProjection;
+		};
+
+		static void RecordForwardGraphPass(VkCommandBuffer commandBuffer, VulkanRenderGraph* graph, void* userData);
+
+		void RecordGpuCulledFrame(VkCommandBuffer commandBuffer, uint32_t imageIndex, const Matrix4& viewProjection);
+
 		Window* window;
 		Logger* logger;
+		JobSystem* jobSystem;
 
 		VulkanLoader* loader;
 		VulkanInstance* instance;
@@ -48,5 +141,30 @@ namespace wfe {
 		VulkanCommandPool* computeCommandPool;
 		VulkanAllocator* allocator;
 		VulkanSwapChain* swapChain;
+		VulkanDescriptorLayoutCache* descriptorLayoutCache;
+		VulkanDescriptorAllocator* descriptorAllocator;
+		VulkanBindlessHeap* bindlessHeap;
+		VulkanShaderLibrary* shaderLibrary;
+		VulkanPipelineVariantCache* pipelineVariantCache;
+		VulkanGpuCuller* gpuCuller;
+		VulkanMeshletCuller* meshletCuller;
+		VulkanDepthPyramid* depthPyramid;
+		FrustumCuller* frustumCuller;
+		VulkanTransientRing* transientRing;
+		VulkanDrawQueue* drawQueue;
+		VulkanForwardPass* forwardPass;
+		VulkanRenderGraph* renderGraph;
+		VulkanRenderGraph::ResourceHandle graphColorImage;
+		VulkanRenderGraph::ResourceHandle graphDepthImage;
+		ForwardGraphPass forwardGraphPass;
+		const FramePacket* gpuCulledPacket;
+		float32_t gpuInterpolationFactor;
+		vector<VulkanGpuCuller::Mesh> gpuMeshes;
+
+		VkCommandBuffer commandBuffers[MAX_FRAMES_IN_FLIGHT];
+		VkFence inFlightFences[MAX_FRAMES_IN_FLIGHT];
+		VkSemaphore imageAvailableSemaphores[MAX_FRAMES_IN_FLIGHT];
+		VkSemaphore renderFinishedSemaphores[MAX_FRAMES_IN_FLIGHT];
+		size_t frameIndex;
 	};
-}
+}
\ No newline at end of file
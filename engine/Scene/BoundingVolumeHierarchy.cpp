@@ -0,0 +1,607 @@
+#include "BoundingVolumeHierarchy.hpp"
+
+#include <float.h>
+#include <math.h>
+
+namespace wfe {
+	// Constants
+	static const uint32_t SAH_BIN_COUNT = 16;
+	static const uint32_t MAX_SAH_DEPTH = 32;
+	static const size_t MAX_TRAVERSAL_DEPTH = 128;
+	static const float32_t TRAVERSAL_COST = 1.f;
+	static const size_t MIN_UNINDEXED_REBUILD_COUNT = 64;
+
+	static const uint8_t OBJECT_FLAG_ALIVE = 1;
+	static const uint8_t OBJECT_FLAG_INDEXED = 2;
+
+	static const BoundingVolumeHierarchy::Aabb EMPTY_AABB { { FLT_MAX, FLT_MAX, FLT_MAX }, { -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+
+	// Internal structs
+	struct SahBin {
+		BoundingVolumeHierarchy::Aabb bounds;
+		uint32_t count;
+	};
+
+	// Internal helper functions
+	static void ExpandAabb(BoundingVolumeHierarchy::Aabb& aabb, const float32_t* min, const float32_t* max) {
+		for(size_t i = 0; i != 3; ++i) {
+			aabb.min[i] = min[i] < aabb.min[i] ? min[i] : aabb.min[i];
+			aabb.max[i] = max[i] > aabb.max[i] ? max[i] : aabb.max[i];
+		}
+	}
+	static float32_t GetSurfaceArea(const float32_t* min, const float32_t* max) {
+		// Empty boxes have no area
+		float32_t sizeX = max[0] - min[0];
+		float32_t sizeY = max[1] - min[1];
+		float32_t sizeZ = max[2] - min[2];
+		if(sizeX < 0.f || sizeY < 0.f || sizeZ < 0.f)
+			return 0.f;
+
+		return 2.f * (sizeX * sizeY + sizeY * sizeZ + sizeZ * sizeX);
+	}
+	static bool8_t IntersectAabbs(const float32_t* min, const float32_t* max, const BoundingVolumeHierarchy::Aabb& aabb) {
+		return min[0] <= aabb.max[0] && max[0] >= aabb.min[0] && min[1] <= aabb.max[1] && max[1] >= aabb.min[1] && min[2] <= aabb.max[2] && max[2] >= aabb.min[2];
+	}
+	static bool8_t IntersectRay(const float32_t* min, const float32_t* max, const float32_t* origin, const float32_t* invDirection, float32_t maxDistance, float32_t& entryDistance) {
+		// Clip the ray against every axis' slab
+		float32_t entry = 0.f;
+		float32_t exit = maxDistance;
+
+		for(size_t i = 0; i != 3; ++i) {
+			float32_t near = (min[i] - origin[i]) * invDirection[i];
+			float32_t far = (max[i] - origin[i]) * invDirection[i];
+			if(near > far) {
+				float32_t temp = near;
+				near = far;
+				far = temp;
+			}
+
+			// The comparisons are written so that NaNs from rays parallel to a slab's planes are ignored
+			entry = near > entry ? near : entry;
+			exit = far < exit ? far : exit;
+		}
+
+		entryDistance = entry;
+		return entry <= exit;
+	}
+	static uint32_t TestFrustumPlanes(const float32_t* min, const float32_t* max, const FrustumCuller::Plane* planes, uint32_t planeMask) {
+		// Test the box against every plane it still intersects, returning UINT32_T_MAX if it's outside any plane and removing the planes it's fully inside of
+		for(size_t i = 0; i != FrustumCuller::PLANE_COUNT; ++i) {
+			if(!(planeMask & (1 << i)))
+				continue;
+
+			const FrustumCuller::Plane& plane = planes[i];
+			float32_t distance = plane.distance;
+			float32_t radius = 0.f;
+			for(size_t j = 0; j != 3; ++j) {
+				distance += plane.normal[j] * (min[j] + max[j]) * .5f;
+				radius += fabsf(plane.normal[j]) * (max[j] - min[j]) * .5f;
+			}
+
+			if(distance + radius < 0.f)
+				return UINT32_T_MAX;
+			if(distance - radius >= 0.f)
+				planeMask &= ~(1 << i);
+		}
+
+		return planeMask;
+	}
+
+	uint32_t BoundingVolumeHierarchy::BuildNode(Tree* tree, const Aabb* bounds, uint32_t begin, uint32_t end, uint32_t depth) {
+		uint32_t* items = tree->items.data();
+		uint32_t count = end - begin;
+
+		// Get the bounds of the node's objects and of their centroids
+		Aabb nodeBounds = EMPTY_AABB;
+		Aabb centroidBounds = EMPTY_AABB;
+
+		for(uint32_t i = begin; i != end; ++i) {
+			const Aabb& objectBounds = bounds[items[i]];
+			float32_t centroid[3] = { objectBounds.min[0] + objectBounds.max[0], objectBounds.min[1] + objectBounds.max[1], objectBounds.min[2] + objectBounds.max[2] };
+
+			ExpandAabb(nodeBounds, objectBounds.min, objectBounds.max);
+			ExpandAabb(centroidBounds, centroid, centroid);
+		}
+
+		// Add the node, before its children to keep the depth-first order
+		uint32_t nodeIndex = (uint32_t)tree->nodes.size();
+		tree->nodes.push_back({ { nodeBounds.min[0], nodeBounds.min[1], nodeBounds.min[2] }, begin, { nodeBounds.max[0], nodeBounds.max[1], nodeBounds.max[2] }, count });
+
+		if(count == 1)
+			return nodeIndex;
+
+		// Find the cheapest split by binning the centroids on every axis
+		uint32_t bestAxis = UINT32_T_MAX;
+		uint32_t bestBin = 0;
+		float32_t bestCost = FLT_MAX;
+
+		if(depth < MAX_SAH_DEPTH) {
+			for(uint32_t axis = 0; axis != 3; ++axis) {
+				float32_t extent = centroidBounds.max[axis] - centroidBounds.min[axis];
+				if(!(extent > 0.f))
+					continue;
+
+				SahBin bins[SAH_BIN_COUNT];
+				for(uint32_t i = 0; i != SAH_BIN_COUNT; ++i)
+					bins[i] = { EMPTY_AABB, 0 };
+
+				float32_t binScale = (float32_t)SAH_BIN_COUNT / extent;
+				for(uint32_t i = begin; i != end; ++i) {
+					const Aabb& objectBounds = bounds[items[i]];
+					uint32_t bin = (uint32_t)((objectBounds.min[axis] + objectBounds.max[axis] - centroidBounds.min[axis]) * binScale);
+					bin = bin < SAH_BIN_COUNT ? bin : SAH_BIN_COUNT - 1;
+
+					ExpandAabb(bins[bin].bounds, objectBounds.min, objectBounds.max);
+					++bins[bin].count;
+				}
+
+				// Sweep the bins from the right to get the cost of every right side, then from the left to get every split's cost
+				float32_t rightCosts[SAH_BIN_COUNT];
+				Aabb sideBounds = EMPTY_AABB;
+				uint32_t sideCount = 0;
+
+				for(uint32_t i = SAH_BIN_COUNT - 1; i; --i) {
+					ExpandAabb(sideBounds, bins[i].bounds.min, bins[i].bounds.max);
+					sideCount += bins[i].count;
+					rightCosts[i] = GetSurfaceArea(sideBounds.min, sideBounds.max) * (float32_t)sideCount;
+				}
+
+				sideBounds = EMPTY_AABB;
+				sideCount = 0;
+
+				for(uint32_t i = 1; i != SAH_BIN_COUNT; ++i) {
+					ExpandAabb(sideBounds, bins[i - 1].bounds.min, bins[i - 1].bounds.max);
+					sideCount += bins[i - 1].count;
+
+					float32_t cost = GetSurfaceArea(sideBounds.min, sideBounds.max) * (float32_t)sideCount + rightCosts[i];
+					if(sideCount && sideCount != count && cost < bestCost) {
+						bestAxis = axis;
+						bestBin = i;
+						bestCost = cost;
+					}
+				}
+			}
+		}
+
+		// Keep small nodes as leaves if splitting them wouldn't lower the cost
+		float32_t nodeArea = GetSurfaceArea(nodeBounds.min, nodeBounds.max);
+		if(count <= MAX_LEAF_SIZE && (bestAxis == UINT32_T_MAX || (float32_t)count * nodeArea <= TRAVERSAL_COST * nodeArea + bestCost))
+			return nodeIndex;
+
+		// Partition the items by the chosen split, or in half if no split was found
+		uint32_t middle;
+		if(bestAxis != UINT32_T_MAX) {
+			float32_t binScale = (float32_t)SAH_BIN_COUNT / (centroidBounds.max[bestAxis] - centroidBounds.min[bestAxis]);
+
+			middle = begin;
+			for(uint32_t i = begin; i != end; ++i) {
+				const Aabb& objectBounds = bounds[items[i]];
+				uint32_t bin = (uint32_t)((objectBounds.min[bestAxis] + objectBounds.max[bestAxis] - centroidBounds.min[bestAxis]) * binScale);
+				if(bin < bestBin) {
+					uint32_t temp = items[i];
+					items[i] = items[middle];
+					items[middle++] = temp;
+				}
+			}
+		} else {
+			middle = begin + count / 2;
+		}
+
+		// Build the children and link the right one
+		BuildNode(tree, bounds, begin, middle, depth + 1);
+		uint32_t rightIndex = BuildNode(tree, bounds, middle, end, depth + 1);
+
+		tree->nodes[nodeIndex].offset = rightIndex;
+		tree->nodes[nodeIndex].count = 0;
+
+		return nodeIndex;
+	}
+	void BoundingVolumeHierarchy::BuildTree(Tree* tree, const Aabb* bounds, const uint32_t* objects, size_t objectCount) {
+		// Reset the tree
+		tree->nodes.clear();
+		tree->items.resize(objectCount);
+		memcpy(tree->items.data(), objects, objectCount * sizeof(uint32_t));
+
+		// Build the nodes recursively, then save the fresh tree's cost
+		if(objectCount)
+			BuildNode(tree, bounds, 0, (uint32_t)objectCount, 0);
+
+		RefitTree(tree, bounds);
+		tree->builtCost = tree->cost;
+	}
+	void BoundingVolumeHierarchy::RefitTree(Tree* tree, const Aabb* bounds) {
+		// Exit the function if the tree is empty
+		if(!tree->nodes.size()) {
+			tree->cost = 0.f;
+			return;
+		}
+
+		// Refit the nodes in reverse depth-first order, so that children are always refit before their parents, summing up the SAH cost
+		Node* nodes = tree->nodes.data();
+		const uint32_t* items = tree->items.data();
+		float32_t cost = 0.f;
+
+		for(size_t i = tree->nodes.size(); i--;) {
+			Node& node = nodes[i];
+			Aabb nodeBounds = EMPTY_AABB;
+
+			if(node.count) {
+				for(uint32_t j = node.offset; j != node.offset + node.count; ++j)
+					ExpandAabb(nodeBounds, bounds[items[j]].min, bounds[items[j]].max);
+
+				cost += GetSurfaceArea(nodeBounds.min, nodeBounds.max) * (float32_t)node.count;
+			} else {
+				ExpandAabb(nodeBounds, nodes[i + 1].min, nodes[i + 1].max);
+				ExpandAabb(nodeBounds, nodes[node.offset].min, nodes[node.offset].max);
+
+				cost += GetSurfaceArea(nodeBounds.min, nodeBounds.max) * TRAVERSAL_COST;
+			}
+
+			memcpy(node.min, nodeBounds.min, sizeof(node.min));
+			memcpy(node.max, nodeBounds.max, sizeof(node.max));
+		}
+
+		// Make the cost relative to the root's area
+		float32_t rootArea = GetSurfaceArea(nodes[0].min, nodes[0].max);
+		tree->cost = rootArea > 0.f ? cost / rootArea : 0.f;
+	}
+	void BoundingVolumeHierarchy::BuildJob(void* userData) {
+		// Build the pending tree from the snapshot; the build counter tells the owning thread once it's done
+		BoundingVolumeHierarchy* hierarchy = (BoundingVolumeHierarchy*)userData;
+
+		PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
+		BuildTree(hierarchy->buildTree, hierarchy->buildBounds.data(), hierarchy->buildObjects.data(), hierarchy->buildObjects.size());
+		PopMemoryUsageType();
+	}
+
+	void BoundingVolumeHierarchy::SnapshotObjects() {
+		// Copy the bounds of every live object, so that the build doesn't race with later updates
+		buildBounds.resize(objectBounds.size());
+		memcpy(buildBounds.data(), objectBounds.data(), objectBounds.size() * sizeof(Aabb));
+
+		buildObjects.clear();
+		for(size_t i = 0; i != objectFlags.size(); ++i)
+			if(objectFlags[i] & OBJECT_FLAG_ALIVE)
+				buildObjects.push_back((uint32_t)i);
+	}
+	void BoundingVolumeHierarchy::FinishBuild() {
+		// Swap in the new tree
+		Tree* oldTree = tree;
+		tree = buildTree;
+		buildTree = oldTree;
+
+		// Mark the objects included in the new tree as indexed, then find the objects added since the snapshot
+		for(size_t i = 0; i != objectFlags.size(); ++i)
+			objectFlags[i] &= ~OBJECT_FLAG_INDEXED;
+		for(size_t i = 0; i != tree->items.size(); ++i)
+			objectFlags[tree->items[i]] |= OBJECT_FLAG_INDEXED;
+
+		unindexedObjects.clear();
+		for(size_t i = 0; i != objectFlags.size(); ++i)
+			if(objectFlags[i] == OBJECT_FLAG_ALIVE)
+				unindexedObjects.push_back((uint32_t)i);
+
+		// Refit the new tree, as objects may have moved or been removed since the snapshot
+		refitNeeded = true;
+	}
+	void BoundingVolumeHierarchy::WaitForBuild() {
+		// Exit the function if no build is running
+		if(!building)
+			return;
+
+		// Wait for the build job, running other jobs in the meantime
+		jobSystem->Wait(&buildCounter);
+		building = false;
+	}
+
+	// Public functions
+	BoundingVolumeHierarchy::BoundingVolumeHierarchy(JobSystem* jobSystem) : refitNeeded(false), jobSystem(jobSystem), building(false) {
+		tree = NewObject<Tree>();
+		buildTree = NewObject<Tree>();
+
+		tree->cost = 0.f;
+		tree->builtCost = 0.f;
+	}
+
+	uint32_t BoundingVolumeHierarchy::AddObject(const Aabb& bounds) {
+		// Reuse a removed object's index, if one exists
+		uint32_t index;
+		if(freeObjects.size()) {
+			index = freeObjects.back();
+			freeObjects.pop_back();
+
+			objectBounds[index] = bounds;
+			objectFlags[index] = (objectFlags[index] & OBJECT_FLAG_INDEXED) | OBJECT_FLAG_ALIVE;
+		} else {
+			index = (uint32_t)objectBounds.size();
+
+			objectBounds.push_back(bounds);
+			objectFlags.push_back(OBJECT_FLAG_ALIVE);
+		}
+
+		// Refit the tree if the index's slot is still in it, otherwise test the object linearly until the next rebuild
+		if(objectFlags[index] & OBJECT_FLAG_INDEXED) {
+			refitNeeded = true;
+		} else {
+			unindexedObjects.push_back(index);
+		}
+
+		return index;
+	}
+	void BoundingVolumeHierarchy::SetObjectBounds(uint32_t index, const Aabb& bounds) {
+		objectBounds[index] = bounds;
+		if(objectFlags[index] & OBJECT_FLAG_INDEXED)
+			refitNeeded = true;
+	}
+	void BoundingVolumeHierarchy::RemoveObject(uint32_t index) {
+		// Remove the object from the unindexed objects, or refit the tree with its slot emptied
+		if(objectFlags[index] & OBJECT_FLAG_INDEXED) {
+			refitNeeded = true;
+		} else {
+			for(size_t i = 0; i != unindexedObjects.size(); ++i) {
+				if(unindexedObjects[i] == index) {
+					unindexedObjects[i] = unindexedObjects.back();
+					unindexedObjects.pop_back();
+					break;
+				}
+			}
+		}
+
+		objectBounds[index] = EMPTY_AABB;
+		objectFlags[index] &= ~OBJECT_FLAG_ALIVE;
+		freeObjects.push_back(index);
+	}
+	void BoundingVolumeHierarchy::Build() {
+		// Discard any running background build
+		WaitForBuild();
+
+		// Build the tree on the calling thread
+		PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
+		SnapshotObjects();
+		BuildTree(buildTree, buildBounds.data(), buildObjects.data(), buildObjects.size());
+		PopMemoryUsageType();
+
+		FinishBuild();
+		refitNeeded = false;
+	}
+	void BoundingVolumeHierarchy::Update() {
+		// Swap in the background build's tree if it finished
+		if(building && buildCounter.IsDone()) {
+			building = false;
+			FinishBuild();
+		}
+
+		// Refit the tree if any of its objects changed
+		if(refitNeeded) {
+			RefitTree(tree, objectBounds.data());
+			refitNeeded = false;
+		}
+
+		// Rebuild the tree if its quality degraded or too many objects are tested linearly
+		if(!building && (tree->cost > tree->builtCost * REBUILD_COST_RATIO || (unindexedObjects.size() > MIN_UNINDEXED_REBUILD_COUNT && unindexedObjects.size() * 8 > objectBounds.size()))) {
+			// Rebuild on the calling thread if there's no job system to submit the build to
+			if(!jobSystem) {
+				Build();
+				return;
+			}
+
+			PushMemoryUsageType(MEMORY_USAGE_TYPE_COMMAND);
+			SnapshotObjects();
+			PopMemoryUsageType();
+
+			JobSystem::Job job { BuildJob, this };
+			jobSystem->Submit(1, &job, &buildCounter);
+			building = true;
+		}
+	}
+
+	void BoundingVolumeHierarchy::QueryFrustum(const FrustumCuller::Plane* planes, vector<uint32_t>& objects) const {
+		// Traverse the tree, skipping the plane tests of nodes fully inside them
+		const uint32_t ALL_PLANES_MASK = (1 << FrustumCuller::PLANE_COUNT) - 1;
+
+		if(tree->nodes.size()) {
+			const Node* nodes = tree->nodes.data();
+			const uint32_t* items = tree->items.data();
+
+			uint32_t stack[MAX_TRAVERSAL_DEPTH][2];
+			size_t stackSize = 0;
+			stack[stackSize][0] = 0;
+			stack[stackSize++][1] = ALL_PLANES_MASK;
+
+			while(stackSize) {
+				--stackSize;
+				const Node& node = nodes[stack[stackSize][0]];
+				uint32_t planeMask = TestFrustumPlanes(node.min, node.max, planes, stack[stackSize][1]);
+				if(planeMask == UINT32_T_MAX)
+					continue;
+
+				if(node.count) {
+					for(uint32_t i = node.offset; i != node.offset + node.count; ++i) {
+						uint32_t object = items[i];
+						if((objectFlags[object] & OBJECT_FLAG_ALIVE) && (!planeMask || TestFrustumPlanes(objectBounds[object].min, objectBounds[object].max, planes, planeMask) != UINT32_T_MAX))
+							objects.push_back(object);
+					}
+				} else {
+					uint32_t nodeIndex = (uint32_t)(&node - nodes);
+
+					stack[stackSize][0] = node.offset;
+					stack[stackSize++][1] = planeMask;
+					stack[stackSize][0] = nodeIndex + 1;
+					stack[stackSize++][1] = planeMask;
+				}
+			}
+		}
+
+		// Test the unindexed objects linearly
+		for(size_t i = 0; i != unindexedObjects.size(); ++i) {
+			uint32_t object = unindexedObjects[i];
+			if(TestFrustumPlanes(objectBounds[object].min, objectBounds[object].max, planes, ALL_PLANES_MASK) != UINT32_T_MAX)
+				objects.push_back(object);
+		}
+	}
+	void BoundingVolumeHierarchy::QueryAabb(const Aabb& bounds, vector<uint32_t>& objects) const {
+		// Traverse the tree
+		if(tree->nodes.size()) {
+			const Node* nodes = tree->nodes.data();
+			const uint32_t* items = tree->items.data();
+
+			uint32_t stack[MAX_TRAVERSAL_DEPTH];
+			size_t stackSize = 0;
+			stack[stackSize++] = 0;
+
+			while(stackSize) {
+				uint32_t nodeIndex = stack[--stackSize];
+				const Node& node = nodes[nodeIndex];
+				if(!IntersectAabbs(node.min, node.max, bounds))
+					continue;
+
+				if(node.count) {
+					for(uint32_t i = node.offset; i != node.offset + node.count; ++i) {
+						uint32_t object = items[i];
+						if((objectFlags[object] & OBJECT_FLAG_ALIVE) && IntersectAabbs(objectBounds[object].min, objectBounds[object].max, bounds))
+							objects.push_back(object);
+					}
+				} else {
+					stack[stackSize++] = node.offset;
+					stack[stackSize++] = nodeIndex + 1;
+				}
+			}
+		}
+
+		// Test the unindexed objects linearly
+		for(size_t i = 0; i != unindexedObjects.size(); ++i) {
+			uint32_t object = unindexedObjects[i];
+			if(IntersectAabbs(objectBounds[object].min, objectBounds[object].max, bounds))
+				objects.push_back(object);
+		}
+	}
+	void BoundingVolumeHierarchy::QueryRay(const float32_t* origin, const float32_t* direction, float32_t maxDistance, vector<uint32_t>& objects) const {
+		float32_t invDirection[3] = { 1.f / direction[0], 1.f / direction[1], 1.f / direction[2] };
+		float32_t entryDistance;
+
+		// Traverse the tree
+		if(tree->nodes.size()) {
+			const Node* nodes = tree->nodes.data();
+			const uint32_t* items = tree->items.data();
+
+			uint32_t stack[MAX_TRAVERSAL_DEPTH];
+			size_t stackSize = 0;
+			stack[stackSize++] = 0;
+
+			while(stackSize) {
+				uint32_t nodeIndex = stack[--stackSize];
+				const Node& node = nodes[nodeIndex];
+				if(!IntersectRay(node.min, node.max, origin, invDirection, maxDistance, entryDistance))
+					continue;
+
+				if(node.count) {
+					for(uint32_t i = node.offset; i != node.offset + node.count; ++i) {
+						uint32_t object = items[i];
+						if((objectFlags[object] & OBJECT_FLAG_ALIVE) && IntersectRay(objectBounds[object].min, objectBounds[object].max, origin, invDirection, maxDistance, entryDistance))
+							objects.push_back(object);
+					}
+				} else {
+					stack[stackSize++] = node.offset;
+					stack[stackSize++] = nodeIndex + 1;
+				}
+			}
+		}
+
+		// Test the unindexed objects linearly
+		for(size_t i = 0; i != unindexedObjects.size(); ++i) {
+			uint32_t object = unindexedObjects[i];
+			if(IntersectRay(objectBounds[object].min, objectBounds[object].max, origin, invDirection, maxDistance, entryDistance))
+				objects.push_back(object);
+		}
+	}
+	uint32_t BoundingVolumeHierarchy::Raycast(const float32_t* origin, const float32_t* direction, float32_t maxDistance, float32_t& hitDistance) const {
+		float32_t invDirection[3] = { 1.f / direction[0], 1.f / direction[1], 1.f / direction[2] };
+		float32_t entryDistance;
+
+		uint32_t hitObject = UINT32_T_MAX;
+		hitDistance = maxDistance;
+
+		// Test the unindexed objects linearly first, so that their hits can prune the tree's traversal
+		for(size_t i = 0; i != unindexedObjects.size(); ++i) {
+			uint32_t object = unindexedObjects[i];
+			if(IntersectRay(objectBounds[object].min, objectBounds[object].max, origin, invDirection, hitDistance, entryDistance) && (entryDistance < hitDistance || hitObject == UINT32_T_MAX)) {
+				hitObject = object;
+				hitDistance = entryDistance;
+			}
+		}
+
+		// Traverse the tree from front to back, skipping nodes behind the closest hit
+		if(tree->nodes.size()) {
+			const Node* nodes = tree->nodes.data();
+			const uint32_t* items = tree->items.data();
+
+			uint32_t stack[MAX_TRAVERSAL_DEPTH];
+			size_t stackSize = 0;
+			stack[stackSize++] = 0;
+
+			while(stackSize) {
+				uint32_t nodeIndex = stack[--stackSize];
+				const Node& node = nodes[nodeIndex];
+				if(!IntersectRay(node.min, node.max, origin, invDirection, hitDistance, entryDistance))
+					continue;
+
+				if(node.count) {
+					for(uint32_t i = node.offset; i != node.offset + node.count; ++i) {
+						uint32_t object = items[i];
+						if((objectFlags[object] & OBJECT_FLAG_ALIVE) && IntersectRay(objectBounds[object].min, objectBounds[object].max, origin, invDirection, hitDistance, entryDistance) && (entryDistance < hitDistance || hitObject == UINT32_T_MAX)) {
+							hitObject = object;
+							hitDistance = entryDistance;
+						}
+					}
+				} else {
+					// Push the farther child first, so that the closer one is visited first
+					const Node& leftNode = nodes[nodeIndex + 1];
+					const Node& rightNode = nodes[node.offset];
+					float32_t leftDistance = FLT_MAX, rightDistance = FLT_MAX;
+					bool8_t leftHit = IntersectRay(leftNode.min, leftNode.max, origin, invDirection, hitDistance, leftDistance);
+					bool8_t rightHit = IntersectRay(rightNode.min, rightNode.max, origin, invDirection, hitDistance, rightDistance);
+
+					if(leftHit && rightHit) {
+						if(leftDistance <= rightDistance) {
+							stack[stackSize++] = node.offset;
+							stack[stackSize++] = nodeIndex + 1;
+						} else {
+							stack[stackSize++] = nodeIndex + 1;
+							stack[stackSize++] = node.offset;
+						}
+					} else if(leftHit) {
+						stack[stackSize++] = nodeIndex + 1;
+					} else if(rightHit) {
+						stack[stackSize++] = node.offset;
+					}
+				}
+			}
+		}
+
+		return hitObject;
+	}
+	void BoundingVolumeHierarchy::Clear() {
+		// Discard any running background build
+		WaitForBuild();
+
+		// Clear every object and the tree
+		objectBounds.clear();
+		objectFlags.clear();
+		freeObjects.clear();
+		unindexedObjects.clear();
+		refitNeeded = false;
+
+		tree->nodes.clear();
+		tree->items.clear();
+		tree->cost = 0.f;
+		tree->builtCost = 0.f;
+	}
+
+	BoundingVolumeHierarchy::~BoundingVolumeHierarchy() {
+		// Wait for any running background build, then destroy both trees
+		WaitForBuild();
+
+		DestroyObject(tree);
+		DestroyObject(buildTree);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "General/JobSystem.hpp"
+#include "Renderer/Culling/FrustumCuller.hpp"
+
+#include <Core.hpp>
+
+namespace wfe {
+	/// @brief A bounding volume hierarchy over axis-aligned object bounds, used for frustum, ray and box queries. Moved objects are refit incrementally and the hierarchy is rebuilt by a background job when its quality degrades.
+	class BoundingVolumeHierarchy {
+	public:
+		/// @brief The maximum number of objects in a leaf node.
+		static const uint32_t MAX_LEAF_SIZE = 8;
+		/// @brief The ratio between the current and the freshly built SAH cost above which the hierarchy is rebuilt.
+		static constexpr float32_t REBUILD_COST_RATIO = 1.5f;
+
+		/// @brief A struct containing an axis-aligned bounding box.
+		struct Aabb {
+			/// @brief The box's minimum corner.
+			float32_t min[3];
+			/// @brief The box's maximum corner.
+			float32_t max[3];
+		};
+		/// @brief A struct containing a hierarchy node. Nodes are stored in depth-first order, so an inner node's left child always follows it.
+		struct Node {
+			/// @brief The minimum corner of the node's bounds.
+			float32_t min[3];
+			/// @brief The index of the right child for inner nodes, or the index of the first item for leaf nodes.
+			uint32_t offset;
+			/// @brief The maximum corner of the node's bounds.
+			float32_t max[3];
+			/// @brief The number of items in a leaf node, or 0 for inner nodes.
+			uint32_t count;
+		};
+
+		/// @brief Creates an empty bounding volume hierarchy.
+		/// @param jobSystem The job system background rebuilds are submitted to, or nullptr to rebuild on the thread that updates the hierarchy.
+		BoundingVolumeHierarchy(JobSystem* jobSystem);
+		BoundingVolumeHierarchy(const BoundingVolumeHierarchy&) = delete;
+		BoundingVolumeHierarchy(BoundingVolumeHierarchy&&) noexcept = delete;
+
+		BoundingVolumeHierarchy& operator=(const BoundingVolumeHierarchy&) = delete;
+		BoundingVolumeHierarchy& operator=(BoundingVolumeHierarchy&&) = delete;
+
+		/// @brief Gets the number of object slots, including the slots of removed objects.
+		/// @return The hierarchy's object slot count.
+		size_t GetObjectCount() const {
+			return objectBounds.size();
+		}
+		/// @brief Gets the number of nodes in the current hierarchy.
+		/// @return The hierarchy's node count.
+		size_t GetNodeCount() const {
+			return tree->nodes.size();
+		}
+		/// @brief Gets the current hierarchy's SAH cost, relative to its root's surface area.
+		/// @return The hierarchy's current cost.
+		float32_t GetCost() const {
+			return tree->cost;
+		}
+		/// @brief Gets the job system background rebuilds are submitted to.
+		/// @return A pointer to the job system, or nullptr if rebuilds run on the thread that updates the hierarchy.
+		JobSystem* GetJobSystem() const {
+			return jobSystem;
+		}
+		/// @brief Checks if the hierarchy is being rebuilt by a background job.
+		/// @return True if a background rebuild is running, otherwise false.
+		bool8_t IsRebuilding() const {
+			return building;
+		}
+
+		/// @brief Adds an object to the hierarchy. The object is tested linearly by queries until the next rebuild.
+		/// @param bounds The object's bounds.
+		/// @return The object's index, which is written to the results of the queries it passes.
+		uint32_t AddObject(const Aabb& bounds);
+		/// @brief Sets the given object's bounds. The hierarchy is refit on the next update.
+		/// @param index The object's index.
+		/// @param bounds The object's new bounds.
+		void SetObjectBounds(uint32_t index, const Aabb& bounds);
+		/// @brief Removes the given object from the hierarchy. Its index may be returned by later calls to AddObject.
+		/// @param index The object's index.
+		void RemoveObject(uint32_t index);
+		/// @brief Rebuilds the hierarchy on the calling thread, waiting for any running background rebuild.
+		void Build();
+		/// @brief Updates the hierarchy, usually once per frame. Swaps in a finished background rebuild, refits the hierarchy if objects moved and submits a background rebuild if its quality degraded.
+		void Update();
+
+		/// @brief Finds every object whose bounds intersect the given frustum.
+		/// @param planes The array of FrustumCuller::PLANE_COUNT frustum planes, usually extracted using FrustumCuller::ExtractPlanes.
+		/// @param objects The vector the indices of the found objects will be appended to.
+		void QueryFrustum(const FrustumCuller::Plane* planes, vector<uint32_t>& objects) const;
+		/// @brief Finds every object whose bounds intersect the given box.
+		/// @param bounds The box to test against.
+		/// @param objects The vector the indices of the found objects will be appended to.
+		void QueryAabb(const Aabb& bounds, vector<uint32_t>& objects) const;
+		/// @brief Finds every object whose bounds are hit by the given ray.
+		/// @param origin The ray's origin.
+		/// @param direction The ray's direction, which doesn't have to be normalized.
+		/// @param maxDistance The maximum hit distance, in multiples of the direction's length.
+		/// @param objects The vector the indices of the found objects will be appended to.
+		void QueryRay(const float32_t* origin, const float32_t* direction, float32_t maxDistance, vector<uint32_t>& objects) const;
+		/// @brief Finds the object whose bounds are hit first by the given ray.
+		/// @param origin The ray's origin.
+		/// @param direction The ray's direction, which doesn't have to be normalized.
+		/// @param maxDistance The maximum hit distance, in multiples of the direction's length.
+		/// @param hitDistance A reference to the variable in which the hit distance will be written.
+		/// @return The index of the hit object, or UINT32_T_MAX if no object was hit.
+		uint32_t Raycast(const float32_t* origin, const float32_t* direction, float32_t maxDistance, float32_t& hitDistance) const;
+		/// @brief Removes every object from the hierarchy, waiting for any running background rebuild.
+		void Clear();
+
+		/// @brief Destroys the bounding volume hierarchy, waiting for any running background rebuild.
+		~BoundingVolumeHierarchy();
+	private:
+		struct Tree {
+			vector<Node> nodes;
+			vector<uint32_t> items;
+			float32_t cost;
+			float32_t builtCost;
+		};
+
+		static uint32_t BuildNode(Tree* tree, const Aabb* bounds, uint32_t begin, uint32_t end, uint32_t depth);
+		static void BuildTree(Tree* tree, const Aabb* bounds, const uint32_t* objects, size_t objectCount);
+		static void RefitTree(Tree* tree, const Aabb* bounds);
+		static void BuildJob(void* userData);
+
+		void SnapshotObjects();
+		void FinishBuild();
+		void WaitForBuild();
+
+		vector<Aabb> objectBounds;
+		vector<uint8_t> objectFlags;
+		vector<uint32_t> freeObjects;
+		vector<uint32_t> unindexedObjects;
+		bool8_t refitNeeded;
+
+		Tree* tree;
+		Tree* buildTree;
+		vector<Aabb> buildBounds;
+		vector<uint32_t> buildObjects;
+		JobSystem* jobSystem;
+		JobSystem::Counter buildCounter;
+		bool8_t building;
+	};
+}
\ No newline at end of file
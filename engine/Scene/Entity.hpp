@@ -0,0 +1,44 @@
+#pragma once
+
+#include <Core.hpp>
+
+namespace wfe {
+	/// @brief The index of a component type registered in an entity world.
+	typedef uint32_t ComponentType;
+	/// @brief A set of component types, where bit i is set if the component type with the index i is in the set.
+	typedef uint64_t ComponentMask;
+
+	/// @brief The maximum number of component types that can be registered in an entity world.
+	static const uint32_t MAX_COMPONENT_TYPE_COUNT = 64;
+
+	/// @brief A generation-checked handle to an entity. A handle outlives its entity safely, as destroying an entity bumps its slot's generation and invalidates every old handle.
+	struct Entity {
+		/// @brief The index of the entity's slot in its world.
+		uint32_t index;
+		/// @brief The generation of the entity's slot at the time the entity was created. Live entities always have a non-zero generation, while 0 marks entities created in a command buffer that wasn't executed yet.
+		uint32_t generation;
+
+		/// @brief Checks if the given handles refer to the same entity.
+		/// @param other The handle to compare against.
+		/// @return True if the handles are equal, otherwise false.
+		bool8_t operator==(const Entity& other) const {
+			return index == other.index && generation == other.generation;
+		}
+		/// @brief Checks if the given handles refer to different entities.
+		/// @param other The handle to compare against.
+		/// @return True if the handles are different, otherwise false.
+		bool8_t operator!=(const Entity& other) const {
+			return index != other.index || generation != other.generation;
+		}
+	};
+
+	/// @brief The null entity handle, which never refers to a live entity.
+	static const Entity NULL_ENTITY { UINT32_T_MAX, 0 };
+
+	/// @brief Gets the component mask containing only the given component type.
+	/// @param type The component type.
+	/// @return The component type's mask.
+	inline ComponentMask GetComponentMask(ComponentType type) {
+		return (ComponentMask)1 << type;
+	}
+}
\ No newline at end of file
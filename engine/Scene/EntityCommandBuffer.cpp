@@ -0,0 +1,36 @@
+#include "EntityCommandBuffer.hpp"
+
+namespace wfe {
+	// Public functions
+	EntityCommandBuffer::EntityCommandBuffer() : createdEntityCount(0) { }
+
+	Entity EntityCommandBuffer::CreateEntity(ComponentMask mask) {
+		// Hand out a placeholder with a null generation, indexing the buffer's created entities
+		Entity entity { createdEntityCount++, 0 };
+		commands.push_back({ COMMAND_TYPE_CREATE_ENTITY, entity, mask, 0, 0, 0 });
+
+		return entity;
+	}
+	void EntityCommandBuffer::DestroyEntity(Entity entity) {
+		commands.push_back({ COMMAND_TYPE_DESTROY_ENTITY, entity, 0, 0, 0, 0 });
+	}
+	void EntityCommandBuffer::AddComponents(Entity entity, ComponentMask mask) {
+		commands.push_back({ COMMAND_TYPE_ADD_COMPONENTS, entity, mask, 0, 0, 0 });
+	}
+	void EntityCommandBuffer::RemoveComponents(Entity entity, ComponentMask mask) {
+		commands.push_back({ COMMAND_TYPE_REMOVE_COMPONENTS, entity, mask, 0, 0, 0 });
+	}
+	void EntityCommandBuffer::SetComponent(Entity entity, ComponentType type, const void* data, size_t size) {
+		// Copy the component's value to the end of the data buffer
+		size_t dataOffset = this->data.size();
+		this->data.resize(dataOffset + size);
+		memcpy(this->data.data() + dataOffset, data, size);
+
+		commands.push_back({ COMMAND_TYPE_SET_COMPONENT, entity, GetComponentMask(type), type, dataOffset, size });
+	}
+	void EntityCommandBuffer::Clear() {
+		commands.clear();
+		data.clear();
+		createdEntityCount = 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Entity.hpp"
+
+#include <Core.hpp>
+
+namespace wfe {
+	class EntityWorld;
+
+	/// @brief A buffer of structural changes to an entity world, such as creating or destroying entities and adding or removing components. Changes can't be made to a world while it's queried, so jobs record them in their own command buffer and the buffers are executed once the query finished.
+	class EntityCommandBuffer {
+	public:
+		/// @brief Creates an empty entity command buffer.
+		EntityCommandBuffer();
+		EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+		EntityCommandBuffer(EntityCommandBuffer&&) noexcept = delete;
+
+		EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+		EntityCommandBuffer& operator=(EntityCommandBuffer&&) = delete;
+
+		/// @brief Gets the number of commands recorded since the buffer was last cleared.
+		/// @return The buffer's command count.
+		size_t GetCommandCount() const {
+			return commands.size();
+		}
+
+		/// @brief Records the creation of an entity with the given components, which are zero-initialized.
+		/// @param mask The entity's components.
+		/// @return A placeholder handle, which may be passed to later commands in the same buffer and is replaced by the created entity when the buffer is executed.
+		Entity CreateEntity(ComponentMask mask);
+		/// @brief Records the destruction of the given entity. Destroying an entity that's no longer alive when the buffer is executed does nothing.
+		/// @param entity The entity to destroy.
+		void DestroyEntity(Entity entity);
+		/// @brief Records the addition of the given components to the given entity. Components the entity already has keep their values.
+		/// @param entity The entity to add the components to.
+		/// @param mask The components to add.
+		void AddComponents(Entity entity, ComponentMask mask);
+		/// @brief Records the removal of the given components from the given entity.
+		/// @param entity The entity to remove the components from.
+		/// @param mask The components to remove.
+		void RemoveComponents(Entity entity, ComponentMask mask);
+		/// @brief Records setting the value of one of the given entity's components, adding the component first if the entity doesn't have it.
+		/// @param entity The entity whose component to set.
+		/// @param type The component's type.
+		/// @param data A pointer to the component's new value, which is copied into the buffer.
+		/// @param size The size of the component's value, which must match the component type's registered size.
+		void SetComponent(Entity entity, ComponentType type, const void* data, size_t size);
+		/// @brief Removes every command from the buffer, keeping its memory.
+		void Clear();
+
+		/// @brief Destroys the entity command buffer.
+		~EntityCommandBuffer() = default;
+	private:
+		enum CommandType {
+			COMMAND_TYPE_CREATE_ENTITY,
+			COMMAND_TYPE_DESTROY_ENTITY,
+			COMMAND_TYPE_ADD_COMPONENTS,
+			COMMAND_TYPE_REMOVE_COMPONENTS,
+			COMMAND_TYPE_SET_COMPONENT
+		};
+		struct Command {
+			CommandType type;
+			Entity entity;
+			ComponentMask mask;
+			ComponentType componentType;
+			size_t dataOffset;
+			size_t dataSize;
+		};
+
+		vector<Command> commands;
+		vector<uint8_t> data;
+		uint32_t createdEntityCount;
+
+		friend EntityWorld;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,417 @@
+#include "EntityWorld.hpp"
+#include "General/HeapMemory.hpp"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace wfe {
+	// Internal structs
+	class EntityWorld::Archetype {
+	public:
+		ComponentMask mask;
+		uint32_t chunkCapacity;
+		size_t columnOffsets[MAX_COMPONENT_TYPE_COUNT];
+		vector<Chunk*> chunks;
+	};
+
+	// Internal helper functions
+	static ComponentType CountTrailingZeros64(ComponentMask mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+		unsigned long index;
+		_BitScanForward64(&index, mask);
+		return (ComponentType)index;
+#else
+		return (ComponentType)__builtin_ctzll(mask);
+#endif
+	}
+	static size_t AlignOffset(size_t offset, size_t alignment) {
+		return (offset + alignment - 1) & ~(alignment - 1);
+	}
+	static bool8_t MatchesQuery(ComponentMask mask, const EntityWorld::Query& query) {
+		return (mask & query.required) == query.required && !(mask & query.excluded);
+	}
+
+	void EntityWorld::RunQueryChunks(void* userData, size_t begin, size_t end) {
+		QueryContext* context = (QueryContext*)userData;
+
+		for(size_t i = begin; i != end; ++i)
+			context->function(context->userData, context->chunks[i].chunk, context->chunks[i].firstIndex);
+	}
+
+	EntityWorld::Archetype* EntityWorld::GetArchetype(ComponentMask mask) {
+		// Return the existing archetype with the given mask, if one exists
+		auto archetypeIter = archetypeMap.find(mask);
+		if(archetypeIter != archetypeMap.end())
+			return archetypeIter->second;
+
+		// Make sure every component in the mask was registered
+		ComponentType componentCount = (ComponentType)componentSizes.size();
+		if(componentCount != MAX_COMPONENT_TYPE_COUNT && mask >> componentCount)
+			throw Exception("Entity component mask contains unregistered component types!");
+
+		// Fit as many entities as possible in a chunk, shrinking the capacity until the arrays' alignment padding fits as well
+		size_t entitySize = sizeof(Entity);
+		for(ComponentMask bits = mask; bits; bits &= bits - 1)
+			entitySize += componentSizes[CountTrailingZeros64(bits)];
+
+		Archetype* archetype = NewObject<Archetype>();
+		archetype->mask = mask;
+		archetype->chunkCapacity = (uint32_t)((CHUNK_SIZE - CHUNK_HEADER_SIZE) / entitySize);
+
+		for(; archetype->chunkCapacity; --archetype->chunkCapacity) {
+			size_t offset = CHUNK_HEADER_SIZE + archetype->chunkCapacity * sizeof(Entity);
+			for(ComponentMask bits = mask; bits; bits &= bits - 1) {
+				ComponentType type = CountTrailingZeros64(bits);
+
+				offset = AlignOffset(offset, componentAlignments[type]);
+				archetype->columnOffsets[type] = offset;
+				offset += archetype->chunkCapacity * componentSizes[type];
+			}
+
+			if(offset <= CHUNK_SIZE)
+				break;
+		}
+
+		if(!archetype->chunkCapacity) {
+			DestroyObject(archetype);
+			throw Exception("Entity components don't fit in a single chunk!");
+		}
+
+		// Add the new archetype
+		archetypes.push_back(archetype);
+		archetypeMap.insert({ mask, archetype });
+
+		return archetype;
+	}
+	EntityWorld::Chunk* EntityWorld::AllocateChunk(Archetype* archetype) {
+		// Reuse a chunk freed by any archetype, as every chunk has the same size
+		Chunk* chunk;
+		if(freeChunks.size()) {
+			chunk = freeChunks.back();
+			freeChunks.pop_back();
+		} else {
+			chunk = (Chunk*)AllocHeapMemory(CHUNK_SIZE);
+			if(!chunk)
+				throw BadAllocException("Failed to allocate entity chunk!");
+		}
+
+		chunk->archetype = archetype;
+		chunk->entityCount = 0;
+
+		archetype->chunks.push_back(chunk);
+
+		return chunk;
+	}
+	void EntityWorld::AllocateRow(Archetype* archetype, Chunk*& chunk, uint32_t& row) {
+		// Append the row to the archetype's last chunk, allocating a new chunk if it's full
+		if(archetype->chunks.size() && archetype->chunks.back()->entityCount != archetype->chunkCapacity)
+			chunk = archetype->chunks.back();
+		else
+			chunk = AllocateChunk(archetype);
+
+		row = chunk->entityCount++;
+	}
+	void EntityWorld::FreeRow(Chunk* chunk, uint32_t row) {
+		Archetype* archetype = chunk->archetype;
+		Chunk* lastChunk = archetype->chunks.back();
+		uint32_t lastRow = lastChunk->entityCount - 1;
+
+		// Move the archetype's last entity into the freed row, keeping the archetype's chunks tightly packed
+		if(chunk != lastChunk || row != lastRow) {
+			Entity* entities = (Entity*)((uint8_t*)chunk + CHUNK_HEADER_SIZE);
+			const Entity* lastEntities = (const Entity*)((const uint8_t*)lastChunk + CHUNK_HEADER_SIZE);
+
+			Entity movedEntity = lastEntities[lastRow];
+			entities[row] = movedEntity;
+
+			for(ComponentMask bits = archetype->mask; bits; bits &= bits - 1) {
+				ComponentType type = CountTrailingZeros64(bits);
+				size_t offset = archetype->columnOffsets[type];
+				size_t size = componentSizes[type];
+
+				memcpy((uint8_t*)chunk + offset + row * size, (const uint8_t*)lastChunk + offset + lastRow * size, size);
+			}
+
+			entityRecords[movedEntity.index].chunk = chunk;
+			entityRecords[movedEntity.index].row = row;
+		}
+
+		// Free the last chunk if it's now empty
+		if(!--lastChunk->entityCount) {
+			archetype->chunks.pop_back();
+			freeChunks.push_back(lastChunk);
+		}
+	}
+	void EntityWorld::MoveEntity(Entity entity, ComponentMask newMask) {
+		EntityRecord& record = entityRecords[entity.index];
+		Chunk* oldChunk = record.chunk;
+		uint32_t oldRow = record.row;
+		ComponentMask oldMask = oldChunk->archetype->mask;
+
+		// Exit the function if the entity's archetype doesn't change
+		if(newMask == oldMask)
+			return;
+
+		// Allocate the entity's row in the new archetype
+		Archetype* newArchetype = GetArchetype(newMask);
+		Chunk* newChunk;
+		uint32_t newRow;
+		AllocateRow(newArchetype, newChunk, newRow);
+
+		((Entity*)((uint8_t*)newChunk + CHUNK_HEADER_SIZE))[newRow] = entity;
+
+		// Copy the components both archetypes share and zero the added ones
+		for(ComponentMask bits = newMask; bits; bits &= bits - 1) {
+			ComponentType type = CountTrailingZeros64(bits);
+			size_t size = componentSizes[type];
+			uint8_t* component = (uint8_t*)newChunk + newArchetype->columnOffsets[type] + newRow * size;
+
+			if(oldMask & bits & ~(bits - 1))
+				memcpy(component, (const uint8_t*)oldChunk + oldChunk->archetype->columnOffsets[type] + oldRow * size, size);
+			else
+				memset(component, 0, size);
+		}
+
+		// Free the entity's old row, then point its record to the new row
+		FreeRow(oldChunk, oldRow);
+
+		record.chunk = newChunk;
+		record.row = newRow;
+	}
+	void EntityWorld::GatherChunks(const Query& query, vector<QueryChunk>& queryChunks) const {
+		// Add every chunk of every matched archetype, counting the entities before each chunk
+		size_t firstIndex = 0;
+		for(Archetype* archetype : archetypes) {
+			if(!MatchesQuery(archetype->mask, query))
+				continue;
+
+			for(Chunk* chunk : archetype->chunks) {
+				queryChunks.push_back({ chunk, firstIndex });
+				firstIndex += chunk->entityCount;
+			}
+		}
+	}
+
+	// Public functions
+	ComponentMask EntityWorld::Chunk::GetComponentMask() const {
+		return archetype->mask;
+	}
+	void* EntityWorld::Chunk::GetComponents(ComponentType type) {
+		// Check if the chunk's archetype has the component
+		if(!(archetype->mask & wfe::GetComponentMask(type)))
+			return nullptr;
+
+		return (uint8_t*)this + archetype->columnOffsets[type];
+	}
+	const void* EntityWorld::Chunk::GetComponents(ComponentType type) const {
+		// Check if the chunk's archetype has the component
+		if(!(archetype->mask & wfe::GetComponentMask(type)))
+			return nullptr;
+
+		return (const uint8_t*)this + archetype->columnOffsets[type];
+	}
+
+	EntityWorld::EntityWorld(JobSystem* jobSystem) : jobSystem(jobSystem), entityCount(0) { }
+
+	ComponentType EntityWorld::RegisterComponent(size_t size, size_t alignment) {
+		// Make sure another component type can be registered
+		if(componentSizes.size() == MAX_COMPONENT_TYPE_COUNT)
+			throw Exception("Exceeded the maximum entity component type count!");
+
+		// Make sure the alignment is a supported power of two
+		if(!alignment || (alignment & (alignment - 1)) || alignment > MAX_COMPONENT_ALIGNMENT)
+			throw Exception("Unsupported entity component alignment!");
+
+		// Add the component type
+		ComponentType type = (ComponentType)componentSizes.size();
+		componentSizes.push_back(size);
+		componentAlignments.push_back(alignment);
+
+		return type;
+	}
+
+	Entity EntityWorld::CreateEntity(ComponentMask mask) {
+		Archetype* archetype = GetArchetype(mask);
+
+		// Reuse a free entity slot, or add a new one
+		uint32_t index;
+		if(freeEntityIndices.size()) {
+			index = freeEntityIndices.back();
+			freeEntityIndices.pop_back();
+		} else {
+			index = (uint32_t)entityRecords.size();
+			entityRecords.push_back({ nullptr, 0, 1 });
+		}
+
+		EntityRecord& record = entityRecords[index];
+		Entity entity { index, record.generation };
+
+		// Allocate the entity's row and zero its components
+		AllocateRow(archetype, record.chunk, record.row);
+
+		((Entity*)((uint8_t*)record.chunk + CHUNK_HEADER_SIZE))[record.row] = entity;
+
+		for(ComponentMask bits = mask; bits; bits &= bits - 1) {
+			ComponentType type = CountTrailingZeros64(bits);
+			size_t size = componentSizes[type];
+
+			memset((uint8_t*)record.chunk + archetype->columnOffsets[type] + record.row * size, 0, size);
+		}
+
+		++entityCount;
+
+		return entity;
+	}
+	void EntityWorld::DestroyEntity(Entity entity) {
+		// Exit the function if the entity is no longer alive
+		if(!IsAlive(entity))
+			return;
+
+		// Free the entity's row
+		EntityRecord& record = entityRecords[entity.index];
+		FreeRow(record.chunk, record.row);
+
+		// Bump the slot's generation, skipping the null generation, to invalidate every handle to the entity
+		record.chunk = nullptr;
+		if(!++record.generation)
+			record.generation = 1;
+
+		freeEntityIndices.push_back(entity.index);
+		--entityCount;
+	}
+	ComponentMask EntityWorld::GetComponentMask(Entity entity) const {
+		// Make sure the entity is alive
+		if(!IsAlive(entity))
+			throw Exception("Cannot get the components of a dead entity!");
+
+		return entityRecords[entity.index].chunk->archetype->mask;
+	}
+	void EntityWorld::AddComponents(Entity entity, ComponentMask mask) {
+		// Move the entity to the archetype with the added components
+		MoveEntity(entity, GetComponentMask(entity) | mask);
+	}
+	void EntityWorld::RemoveComponents(Entity entity, ComponentMask mask) {
+		// Move the entity to the archetype without the removed components
+		MoveEntity(entity, GetComponentMask(entity) & ~mask);
+	}
+	void* EntityWorld::GetComponent(Entity entity, ComponentType type) {
+		// Exit the function if the entity is no longer alive
+		if(!IsAlive(entity))
+			return nullptr;
+
+		// Get the component from the entity's row in its chunk's array
+		const EntityRecord& record = entityRecords[entity.index];
+		uint8_t* components = (uint8_t*)record.chunk->GetComponents(type);
+
+		return components ? components + record.row * componentSizes[type] : nullptr;
+	}
+	const void* EntityWorld::GetComponent(Entity entity, ComponentType type) const {
+		// Exit the function if the entity is no longer alive
+		if(!IsAlive(entity))
+			return nullptr;
+
+		// Get the component from the entity's row in its chunk's array
+		const EntityRecord& record = entityRecords[entity.index];
+		const uint8_t* components = (const uint8_t*)((const Chunk*)record.chunk)->GetComponents(type);
+
+		return components ? components + record.row * componentSizes[type] : nullptr;
+	}
+	void EntityWorld::ExecuteCommands(EntityCommandBuffer* commandBuffer) {
+		commandEntities.resize(commandBuffer->createdEntityCount);
+
+		for(const EntityCommandBuffer::Command& command : commandBuffer->commands) {
+			// Replace placeholder handles with the entities created by the buffer
+			Entity entity = command.entity;
+			if(!entity.generation && entity.index < commandEntities.size())
+				entity = commandEntities[entity.index];
+
+			switch(command.type) {
+			case EntityCommandBuffer::COMMAND_TYPE_CREATE_ENTITY:
+				commandEntities[command.entity.index] = CreateEntity(command.mask);
+				break;
+			case EntityCommandBuffer::COMMAND_TYPE_DESTROY_ENTITY:
+				DestroyEntity(entity);
+				break;
+			case EntityCommandBuffer::COMMAND_TYPE_ADD_COMPONENTS:
+				if(IsAlive(entity))
+					AddComponents(entity, command.mask);
+				break;
+			case EntityCommandBuffer::COMMAND_TYPE_REMOVE_COMPONENTS:
+				if(IsAlive(entity))
+					RemoveComponents(entity, command.mask);
+				break;
+			case EntityCommandBuffer::COMMAND_TYPE_SET_COMPONENT:
+				if(!IsAlive(entity))
+					break;
+
+				// Make sure the command's data matches the component's size
+				if(command.dataSize != componentSizes[command.componentType])
+					throw Exception("Entity command component size doesn't match the component type's size!");
+
+				// Add the component if the entity doesn't have it, then copy the command's data to it
+				AddComponents(entity, command.mask);
+				memcpy(GetComponent(entity, command.componentType), commandBuffer->data.data() + command.dataOffset, command.dataSize);
+
+				break;
+			}
+		}
+
+		commandBuffer->Clear();
+	}
+
+	size_t EntityWorld::CountEntities(const Query& query) const {
+		// Add the entity counts of every matched archetype's chunks
+		size_t count = 0;
+		for(Archetype* archetype : archetypes) {
+			if(!MatchesQuery(archetype->mask, query))
+				continue;
+
+			for(Chunk* chunk : archetype->chunks)
+				count += chunk->entityCount;
+		}
+
+		return count;
+	}
+	void EntityWorld::ForEachChunk(const Query& query, ChunkFunction function, void* userData) {
+		// Run the function on every chunk of every matched archetype
+		size_t firstIndex = 0;
+		for(Archetype* archetype : archetypes) {
+			if(!MatchesQuery(archetype->mask, query))
+				continue;
+
+			for(Chunk* chunk : archetype->chunks) {
+				function(userData, chunk, firstIndex);
+				firstIndex += chunk->entityCount;
+			}
+		}
+	}
+	void EntityWorld::ParallelForEachChunk(const Query& query, ChunkFunction function, void* userData) {
+		// Run the query on the calling thread if there's no job system
+		if(!jobSystem) {
+			ForEachChunk(query, function, userData);
+			return;
+		}
+
+		// Gather the matched chunks, then split them between the job system's threads
+		vector<QueryChunk> queryChunks;
+		GatherChunks(query, queryChunks);
+
+		QueryContext context { function, userData, queryChunks.data() };
+		jobSystem->ParallelFor(queryChunks.size(), MIN_CHUNKS_PER_BATCH, RunQueryChunks, &context);
+	}
+
+	EntityWorld::~EntityWorld() {
+		// Free every archetype and its chunks
+		for(Archetype* archetype : archetypes) {
+			for(Chunk* chunk : archetype->chunks)
+				FreeMemory(chunk);
+
+			DestroyObject(archetype);
+		}
+
+		// Free every unused chunk
+		for(Chunk* chunk : freeChunks)
+			FreeMemory(chunk);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,201 @@
+#pragma once
+
+#include "Entity.hpp"
+#include "EntityCommandBuffer.hpp"
+#include "General/JobSystem.hpp"
+
+#include <Core.hpp>
+
+namespace wfe {
+	/// @brief An archetype-based entity component system. Entities with the same set of components share an archetype, which stores them in fixed size chunks holding every component in its own tightly packed array, so that queries stream through the components they need and split their chunks between threads.
+	class EntityWorld {
+	public:
+		/// @brief The size of every chunk, in bytes, including its header.
+		static const size_t CHUNK_SIZE = 16 << 10;
+		/// @brief The size of every chunk's header, which is padded to a cache line so that the chunk's entity array starts on its own cache line.
+		static const size_t CHUNK_HEADER_SIZE = 64;
+		/// @brief The maximum alignment of a component type.
+		static const size_t MAX_COMPONENT_ALIGNMENT = 16;
+		/// @brief The minimum number of chunks run by a single job of a parallel query.
+		static const size_t MIN_CHUNKS_PER_BATCH = 4;
+
+		/// @brief A set of components an entity must have and must not have to be matched by a query.
+		struct Query {
+			/// @brief The components every matched entity has.
+			ComponentMask required;
+			/// @brief The components no matched entity has.
+			ComponentMask excluded;
+		};
+
+		class Archetype;
+
+		/// @brief A fixed size block of memory holding entities of the same archetype, with each component stored in its own array.
+		class Chunk {
+		public:
+			/// @brief Gets the number of entities in the chunk.
+			/// @return The chunk's entity count.
+			uint32_t GetEntityCount() const {
+				return entityCount;
+			}
+			/// @brief Gets the entities in the chunk.
+			/// @return A pointer to the array of the chunk's entity handles.
+			const Entity* GetEntities() const {
+				return (const Entity*)((const uint8_t*)this + CHUNK_HEADER_SIZE);
+			}
+			/// @brief Gets the components of the chunk's archetype.
+			/// @return The archetype's component mask.
+			ComponentMask GetComponentMask() const;
+			/// @brief Gets the array of the given component type.
+			/// @param type The component type.
+			/// @return A pointer to the array of the chunk's components of the given type, or nullptr if the chunk's archetype doesn't have the component.
+			void* GetComponents(ComponentType type);
+			/// @brief Gets the array of the given component type.
+			/// @param type The component type.
+			/// @return A const pointer to the array of the chunk's components of the given type, or nullptr if the chunk's archetype doesn't have the component.
+			const void* GetComponents(ComponentType type) const;
+		private:
+			Archetype* archetype;
+			uint32_t entityCount;
+
+			friend EntityWorld;
+		};
+
+		/// @brief The signature of the function run on a query's chunks.
+		/// @param userData The user data given to the query.
+		/// @param chunk The matched chunk.
+		/// @param firstIndex The index of the chunk's first entity among every entity matched by the query, which is stable as long as the world's structure doesn't change.
+		typedef void(*ChunkFunction)(void* userData, Chunk* chunk, size_t firstIndex);
+
+		/// @brief Creates an empty entity world.
+		/// @param jobSystem The job system parallel queries split their chunks between, or nullptr to run every query on the calling thread.
+		EntityWorld(JobSystem* jobSystem);
+		EntityWorld(const EntityWorld&) = delete;
+		EntityWorld(EntityWorld&&) noexcept = delete;
+
+		EntityWorld& operator=(const EntityWorld&) = delete;
+		EntityWorld& operator=(EntityWorld&&) = delete;
+
+		/// @brief Gets the job system parallel queries split their chunks between.
+		/// @return A pointer to the job system, or nullptr if queries run on the calling thread.
+		JobSystem* GetJobSystem() const {
+			return jobSystem;
+		}
+		/// @brief Gets the number of live entities.
+		/// @return The world's entity count.
+		size_t GetEntityCount() const {
+			return entityCount;
+		}
+		/// @brief Gets the number of archetypes created so far, including the archetypes with no entities.
+		/// @return The world's archetype count.
+		size_t GetArchetypeCount() const {
+			return archetypes.size();
+		}
+
+		/// @brief Registers a new component type. Components are moved between chunks by copying their bytes, so they must be trivially copyable.
+		/// @param size The size of the component, in bytes, or 0 for tag components with no data.
+		/// @param alignment The alignment of the component, which must be a power of two no greater than MAX_COMPONENT_ALIGNMENT.
+		/// @return The new component type.
+		ComponentType RegisterComponent(size_t size, size_t alignment);
+		/// @brief Gets the size of the given component type.
+		/// @param type The component type.
+		/// @return The component's size, in bytes.
+		size_t GetComponentSize(ComponentType type) const {
+			return componentSizes[type];
+		}
+
+		/// @brief Creates an entity with the given components, which are zero-initialized.
+		/// @param mask The entity's components.
+		/// @return The created entity.
+		Entity CreateEntity(ComponentMask mask);
+		/// @brief Destroys the given entity. Destroying an entity that's no longer alive does nothing.
+		/// @param entity The entity to destroy.
+		void DestroyEntity(Entity entity);
+		/// @brief Checks if the given entity is alive.
+		/// @param entity The entity to check.
+		/// @return True if the entity is alive, otherwise false.
+		bool8_t IsAlive(Entity entity) const {
+			return entity.generation && entity.index < entityRecords.size() && entityRecords[entity.index].generation == entity.generation;
+		}
+		/// @brief Gets the components of the given entity.
+		/// @param entity The entity, which must be alive.
+		/// @return The entity's component mask.
+		ComponentMask GetComponentMask(Entity entity) const;
+		/// @brief Adds the given components to the given entity, moving it to the matching archetype. Components the entity already has keep their values, while added components are zero-initialized.
+		/// @param entity The entity, which must be alive.
+		/// @param mask The components to add.
+		void AddComponents(Entity entity, ComponentMask mask);
+		/// @brief Removes the given components from the given entity, moving it to the matching archetype.
+		/// @param entity The entity, which must be alive.
+		/// @param mask The components to remove.
+		void RemoveComponents(Entity entity, ComponentMask mask);
+		/// @brief Gets one of the given entity's components.
+		/// @param entity The entity.
+		/// @param type The component's type.
+		/// @return A pointer to the component, which stays valid until the world's structure changes, or nullptr if the entity isn't alive or doesn't have the component.
+		void* GetComponent(Entity entity, ComponentType type);
+		/// @brief Gets one of the given entity's components.
+		/// @param entity The entity.
+		/// @param type The component's type.
+		/// @return A const pointer to the component, which stays valid until the world's structure changes, or nullptr if the entity isn't alive or doesn't have the component.
+		const void* GetComponent(Entity entity, ComponentType type) const;
+		/// @brief Executes every command in the given command buffer in the order they were recorded, then clears the buffer. Commands targeting entities that are no longer alive are skipped.
+		/// @param commandBuffer The command buffer to execute.
+		void ExecuteCommands(EntityCommandBuffer* commandBuffer);
+
+		/// @brief Counts the entities matched by the given query.
+		/// @param query The query to match entities against.
+		/// @return The number of matched entities.
+		size_t CountEntities(const Query& query) const;
+		/// @brief Runs the given function on every chunk matched by the given query, on the calling thread.
+		/// @param query The query to match chunks against.
+		/// @param function The function to run on every matched chunk.
+		/// @param userData The user data to pass to the function.
+		void ForEachChunk(const Query& query, ChunkFunction function, void* userData);
+		/// @brief Runs the given function on every chunk matched by the given query, splitting the chunks between the job system's threads and waiting for every chunk to finish. The world's structure mustn't change until the query returns; use command buffers to record changes instead.
+		/// @param query The query to match chunks against.
+		/// @param function The function to run on every matched chunk, which may be called from multiple threads at once.
+		/// @param userData The user data to pass to the function.
+		void ParallelForEachChunk(const Query& query, ChunkFunction function, void* userData);
+
+		/// @brief Destroys the entity world and every entity in it.
+		~EntityWorld();
+	private:
+		struct EntityRecord {
+			Chunk* chunk;
+			uint32_t row;
+			uint32_t generation;
+		};
+		struct QueryChunk {
+			Chunk* chunk;
+			size_t firstIndex;
+		};
+		struct QueryContext {
+			ChunkFunction function;
+			void* userData;
+			const QueryChunk* chunks;
+		};
+
+		static void RunQueryChunks(void* userData, size_t begin, size_t end);
+
+		Archetype* GetArchetype(ComponentMask mask);
+		Chunk* AllocateChunk(Archetype* archetype);
+		void AllocateRow(Archetype* archetype, Chunk*& chunk, uint32_t& row);
+		void FreeRow(Chunk* chunk, uint32_t row);
+		void MoveEntity(Entity entity, ComponentMask newMask);
+		void GatherChunks(const Query& query, vector<QueryChunk>& queryChunks) const;
+
+		JobSystem* jobSystem;
+		size_t entityCount;
+
+		vector<size_t> componentSizes;
+		vector<size_t> componentAlignments;
+
+		vector<Archetype*> archetypes;
+		unordered_map<ComponentMask, Archetype*> archetypeMap;
+		vector<Chunk*> freeChunks;
+
+		vector<EntityRecord> entityRecords;
+		vector<uint32_t> freeEntityIndices;
+		vector<Entity> commandEntities;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,308 @@
+#include "SceneSystems.hpp"
+
+#include <math.h>
+
+namespace wfe {
+	// Internal helper functions
+	static float32_t ComputeMaxScale(const VulkanDrawQueue::InstanceTransform& transform) {
+		// Get the squared length of every basis column, keeping the largest
+		float32_t maxScale = 0.f;
+		for(size_t i = 0; i != 3; ++i) {
+			float32_t scale = transform.rows[0][i] * transform.rows[0][i] + transform.rows[1][i] * transform.rows[1][i] + transform.rows[2][i] * transform.rows[2][i];
+			if(scale > maxScale)
+				maxScale = scale;
+		}
+
+		return sqrtf(maxScale);
+	}
+	static void ComputeWorldSphere(const VulkanDrawQueue::InstanceTransform& world, const SceneSystems::BoundingSphere& sphere, float32_t* center, float32_t& radius) {
+		// Transform the sphere's center to world space and scale its radius by the transform's largest scale
+		for(size_t i = 0; i != 3; ++i)
+			center[i] = world.rows[i][0] * sphere.center[0] + world.rows[i][1] * sphere.center[1] + world.rows[i][2] * sphere.center[2] + world.rows[i][3];
+
+		radius = sphere.radius * ComputeMaxScale(world);
+	}
+	static bool8_t IsZeroTransform(const VulkanDrawQueue::InstanceTransform& transform) {
+		// Check if every element is 0, which is only the case for the zero-initialized transforms of entities that were never updated
+		for(size_t i = 0; i != 3; ++i)
+			for(size_t j = 0; j != 4; ++j)
+				if(transform.rows[i][j] != 0.f)
+					return false;
+
+		return true;
+	}
+	static uint64_t ComputeSortKey(const Matrix4& viewProjection, const SceneSystems::Mesh& mesh, const VulkanDrawQueue::InstanceTransform& world) {
+		// Project the entity's origin to get its normalized depth
+		Vector4 clip = viewProjection * Vector4 { world.rows[0][3], world.rows[1][3], world.rows[2][3], 1.f };
+		float32_t depth = clip.w > 0.f ? clip.z / clip.w : 0.f;
+
+		return VulkanDrawQueue::MakeSortKey(mesh.passIndex, mesh.pipelineIndex, mesh.materialIndex, depth);
+	}
+	static size_t FindFirstIndex(const uint32_t* indices, size_t count, size_t value) {
+		// Binary search the sorted indices for the first one that isn't below the value
+		size_t begin = 0, end = count;
+		while(begin != end) {
+			size_t middle = (begin + end) >> 1;
+			if(indices[middle] < value)
+				begin = middle + 1;
+			else
+				end = middle;
+		}
+
+		return begin;
+	}
+
+	void SceneSystems::UpdateTransformChunk(void* userData, EntityWorld::Chunk* chunk, size_t firstIndex) {
+		SceneSystems* systems = (SceneSystems*)userData;
+		const TransformHierarchy* transformHierarchy = systems->transformHierarchy;
+
+		const TransformNode* transformNodes = (const TransformNode*)chunk->GetComponents(systems->transformNodeComponent);
+		VulkanDrawQueue::InstanceTransform* worldTransforms = (VulkanDrawQueue::InstanceTransform*)chunk->GetComponents(systems->worldTransformComponent);
+		VulkanDrawQueue::InstanceTransform* previousTransforms = (VulkanDrawQueue::InstanceTransform*)chunk->GetComponents(systems->previousTransformComponent);
+		uint32_t entityCount = chunk->GetEntityCount();
+
+		for(uint32_t i = 0; i != entityCount; ++i) {
+			const Matrix4& matrix = transformHierarchy->GetWorldMatrix(transformNodes[i].node);
+			VulkanDrawQueue::InstanceTransform& world = worldTransforms[i];
+
+			// Keep the last tick's world transform, if the chunk's archetype has a previous transform
+			bool8_t firstUpdate = IsZeroTransform(world);
+			if(previousTransforms)
+				previousTransforms[i] = world;
+
+			// Transpose the node's column-major world matrix into the instance transform's rows, dropping the last row
+			for(size_t j = 0; j != 4; ++j) {
+				world.rows[0][j] = matrix.columns[j].x;
+				world.rows[1][j] = matrix.columns[j].y;
+				world.rows[2][j] = matrix.columns[j].z;
+			}
+
+			// Entities updated for the first time didn't exist last tick, so they start out without motion
+			if(previousTransforms && firstUpdate)
+				previousTransforms[i] = world;
+		}
+	}
+	void SceneSystems::CullChunk(void* userData, EntityWorld::Chunk* chunk, size_t firstIndex) {
+		SceneSystems* systems = (SceneSystems*)userData;
+		FrustumCuller* frustumCuller = systems->frustumCuller;
+
+		const VulkanDrawQueue::InstanceTransform* worldTransforms = (const VulkanDrawQueue::InstanceTransform*)chunk->GetComponents(systems->worldTransformComponent);
+		const BoundingSphere* boundingSpheres = (const BoundingSphere*)chunk->GetComponents(systems->boundingSphereComponent);
+		uint32_t entityCount = chunk->GetEntityCount();
+
+		for(uint32_t i = 0; i != entityCount; ++i) {
+			// Every chunk writes its own range of the culler's objects
+			float32_t center[3], radius;
+			ComputeWorldSphere(worldTransforms[i], boundingSpheres[i], center, radius);
+
+			frustumCuller->SetSphere((uint32_t)(firstIndex + i), center, radius);
+		}
+	}
+	void SceneSystems::UpdateBoundsChunk(void* userData, EntityWorld::Chunk* chunk, size_t firstIndex) {
+		SceneSystems* systems = (SceneSystems*)userData;
+		BoundingVolumeHierarchy* boundingVolumeHierarchy = systems->boundingVolumeHierarchy;
+
+		const Entity* entities = chunk->GetEntities();
+		const VulkanDrawQueue::InstanceTransform* worldTransforms = (const VulkanDrawQueue::InstanceTransform*)chunk->GetComponents(systems->worldTransformComponent);
+		const BoundingSphere* boundingSpheres = (const BoundingSphere*)chunk->GetComponents(systems->boundingSphereComponent);
+		uint32_t entityCount = chunk->GetEntityCount();
+
+		for(uint32_t i = 0; i != entityCount; ++i) {
+			// Bound the entity's world sphere with a box
+			float32_t center[3], radius;
+			ComputeWorldSphere(worldTransforms[i], boundingSpheres[i], center, radius);
+
+			BoundingVolumeHierarchy::Aabb bounds {
+				{ center[0] - radius, center[1] - radius, center[2] - radius },
+				{ center[0] + radius, center[1] + radius, center[2] + radius }
+			};
+
+			// Move the entity's object, or add one if the entity's slot has none or its object belongs to a destroyed entity that used the same slot
+			Entity entity = entities[i];
+			while(systems->entityObjects.size() <= entity.index)
+				systems->entityObjects.push_back(UINT32_T_MAX);
+
+			uint32_t object = systems->entityObjects[entity.index];
+			if(object != UINT32_T_MAX && systems->objectEntities[object] == entity) {
+				boundingVolumeHierarchy->SetObjectBounds(object, bounds);
+			} else {
+				object = boundingVolumeHierarchy->AddObject(bounds);
+				systems->entityObjects[entity.index] = object;
+
+				if(object == systems->objectEntities.size()) {
+					systems->objectEntities.push_back(entity);
+					systems->objectUpdates.push_back(0);
+				} else {
+					systems->objectEntities[object] = entity;
+				}
+			}
+
+			systems->objectUpdates[object] = systems->boundsUpdateIndex;
+		}
+	}
+	void SceneSystems::ExtractPacketChunk(void* userData, EntityWorld::Chunk* chunk, size_t firstIndex) {
+		SceneSystems* systems = (SceneSystems*)userData;
+		const Matrix4& viewProjection = systems->viewProjection;
+
+		const VulkanDrawQueue::InstanceTransform* worldTransforms = (const VulkanDrawQueue::InstanceTransform*)chunk->GetComponents(systems->worldTransformComponent);
+		const VulkanDrawQueue::InstanceTransform* previousTransforms = (const VulkanDrawQueue::InstanceTransform*)chunk->GetComponents(systems->previousTransformComponent);
+		const BoundingSphere* boundingSpheres = (const BoundingSphere*)chunk->GetComponents(systems->boundingSphereComponent);
+		const MeshInstance* meshInstances = (const MeshInstance*)chunk->GetComponents(systems->meshInstanceComponent);
+
+		// Find the chunk's range of the sorted visible indices, which is also its range of the packet's instances
+		size_t begin = FindFirstIndex(systems->visibleIndices.data(), systems->visibleCount, firstIndex);
+		size_t end = FindFirstIndex(systems->visibleIndices.data(), systems->visibleCount, firstIndex + chunk->GetEntityCount());
+
+		for(size_t i = begin; i != end; ++i) {
+			size_t index = systems->visibleIndices[i] - firstIndex;
+			uint32_t meshIndex = meshInstances[index].meshIndex;
+
+			FramePacket::MeshInstance& instance = systems->packetInstances[i];
+			instance.sortKey = ComputeSortKey(viewProjection, systems->meshes[meshIndex], worldTransforms[index]);
+			instance.drawIndex = meshIndex;
+			instance.transform = worldTransforms[index];
+			instance.previousTransform = previousTransforms ? previousTransforms[index] : worldTransforms[index];
+			ComputeWorldSphere(worldTransforms[index], boundingSpheres[index], instance.boundingSphere, instance.boundingSphere[3]);
+		}
+	}
+	void SceneSystems::ExtractLightChunk(void* userData, EntityWorld::Chunk* chunk, size_t firstIndex) {
+		SceneSystems* systems = (SceneSystems*)userData;
+
+		const VulkanDrawQueue::InstanceTransform* worldTransforms = (const VulkanDrawQueue::InstanceTransform*)chunk->GetComponents(systems->worldTransformComponent);
+		const PointLight* pointLights = (const PointLight*)chunk->GetComponents(systems->pointLightComponent);
+		uint32_t entityCount = chunk->GetEntityCount();
+
+		for(uint32_t i = 0; i != entityCount; ++i) {
+			const VulkanDrawQueue::InstanceTransform& world = worldTransforms[i];
+			const PointLight& pointLight = pointLights[i];
+
+			FramePacket::Light& light = systems->packetLights[firstIndex + i];
+			light.position[0] = world.rows[0][3];
+			light.position[1] = world.rows[1][3];
+			light.position[2] = world.rows[2][3];
+			light.radius = pointLight.radius;
+			light.color[0] = pointLight.color[0];
+			light.color[1] = pointLight.color[1];
+			light.color[2] = pointLight.color[2];
+			light.intensity = pointLight.intensity;
+		}
+	}
+
+	// Public functions
+	SceneSystems::SceneSystems(EntityWorld* world) : world(world), boundsUpdateIndex(0), viewProjection(IDENTITY_MATRIX), visibleCount(0), packetInstances(nullptr), packetLights(nullptr), lastCamera{}, lastCameraSet(false) {
+		// Register the systems' components
+		transformNodeComponent = world->RegisterComponent(sizeof(TransformNode), alignof(TransformNode));
+		worldTransformComponent = world->RegisterComponent(sizeof(VulkanDrawQueue::InstanceTransform), alignof(VulkanDrawQueue::InstanceTransform));
+		previousTransformComponent = world->RegisterComponent(sizeof(VulkanDrawQueue::InstanceTransform), alignof(VulkanDrawQueue::InstanceTransform));
+		boundingSphereComponent = world->RegisterComponent(sizeof(BoundingSphere), alignof(BoundingSphere));
+		meshInstanceComponent = world->RegisterComponent(sizeof(MeshInstance), alignof(MeshInstance));
+		pointLightComponent = world->RegisterComponent(sizeof(PointLight), alignof(PointLight));
+
+		// Create the transform hierarchy, the frustum culler, which splits large culls between the world's job system threads, and the bounding volume hierarchy, which is rebuilt by the job system's workers
+		transformHierarchy = NewObject<TransformHierarchy>();
+		frustumCuller = NewObject<FrustumCuller>(world->GetJobSystem());
+		boundingVolumeHierarchy = NewObject<BoundingVolumeHierarchy>(world->GetJobSystem());
+	}
+
+	uint32_t SceneSystems::AddMesh(const Mesh& mesh) {
+		uint32_t index = (uint32_t)meshes.size();
+		meshes.push_back(mesh);
+
+		return index;
+	}
+
+	void SceneSystems::UpdateTransforms() {
+		// Recompute the world matrices of every changed node's subtree, then copy every entity's world matrix in parallel
+		transformHierarchy->Update();
+
+		EntityWorld::Query query { wfe::GetComponentMask(transformNodeComponent) | wfe::GetComponentMask(worldTransformComponent), 0 };
+		world->ParallelForEachChunk(query, UpdateTransformChunk, this);
+	}
+	size_t SceneSystems::Cull(const Matrix4& viewProjection) {
+		EntityWorld::Query query { wfe::GetComponentMask(worldTransformComponent) | wfe::GetComponentMask(boundingSphereComponent) | wfe::GetComponentMask(meshInstanceComponent), 0 };
+
+		// Size the culler for every matched entity, then write the entities' world bounds in parallel, indexed by their position in the query
+		size_t entityCount = world->CountEntities(query);
+		frustumCuller->Resize(entityCount);
+		visibleIndices.resize(entityCount);
+
+		world->ParallelForEachChunk(query, CullChunk, this);
+
+		// Cull the bounds, keeping the view projection for the extraction's depth sorting
+		FrustumCuller::Plane planes[FrustumCuller::PLANE_COUNT];
+		FrustumCuller::ExtractPlanes(viewProjection, planes);
+
+		this->viewProjection = viewProjection;
+		visibleCount = frustumCuller->Cull(planes, visibleIndices.data());
+
+		return visibleCount;
+	}
+	void SceneSystems::UpdateBounds() {
+		// Write the bounds of every renderable entity on the calling thread, as the hierarchy's objects can't be added from multiple threads, stamping the objects that were written
+		EntityWorld::Query query { wfe::GetComponentMask(worldTransformComponent) | wfe::GetComponentMask(boundingSphereComponent) | wfe::GetComponentMask(meshInstanceComponent), 0 };
+
+		++boundsUpdateIndex;
+		world->ForEachChunk(query, UpdateBoundsChunk, this);
+
+		// Remove the objects of the entities that weren't visited, as they were destroyed or lost a renderable component
+		for(size_t i = 0; i != objectEntities.size(); ++i) {
+			if(objectEntities[i] == NULL_ENTITY || objectUpdates[i] == boundsUpdateIndex)
+				continue;
+
+			boundingVolumeHierarchy->RemoveObject((uint32_t)i);
+			if(entityObjects[objectEntities[i].index] == i)
+				entityObjects[objectEntities[i].index] = UINT32_T_MAX;
+			objectEntities[i] = NULL_ENTITY;
+		}
+
+		// Refit the hierarchy, swapping in or submitting a rebuild if needed
+		boundingVolumeHierarchy->Update();
+	}
+	Entity SceneSystems::Pick(const float32_t* origin, const float32_t* direction, float32_t maxDistance, float32_t& hitDistance) const {
+		uint32_t object = boundingVolumeHierarchy->Raycast(origin, direction, maxDistance, hitDistance);
+		if(object == UINT32_T_MAX)
+			return NULL_ENTITY;
+
+		return objectEntities[object];
+	}
+	void SceneSystems::ExtractFramePacket(FramePacket* packet) {
+		// Copy every mesh's draw state, so that the instances' mesh indices also index the packet's draws
+		VulkanDrawQueue::Draw* draws = packet->AllocateDraws(meshes.size());
+		for(size_t i = 0; i != meshes.size(); ++i)
+			draws[i] = meshes[i].draw;
+
+		// Write the visible entities in parallel; every chunk finds its own range of the visible indices
+		EntityWorld::Query query { wfe::GetComponentMask(worldTransformComponent) | wfe::GetComponentMask(boundingSphereComponent) | wfe::GetComponentMask(meshInstanceComponent), 0 };
+
+		packetInstances = packet->AllocateMeshInstances(visibleCount);
+		world->ParallelForEachChunk(query, ExtractPacketChunk, this);
+
+		// Write the lights in parallel, indexed by their position in the query
+		EntityWorld::Query lightQuery { wfe::GetComponentMask(worldTransformComponent) | wfe::GetComponentMask(pointLightComponent), 0 };
+
+		packetLights = packet->AllocateLights(world->CountEntities(lightQuery));
+		world->ParallelForEachChunk(lightQuery, ExtractLightChunk, this);
+
+		packetInstances = nullptr;
+		packetLights = nullptr;
+	}
+	void SceneSystems::UpdateFramePacket(const FramePacket::Camera& camera, FramePacket* packet) {
+		// Pair the camera with the last call's camera, which is the camera itself on the first call
+		packet->SetCamera(camera);
+		packet->SetPreviousCamera(lastCameraSet ? lastCamera : camera);
+		lastCamera = camera;
+		lastCameraSet = true;
+
+		UpdateTransforms();
+		Cull(camera.viewProjection);
+		UpdateBounds();
+		ExtractFramePacket(packet);
+	}
+
+	SceneSystems::~SceneSystems() {
+		// Destroy the transform hierarchy, the frustum culler and the bounding volume hierarchy, which waits for its running rebuild
+		DestroyObject(transformHierarchy);
+		DestroyObject(frustumCuller);
+		DestroyObject(boundingVolumeHierarchy);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "BoundingVolumeHierarchy.hpp"
+#include "EntityWorld.hpp"
+#include "TransformHierarchy.hpp"
+#include "Renderer/Culling/FrustumCuller.hpp"
+#include "Renderer/FramePacket.hpp"
+
+#include <Core.hpp>
+
+namespace wfe {
+	/// @brief The entity systems that turn a world's renderable entities into draws: the transform system updates the systems' transform hierarchy, which only recomputes the subtrees whose local transforms changed, and copies every entity's world matrix to its world transform, keeping the last tick's world transform for the entities that have a previous transform component, the culling system tests the entities' world bounds with the systems' own frustum culler, the bounds system keeps the entities' world bounds in a bounding volume hierarchy for picking and the extraction system writes the visible entities and the lights to a frame packet, which the renderer consumes on another thread. The systems never touch renderer state, so they can run on the simulation thread while the main thread renders.
+	class SceneSystems {
+	public:
+		/// @brief A component linking an entity to the node of the systems' transform hierarchy that holds its local transform.
+		struct TransformNode {
+			/// @brief The index of the entity's node, as returned by the hierarchy's AddNode.
+			uint32_t node;
+		};
+		/// @brief A component containing an entity's sphere bounds, relative to its own transform.
+		struct BoundingSphere {
+			/// @brief The sphere's center.
+			float32_t center[3];
+			/// @brief The sphere's radius.
+			float32_t radius;
+		};
+		/// @brief A component referencing the mesh an entity is drawn with.
+		struct MeshInstance {
+			/// @brief The index of the mesh, as returned by AddMesh.
+			uint32_t meshIndex;
+		};
+		/// @brief A component making an entity a point light, placed at the translation of its world transform.
+		struct PointLight {
+			/// @brief The light's linear color.
+			float32_t color[3];
+			/// @brief The light's intensity, which scales its color.
+			float32_t intensity;
+			/// @brief The distance at which the light's contribution reaches 0.
+			float32_t radius;
+		};
+		/// @brief A struct containing the draw state of a mesh, shared by every entity drawn with it.
+		struct Mesh {
+			/// @brief The mesh's draw state and parameters. Its instance count and first instance are ignored.
+			VulkanDrawQueue::Draw draw;
+			/// @brief The index of the pass the mesh is drawn in.
+			uint32_t passIndex;
+			/// @brief The index of the mesh's pipeline.
+			uint32_t pipelineIndex;
+			/// @brief The index of the mesh's material.
+			uint32_t materialIndex;
+		};
+
+		/// @brief Creates the scene systems, their transform hierarchy, their frustum culler and their bounding volume hierarchy and registers their components in the given world.
+		/// @param world The world whose entities the systems run on. Its job system is also used to split the culls between threads and to rebuild the bounding volume hierarchy.
+		SceneSystems(EntityWorld* world);
+		SceneSystems(const SceneSystems&) = delete;
+		SceneSystems(SceneSystems&&) noexcept = delete;
+
+		SceneSystems& operator=(const SceneSystems&) = delete;
+		SceneSystems& operator=(SceneSystems&&) = delete;
+
+		/// @brief Gets the world whose entities the systems run on.
+		/// @return A pointer to the entity world.
+		EntityWorld* GetWorld() {
+			return world;
+		}
+		/// @brief Gets the systems' transform hierarchy, whose nodes hold the entities' transforms relative to their parents. Entities are moved by setting their nodes' local transforms.
+		/// @return A pointer to the transform hierarchy.
+		TransformHierarchy* GetTransformHierarchy() {
+			return transformHierarchy;
+		}
+		/// @brief Gets the transform node component type, whose components are TransformNode structs.
+		/// @return The transform node component type.
+		ComponentType GetTransformNodeComponent() const {
+			return transformNodeComponent;
+		}
+		/// @brief Gets the world transform component type, whose components are VulkanDrawQueue::InstanceTransform structs written by the transform system.
+		/// @return The world transform component type.
+		ComponentType GetWorldTransformComponent() const {
+			return worldTransformComponent;
+		}
+		/// @brief Gets the previous transform component type, whose components are VulkanDrawQueue::InstanceTransform structs holding the entities' world transforms as of the tick before the last transform update. Renderable entities without it are drawn without interpolation.
+		/// @return The previous transform component type.
+		ComponentType GetPreviousTransformComponent() const {
+			return previousTransformComponent;
+		}
+		/// @brief Gets the bounding sphere component type, whose components are BoundingSphere structs.
+		/// @return The bounding sphere component type.
+		ComponentType GetBoundingSphereComponent() const {
+			return boundingSphereComponent;
+		}
+		/// @brief Gets the mesh instance component type, whose components are MeshInstance structs.
+		/// @return The mesh instance component type.
+		ComponentType GetMeshInstanceComponent() const {
+			return meshInstanceComponent;
+		}
+		/// @brief Gets the point light component type, whose components are PointLight structs.
+		/// @return The point light component type.
+		ComponentType GetPointLightComponent() const {
+			return pointLightComponent;
+		}
+		/// @brief Gets the components a renderable entity needs to be culled and drawn, including its previous transform, which lets frames blend its last two ticks.
+		/// @return The renderable component mask.
+		ComponentMask GetRenderableMask() const {
+			return wfe::GetComponentMask(transformNodeComponent) | wfe::GetComponentMask(worldTransformComponent) | wfe::GetComponentMask(previousTransformComponent) | wfe::GetComponentMask(boundingSphereComponent) | wfe::GetComponentMask(meshInstanceComponent);
+		}
+		/// @brief Gets the systems' frustum culler, whose objects are the renderable entities' world bounds as of the last cull.
+		/// @return A pointer to the frustum culler.
+		FrustumCuller* GetFrustumCuller() {
+			return frustumCuller;
+		}
+		/// @brief Gets the systems' bounding volume hierarchy, whose objects are the renderable entities' world bounds as of the last bounds update.
+		/// @return A pointer to the bounding volume hierarchy.
+		BoundingVolumeHierarchy* GetBoundingVolumeHierarchy() {
+			return boundingVolumeHierarchy;
+		}
+		/// @brief Gets the number of entities that passed the last cull.
+		/// @return The visible entity count.
+		size_t GetVisibleCount() const {
+			return visibleCount;
+		}
+
+		/// @brief Adds a mesh entities can be drawn with.
+		/// @param mesh The mesh's draw state.
+		/// @return The mesh's index, to be set in the entities' mesh instance components.
+		uint32_t AddMesh(const Mesh& mesh);
+
+		/// @brief Updates the transform hierarchy, then copies the world matrix of every entity's node to its world transform, moving the old world transform to the entity's previous transform if it has one, splitting the entities between the world's job system threads.
+		void UpdateTransforms();
+		/// @brief Culls every renderable entity's world bounds against the given view projection's frustum.
+		/// @param viewProjection The view projection matrix, which maps depth to Vulkan's [0, 1] range.
+		/// @return The number of visible entities.
+		size_t Cull(const Matrix4& viewProjection);
+		/// @brief Writes every renderable entity's world bounds to the bounding volume hierarchy, adding the entities it doesn't hold yet and removing the ones that were destroyed or are no longer renderable, then updates the hierarchy.
+		void UpdateBounds();
+		/// @brief Finds the renderable entity whose world bounds are hit first by the given ray, as of the last bounds update. Must be called on the thread that updates the systems.
+		/// @param origin The ray's origin.
+		/// @param direction The ray's direction, which doesn't have to be normalized.
+		/// @param maxDistance The maximum hit distance, in multiples of the direction's length.
+		/// @param hitDistance A reference to the variable in which the hit distance will be written.
+		/// @return The hit entity, or NULL_ENTITY if no entity was hit.
+		Entity Pick(const float32_t* origin, const float32_t* direction, float32_t maxDistance, float32_t& hitDistance) const;
+		/// @brief Copies every mesh's draw state, every entity that passed the last cull and every point light to the given frame packet, splitting the entities between the world's job system threads. Must be called before the world's structure changes.
+		/// @param packet The frame packet to write to, which must have been reset. Its camera is left unchanged.
+		void ExtractFramePacket(FramePacket* packet);
+		/// @brief Runs the transform, culling and bounds systems for the given camera, then extracts the results, the camera and the camera the last call was given to the given frame packet.
+		/// @param camera The camera to cull and sort the entities for.
+		/// @param packet The frame packet to write to, which must have been reset.
+		void UpdateFramePacket(const FramePacket::Camera& camera, FramePacket* packet);
+
+		/// @brief Destroys the scene systems, their transform hierarchy, their frustum culler and their bounding volume hierarchy.
+		~SceneSystems();
+	private:
+		static void UpdateTransformChunk(void* userData, EntityWorld::Chunk* chunk, size_t firstIndex);
+		static void CullChunk(void* userData, EntityWorld::Chunk* chunk, size_t firstIndex);
+		static void UpdateBoundsChunk(void* userData, EntityWorld::Chunk* chunk, size_t firstIndex);
+		static void ExtractPacketChunk(void* userData, EntityWorld::Chunk* chunk, size_t firstIndex);
+		static void ExtractLightChunk(void* userData, EntityWorld::Chunk* chunk, size_t firstIndex);
+
+		EntityWorld* world;
+		TransformHierarchy* transformHierarchy;
+		FrustumCuller* frustumCuller;
+		BoundingVolumeHierarchy* boundingVolumeHierarchy;
+
+		ComponentType transformNodeComponent;
+		ComponentType worldTransformComponent;
+		ComponentType previousTransformComponent;
+		ComponentType boundingSphereComponent;
+		ComponentType meshInstanceComponent;
+		ComponentType pointLightComponent;
+
+		vector<Mesh> meshes;
+
+		vector<uint32_t> entityObjects;
+		vector<Entity> objectEntities;
+		vector<uint32_t> objectUpdates;
+		uint32_t boundsUpdateIndex;
+
+		Matrix4 viewProjection;
+		vector<uint32_t> visibleIndices;
+		size_t visibleCount;
+		FramePacket::MeshInstance* packetInstances;
+		FramePacket::Light* packetLights;
+
+		FramePacket::Camera lastCamera;
+		bool8_t lastCameraSet;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,278 @@
+#include "TransformHierarchy.hpp"
+#include "General/RadixSort.hpp"
+
+namespace wfe {
+	// Internal helper functions
+	void TransformHierarchy::AddRange(vector<SlotRange>& ranges, uint32_t begin, uint32_t end) {
+		// Extend the last range if the new range touches it, as ranges are added in ascending order
+		if(ranges.size() && begin <= ranges.back().end) {
+			if(end > ranges.back().end)
+				ranges.back().end = end;
+		} else {
+			ranges.push_back({ begin, end });
+		}
+	}
+
+	void TransformHierarchy::ComputeRange(uint32_t begin, uint32_t end) {
+		size_t count = end - begin;
+		parentMatrices.resize(count);
+		localMatrices.resize(count);
+
+		// Build the range's local matrices and gather their parents' world matrices, as the parents of consecutive nodes aren't always consecutive
+		for(size_t i = 0; i != count; ++i) {
+			const LocalTransform& localTransform = localTransforms[begin + i];
+			localMatrices[i] = MatrixFromTransform(localTransform.position, localTransform.rotation, { localTransform.scale, localTransform.scale, localTransform.scale });
+			parentMatrices[i] = worldMatrices[parentSlots[begin + i]];
+		}
+
+		// Multiply every local matrix by its parent's world matrix in one batch
+		MultiplyMatrices(count, parentMatrices.data(), localMatrices.data(), worldMatrices.data() + begin, simdLevel);
+	}
+
+	void TransformHierarchy::SortNodes() {
+		uint32_t nodeCount = (uint32_t)slotNodes.size();
+		uint32_t nodeIndexCount = (uint32_t)nodeSlots.size();
+
+		// Group every node's children using a counting sort over the parents, keeping the current slot order among siblings
+		vector<uint32_t> childStarts;
+		vector<uint32_t> childNodes;
+		childStarts.resize(nodeIndexCount + 1);
+		childNodes.resize(nodeCount);
+
+		for(uint32_t node = 0; node != nodeIndexCount; ++node)
+			childStarts[node + 1] = childStarts[node] + nodeChildCounts[node];
+		for(uint32_t slot = 0; slot != nodeCount; ++slot) {
+			uint32_t node = slotNodes[slot];
+			uint32_t parent = nodeParents[node];
+			if(parent != NULL_NODE)
+				childNodes[childStarts[parent]++] = node;
+		}
+		for(uint32_t node = nodeIndexCount; node; --node)
+			childStarts[node] = childStarts[node - 1];
+		childStarts[0] = 0;
+
+		// Order the nodes breadth-first, starting with the roots. Every node's children are appended together, so the children of consecutive nodes are consecutive as well
+		vector<uint32_t> order;
+		order.reserve(nodeCount);
+		childOffsets.resize(nodeCount + 1);
+		levelOffsets.clear();
+		levelOffsets.push_back(0);
+
+		for(uint32_t slot = 0; slot != nodeCount; ++slot)
+			if(nodeParents[slotNodes[slot]] == NULL_NODE)
+				order.push_back(slotNodes[slot]);
+
+		uint32_t levelEnd = (uint32_t)order.size();
+		for(uint32_t head = 0; head != order.size(); ++head) {
+			// Start a new level once every node of the previous one was visited
+			if(head == levelEnd) {
+				levelOffsets.push_back(levelEnd);
+				levelEnd = (uint32_t)order.size();
+			}
+
+			uint32_t node = order[head];
+			childOffsets[head] = (uint32_t)order.size();
+			for(uint32_t i = childStarts[node]; i != childStarts[node + 1]; ++i)
+				order.push_back(childNodes[i]);
+		}
+
+		if(nodeCount)
+			levelOffsets.push_back(nodeCount);
+		childOffsets[nodeCount] = nodeCount;
+
+		// Move every node's local transform to its new slot
+		vector<LocalTransform> sortedTransforms;
+		sortedTransforms.resize(nodeCount);
+
+		for(uint32_t slot = 0; slot != nodeCount; ++slot)
+			sortedTransforms[slot] = localTransforms[nodeSlots[order[slot]]];
+
+		memcpy(localTransforms.data(), sortedTransforms.data(), nodeCount * sizeof(LocalTransform));
+
+		for(uint32_t slot = 0; slot != nodeCount; ++slot) {
+			slotNodes[slot] = order[slot];
+			nodeSlots[order[slot]] = slot;
+		}
+
+		// Point the roots to the identity matrix stored past the last slot, so that they're computed like any other node
+		parentSlots.resize(nodeCount);
+		for(uint32_t slot = 0; slot != nodeCount; ++slot) {
+			uint32_t parent = nodeParents[slotNodes[slot]];
+			parentSlots[slot] = parent == NULL_NODE ? nodeCount : nodeSlots[parent];
+		}
+
+		worldMatrices.resize(nodeCount + 1);
+		worldMatrices[nodeCount] = IDENTITY_MATRIX;
+
+		// Clear the marked nodes, as every node will be recomputed
+		for(uint64_t slot : dirtySlots)
+			dirtyFlags[slot] = 0;
+		dirtySlots.clear();
+		dirtyValues.clear();
+	}
+
+	// Public functions
+	TransformHierarchy::TransformHierarchy() : simdLevel(wfe::GetSimdLevel()), orderDirty(false), updatedCount(0) {
+		levelOffsets.push_back(0);
+	}
+
+	uint32_t TransformHierarchy::AddNode(uint32_t parent, const LocalTransform& localTransform) {
+		// Make sure the parent exists
+		if(parent != NULL_NODE && (parent >= nodeSlots.size() || nodeSlots[parent] == UINT32_T_MAX))
+			throw Exception("Invalid transform node parent!");
+
+		// Reuse a free node index, or add a new one
+		uint32_t node;
+		if(freeNodes.size()) {
+			node = freeNodes.back();
+			freeNodes.pop_back();
+		} else {
+			node = (uint32_t)nodeSlots.size();
+			nodeSlots.push_back(0);
+			nodeParents.push_back(NULL_NODE);
+			nodeChildCounts.push_back(0);
+		}
+
+		nodeSlots[node] = (uint32_t)slotNodes.size();
+		nodeParents[node] = parent;
+		nodeChildCounts[node] = 0;
+		if(parent != NULL_NODE)
+			++nodeChildCounts[parent];
+
+		// Append the node's slot, which is moved to its breadth-first position on the next update
+		slotNodes.push_back(node);
+		localTransforms.push_back(localTransform);
+		dirtyFlags.push_back(0);
+
+		orderDirty = true;
+
+		return node;
+	}
+	void TransformHierarchy::RemoveNode(uint32_t node) {
+		// Make sure the node has no children
+		if(nodeChildCounts[node])
+			throw Exception("Cannot remove a transform node with children!");
+
+		// Move the last slot into the removed node's slot
+		uint32_t slot = nodeSlots[node];
+		uint32_t lastSlot = (uint32_t)slotNodes.size() - 1;
+
+		if(slot != lastSlot) {
+			uint32_t lastNode = slotNodes[lastSlot];
+
+			slotNodes[slot] = lastNode;
+			nodeSlots[lastNode] = slot;
+			localTransforms[slot] = localTransforms[lastSlot];
+			dirtyFlags[slot] = dirtyFlags[lastSlot];
+		}
+
+		slotNodes.pop_back();
+		localTransforms.pop_back();
+		dirtyFlags.pop_back();
+
+		// Free the node's index
+		if(nodeParents[node] != NULL_NODE)
+			--nodeChildCounts[nodeParents[node]];
+
+		nodeSlots[node] = UINT32_T_MAX;
+		nodeParents[node] = NULL_NODE;
+		freeNodes.push_back(node);
+
+		orderDirty = true;
+	}
+	void TransformHierarchy::SetParent(uint32_t node, uint32_t parent) {
+		// Make sure the new parent isn't the node or one of its descendants
+		for(uint32_t ancestor = parent; ancestor != NULL_NODE; ancestor = nodeParents[ancestor])
+			if(ancestor == node)
+				throw Exception("Cannot move a transform node under itself!");
+
+		// Move the node to its new parent
+		if(nodeParents[node] != NULL_NODE)
+			--nodeChildCounts[nodeParents[node]];
+		if(parent != NULL_NODE)
+			++nodeChildCounts[parent];
+
+		nodeParents[node] = parent;
+		orderDirty = true;
+	}
+	void TransformHierarchy::SetLocalTransform(uint32_t node, const LocalTransform& localTransform) {
+		uint32_t slot = nodeSlots[node];
+
+		localTransforms[slot] = localTransform;
+
+		// Mark the node, unless it's already marked or every node will be recomputed after re-sorting
+		if(!orderDirty && !dirtyFlags[slot]) {
+			dirtyFlags[slot] = 1;
+			dirtySlots.push_back(slot);
+			dirtyValues.push_back(slot);
+		}
+	}
+	void TransformHierarchy::Update() {
+		updatedCount = 0;
+		childRanges.clear();
+
+		if(orderDirty) {
+			// Re-sort the nodes, then recompute every node starting with the roots
+			SortNodes();
+			orderDirty = false;
+
+			if(slotNodes.size())
+				childRanges.push_back({ 0, levelOffsets[1] });
+		} else {
+			// Exit the function if no node changed, which makes static hierarchies free to update
+			if(!dirtySlots.size())
+				return;
+
+			// Sort the marked slots, so that they can be merged into every level's ranges in order
+			tempDirtySlots.resize(dirtySlots.size());
+			tempDirtyValues.resize(dirtyValues.size());
+			RadixSort(dirtySlots.size(), dirtySlots.data(), dirtyValues.data(), tempDirtySlots.data(), tempDirtyValues.data());
+		}
+
+		size_t dirtyIndex = 0;
+		size_t dirtyCount = dirtySlots.size();
+		size_t levelCount = levelOffsets.size() - 1;
+
+		for(size_t level = 0; level != levelCount; ++level) {
+			// Stop once there are no ranges left to propagate and no marked nodes left
+			if(!childRanges.size() && dirtyIndex == dirtyCount)
+				break;
+
+			// Merge the level's marked nodes into the children of the nodes recomputed in the previous level
+			uint32_t levelEnd = levelOffsets[level + 1];
+			size_t rangeIndex = 0;
+			levelRanges.clear();
+
+			while(true) {
+				bool8_t hasDirty = dirtyIndex != dirtyCount && dirtySlots[dirtyIndex] < levelEnd;
+				bool8_t hasRange = rangeIndex != childRanges.size();
+
+				if(hasDirty && (!hasRange || dirtySlots[dirtyIndex] < childRanges[rangeIndex].begin)) {
+					AddRange(levelRanges, (uint32_t)dirtySlots[dirtyIndex], (uint32_t)dirtySlots[dirtyIndex] + 1);
+					++dirtyIndex;
+				} else if(hasRange) {
+					AddRange(levelRanges, childRanges[rangeIndex].begin, childRanges[rangeIndex].end);
+					++rangeIndex;
+				} else {
+					break;
+				}
+			}
+
+			// Recompute every range, then propagate the ranges to their children, which are contiguous thanks to the breadth-first order
+			childRanges.clear();
+			for(const SlotRange& range : levelRanges) {
+				ComputeRange(range.begin, range.end);
+				updatedCount += range.end - range.begin;
+
+				if(childOffsets[range.begin] != childOffsets[range.end])
+					AddRange(childRanges, childOffsets[range.begin], childOffsets[range.end]);
+			}
+		}
+
+		// Clear the marked nodes
+		for(uint64_t slot : dirtySlots)
+			dirtyFlags[slot] = 0;
+		dirtySlots.clear();
+		dirtyValues.clear();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "Math/MathBatch.hpp"
+
+#include <Core.hpp>
+
+namespace wfe {
+	/// @brief A hierarchy of transform nodes, which stores its local transforms and world matrices sorted breadth-first, so that every parent's world matrix is computed before its children's and every node's children are contiguous. Updates only recompute the subtrees below nodes whose local transform changed, multiplying every contiguous range of nodes by their parents in one batch.
+	class TransformHierarchy {
+	public:
+		/// @brief The index used for the parent of root nodes.
+		static constexpr uint32_t NULL_NODE = UINT32_T_MAX;
+
+		/// @brief A struct containing a node's transform relative to its parent.
+		struct LocalTransform {
+			/// @brief The node's position.
+			Vector3 position;
+			/// @brief The node's rotation, which must be normalized.
+			Quaternion rotation;
+			/// @brief The node's uniform scale.
+			float32_t scale;
+		};
+
+		/// @brief Creates an empty transform hierarchy.
+		TransformHierarchy();
+		TransformHierarchy(const TransformHierarchy&) = delete;
+		TransformHierarchy(TransformHierarchy&&) noexcept = delete;
+
+		TransformHierarchy& operator=(const TransformHierarchy&) = delete;
+		TransformHierarchy& operator=(TransformHierarchy&&) = delete;
+
+		/// @brief Gets the SIMD level of the matrix multiplication kernel chosen for the current CPU.
+		/// @return The matrix multiplication kernel's SIMD level.
+		SimdLevel GetSimdLevel() const {
+			return simdLevel;
+		}
+		/// @brief Gets the number of nodes in the hierarchy.
+		/// @return The hierarchy's node count.
+		size_t GetNodeCount() const {
+			return slotNodes.size();
+		}
+		/// @brief Gets the number of levels in the hierarchy, as of the last update.
+		/// @return The hierarchy's depth.
+		size_t GetLevelCount() const {
+			return levelOffsets.size() - 1;
+		}
+		/// @brief Gets the number of world matrices computed by the last update, which is 0 if no node changed.
+		/// @return The last update's computed matrix count.
+		size_t GetUpdatedCount() const {
+			return updatedCount;
+		}
+
+		/// @brief Adds a node to the hierarchy.
+		/// @param parent The node's parent, or NULL_NODE to add a root node.
+		/// @param localTransform The node's transform relative to its parent.
+		/// @return The node's index, which stays the same until the node is removed.
+		uint32_t AddNode(uint32_t parent, const LocalTransform& localTransform);
+		/// @brief Removes the given node from the hierarchy. Its index may be returned by later calls to AddNode.
+		/// @param node The node to remove, which mustn't have any children.
+		void RemoveNode(uint32_t node);
+		/// @brief Moves the given node under a new parent, keeping its local transform.
+		/// @param node The node to move.
+		/// @param parent The node's new parent, which mustn't be the node or one of its descendants, or NULL_NODE to make the node a root.
+		void SetParent(uint32_t node, uint32_t parent);
+		/// @brief Gets the given node's parent.
+		/// @param node The node.
+		/// @return The node's parent, or NULL_NODE if the node is a root.
+		uint32_t GetParent(uint32_t node) const {
+			return nodeParents[node];
+		}
+		/// @brief Sets the given node's local transform, marking its subtree for the next update.
+		/// @param node The node.
+		/// @param localTransform The node's new transform relative to its parent.
+		void SetLocalTransform(uint32_t node, const LocalTransform& localTransform);
+		/// @brief Gets the given node's local transform.
+		/// @param node The node.
+		/// @return The node's transform relative to its parent.
+		const LocalTransform& GetLocalTransform(uint32_t node) const {
+			return localTransforms[nodeSlots[node]];
+		}
+		/// @brief Gets the given node's world matrix, as of the last update.
+		/// @param node The node. The hierarchy's structure mustn't have changed since the last update.
+		/// @return A reference to the node's world matrix.
+		const Matrix4& GetWorldMatrix(uint32_t node) const {
+			return worldMatrices[nodeSlots[node]];
+		}
+		/// @brief Updates the hierarchy, usually once per frame. Re-sorts the nodes if the hierarchy's structure changed, then recomputes the world matrices of every changed node and its descendants.
+		void Update();
+
+		/// @brief Destroys the transform hierarchy.
+		~TransformHierarchy() = default;
+	private:
+		struct SlotRange {
+			uint32_t begin;
+			uint32_t end;
+		};
+
+		static void AddRange(vector<SlotRange>& ranges, uint32_t begin, uint32_t end);
+
+		void SortNodes();
+		void ComputeRange(uint32_t begin, uint32_t end);
+
+		SimdLevel simdLevel;
+
+		vector<uint32_t> nodeSlots;
+		vector<uint32_t> nodeParents;
+		vector<uint32_t> nodeChildCounts;
+		vector<uint32_t> freeNodes;
+		bool8_t orderDirty;
+
+		vector<uint32_t> slotNodes;
+		vector<uint32_t> parentSlots;
+		vector<uint32_t> childOffsets;
+		vector<uint32_t> levelOffsets;
+
+		vector<LocalTransform> localTransforms;
+		vector<Matrix4> worldMatrices;
+		vector<Matrix4> parentMatrices;
+		vector<Matrix4> localMatrices;
+
+		vector<uint8_t> dirtyFlags;
+		vector<uint64_t> dirtySlots;
+		vector<uint32_t> dirtyValues;
+		vector<uint64_t> tempDirtySlots;
+		vector<uint32_t> tempDirtyValues;
+		vector<SlotRange> levelRanges;
+		vector<SlotRange> childRanges;
+		size_t updatedCount;
+	};
+}
\ No newline at end of file
@@ -1,6 +1,27 @@
 #pragma once
 
+#include "General/CpuInfo.hpp"
+#include "General/FixedTimestep.hpp"
+#include "General/JobSystem.hpp"
+#include "General/LinearArena.hpp"
 #include "General/Program.hpp"
+#include "Math/MathBatch.hpp"
+#include "Math/Matrix.hpp"
+#include "Math/Quaternion.hpp"
+#include "Math/Vector.hpp"
+#include "Platform/Clock.hpp"
+#include "Platform/Fiber.hpp"
 #include "Platform/Window.hpp"
 #include "Platform/Input.hpp"
-#include "Renderer/Renderer.hpp"
\ No newline at end of file
+#include "Platform/Semaphore.hpp"
+#include "Platform/Thread.hpp"
+#include "Renderer/Renderer.hpp"
+#include "Renderer/Culling/FrustumCuller.hpp"
+#include "Renderer/FramePacket.hpp"
+#include "Renderer/Geometry/MeshletBuilder.hpp"
+#include "Scene/BoundingVolumeHierarchy.hpp"
+#include "Scene/Entity.hpp"
+#include "Scene/EntityCommandBuffer.hpp"
+#include "Scene/EntityWorld.hpp"
+#include "Scene/SceneSystems.hpp"
+#include "Scene/TransformHierarchy.hpp"
\ No newline at end of file